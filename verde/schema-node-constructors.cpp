@@ -32,8 +32,8 @@ SchemaNodeBase::SchemaNodeBase(const ParserHelper& node_factory,
 		const YAML::Node& yaml_node) :
 		node_factory_(node_factory), name_(yaml_node["name"].as<std::string>()), type_(
 				yaml_node["type"].as<std::string>()) {
-	if (yaml_node["description"]) {
-		description_ = yaml_node["description"].as<std::string>();
+	if (const YAML::NodeView description_node = yaml_node.find("description")) {
+		description_ = description_node.as<std::string>();
 	}
 }
 
@@ -110,13 +110,15 @@ VectorSchemaNode::VectorSchemaNode(const ParserHelper& node_factory,
 
 	element_node_ = node_factory_.build_node(yaml_node["elements"]);
 
-	if(yaml_node["minimum-length"]){
-		minimum_length_ = yaml_node["minimum-length"].as<unsigned int>();
+	if (const YAML::NodeView minimum_length_node =
+			yaml_node.find("minimum-length")) {
+		minimum_length_ = minimum_length_node.as<unsigned int>();
 		check_minimum_length_ = true;
 	}
 
-	if(yaml_node["maximum-length"]){
-		maximum_length_ = yaml_node["maximum-length"].as<unsigned int>();
+	if (const YAML::NodeView maximum_length_node =
+			yaml_node.find("maximum-length")) {
+		maximum_length_ = maximum_length_node.as<unsigned int>();
 		check_maximum_length_ = true;
 	}
 }
@@ -177,13 +179,13 @@ StringSchemaNode::StringSchemaNode(const ParserHelper& node_factory,
 			"default", "values" };
 	check_schema_node_keys_validity(valid_keys, yaml_node, get_name(),
 			get_type());
-	if (yaml_node["default"]) {
+	if (const YAML::NodeView default_node = yaml_node.find("default")) {
 		has_default_ = true;
-		default_ = yaml_node["default"].as<std::string>();
+		default_ = default_node.as<std::string>();
 	}
-	if (yaml_node["values"]) {
+	if (const YAML::NodeView values_node = yaml_node.find("values")) {
 		has_valid_values_ = true;
-		for (const auto& value_node : yaml_node["values"]) {
+		for (const auto& value_node : values_node) {
 			const std::string& value_node_str = value_node.as<std::string>();
 			valid_values_string_ += value_node_str + ", ";
 			valid_values_.push_back(value_node_str);
@@ -207,13 +209,13 @@ DoubleSchemaNode::DoubleSchemaNode(const ParserHelper& node_factory,
 			"default", "values" };
 	check_schema_node_keys_validity(valid_keys, yaml_node, get_name(),
 			get_type());
-	if (yaml_node["default"]) {
+	if (const YAML::NodeView default_node = yaml_node.find("default")) {
 		has_default_ = true;
-		default_ = yaml_node["default"].as<double>();
+		default_ = default_node.as<double>();
 	}
-	if (yaml_node["values"]) {
+	if (const YAML::NodeView values_node = yaml_node.find("values")) {
 		has_valid_values_ = true;
-		for (const auto& value_node : yaml_node["values"]) {
+		for (const auto& value_node : values_node) {
 			const std::string& value_node_str = value_node.as<std::string>();
 			valid_values_string_ += value_node_str + ", ";
 			valid_values_.push_back(value_node.as<double>());
@@ -237,13 +239,13 @@ FloatSchemaNode::FloatSchemaNode(const ParserHelper& node_factory,
 			"default", "values" };
 	check_schema_node_keys_validity(valid_keys, yaml_node, get_name(),
 			get_type());
-	if (yaml_node["default"]) {
+	if (const YAML::NodeView default_node = yaml_node.find("default")) {
 		has_default_ = true;
-		default_ = yaml_node["default"].as<float>();
+		default_ = default_node.as<float>();
 	}
-	if (yaml_node["values"]) {
+	if (const YAML::NodeView values_node = yaml_node.find("values")) {
 		has_valid_values_ = true;
-		for (const auto& value_node : yaml_node["values"]) {
+		for (const auto& value_node : values_node) {
 			const std::string& value_node_str = value_node.as<std::string>();
 			valid_values_string_ += value_node_str + ", ";
 			valid_values_.push_back(value_node.as<float>());
@@ -267,9 +269,9 @@ BoolSchemaNode::BoolSchemaNode(const ParserHelper& node_factory,
 			"default" };
 	check_schema_node_keys_validity(valid_keys, yaml_node, get_name(),
 			get_type());
-	if (yaml_node["default"]) {
+	if (const YAML::NodeView default_node = yaml_node.find("default")) {
 		has_default_ = true;
-		default_ = yaml_node["default"].as<float>();
+		default_ = default_node.as<float>();
 	}
 }
 
@@ -289,13 +291,13 @@ IntegerSchemaNode::IntegerSchemaNode(const ParserHelper& node_factory,
 			"default", "values" };
 	check_schema_node_keys_validity(valid_keys, yaml_node, get_name(),
 			get_type());
-	if (yaml_node["default"]) {
+	if (const YAML::NodeView default_node = yaml_node.find("default")) {
 		has_default_ = true;
-		default_ = yaml_node["default"].as<int>();
+		default_ = default_node.as<int>();
 	}
-	if (yaml_node["values"]) {
+	if (const YAML::NodeView values_node = yaml_node.find("values")) {
 		has_valid_values_ = true;
-		for (const auto& value_node : yaml_node["values"]) {
+		for (const auto& value_node : values_node) {
 			const std::string& value_node_str = value_node.as<std::string>();
 			valid_values_string_ += value_node_str + ", ";
 			valid_values_.push_back(value_node.as<int>());
@@ -319,13 +321,13 @@ UnsignedIntegerSchemaNode::UnsignedIntegerSchemaNode(
 			"default", "values" };
 	check_schema_node_keys_validity(valid_keys, yaml_node, get_name(),
 			get_type());
-	if (yaml_node["default"]) {
+	if (const YAML::NodeView default_node = yaml_node.find("default")) {
 		has_default_ = true;
-		default_ = yaml_node["default"].as<unsigned int>();
+		default_ = default_node.as<unsigned int>();
 	}
-	if (yaml_node["values"]) {
+	if (const YAML::NodeView values_node = yaml_node.find("values")) {
 		has_valid_values_ = true;
-		for (const auto& value_node : yaml_node["values"]) {
+		for (const auto& value_node : values_node) {
 			const std::string& value_node_str = value_node.as<std::string>();
 			valid_values_string_ += value_node_str + ", ";
 			valid_values_.push_back(value_node.as<unsigned int>());
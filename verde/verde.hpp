@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <algorithm>
 
 namespace verde {
 
@@ -32,11 +32,19 @@ class YAML_CPP_API Emitter : private noncopyable {
  public:
   Emitter();
   explicit Emitter(std::ostream& stream);
+
+  /**
+   * Emits to an open file descriptor, in blocks (see
+   * {@link ostream_wrapper}); the rest is written out by {@link Flush}, or
+   * when the emitter is destroyed.
+   */
+  explicit Emitter(int fd);
   ~Emitter();
 
   // output
   const char* c_str() const;
   std::size_t size() const;
+  bool Flush();
 
   // state checking
   bool good() const;
@@ -52,6 +60,8 @@ class YAML_CPP_API Emitter : private noncopyable {
   bool SetIndent(std::size_t n);
   bool SetPreCommentIndent(std::size_t n);
   bool SetPostCommentIndent(std::size_t n);
+  // the default precision is digits10 + 1, as convert<T>::encode writes; 0
+  // writes the fewest digits that read back as the same value
   bool SetFloatPrecision(std::size_t n);
   bool SetDoublePrecision(std::size_t n);
 
@@ -78,11 +88,27 @@ class YAML_CPP_API Emitter : private noncopyable {
   Emitter& WriteStreamable(T value);
 
  private:
-  template <typename T>
-  void SetStreamablePrecision(std::stringstream&) {}
   std::size_t GetFloatPrecision() const;
   std::size_t GetDoublePrecision() const;
 
+  // the built-in numbers are formatted straight into the output; anything
+  // else goes through a stream
+  void WriteIntegralValue(short value);
+  void WriteIntegralValue(unsigned short value);
+  void WriteIntegralValue(int value);
+  void WriteIntegralValue(unsigned int value);
+  void WriteIntegralValue(long value);
+  void WriteIntegralValue(unsigned long value);
+  void WriteIntegralValue(long long value);
+  void WriteIntegralValue(unsigned long long value);
+  template <typename T>
+  void WriteIntegralValue(const T& value);
+
+  void WriteStreamableValue(float value);
+  void WriteStreamableValue(double value);
+  template <typename T>
+  void WriteStreamableValue(const T& value);
+
   void PrepareIntegralStream(std::stringstream& stream) const;
   void StartedScalar();
 
@@ -132,12 +158,7 @@ inline Emitter& Emitter::WriteIntegralType(T value) {
     return *this;
 
   PrepareNode(EmitterNodeType::Scalar);
-
-  std::stringstream stream;
-  PrepareIntegralStream(stream);
-  stream << value;
-  m_stream << stream.str();
-
+  WriteIntegralValue(value);
   StartedScalar();
 
   return *this;
@@ -149,25 +170,25 @@ inline Emitter& Emitter::WriteStreamable(T value) {
     return *this;
 
   PrepareNode(EmitterNodeType::Scalar);
-
-  std::stringstream stream;
-  SetStreamablePrecision<T>(stream);
-  stream << value;
-  m_stream << stream.str();
-
+  WriteStreamableValue(value);
   StartedScalar();
 
   return *this;
 }
 
-template <>
-inline void Emitter::SetStreamablePrecision<float>(std::stringstream& stream) {
-  stream.precision(static_cast<std::streamsize>(GetFloatPrecision()));
+template <typename T>
+inline void Emitter::WriteIntegralValue(const T& value) {
+  std::stringstream stream;
+  PrepareIntegralStream(stream);
+  stream << value;
+  m_stream << stream.str();
 }
 
-template <>
-inline void Emitter::SetStreamablePrecision<double>(std::stringstream& stream) {
-  stream.precision(static_cast<std::streamsize>(GetDoublePrecision()));
+template <typename T>
+inline void Emitter::WriteStreamableValue(const T& value) {
+  std::stringstream stream;
+  stream << value;
+  m_stream << stream.str();
 }
 
 // overloads of insertion
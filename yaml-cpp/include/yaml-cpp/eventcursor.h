@@ -0,0 +1,148 @@
+#ifndef EVENTCURSOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define EVENTCURSOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <ios>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/noncopyable.h"
+#include "yaml-cpp/parser.h"
+#include "yaml-cpp/stringref.h"
+
+namespace YAML {
+class SingleDocParser;
+struct ParserEvent;
+
+/** The kinds of event, matching the calls on an {@link EventHandler}. */
+struct EventType {
+  enum value {
+    DocumentStart,
+    DocumentEnd,
+    Null,
+    Alias,
+    Scalar,
+    SequenceStart,
+    SequenceEnd,
+    MapStart,
+    MapEnd
+  };
+};
+
+/**
+ * A cursor pulls the events of a YAML stream one at a time, rather than
+ * having a {@link Parser} push all of a document's events to an
+ * {@link EventHandler}. It holds on to nothing but the current event and
+ * one entry per open collection (plus the anchor names seen so far), so it
+ * can walk input of any size, skip whole subtrees, and stop anywhere.
+ *
+ * The events, and their errors, are exactly those that
+ * {@link Parser::HandleNextDocument} would give.
+ */
+class YAML_CPP_API EventCursor : private noncopyable {
+ public:
+  /**
+   * Constructs a cursor over the given input stream, which must live as
+   * long as the cursor.
+   */
+  explicit EventCursor(std::istream& in);
+
+  /**
+   * Constructs a cursor over memory-resident input; scalars that appear
+   * verbatim in it can be read through {@link ScalarRef} without copying.
+   */
+  explicit EventCursor(std::shared_ptr<const std::string> input);
+
+  ~EventCursor();
+
+  /**
+   * Moves on to the next event.
+   *
+   * @throw a ParserException on error.
+   * @return false if there are no more events
+   */
+  bool Next();
+
+  /**
+   * If the current event starts a sequence or a map, moves straight on to
+   * the event that ends it, without producing events for anything in
+   * between. Block and flow collections are skipped a token at a time,
+   * so only the scanner's errors are reported in there (and anchors are
+   * still counted, so later aliases come out the same). Otherwise it does
+   * nothing.
+   *
+   * @throw a ParserException on error.
+   */
+  void Skip();
+
+  EventType::value Type() const;
+
+  /**
+   * Returns where the current event starts; for the end of a collection or
+   * document, that's where it ends.
+   */
+  const YAML::Mark& Mark() const;
+
+  /** Returns the tag of a scalar or collection. */
+  const std::string& Tag() const;
+
+  /**
+   * Returns the anchor of a node (or, for an alias, the anchor it refers
+   * to); anchors are numbered from 1 in each document.
+   */
+  anchor_t Anchor() const;
+
+  /** Returns the style of a collection. */
+  EmitterStyle::value Style() const;
+
+  /** Returns the value of a scalar. */
+  std::string Scalar() const;
+
+  /**
+   * Returns the value of a scalar without copying it; it's good until the
+   * next call to {@link Next} or {@link Skip}.
+   */
+  StringRef ScalarRef() const;
+
+  /**
+   * If the current event starts a sequence, reads each of its entries as a
+   * number (as convert<T> would), appending them to {@code values}, and
+   * moves on to the event that ends it. The scalars of a flow sequence are
+   * read straight from the scanner's tokens, without producing events for
+   * them (or, of course, nodes); anything else goes through events as
+   * usual. Otherwise it does nothing. T is any of the arithmetic types but
+   * bool.
+   *
+   * @throw a ParserException on error, or a TypedBadConversion<T> (once the
+   *        cursor is at the end of the sequence) if an entry isn't a number.
+   * @return false if the current event doesn't start a sequence
+   */
+  template <typename T>
+  bool ReadNumbers(std::vector<T>& values);
+
+  /**
+   * Returns the number of collections that are open, counting one that
+   * the current event starts, but not one that it ends.
+   */
+  std::size_t Depth() const;
+
+ private:
+  Parser m_parser;
+  std::unique_ptr<SingleDocParser> m_pDocument;
+  std::unique_ptr<ParserEvent> m_pEvent;
+  bool m_hasEvent;
+};
+}
+
+#endif  // EVENTCURSOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -11,6 +11,7 @@
 
 #include "yaml-cpp/anchor.h"
 #include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/stringref.h"
 
 namespace YAML {
 struct Mark;
@@ -27,6 +28,22 @@ class EventHandler {
   virtual void OnScalar(const Mark& mark, const std::string& tag,
                         anchor_t anchor, const std::string& value) = 0;
 
+  // Called instead of OnScalar when the value appears verbatim in
+  // memory-resident input; the reference is only good for as long as that
+  // input is alive. By default, this just copies it.
+  virtual void OnScalarRef(const Mark& mark, const std::string& tag,
+                           anchor_t anchor, const StringRef& value) {
+    OnScalarMove(mark, tag, anchor, value.str());
+  }
+
+  // Called instead of OnScalar when the value is a copy that nothing else
+  // will look at again, so the handler may move from it. By default, this just
+  // passes it on to OnScalar.
+  virtual void OnScalarMove(const Mark& mark, const std::string& tag,
+                            anchor_t anchor, std::string&& value) {
+    OnScalar(mark, tag, anchor, value);
+  }
+
   virtual void OnSequenceStart(const Mark& mark, const std::string& tag,
                                anchor_t anchor, EmitterStyle::value style) = 0;
   virtual void OnSequenceEnd() = 0;
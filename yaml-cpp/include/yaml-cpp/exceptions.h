@@ -73,6 +73,15 @@ const char* const CHAR_IN_BLOCK = "unexpected character in block scalar";
 const char* const AMBIGUOUS_ANCHOR =
     "cannot assign the same alias to multiple nodes";
 const char* const UNKNOWN_ANCHOR = "the referenced anchor is not defined";
+const char* const JSON_VALUE = "expected a JSON value";
+const char* const JSON_KEY = "expected a string as a JSON object key";
+const char* const JSON_COLON = "expected ':' after a JSON object key";
+const char* const JSON_NUMBER = "invalid JSON number";
+const char* const JSON_TRAILING = "unexpected content after the JSON value";
+const char* const TOO_MANY_NODES = "too many nodes in the document";
+const char* const TOO_DEEP = "collections nested too deeply";
+const char* const TOO_MANY_ALIASES = "too many aliases in the document";
+const char* const TOO_MUCH_SCALAR = "too much scalar text in the document";
 
 const char* const INVALID_NODE =
     "invalid node; this may result from using a map iterator as a sequence "
@@ -84,6 +93,7 @@ const char* const BAD_DEREFERENCE = "bad dereference";
 const char* const BAD_SUBSCRIPT = "operator[] call on a scalar";
 const char* const BAD_PUSHBACK = "appending to a non-sequence";
 const char* const BAD_INSERT = "inserting in a non-convertible-to-map";
+const char* const FROZEN_NODE = "modifying a frozen node";
 
 const char* const UNMATCHED_GROUP_TAG = "unmatched group tag";
 const char* const UNEXPECTED_END_SEQ = "unexpected end sequence token";
@@ -93,7 +103,10 @@ const char* const SINGLE_QUOTED_CHAR =
 const char* const INVALID_ANCHOR = "invalid anchor";
 const char* const INVALID_ALIAS = "invalid alias";
 const char* const INVALID_TAG = "invalid tag";
+const char* const OUTPUT_FAILED = "error writing output";
 const char* const BAD_FILE = "bad file";
+const char* const BAD_PATH = "invalid path";
+const char* const BAD_PACKED_DATA = "invalid packed data";
 
 template <typename T>
 inline const std::string KEY_NOT_FOUND_WITH_KEY(
@@ -246,6 +259,14 @@ class YAML_CPP_API BadInsert : public RepresentationException {
   virtual ~BadInsert() YAML_CPP_NOEXCEPT;
 };
 
+class YAML_CPP_API FrozenNode : public RepresentationException {
+ public:
+  FrozenNode()
+      : RepresentationException(Mark::null_mark(), ErrorMsg::FROZEN_NODE) {}
+  FrozenNode(const FrozenNode&) = default;
+  virtual ~FrozenNode() YAML_CPP_NOEXCEPT;
+};
+
 class YAML_CPP_API EmitterException : public Exception {
  public:
   EmitterException(const std::string& msg_)
@@ -260,6 +281,23 @@ class YAML_CPP_API BadFile : public Exception {
   BadFile(const BadFile&) = default;
   virtual ~BadFile() YAML_CPP_NOEXCEPT;
 };
+
+class YAML_CPP_API BadPath : public Exception {
+ public:
+  explicit BadPath(const std::string& path)
+      : Exception(Mark::null_mark(), std::string(ErrorMsg::BAD_PATH) + ": " +
+                                         path) {}
+  BadPath(const BadPath&) = default;
+  virtual ~BadPath() YAML_CPP_NOEXCEPT;
+};
+
+class YAML_CPP_API BadPackedData : public Exception {
+ public:
+  BadPackedData()
+      : Exception(Mark::null_mark(), ErrorMsg::BAD_PACKED_DATA) {}
+  BadPackedData(const BadPackedData&) = default;
+  virtual ~BadPackedData() YAML_CPP_NOEXCEPT;
+};
 }
 
 #undef YAML_CPP_NOEXCEPT
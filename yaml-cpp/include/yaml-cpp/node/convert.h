@@ -8,10 +8,12 @@
 #endif
 
 #include <array>
+#include <cstddef>
 #include <limits>
 #include <list>
 #include <map>
-#include <sstream>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #include "yaml-cpp/binary.h"
@@ -19,7 +21,9 @@
 #include "yaml-cpp/node/iterator.h"
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/node/type.h"
+#include "yaml-cpp/node/view.h"
 #include "yaml-cpp/null.h"
+#include "yaml-cpp/stringref.h"
 
 namespace YAML {
 class Binary;
@@ -42,6 +46,147 @@ inline bool IsNegativeInfinity(const std::string& input) {
 inline bool IsNaN(const std::string& input) {
   return input == ".nan" || input == ".NaN" || input == ".NAN";
 }
+
+// Numbers are read and written exactly as a std::stringstream in the classic
+// locale would (reading with the base unset, so that 0x1f and 017 are hex and
+// octal), but without making one. Reading doesn't skip leading whitespace,
+// allows trailing whitespace, and fails if the value doesn't fit.
+
+// ParseInteger
+// . Reads an optional sign and the digits that follow it, in whichever base
+//   they're in; fails if there aren't any, or if they don't fit.
+YAML_CPP_API bool ParseInteger(const StringRef& input, bool& negative,
+                               unsigned long long& magnitude);
+YAML_CPP_API std::string FormatInteger(long long value);
+YAML_CPP_API std::string FormatInteger(unsigned long long value);
+
+// DecodeInteger
+// . As with a stream, an unsigned type takes a negative number modulo its
+//   range (so "-1" is its maximum).
+template <typename T>
+inline bool DecodeInteger(const StringRef& input, T& rhs) {
+  bool negative = false;
+  unsigned long long magnitude = 0;
+  if (!ParseInteger(input, negative, magnitude))
+    return false;
+
+  const unsigned long long max =
+      static_cast<unsigned long long>(std::numeric_limits<T>::max());
+  if (!std::numeric_limits<T>::is_signed) {
+    if (magnitude > max)
+      return false;
+    rhs = static_cast<T>(negative ? 0 - magnitude : magnitude);
+  } else if (negative) {
+    if (magnitude > max + 1)
+      return false;
+    rhs = static_cast<T>(-static_cast<long long>(magnitude - 1) - 1);
+  } else {
+    if (magnitude > max)
+      return false;
+    rhs = static_cast<T>(magnitude);
+  }
+  return true;
+}
+
+template <typename T>
+inline std::string EncodeInteger(T rhs) {
+  return std::numeric_limits<T>::is_signed
+             ? FormatInteger(static_cast<long long>(rhs))
+             : FormatInteger(static_cast<unsigned long long>(rhs));
+}
+
+// a character type is read as a single character (which a stream does too)
+template <typename T>
+inline bool DecodeChar(const StringRef& input, T& rhs) {
+  if (input.empty())
+    return false;
+  for (std::size_t i = 1; i < input.size(); i++) {
+    const char ch = input[i];
+    if (ch != ' ' && (ch < '\t' || ch > '\r'))
+      return false;
+  }
+  rhs = static_cast<T>(input[0]);
+  return true;
+}
+
+// DecodeFloat
+// . Also takes the .inf and .nan spellings. A number too big for the type
+//   fails, but one too small for it is rounded (to zero, if need be).
+YAML_CPP_API bool DecodeFloat(const StringRef& input, float& rhs);
+YAML_CPP_API bool DecodeFloat(const StringRef& input, double& rhs);
+YAML_CPP_API bool DecodeFloat(const StringRef& input, long double& rhs);
+
+// EncodeFloat
+// . Writes digits10 + 1 significant digits, as %g does.
+YAML_CPP_API std::string EncodeFloat(float rhs);
+YAML_CPP_API std::string EncodeFloat(double rhs);
+YAML_CPP_API std::string EncodeFloat(long double rhs);
+
+// DecodeBool
+// . Takes y/n, yes/no, true/false and on/off, in lowercase, UPPERCASE or
+//   Capitalized.
+YAML_CPP_API bool DecodeBool(const StringRef& input, bool& rhs);
+
+// the types that the above read, which sequences of can be read in bulk
+template <typename T>
+struct is_numeric {
+  static const bool value =
+      std::is_arithmetic<T>::value && !std::is_same<T, bool>::value;
+};
+
+template <typename T>
+inline bool DecodeNumber(const StringRef& input, T& rhs) {
+  return DecodeInteger(input, rhs);
+}
+inline bool DecodeNumber(const StringRef& input, char& rhs) {
+  return DecodeChar(input, rhs);
+}
+inline bool DecodeNumber(const StringRef& input, signed char& rhs) {
+  return DecodeChar(input, rhs);
+}
+inline bool DecodeNumber(const StringRef& input, unsigned char& rhs) {
+  return DecodeChar(input, rhs);
+}
+inline bool DecodeNumber(const StringRef& input, float& rhs) {
+  return DecodeFloat(input, rhs);
+}
+inline bool DecodeNumber(const StringRef& input, double& rhs) {
+  return DecodeFloat(input, rhs);
+}
+inline bool DecodeNumber(const StringRef& input, long double& rhs) {
+  return DecodeFloat(input, rhs);
+}
+
+// DecodeSequence
+// . Appends each entry of a sequence to 'rhs' (which has room for them), as
+//   as<T>() would: throws TypedBadConversion<T> at the first that isn't one.
+// . Numbers are read straight from each scalar, through a view (so without
+//   copying a Node for each).
+template <typename T>
+inline void DecodeSequence(const Node& node, std::vector<T>& rhs,
+                           std::true_type /* numeric */) {
+  const NodeView view(node);
+  for (NodeView::const_iterator it = view.begin(); it != view.end(); ++it) {
+    const NodeView entry = *it;
+    T value;
+    if (entry.Type() != NodeType::Scalar ||
+        !DecodeNumber(StringRef(entry.Scalar()), value))
+      throw TypedBadConversion<T>(entry.Mark());
+    rhs.push_back(value);
+  }
+}
+
+template <typename T>
+inline void DecodeSequence(const Node& node, std::vector<T>& rhs,
+                           std::false_type /* numeric */) {
+  for (const_iterator it = node.begin(); it != node.end(); ++it)
+#if defined(__GNUC__) && __GNUC__ < 4
+    // workaround for GCC 3:
+    rhs.push_back(it->template as<T>());
+#else
+    rhs.push_back(it->as<T>());
+#endif
+}
 }
 
 // Node
@@ -88,70 +233,68 @@ struct convert<_Null> {
   }
 };
 
-#define YAML_DEFINE_CONVERT_STREAMABLE(type, negative_op)                \
-  template <>                                                            \
-  struct convert<type> {                                                 \
-    static Node encode(const type& rhs) {                                \
-      std::stringstream stream;                                          \
-      stream.precision(std::numeric_limits<type>::digits10 + 1);         \
-      stream << rhs;                                                     \
-      return Node(stream.str());                                         \
-    }                                                                    \
-                                                                         \
-    static bool decode(const Node& node, type& rhs) {                    \
-      if (node.Type() != NodeType::Scalar)                               \
-        return false;                                                    \
-      const std::string& input = node.Scalar();                          \
-      std::stringstream stream(input);                                   \
-      stream.unsetf(std::ios::dec);                                      \
-      if ((stream >> std::noskipws >> rhs) && (stream >> std::ws).eof()) \
-        return true;                                                     \
-      if (std::numeric_limits<type>::has_infinity) {                     \
-        if (conversion::IsInfinity(input)) {                             \
-          rhs = std::numeric_limits<type>::infinity();                   \
-          return true;                                                   \
-        } else if (conversion::IsNegativeInfinity(input)) {              \
-          rhs = negative_op std::numeric_limits<type>::infinity();       \
-          return true;                                                   \
-        }                                                                \
-      }                                                                  \
-                                                                         \
-      if (std::numeric_limits<type>::has_quiet_NaN &&                    \
-          conversion::IsNaN(input)) {                                    \
-        rhs = std::numeric_limits<type>::quiet_NaN();                    \
-        return true;                                                     \
-      }                                                                  \
-                                                                         \
-      return false;                                                      \
-    }                                                                    \
+#define YAML_DEFINE_CONVERT_INTEGER(type)                   \
+  template <>                                               \
+  struct convert<type> {                                    \
+    static Node encode(const type& rhs) {                   \
+      return Node(conversion::EncodeInteger(rhs));          \
+    }                                                       \
+                                                            \
+    static bool decode(const Node& node, type& rhs) {       \
+      if (node.Type() != NodeType::Scalar)                  \
+        return false;                                       \
+      return conversion::DecodeInteger(node.Scalar(), rhs); \
+    }                                                       \
   }
 
-#define YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(type) \
-  YAML_DEFINE_CONVERT_STREAMABLE(type, -)
+#define YAML_DEFINE_CONVERT_CHAR(type)                     \
+  template <>                                              \
+  struct convert<type> {                                   \
+    static Node encode(const type& rhs) {                  \
+      return Node(std::string(1, static_cast<char>(rhs))); \
+    }                                                      \
+                                                           \
+    static bool decode(const Node& node, type& rhs) {      \
+      if (node.Type() != NodeType::Scalar)                 \
+        return false;                                      \
+      return conversion::DecodeChar(node.Scalar(), rhs);   \
+    }                                                      \
+  }
 
-#define YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(type) \
-  YAML_DEFINE_CONVERT_STREAMABLE(type, +)
+#define YAML_DEFINE_CONVERT_FLOAT(type)                   \
+  template <>                                             \
+  struct convert<type> {                                  \
+    static Node encode(const type& rhs) {                 \
+      return Node(conversion::EncodeFloat(rhs));          \
+    }                                                     \
+                                                          \
+    static bool decode(const Node& node, type& rhs) {     \
+      if (node.Type() != NodeType::Scalar)                \
+        return false;                                     \
+      return conversion::DecodeFloat(node.Scalar(), rhs); \
+    }                                                     \
+  }
 
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(int);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(short);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(long);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(long long);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned short);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned long);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned long long);
+YAML_DEFINE_CONVERT_INTEGER(int);
+YAML_DEFINE_CONVERT_INTEGER(short);
+YAML_DEFINE_CONVERT_INTEGER(long);
+YAML_DEFINE_CONVERT_INTEGER(long long);
+YAML_DEFINE_CONVERT_INTEGER(unsigned);
+YAML_DEFINE_CONVERT_INTEGER(unsigned short);
+YAML_DEFINE_CONVERT_INTEGER(unsigned long);
+YAML_DEFINE_CONVERT_INTEGER(unsigned long long);
 
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(char);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(signed char);
-YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED(unsigned char);
+YAML_DEFINE_CONVERT_CHAR(char);
+YAML_DEFINE_CONVERT_CHAR(signed char);
+YAML_DEFINE_CONVERT_CHAR(unsigned char);
 
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(float);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(double);
-YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(long double);
+YAML_DEFINE_CONVERT_FLOAT(float);
+YAML_DEFINE_CONVERT_FLOAT(double);
+YAML_DEFINE_CONVERT_FLOAT(long double);
 
-#undef YAML_DEFINE_CONVERT_STREAMABLE_SIGNED
-#undef YAML_DEFINE_CONVERT_STREAMABLE_UNSIGNED
-#undef YAML_DEFINE_CONVERT_STREAMABLE
+#undef YAML_DEFINE_CONVERT_INTEGER
+#undef YAML_DEFINE_CONVERT_CHAR
+#undef YAML_DEFINE_CONVERT_FLOAT
 
 // bool
 template <>
@@ -204,13 +347,10 @@ struct convert<std::vector<T>> {
       return false;
 
     rhs.clear();
-    for (const_iterator it = node.begin(); it != node.end(); ++it)
-#if defined(__GNUC__) && __GNUC__ < 4
-      // workaround for GCC 3:
-      rhs.push_back(it->template as<T>());
-#else
-      rhs.push_back(it->as<T>());
-#endif
+    rhs.reserve(node.size());
+    conversion::DecodeSequence(
+        node, rhs,
+        std::integral_constant<bool, conversion::is_numeric<T>::value>());
     return true;
   }
 };
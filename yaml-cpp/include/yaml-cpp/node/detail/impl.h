@@ -7,8 +7,10 @@
 #pragma once
 #endif
 
+#include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node.h"
 #include "yaml-cpp/node/detail/node_data.h"
+#include <cstring>
 #include <type_traits>
 
 namespace YAML {
@@ -16,7 +18,11 @@ namespace detail {
 template <typename Key, typename Enable = void>
 struct get_idx {
   static node* get(const std::vector<node*>& /* sequence */,
-                   const Key& /* key */, shared_memory_holder /* pMemory */) {
+                   const Key& /* key */) {
+    return 0;
+  }
+  static node* get(std::vector<node*>& /* sequence */, const Key& /* key */,
+                   shared_memory_holder /* pMemory */) {
     return 0;
   }
 };
@@ -25,8 +31,7 @@ template <typename Key>
 struct get_idx<Key,
                typename std::enable_if<std::is_unsigned<Key>::value &&
                                        !std::is_same<Key, bool>::value>::type> {
-  static node* get(const std::vector<node*>& sequence, const Key& key,
-                   shared_memory_holder /* pMemory */) {
+  static node* get(const std::vector<node*>& sequence, const Key& key) {
     return key < sequence.size() ? sequence[key] : 0;
   }
 
@@ -34,18 +39,20 @@ struct get_idx<Key,
                    shared_memory_holder pMemory) {
     if (key > sequence.size() || (key > 0 && !sequence[key - 1]->is_defined()))
       return 0;
-    if (key == sequence.size())
-      sequence.push_back(&pMemory->create_node());
+    if (key == sequence.size()) {
+      node& value = pMemory->create_node();
+      value.add_parent();
+      sequence.push_back(&value);
+    }
     return sequence[key];
   }
 };
 
 template <typename Key>
 struct get_idx<Key, typename std::enable_if<std::is_signed<Key>::value>::type> {
-  static node* get(const std::vector<node*>& sequence, const Key& key,
-                   shared_memory_holder pMemory) {
+  static node* get(const std::vector<node*>& sequence, const Key& key) {
     return key >= 0 ? get_idx<std::size_t>::get(
-                          sequence, static_cast<std::size_t>(key), pMemory)
+                          sequence, static_cast<std::size_t>(key))
                     : 0;
   }
   static node* get(std::vector<node*>& sequence, const Key& key,
@@ -88,22 +95,45 @@ struct remove_idx<Key,
 };
 
 template <typename T>
-inline bool node::equals(const T& rhs, shared_memory_holder pMemory) {
+inline bool node::equals(const T& rhs, memory_holder& memory) {
   T lhs;
-  if (convert<T>::decode(Node(*this, pMemory), lhs)) {
+  if (convert<T>::decode(Node(*this, memory.shared_from_this()), lhs)) {
     return lhs == rhs;
   }
   return false;
 }
 
-inline bool node::equals(const char* rhs, shared_memory_holder pMemory) {
-  return equals<std::string>(rhs, pMemory);
+// strings compare against the scalar directly, so we don't copy it (or
+// materialize it, if it refers to the input)
+inline bool node::equals(const std::string& rhs, memory_holder&) {
+  return type() == NodeType::Scalar && scalar_ref() == StringRef(rhs);
+}
+
+inline bool node::equals(const char* rhs, memory_holder&) {
+  return type() == NodeType::Scalar &&
+         scalar_ref() == StringRef(rhs, std::strlen(rhs));
+}
+
+// the text of a key that's compared as a string (and so can be looked up in a
+// map's index), if it's one of those
+template <typename Key>
+inline bool key_text(const Key&, StringRef&) {
+  return false;
+}
+
+inline bool key_text(const std::string& key, StringRef& text) {
+  text = StringRef(key);
+  return true;
+}
+
+inline bool key_text(const char* key, StringRef& text) {
+  text = StringRef(key, std::strlen(key));
+  return true;
 }
 
 // indexing
 template <typename Key>
-inline node* node_data::get(const Key& key,
-                            shared_memory_holder pMemory) const {
+inline node* node_data::get(const Key& key, memory_holder& memory) const {
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -111,20 +141,23 @@ inline node* node_data::get(const Key& key,
     case NodeType::Null:
       return NULL;
     case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory))
+      if (node* pNode = get_idx<Key>::get(sequence(), key))
         return pNode;
       return NULL;
     case NodeType::Scalar:
       throw BadSubscript();
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->equals(key, pMemory)) {
-      return it->second;
+  node_map::const_iterator it;
+  StringRef text;
+  if (!key_text(key, text) || !find_indexed(text, it)) {
+    for (it = map().begin(); it != map().end(); ++it) {
+      if (it->first->equals(key, memory))
+        break;
     }
   }
 
-  return NULL;
+  return it != map().end() ? it->second : NULL;
 }
 
 template <typename Key>
@@ -135,7 +168,7 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
     case NodeType::Undefined:
     case NodeType::Null:
     case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory)) {
+      if (node* pNode = get_idx<Key>::get(sequence(), key, pMemory)) {
         m_type = NodeType::Sequence;
         return *pNode;
       }
@@ -146,11 +179,16 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
       throw BadSubscript();
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->equals(key, pMemory)) {
-      return *it->second;
+  node_map::const_iterator it;
+  StringRef text;
+  if (!key_text(key, text) || !find_indexed(text, it)) {
+    for (it = map().begin(); it != map().end(); ++it) {
+      if (it->first->equals(key, *pMemory))
+        break;
     }
   }
+  if (it != map().end())
+    return *it->second;
 
   node& k = convert_to_node(key, pMemory);
   node& v = pMemory->create_node();
@@ -161,20 +199,20 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
 template <typename Key>
 inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
   if (m_type == NodeType::Sequence) {
-    return remove_idx<Key>::remove(m_sequence, key);
+    return remove_idx<Key>::remove(sequence(), key);
   } else if (m_type == NodeType::Map) {
-    kv_pairs::iterator it = m_undefinedPairs.begin();
-    while (it != m_undefinedPairs.end()) {
+    kv_pairs::iterator it = undefined_pairs().begin();
+    while (it != undefined_pairs().end()) {
       kv_pairs::iterator jt = std::next(it);
-      if (it->first->equals(key, pMemory)) {
-        m_undefinedPairs.erase(it);
+      if (it->first->equals(key, *pMemory)) {
+        undefined_pairs().erase(it);
       }
       it = jt;
     }
 
-    for (node_map::iterator iter = m_map.begin(); iter != m_map.end(); ++iter) {
-      if (iter->first->equals(key, pMemory)) {
-        m_map.erase(iter);
+    for (node_map::iterator iter = map().begin(); iter != map().end(); ++iter) {
+      if (iter->first->equals(key, *pMemory)) {
+        erase_map_pair(iter);
         return true;
       }
     }
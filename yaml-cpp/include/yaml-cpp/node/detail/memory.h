@@ -7,10 +7,13 @@
 #pragma once
 #endif
 
+#include <memory>
 #include <set>
+#include <string>
 
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/ptr.h"
+#include "yaml-cpp/stringref.h"
 
 namespace YAML {
 namespace detail {
@@ -20,22 +23,70 @@ class node;
 
 namespace YAML {
 namespace detail {
+struct memory_group;
+
 class YAML_CPP_API memory {
  public:
+  memory() : m_pArena(nullptr), m_pStrings(nullptr), m_frozen(false) {}
+  ~memory();
+
   node& create_node();
   void merge(const memory& rhs);
 
+  // keeps memory-resident input alive, for scalars that refer to it
+  void retain(const shared_input& input);
+
+  // from now on, creates nodes in bulk, in an arena of this memory's own
+  void use_arena();
+
+  // returns a copy of 'str' that lives as long as this memory does, and is
+  // shared with every equal string interned here
+  const std::string& intern(const StringRef& str);
+
+  // readies every node here to be read from any number of threads at once;
+  // from then on, nodes can't be created here, or merged in or out
+  void freeze();
+  bool frozen() const { return m_frozen; }
+
  private:
-  typedef std::set<shared_node> Nodes;
+  memory_group& group();
+
+ private:
+  // Owns everything allocated here, together with everything allocated by
+  // any memory this one has been merged with, since nodes can refer across
+  // them (see memory_group). It's made the first time something is.
+  // (declared first, so that it's released last)
+  std::shared_ptr<memory_group> m_pGroup;
+
+  // what this memory has merged in, which is what freeze covers
+  typedef std::set<arena*> Arenas;
+  Arenas m_arenas;
+  arena* m_pArena;
+
+  string_pool* m_pStrings;
+
+  typedef std::set<node*> Nodes;
   Nodes m_nodes;
+
+  bool m_frozen;
 };
 
-class YAML_CPP_API memory_holder {
+// (always owned by a shared_memory_holder, so that it can be shared again
+// from a plain reference)
+class YAML_CPP_API memory_holder
+    : public std::enable_shared_from_this<memory_holder> {
  public:
   memory_holder() : m_pMemory(new memory) {}
 
   node& create_node() { return m_pMemory->create_node(); }
   void merge(memory_holder& rhs);
+  void retain(const shared_input& input) { m_pMemory->retain(input); }
+  void use_arena() { m_pMemory->use_arena(); }
+  const std::string& intern(const StringRef& str) {
+    return m_pMemory->intern(str);
+  }
+  void freeze() { m_pMemory->freeze(); }
+  bool frozen() const { return m_pMemory->frozen(); }
 
  private:
   shared_memory m_pMemory;
@@ -19,6 +19,7 @@ namespace detail {
 class node {
  public:
   node() : m_pRef(new node_ref) {}
+  explicit node(const shared_node_ref& pRef) : m_pRef(pRef) {}
   node(const node&) = delete;
   node& operator=(const node&) = delete;
 
@@ -30,12 +31,14 @@ class node {
   NodeType::value type() const { return m_pRef->type(); }
 
   const std::string& scalar() const { return m_pRef->scalar(); }
+  StringRef scalar_ref() const { return m_pRef->scalar_ref(); }
   const std::string& tag() const { return m_pRef->tag(); }
   EmitterStyle::value style() const { return m_pRef->style(); }
 
   template <typename T>
-  bool equals(const T& rhs, shared_memory_holder pMemory);
-  bool equals(const char* rhs, shared_memory_holder pMemory);
+  bool equals(const T& rhs, memory_holder& memory);
+  bool equals(const std::string& rhs, memory_holder& memory);
+  bool equals(const char* rhs, memory_holder& memory);
 
   void mark_defined() {
     if (is_defined())
@@ -58,6 +61,11 @@ class node {
   void set_ref(const node& rhs) {
     if (rhs.is_defined())
       mark_defined();
+    if (m_pRef->is_key()) {
+      rhs.m_pRef->mark_key();
+      node_data::key_changed();
+    }
+    rhs.m_pRef->add_parent();
     m_pRef = rhs.m_pRef;
   }
   void set_data(const node& rhs) {
@@ -81,9 +89,17 @@ class node {
     mark_defined();
     m_pRef->set_scalar(scalar);
   }
-  void set_tag(const std::string& tag) {
+  void set_scalar(std::string&& scalar) {
     mark_defined();
-    m_pRef->set_tag(tag);
+    m_pRef->set_scalar(std::move(scalar));
+  }
+  void set_scalar_ref(const StringRef& scalar) {
+    mark_defined();
+    m_pRef->set_scalar_ref(scalar);
+  }
+  void set_tag(const std::string* pInterned) {
+    mark_defined();
+    m_pRef->set_tag(pInterned);
   }
 
   // style
@@ -92,6 +108,16 @@ class node {
     m_pRef->set_style(style);
   }
 
+  void freeze() { m_pRef->freeze(); }
+  bool cached_hash(std::size_t& hash) const {
+    return m_pRef->cached_hash(hash);
+  }
+  void cache_hash(std::size_t hash) const { m_pRef->cache_hash(hash); }
+  void mark_key() { m_pRef->mark_key(); }
+  void mark_shared() { m_pRef->mark_shared(); }
+  void add_parent() { m_pRef->add_parent(); }
+  bool is_shared() const { return m_pRef->is_shared(); }
+
   // size/iterator
   std::size_t size() const { return m_pRef->size(); }
 
@@ -118,11 +144,11 @@ class node {
 
   // indexing
   template <typename Key>
-  node* get(const Key& key, shared_memory_holder pMemory) const {
+  node* get(const Key& key, memory_holder& memory) const {
     // NOTE: this returns a non-const node so that the top-level Node can wrap
     // it, and returns a pointer so that it can be NULL (if there is no such
     // key).
-    return static_cast<const node_ref&>(*m_pRef).get(key, pMemory);
+    return static_cast<const node_ref&>(*m_pRef).get(key, memory);
   }
   template <typename Key>
   node& get(const Key& key, shared_memory_holder pMemory) {
@@ -135,11 +161,15 @@ class node {
     return m_pRef->remove(key, pMemory);
   }
 
-  node* get(node& key, shared_memory_holder pMemory) const {
+  node* get(node& key, memory_holder& memory) const {
     // NOTE: this returns a non-const node so that the top-level Node can wrap
     // it, and returns a pointer so that it can be NULL (if there is no such
     // key).
-    return static_cast<const node_ref&>(*m_pRef).get(key, pMemory);
+    return static_cast<const node_ref&>(*m_pRef).get(key, memory);
+  }
+  node* find_key(const StringRef& key, std::size_t hash,
+                 node** pKey = NULL) const {
+    return static_cast<const node_ref&>(*m_pRef).find_key(key, hash, pKey);
   }
   node& get(node& key, shared_memory_holder pMemory) {
     node& value = m_pRef->get(key, pMemory);
@@ -7,9 +7,12 @@
 #pragma once
 #endif
 
+#include <atomic>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -18,6 +21,7 @@
 #include "yaml-cpp/node/iterator.h"
 #include "yaml-cpp/node/ptr.h"
 #include "yaml-cpp/node/type.h"
+#include "yaml-cpp/stringref.h"
 
 namespace YAML {
 namespace detail {
@@ -36,18 +40,60 @@ class YAML_CPP_API node_data {
   void mark_defined();
   void set_mark(const Mark& mark);
   void set_type(NodeType::value type);
-  void set_tag(const std::string& tag);
+  // the tag isn't copied, but kept by address, so it has to be one that
+  // memory::intern returned, from a memory the node's is merged with (which
+  // keeps it alive as long as the node)
+  void set_tag(const std::string* pInterned);
   void set_null();
   void set_scalar(const std::string& scalar);
+  void set_scalar(std::string&& scalar);
+  void set_scalar_ref(const StringRef& scalar);
   void set_style(EmitterStyle::value style);
 
+  // does everything that reading would otherwise do lazily, so that from now
+  // on, reading writes nothing
+  void freeze();
+
+  // a collection's structural hash (see DeepHash), which is only kept once
+  // it's frozen (since until then, its entries can change under it)
+  bool cached_hash(std::size_t& hash) const;
+  void cache_hash(std::size_t hash) const;
+
+  // whether this is (or has been) one of a map's keys; once it is, changing
+  // its type or text has every map rebuild its index of its keys before it
+  // next looks one up
+  void mark_key() { m_isKey = true; }
+  bool is_key() const { return m_isKey; }
+  static void key_changed();
+
+  // whether this is reachable from more than one place (an alias refers to
+  // it, or it's been put in collections or assigned to entries more than
+  // once), so that traversals that would otherwise visit it once for each
+  // can remember it instead; add_parent is called each time it's put in a
+  // collection or assigned to an entry, and marks it shared the second time
+  void mark_shared() { m_isShared = true; }
+  bool is_shared() const { return m_isShared; }
+  void add_parent() {
+    if (m_hasParent)
+      m_isShared = true;
+    m_hasParent = true;
+  }
+  bool has_parent() const { return m_hasParent; }
+
   bool is_defined() const { return m_isDefined; }
   const Mark& mark() const { return m_mark; }
   NodeType::value type() const {
     return m_isDefined ? m_type : NodeType::Undefined;
   }
-  const std::string& scalar() const { return m_scalar; }
-  const std::string& tag() const { return m_tag; }
+  const std::string& scalar() const {
+    if (m_scalarRef.valid())
+      materialize_scalar();
+    return m_scalar;
+  }
+  StringRef scalar_ref() const {
+    return m_scalarRef.valid() ? m_scalarRef : StringRef(m_scalar);
+  }
+  const std::string& tag() const { return *m_pTag; }
   EmitterStyle::value style() const { return m_style; }
 
   // size/iterator
@@ -65,16 +111,22 @@ class YAML_CPP_API node_data {
 
   // indexing
   template <typename Key>
-  node* get(const Key& key, shared_memory_holder pMemory) const;
+  node* get(const Key& key, memory_holder& memory) const;
   template <typename Key>
   node& get(const Key& key, shared_memory_holder pMemory);
   template <typename Key>
   bool remove(const Key& key, shared_memory_holder pMemory);
 
-  node* get(node& key, shared_memory_holder pMemory) const;
+  node* get(node& key, memory_holder& memory) const;
   node& get(node& key, shared_memory_holder pMemory);
   bool remove(node& key, shared_memory_holder pMemory);
 
+  // looks a scalar key up by its text, whose hash_string the caller already
+  // has; NULL if this isn't a map, or has no such key (and if it has, the
+  // key itself is put in pKey, if that's given)
+  node* find_key(const StringRef& key, std::size_t hash,
+                 node** pKey = NULL) const;
+
   // map
   template <typename Key, typename Value>
   void force_insert(const Key& key, const Value& value,
@@ -84,6 +136,15 @@ class YAML_CPP_API node_data {
   static const std::string& empty_scalar();
 
  private:
+  typedef std::vector<node*> node_seq;
+  typedef std::vector<std::pair<node*, node*>> node_map;
+  typedef std::pair<node*, node*> kv_pair;
+  typedef std::list<kv_pair> kv_pairs;
+  enum { IndexThreshold = 32 };
+  typedef std::unordered_multimap<std::size_t, std::size_t> key_index;
+
+  void materialize_scalar() const;
+
   void compute_seq_size() const;
   void compute_map_size() const;
 
@@ -91,6 +152,12 @@ class YAML_CPP_API node_data {
   void reset_map();
 
   void insert_map_pair(node& key, node& value);
+  void append_map_pair(node& key, node& value);  // without adding parents
+  void erase_map_pair(node_map::iterator it);
+  bool find_indexed(const StringRef& key, node_map::const_iterator& it) const;
+  bool find_indexed(const StringRef& key, std::size_t hash,
+                    node_map::const_iterator& it) const;
+  void build_index() const;
   void convert_to_map(shared_memory_holder pMemory);
   void convert_sequence_to_map(shared_memory_holder pMemory);
 
@@ -98,28 +165,57 @@ class YAML_CPP_API node_data {
   static node& convert_to_node(const T& rhs, shared_memory_holder pMemory);
 
  private:
-  bool m_isDefined;
+  // Most nodes are scalars, so only what every node needs is kept inline; the
+  // rest of what a collection needs goes in here, and is allocated the first
+  // time the node is used as one.
+  struct collection_data {
+    collection_data();
+
+    node_seq sequence;
+    std::size_t seqSize;
+
+    node_map map;
+    kv_pairs undefinedPairs;
+
+    // Maps the hash of the text of each scalar key to its position in map;
+    // it's only built once a map is looked up by a string, and is big enough
+    // for that to be worth it. Keys that weren't scalars when they were
+    // indexed are counted, since then a miss in the index isn't the final
+    // word; and it's built again if any key has changed since (see
+    // key_changed).
+    std::unique_ptr<key_index> pIndex;
+    std::size_t unindexedKeys;
+    std::size_t indexGeneration;
+
+    // frozen documents can be read from many threads at once
+    bool frozen;
+    std::atomic<bool> hashed;
+    std::atomic<std::size_t> hash;
+  };
+
+  collection_data& collection() const;
+  const node_seq& sequence() const { return collection().sequence; }
+  node_seq& sequence() { return collection().sequence; }
+  const node_map& map() const { return collection().map; }
+  node_map& map() { return collection().map; }
+  kv_pairs& undefined_pairs() { return collection().undefinedPairs; }
+
+ private:
   Mark m_mark;
   NodeType::value m_type;
-  std::string m_tag;
   EmitterStyle::value m_style;
+  bool m_isDefined;
+  bool m_isKey;
+  bool m_hasParent;
+  bool m_isShared;
+  const std::string* m_pTag;
 
-  // scalar
-  std::string m_scalar;
-
-  // sequence
-  typedef std::vector<node*> node_seq;
-  node_seq m_sequence;
-
-  mutable std::size_t m_seqSize;
-
-  // map
-  typedef std::vector<std::pair<node*, node*>> node_map;
-  node_map m_map;
+  // scalar (either owned, or referring to retained input until it's needed
+  // as a string)
+  mutable std::string m_scalar;
+  mutable StringRef m_scalarRef;
 
-  typedef std::pair<node*, node*> kv_pair;
-  typedef std::list<kv_pair> kv_pairs;
-  mutable kv_pairs m_undefinedPairs;
+  mutable std::unique_ptr<collection_data> m_pCollection;
 };
 }
 }
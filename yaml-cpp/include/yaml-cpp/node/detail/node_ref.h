@@ -17,6 +17,7 @@ namespace detail {
 class node_ref {
  public:
   node_ref() : m_pData(new node_data) {}
+  explicit node_ref(const shared_node_data& pData) : m_pData(pData) {}
   node_ref(const node_ref&) = delete;
   node_ref& operator=(const node_ref&) = delete;
 
@@ -24,18 +25,41 @@ class node_ref {
   const Mark& mark() const { return m_pData->mark(); }
   NodeType::value type() const { return m_pData->type(); }
   const std::string& scalar() const { return m_pData->scalar(); }
+  StringRef scalar_ref() const { return m_pData->scalar_ref(); }
   const std::string& tag() const { return m_pData->tag(); }
   EmitterStyle::value style() const { return m_pData->style(); }
 
   void mark_defined() { m_pData->mark_defined(); }
-  void set_data(const node_ref& rhs) { m_pData = rhs.m_pData; }
+  void set_data(const node_ref& rhs) {
+    if (m_pData->is_key()) {
+      rhs.m_pData->mark_key();
+      node_data::key_changed();
+    }
+    m_pData = rhs.m_pData;
+  }
 
   void set_mark(const Mark& mark) { m_pData->set_mark(mark); }
   void set_type(NodeType::value type) { m_pData->set_type(type); }
-  void set_tag(const std::string& tag) { m_pData->set_tag(tag); }
+  void set_tag(const std::string* pInterned) { m_pData->set_tag(pInterned); }
   void set_null() { m_pData->set_null(); }
   void set_scalar(const std::string& scalar) { m_pData->set_scalar(scalar); }
+  void set_scalar(std::string&& scalar) {
+    m_pData->set_scalar(std::move(scalar));
+  }
+  void set_scalar_ref(const StringRef& scalar) {
+    m_pData->set_scalar_ref(scalar);
+  }
   void set_style(EmitterStyle::value style) { m_pData->set_style(style); }
+  void freeze() { m_pData->freeze(); }
+  bool cached_hash(std::size_t& hash) const {
+    return m_pData->cached_hash(hash);
+  }
+  void cache_hash(std::size_t hash) const { m_pData->cache_hash(hash); }
+  void mark_key() { m_pData->mark_key(); }
+  bool is_key() const { return m_pData->is_key(); }
+  void mark_shared() { m_pData->mark_shared(); }
+  void add_parent() { m_pData->add_parent(); }
+  bool is_shared() const { return m_pData->is_shared(); }
 
   // size/iterator
   std::size_t size() const { return m_pData->size(); }
@@ -60,8 +84,8 @@ class node_ref {
 
   // indexing
   template <typename Key>
-  node* get(const Key& key, shared_memory_holder pMemory) const {
-    return static_cast<const node_data&>(*m_pData).get(key, pMemory);
+  node* get(const Key& key, memory_holder& memory) const {
+    return static_cast<const node_data&>(*m_pData).get(key, memory);
   }
   template <typename Key>
   node& get(const Key& key, shared_memory_holder pMemory) {
@@ -72,8 +96,12 @@ class node_ref {
     return m_pData->remove(key, pMemory);
   }
 
-  node* get(node& key, shared_memory_holder pMemory) const {
-    return static_cast<const node_data&>(*m_pData).get(key, pMemory);
+  node* get(node& key, memory_holder& memory) const {
+    return static_cast<const node_data&>(*m_pData).get(key, memory);
+  }
+  node* find_key(const StringRef& key, std::size_t hash,
+                 node** pKey = NULL) const {
+    return static_cast<const node_data&>(*m_pData).find_key(key, hash, pKey);
   }
   node& get(node& key, shared_memory_holder pMemory) {
     return m_pData->get(key, pMemory);
@@ -27,6 +27,16 @@ YAML_CPP_API std::ostream& operator<<(std::ostream& out, const Node& node);
 
 /** Converts the node to a YAML string. */
 YAML_CPP_API std::string Dump(const Node& node);
+
+/**
+ * Converts the node to a YAML string, like {@link Dump}, but if most of it is
+ * one large block map or sequence (say, the root, or a list under one key of
+ * it), emits runs of its entries on up to {@code threads} threads at once (0
+ * means one per core), and joins them together. If the node has aliases, or
+ * nothing large enough to split, it's emitted sequentially; either way, the
+ * result is the same.
+ */
+YAML_CPP_API std::string DumpParallel(const Node& node, unsigned threads = 0);
 }  // namespace YAML
 
 #endif  // NODE_EMIT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -13,6 +13,7 @@
 #include "yaml-cpp/node/detail/node.h"
 #include "yaml-cpp/exceptions.h"
 #include <string>
+#include <utility>
 
 namespace YAML {
 inline Node::Node() : m_isValid(true), m_pNode(NULL) {}
@@ -32,6 +33,13 @@ inline Node::Node(const T& rhs)
   Assign(rhs);
 }
 
+inline Node::Node(std::string&& rhs)
+    : m_isValid(true),
+      m_pMemory(new detail::memory_holder),
+      m_pNode(&m_pMemory->create_node()) {
+  Assign(std::move(rhs));
+}
+
 inline Node::Node(const detail::iterator_value& rhs)
     : m_isValid(rhs.m_isValid),
       m_pMemory(rhs.m_pMemory),
@@ -153,6 +161,18 @@ inline T Node::as(const S& fallback) const {
   return as_if<T, S>(*this)(fallback);
 }
 
+template <typename T>
+inline bool Node::try_as(T& value) const {
+  if (!m_isValid || !m_pNode)
+    return false;
+
+  T t;
+  if (!convert<T>::decode(*this, t))
+    return false;
+  value = std::move(t);
+  return true;
+}
+
 inline const std::string& Node::Scalar() const {
   if (!m_isValid)
     throw InvalidNode();
@@ -168,8 +188,10 @@ inline const std::string& Node::Tag() const {
 inline void Node::SetTag(const std::string& tag) {
   if (!m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
-  m_pNode->set_tag(tag);
+  m_pNode->set_tag(&m_pMemory->intern(tag));
 }
 
 inline EmitterStyle::value Node::Style() const {
@@ -181,10 +203,26 @@ inline EmitterStyle::value Node::Style() const {
 inline void Node::SetStyle(EmitterStyle::value style) {
   if (!m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
   m_pNode->set_style(style);
 }
 
+// freezing
+inline void Node::Freeze() {
+  if (!m_isValid)
+    throw InvalidNode();
+  EnsureNodeExists();
+  m_pMemory->freeze();
+}
+
+inline bool Node::IsFrozen() const {
+  if (!m_isValid)
+    throw InvalidNode();
+  return m_pNode && m_pMemory->frozen();
+}
+
 // assignment
 inline bool Node::is(const Node& rhs) const {
   if (!m_isValid || !rhs.m_isValid)
@@ -202,6 +240,13 @@ inline Node& Node::operator=(const T& rhs) {
   return *this;
 }
 
+inline Node& Node::operator=(std::string&& rhs) {
+  if (!m_isValid)
+    throw InvalidNode();
+  Assign(std::move(rhs));
+  return *this;
+}
+
 inline void Node::reset(const YAML::Node& rhs) {
   if (!m_isValid || !rhs.m_isValid)
     throw InvalidNode();
@@ -220,13 +265,26 @@ template <>
 inline void Node::Assign(const std::string& rhs) {
   if (!m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
   m_pNode->set_scalar(rhs);
 }
 
+inline void Node::Assign(std::string&& rhs) {
+  if (!m_isValid)
+    throw InvalidNode();
+  if (IsFrozen())
+    throw FrozenNode();
+  EnsureNodeExists();
+  m_pNode->set_scalar(std::move(rhs));
+}
+
 inline void Node::Assign(const char* rhs) {
   if (!m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
   m_pNode->set_scalar(rhs);
 }
@@ -234,6 +292,8 @@ inline void Node::Assign(const char* rhs) {
 inline void Node::Assign(char* rhs) {
   if (!m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
   m_pNode->set_scalar(rhs);
 }
@@ -250,6 +310,8 @@ inline Node& Node::operator=(const Node& rhs) {
 inline void Node::AssignData(const Node& rhs) {
   if (!m_isValid || !rhs.m_isValid)
     throw InvalidNode();
+  if (IsFrozen() || rhs.IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
   rhs.EnsureNodeExists();
 
@@ -267,6 +329,8 @@ inline void Node::AssignNode(const Node& rhs) {
     m_pMemory = rhs.m_pMemory;
     return;
   }
+  if (IsFrozen() || rhs.IsFrozen())
+    throw FrozenNode();
 
   m_pNode->set_ref(*rhs.m_pNode);
   m_pMemory->merge(*rhs.m_pMemory);
@@ -316,6 +380,8 @@ inline void Node::push_back(const T& rhs) {
 inline void Node::push_back(const Node& rhs) {
   if (!m_isValid || !rhs.m_isValid)
     throw InvalidNode();
+  if (IsFrozen() || rhs.IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
   rhs.EnsureNodeExists();
 
@@ -366,6 +432,15 @@ template <typename T>
 inline typename to_value_t<T>::return_type to_value(const T& t) {
   return to_value_t<T>(t)();
 }
+
+// just looking a key up doesn't need a copy (of a C-string, in particular)
+template <typename T>
+inline const T& to_key(const T& t) {
+  return t;
+}
+
+inline const char* to_key(const char* t) { return t; }
+inline const char* to_key(char* t) { return t; }
 }
 
 // indexing
@@ -375,7 +450,7 @@ inline const Node Node::operator[](const Key& key) const {
     throw InvalidNode();
   EnsureNodeExists();
   detail::node* value = static_cast<const detail::node&>(*m_pNode)
-                            .get(detail::to_value(key), m_pMemory);
+                            .get(detail::to_key(key), *m_pMemory);
   if (!value) {
     return Node(ZombieNode);
   }
@@ -386,6 +461,8 @@ template <typename Key>
 inline Node Node::operator[](const Key& key) {
   if (!m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    return static_cast<const Node&>(*this)[key];
   EnsureNodeExists();
   detail::node& value = m_pNode->get(detail::to_value(key), m_pMemory);
   return Node(value, m_pMemory);
@@ -395,6 +472,8 @@ template <typename Key>
 inline bool Node::remove(const Key& key) {
   if (!m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
   return m_pNode->remove(detail::to_value(key), m_pMemory);
 }
@@ -404,9 +483,10 @@ inline const Node Node::operator[](const Node& key) const {
     throw InvalidNode();
   EnsureNodeExists();
   key.EnsureNodeExists();
-  m_pMemory->merge(*key.m_pMemory);
+  if (!IsFrozen() && !key.IsFrozen())
+    m_pMemory->merge(*key.m_pMemory);
   detail::node* value =
-      static_cast<const detail::node&>(*m_pNode).get(*key.m_pNode, m_pMemory);
+      static_cast<const detail::node&>(*m_pNode).get(*key.m_pNode, *m_pMemory);
   if (!value) {
     return Node(ZombieNode);
   }
@@ -416,6 +496,8 @@ inline const Node Node::operator[](const Node& key) const {
 inline Node Node::operator[](const Node& key) {
   if (!m_isValid || !key.m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    return static_cast<const Node&>(*this)[key];
   EnsureNodeExists();
   key.EnsureNodeExists();
   m_pMemory->merge(*key.m_pMemory);
@@ -426,6 +508,8 @@ inline Node Node::operator[](const Node& key) {
 inline bool Node::remove(const Node& key) {
   if (!m_isValid || !key.m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
   key.EnsureNodeExists();
   return m_pNode->remove(*key.m_pNode, m_pMemory);
@@ -436,6 +520,8 @@ template <typename Key, typename Value>
 inline void Node::force_insert(const Key& key, const Value& value) {
   if (!m_isValid)
     throw InvalidNode();
+  if (IsFrozen())
+    throw FrozenNode();
   EnsureNodeExists();
   m_pNode->force_insert(detail::to_value(key), detail::to_value(value),
                         m_pMemory);
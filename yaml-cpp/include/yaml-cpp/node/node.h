@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <stdexcept>
 
 #include "yaml-cpp/dll.h"
@@ -26,10 +27,20 @@ struct iterator_value;
 }  // namespace YAML
 
 namespace YAML {
+class Node;
+class NodeView;
+
+YAML_CPP_API std::size_t DeepHash(const Node& node);
+YAML_CPP_API bool DeepEquals(const Node& lhs, const Node& rhs);
+
 class YAML_CPP_API Node {
  public:
   friend class NodeBuilder;
   friend class NodeEvents;
+  friend class NodePacker;
+  friend class NodeView;
+  friend std::size_t DeepHash(const Node& node);
+  friend bool DeepEquals(const Node& lhs, const Node& rhs);
   friend struct detail::iterator_value;
   friend class detail::node;
   friend class detail::node_data;
@@ -45,6 +56,7 @@ class YAML_CPP_API Node {
   explicit Node(NodeType::value type);
   template <typename T>
   explicit Node(const T& rhs);
+  explicit Node(std::string&& rhs);
   explicit Node(const detail::iterator_value& rhs);
   Node(const Node& rhs);
   ~Node();
@@ -68,6 +80,11 @@ class YAML_CPP_API Node {
   T as(const S& fallback) const;
   const std::string& Scalar() const;
 
+  // converts to 'value' if it can (leaving it alone otherwise), rather than
+  // throwing; false if this is missing, or isn't a T
+  template <typename T>
+  bool try_as(T& value) const;
+
   const std::string& Tag() const;
   void SetTag(const std::string& tag);
 
@@ -76,10 +93,20 @@ class YAML_CPP_API Node {
   EmitterStyle::value Style() const;
   void SetStyle(EmitterStyle::value style);
 
+  // freezing
+  // Makes the whole document that this node is in read-only, so it can be
+  // read from any number of threads at once without locking: lookups (even
+  // through a non-const Node) never add entries, and anything that would
+  // change the document, or merge it with another, throws FrozenNode. A
+  // Clone of a frozen node can be changed again.
+  void Freeze();
+  bool IsFrozen() const;
+
   // assignment
   bool is(const Node& rhs) const;
   template <typename T>
   Node& operator=(const T& rhs);
+  Node& operator=(std::string&& rhs);
   Node& operator=(const Node& rhs);
   void reset(const Node& rhs = Node());
 
@@ -109,6 +136,11 @@ class YAML_CPP_API Node {
   Node operator[](const Node& key);
   bool remove(const Node& key);
 
+  // looks a key (or index) up without ever changing anything, or throwing;
+  // the view isn't valid if there's no such entry (see NodeView)
+  template <typename Key>
+  NodeView find(const Key& key) const;
+
   // map
   template <typename Key, typename Value>
   void force_insert(const Key& key, const Value& value);
@@ -122,6 +154,7 @@ class YAML_CPP_API Node {
 
   template <typename T>
   void Assign(const T& rhs);
+  void Assign(std::string&& rhs);
   void Assign(const char* rhs);
   void Assign(char* rhs);
 
@@ -138,6 +171,25 @@ YAML_CPP_API bool operator==(const Node& lhs, const Node& rhs);
 
 YAML_CPP_API Node Clone(const Node& node);
 
+// structural comparison
+// Two nodes are deeply equal if they have the same type and tag (where "?",
+// for plain scalars, is the same as no tag at all), and the same scalar, the
+// same entries in the same order (sequences), or the same keys and values in
+// any order (maps); marks, styles and anchors don't matter. DeepHash is
+// consistent with that, so NodeHash and NodeEqual let nodes be keys in
+// unordered containers by value (operator== compares identity). Hashes of
+// collections in frozen documents are worked out once, and kept; both throw
+// InvalidNode if either node is.
+struct NodeHash {
+  std::size_t operator()(const Node& node) const { return DeepHash(node); }
+};
+
+struct NodeEqual {
+  bool operator()(const Node& lhs, const Node& rhs) const {
+    return DeepEquals(lhs, rhs);
+  }
+};
+
 template <typename T>
 struct convert;
 }
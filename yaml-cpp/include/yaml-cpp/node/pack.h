@@ -0,0 +1,212 @@
+#ifndef NODE_PACK_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_PACK_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+#include "yaml-cpp/stringref.h"
+
+namespace YAML {
+class PackedDocument;
+
+/**
+ * Encodes a node, and everything under it, in a compact binary form that
+ * can be read back (see {@link PackedDocument}) without scanning or parsing
+ * anything: scalars, tags and styles, and (if {@code marks}) each node's
+ * mark. A node that appears more than once (through an alias) is packed
+ * once, and read back as the same node each time; undefined entries of a
+ * sequence are left out, as they are when it's emitted.
+ *
+ * The data starts with a header, and then each node is a record with its
+ * kind, tag and mark; a scalar's text follows its record, and a collection's
+ * record refers to a table of the offsets of its entries (and, for a large
+ * map, another of its scalar keys in order), so any node can be reached
+ * without reading anything else.
+ *
+ * @throws {@link BadPackedData} if it would be 4 GB or more.
+ */
+YAML_CPP_API std::string Pack(const Node& node, bool marks = false);
+
+/**
+ * A read-only handle on a node of a {@link PackedDocument}, which reads it
+ * straight from the packed data. A handle is small, and copying one or
+ * looking things up through it doesn't allocate; it's good for as long as
+ * the document it came from is.
+ *
+ * As with {@link NodeView}, a lookup that finds nothing gives a handle that
+ * isn't valid, which then throws InvalidNode (except from IsDefined).
+ * Anything wrong with the data it reads throws {@link BadPackedData}.
+ */
+class YAML_CPP_API PackedNode {
+ public:
+  friend class PackedDocument;
+
+  PackedNode();
+
+  YAML::Mark Mark() const;
+  NodeType::value Type() const;
+  bool IsDefined() const;
+  bool IsNull() const { return Type() == NodeType::Null; }
+  bool IsScalar() const { return Type() == NodeType::Scalar; }
+  bool IsSequence() const { return Type() == NodeType::Sequence; }
+  bool IsMap() const { return Type() == NodeType::Map; }
+
+  // access
+
+  /**
+   * Converts the node as Node::as would; a number or bool is read straight
+   * from the packed data, and anything else through ToNode().
+   */
+  template <typename T>
+  T as() const;
+
+  /** Returns the scalar's text, which refers to the packed data. */
+  StringRef ScalarRef() const;
+  std::string Scalar() const;
+
+  std::string Tag() const;
+  EmitterStyle::value Style() const;
+
+  bool is(const PackedNode& rhs) const;
+
+  // size/entries
+  std::size_t size() const;
+
+  /**
+   * Returns the key, or value, of the given entry of a map (or a handle that
+   * isn't valid, if there's no such entry).
+   */
+  PackedNode Key(std::size_t index) const;
+  PackedNode Value(std::size_t index) const;
+
+  // indexing
+
+  /**
+   * Returns the given entry of a sequence; of a map, like a Node, the value
+   * whose key is the index's text.
+   */
+  PackedNode operator[](std::size_t index) const;
+
+  /**
+   * Returns the value of the first entry of a map whose key is a scalar with
+   * the given text; a large map keeps its keys in order, so that's a binary
+   * search, and otherwise it's a linear one.
+   */
+  PackedNode operator[](const std::string& key) const;
+
+  /** Reads the node, and everything under it, back into a Node. */
+  Node ToNode() const;
+
+ private:
+  PackedNode(const PackedDocument* pDocument, std::size_t offset);
+
+  template <typename T>
+  T as(std::true_type /* numeric */) const;
+  template <typename T>
+  T as(std::false_type /* numeric */) const;
+
+ private:
+  const PackedDocument* m_pDocument;  // NULL if this isn't valid
+  std::size_t m_offset;
+};
+
+/**
+ * Packed data (see {@link Pack}), held in memory or mapped from a file. Only
+ * its header is checked up front; each node is checked as it's read.
+ */
+class YAML_CPP_API PackedDocument {
+ public:
+  /**
+   * Reads the packed data in memory; scalars read back into Nodes refer to
+   * it, rather than being copied.
+   *
+   * @throws {@link BadPackedData} if it doesn't start with a valid header.
+   */
+  explicit PackedDocument(std::shared_ptr<const std::string> data);
+
+  /**
+   * Maps the given file into memory (or, where that isn't supported, reads
+   * it), so that only the parts of it that are used need to be read.
+   *
+   * @throws {@link BadFile} if it can't be opened, or {@link BadPackedData}
+   *         if it doesn't start with a valid header.
+   */
+  static PackedDocument MapFile(const std::string& filename);
+
+  PackedNode Root() const;
+
+  /** Reads the whole document back into a Node. */
+  Node ToNode() const;
+
+  const char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  bool HasMarks() const { return m_marks; }
+
+ private:
+  PackedDocument(std::shared_ptr<const void> storage, const char* data,
+                 std::size_t size);
+  void ReadHeader();
+
+ private:
+  friend class PackedNode;
+
+  std::shared_ptr<const void> m_pStorage;
+  std::shared_ptr<const std::string> m_pString;  // if that's the storage
+  const char* m_data;
+  std::size_t m_size;
+  bool m_marks;
+  std::size_t m_root;
+};
+
+template <typename T>
+inline T PackedNode::as() const {
+  return as<T>(
+      std::integral_constant<bool, conversion::is_numeric<T>::value>());
+}
+
+template <typename T>
+inline T PackedNode::as(std::true_type /* numeric */) const {
+  T value;
+  if (Type() != NodeType::Scalar ||
+      !conversion::DecodeNumber(ScalarRef(), value))
+    throw TypedBadConversion<T>(Mark());
+  return value;
+}
+
+template <typename T>
+inline T PackedNode::as(std::false_type /* numeric */) const {
+  return ToNode().as<T>();
+}
+
+template <>
+inline bool PackedNode::as<bool>() const {
+  bool value;
+  if (Type() != NodeType::Scalar || !conversion::DecodeBool(ScalarRef(), value))
+    throw TypedBadConversion<bool>(Mark());
+  return value;
+}
+
+template <>
+inline std::string PackedNode::as<std::string>() const {
+  if (Type() != NodeType::Scalar)
+    throw TypedBadConversion<std::string>(Mark());
+  return Scalar();
+}
+}
+
+#endif  // NODE_PACK_H_62B23520_7C8E_11DE_8A39_0800200C9A66
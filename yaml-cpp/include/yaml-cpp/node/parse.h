@@ -8,6 +8,7 @@
 #endif
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,6 +16,7 @@
 
 namespace YAML {
 class Node;
+struct ParseLimits;
 
 /**
  * Loads the input string as a single YAML document.
@@ -38,12 +40,110 @@ YAML_CPP_API Node Load(const char* input);
 YAML_CPP_API Node Load(std::istream& input);
 
 /**
- * Loads the input file as a single YAML document.
+ * Loads the input string as a single YAML document, held to the
+ * {@code limits} (see {@link ParseLimits}).
+ *
+ * @throws {@link ParserException} if it is malformed, or passes a limit.
+ */
+YAML_CPP_API Node Load(const std::string& input, const ParseLimits& limits);
+
+/**
+ * Loads the input stream as a single YAML document, held to the
+ * {@code limits}.
+ *
+ * @throws {@link ParserException} if it is malformed, or passes a limit.
+ */
+YAML_CPP_API Node Load(std::istream& input, const ParseLimits& limits);
+
+/**
+ * Loads the memory-resident input as a single YAML document. Scalars that
+ * appear verbatim in the input refer to it rather than copying it, and the
+ * document keeps the input alive for as long as they do.
+ *
+ * If {@code detectJson}, input that opens with an object or an array is
+ * tried as strict JSON first (see {@link LoadJson}), and parsed as YAML
+ * only if it isn't. For most JSON the result is the same either way; where
+ * it isn't, it's what {@link LoadJson} gives.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Node Load(std::shared_ptr<const std::string> input,
+                       bool detectJson = false);
+
+/**
+ * Loads the memory-resident input as a single YAML document, as above, held
+ * to the {@code limits}.
+ *
+ * @throws {@link ParserException} if it is malformed, or passes a limit.
+ */
+YAML_CPP_API Node Load(std::shared_ptr<const std::string> input,
+                       const ParseLimits& limits, bool detectJson = false);
+
+/**
+ * Loads the input file as a single YAML document; if {@code detectJson},
+ * it's tried as JSON first, as with {@link Load}.
  *
  * @throws {@link ParserException} if it is malformed.
  * @throws {@link BadFile} if the file cannot be loaded.
  */
-YAML_CPP_API Node LoadFile(const std::string& filename);
+YAML_CPP_API Node LoadFile(const std::string& filename,
+                           bool detectJson = false);
+
+/**
+ * Loads the input file as a single YAML document, as above, held to the
+ * {@code limits}.
+ *
+ * @throws {@link ParserException} if it is malformed, or passes a limit.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Node LoadFile(const std::string& filename,
+                           const ParseLimits& limits, bool detectJson = false);
+
+/**
+ * Loads the memory-resident input as a single document of strict JSON, with
+ * a parser made for it, which is much faster than the YAML one. The node is
+ * the same as {@link Load} would give (strings are tagged "!", and
+ * collections are in flow style), with the same marks, and it refers to the
+ * input in the same way. The exceptions are:
+ * - JSON that the YAML parser rejects, which this accepts: keys longer than
+ *   1024 characters, escaped surrogate pairs, and a key on a different line
+ *   from its ':'.
+ * - A carriage return without a line feed after it, which the YAML parser
+ *   either rejects or leaves out of the columns of the marks after it.
+ * - A tab after a number, which the YAML parser keeps as part of it.
+ *
+ * @throws {@link ParserException} if it isn't strict JSON: if it's
+ * malformed YAML too, it's the same exception, with the same mark, that
+ * {@link Load} would throw.
+ */
+YAML_CPP_API Node LoadJson(std::shared_ptr<const std::string> input);
+
+/**
+ * Loads the memory-resident input as a single document of strict JSON, as
+ * above, held to the {@code limits}.
+ *
+ * @throws {@link ParserException} if it isn't strict JSON, or passes a
+ * limit.
+ */
+YAML_CPP_API Node LoadJson(std::shared_ptr<const std::string> input,
+                           const ParseLimits& limits);
+
+/**
+ * Loads the input string as a single document of strict JSON; see
+ * {@link LoadJson}.
+ *
+ * @throws {@link ParserException} if it isn't strict JSON.
+ */
+YAML_CPP_API Node LoadJson(const std::string& input);
+
+/**
+ * Loads the input file as a single document of strict JSON; see
+ * {@link LoadJson}.
+ *
+ * @throws {@link ParserException} if it isn't strict JSON.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Node LoadJsonFile(const std::string& filename);
 
 /**
  * Loads the input string as a list of YAML documents.
@@ -66,6 +166,25 @@ YAML_CPP_API std::vector<Node> LoadAll(const char* input);
  */
 YAML_CPP_API std::vector<Node> LoadAll(std::istream& input);
 
+/**
+ * Loads the memory-resident input as a list of YAML documents, referring to
+ * it as {@link Load} does.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API std::vector<Node> LoadAll(
+    std::shared_ptr<const std::string> input);
+
+/**
+ * Loads the memory-resident input as a list of YAML documents, each held to
+ * the {@code limits}.
+ *
+ * @throws {@link ParserException} if it is malformed, or a document passes
+ * a limit.
+ */
+YAML_CPP_API std::vector<Node> LoadAll(
+    std::shared_ptr<const std::string> input, const ParseLimits& limits);
+
 /**
  * Loads the input file as a list of YAML documents.
  *
@@ -73,6 +192,70 @@ YAML_CPP_API std::vector<Node> LoadAll(std::istream& input);
  * @throws {@link BadFile} if the file cannot be loaded.
  */
 YAML_CPP_API std::vector<Node> LoadAllFromFile(const std::string& filename);
+
+/**
+ * Loads the memory-resident input as a list of YAML documents, like
+ * {@link LoadAll}, but parses runs of documents on up to {@code threads}
+ * threads at once (0 means one per core). The documents come back in order,
+ * and refer to the input as {@link Load} does.
+ *
+ * @throws {@link ParserException} if it is malformed; it's the same
+ * exception, with the same mark, that {@link LoadAll} would throw.
+ */
+YAML_CPP_API std::vector<Node> LoadAllParallel(
+    std::shared_ptr<const std::string> input, unsigned threads = 0);
+
+/**
+ * Loads the input string as a list of YAML documents, in parallel; see
+ * {@link LoadAllParallel}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API std::vector<Node> LoadAllParallel(const std::string& input,
+                                               unsigned threads = 0);
+
+/**
+ * Loads the input file as a list of YAML documents, in parallel; see
+ * {@link LoadAllParallel}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API std::vector<Node> LoadAllFromFileParallel(
+    const std::string& filename, unsigned threads = 0);
+
+/**
+ * Loads the memory-resident input as a single YAML document, like
+ * {@link Load}, but if its root is a block map or sequence at column 0,
+ * parses runs of its entries on up to {@code threads} threads at once (0
+ * means one per core), and splices them together. If the runs can't be
+ * parsed on their own (say, a quoted scalar or flow collection spans two of
+ * them, or an alias refers to an anchor in an earlier one), the document is
+ * parsed sequentially instead; either way, the result is the same.
+ *
+ * @throws {@link ParserException} if it is malformed; it's the same
+ * exception, with the same mark, that {@link Load} would throw.
+ */
+YAML_CPP_API Node LoadParallel(std::shared_ptr<const std::string> input,
+                               unsigned threads = 0);
+
+/**
+ * Loads the input string as a single YAML document, in parallel; see
+ * {@link LoadParallel}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Node LoadParallel(const std::string& input, unsigned threads = 0);
+
+/**
+ * Loads the input file as a single YAML document, in parallel; see
+ * {@link LoadParallel}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API Node LoadFileParallel(const std::string& filename,
+                                   unsigned threads = 0);
 }  // namespace YAML
 
 #endif  // VALUE_PARSE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,107 @@
+#ifndef NODE_PATH_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_PATH_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/node/view.h"
+
+namespace YAML {
+namespace detail {
+class memory_holder;
+class node;
+}  // namespace detail
+
+/**
+ * A path through a document, such as {@code services[*].endpoints[3].timeout},
+ * compiled once (with the hash of each key worked out up front) so that it
+ * can then be looked up in any number of documents, without allocating.
+ *
+ * A path is a series of steps: {@code key} or {@code .key} looks up a key,
+ * {@code [3]} an index, and {@code *} or {@code [*]} matches every entry of a
+ * sequence, or every value of a map. Keys that have any of {@code .[]*} in
+ * them can be quoted, as {@code ["a.b"]} (with backslash escapes) or
+ * {@code ['a.b']} (where {@code ''} is a quote). An index looks up the key
+ * with that text in a map, and a key never matches in a sequence. The empty
+ * path matches the node it's looked up in.
+ *
+ * Lookups behave as {@link NodeView#find} does: anything that doesn't match
+ * (including looking something up in a scalar) just isn't a result.
+ */
+class YAML_CPP_API Path {
+ public:
+  /** Throws BadPath if {@code expression} isn't a path. */
+  explicit Path(const std::string& expression);
+
+  const std::string& str() const { return m_expression; }
+
+  /** Returns the first match (in document order), or an invalid view. */
+  NodeView Find(const NodeView& root) const;
+
+  /**
+   * Calls {@code f} with each match (as a NodeView), in document order, and
+   * returns how many there were.
+   */
+  template <typename F>
+  std::size_t ForEach(const NodeView& root, F f) const;
+
+ private:
+  struct Step {
+    enum Kind { Key, Index, Wildcard };
+
+    Kind kind;
+    std::string key;  // for an index, its text (for looking it up in a map)
+    std::size_t hash;
+    std::size_t index;
+  };
+
+  class Visitor {
+   public:
+    virtual ~Visitor() {}
+    // returns false to stop
+    virtual bool operator()(const NodeView& match) = 0;
+  };
+
+  template <typename F>
+  class FunctionVisitor : public Visitor {
+   public:
+    explicit FunctionVisitor(F& f) : m_f(f), m_count(0) {}
+    virtual bool operator()(const NodeView& match) {
+      m_f(match);
+      m_count++;
+      return true;
+    }
+    std::size_t count() const { return m_count; }
+
+   private:
+    F& m_f;
+    std::size_t m_count;
+  };
+
+  void Compile();
+  void Visit(const NodeView& root, Visitor& visitor) const;
+  bool Visit(std::size_t step, const detail::node& node,
+             detail::memory_holder& memory, Visitor& visitor) const;
+
+ private:
+  std::string m_expression;
+  std::vector<Step> m_steps;
+};
+
+template <typename F>
+inline std::size_t Path::ForEach(const NodeView& root, F f) const {
+  FunctionVisitor<F> visitor(f);
+  Visit(root, visitor);
+  return visitor.count();
+}
+}
+
+#endif  // NODE_PATH_H_62B23520_7C8E_11DE_8A39_0800200C9A66
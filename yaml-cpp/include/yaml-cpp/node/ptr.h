@@ -9,6 +9,7 @@
 
 #include "yaml-cpp/dll.h"
 #include <memory>
+#include <string>
 
 namespace YAML {
 namespace detail {
@@ -17,12 +18,17 @@ class node_ref;
 class node_data;
 class memory;
 class memory_holder;
+class arena;
+class string_pool;
 
 typedef std::shared_ptr<node> shared_node;
 typedef std::shared_ptr<node_ref> shared_node_ref;
 typedef std::shared_ptr<node_data> shared_node_data;
 typedef std::shared_ptr<memory_holder> shared_memory_holder;
 typedef std::shared_ptr<memory> shared_memory;
+typedef std::shared_ptr<const std::string> shared_input;
+typedef std::shared_ptr<arena> shared_arena;
+typedef std::shared_ptr<string_pool> shared_string_pool;
 }
 }
 
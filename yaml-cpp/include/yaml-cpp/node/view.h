@@ -0,0 +1,313 @@
+#ifndef NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/detail/bool_type.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/detail/memory.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+namespace detail {
+struct view_iterator_value;
+class view_iterator;
+}  // namespace detail
+
+/**
+ * A read-only handle on a node that borrows it from a {@link Node}, rather
+ * than sharing ownership of the document: copying a view, looking things up
+ * through it, and iterating over it never touch a reference count (or
+ * allocate). A view is good for as long as the document it came from is
+ * alive (through some Node).
+ *
+ * Reading through a view behaves exactly as it does through a const Node; in
+ * particular, a lookup that finds nothing gives a view that isn't valid,
+ * which then throws InvalidNode (except from IsDefined and the fallback form
+ * of as). Conversions other than to a string are handed to convert<T> as a
+ * Node, so they do take a reference.
+ */
+class YAML_CPP_API NodeView {
+ public:
+  friend class Node;
+  friend class Path;
+  friend struct detail::view_iterator_value;
+  friend class detail::view_iterator;
+
+  typedef detail::view_iterator const_iterator;
+
+  NodeView();
+  NodeView(const Node& node);
+
+  YAML::Mark Mark() const;
+  NodeType::value Type() const;
+  bool IsDefined() const;
+  bool IsNull() const { return Type() == NodeType::Null; }
+  bool IsScalar() const { return Type() == NodeType::Scalar; }
+  bool IsSequence() const { return Type() == NodeType::Sequence; }
+  bool IsMap() const { return Type() == NodeType::Map; }
+
+  // bool conversions
+  YAML_CPP_OPERATOR_BOOL()
+  bool operator!() const { return !IsDefined(); }
+
+  // access
+  template <typename T>
+  T as() const;
+  template <typename T, typename S>
+  T as(const S& fallback) const;
+  template <typename T>
+  bool try_as(T& value) const;
+  const std::string& Scalar() const;
+
+  const std::string& Tag() const;
+  EmitterStyle::value Style() const;
+
+  bool is(const NodeView& rhs) const;
+
+  // size/iterator
+  std::size_t size() const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // indexing
+  template <typename Key>
+  NodeView operator[](const Key& key) const;
+
+  /**
+   * Looks a key (or index) up like operator[], but rather than throwing, it
+   * gives a view that isn't valid if this view isn't, or isn't a collection.
+   */
+  template <typename Key>
+  NodeView find(const Key& key) const;
+
+  /** Returns an owning Node for the same node. */
+  Node ToNode() const;
+
+ private:
+  NodeView(const detail::node* pNode, detail::memory_holder* pMemory);
+
+ private:
+  const detail::node* m_pNode;  // NULL if this isn't valid
+  detail::memory_holder* m_pMemory;
+};
+
+namespace detail {
+struct view_iterator_value : public NodeView, std::pair<NodeView, NodeView> {
+  view_iterator_value() {}
+  explicit view_iterator_value(const NodeView& rhs) : NodeView(rhs) {}
+  explicit view_iterator_value(const NodeView& key, const NodeView& value)
+      : std::pair<NodeView, NodeView>(key, value) {}
+};
+
+class view_iterator {
+ private:
+  struct proxy {
+    explicit proxy(const view_iterator_value& x) : m_ref(x) {}
+    view_iterator_value* operator->() { return std::addressof(m_ref); }
+    operator view_iterator_value*() { return std::addressof(m_ref); }
+
+    view_iterator_value m_ref;
+  };
+
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = view_iterator_value;
+  using difference_type = std::ptrdiff_t;
+  using pointer = view_iterator_value*;
+  using reference = view_iterator_value;
+
+ public:
+  view_iterator() : m_iterator(), m_pMemory(NULL) {}
+  explicit view_iterator(const_node_iterator rhs, memory_holder* pMemory)
+      : m_iterator(rhs), m_pMemory(pMemory) {}
+
+  view_iterator& operator++() {
+    ++m_iterator;
+    return *this;
+  }
+
+  view_iterator operator++(int) {
+    view_iterator iterator_pre(*this);
+    ++(*this);
+    return iterator_pre;
+  }
+
+  bool operator==(const view_iterator& rhs) const {
+    return m_iterator == rhs.m_iterator;
+  }
+
+  bool operator!=(const view_iterator& rhs) const {
+    return m_iterator != rhs.m_iterator;
+  }
+
+  value_type operator*() const {
+    const const_node_iterator::value_type& v = *m_iterator;
+    if (v.pNode)
+      return value_type(NodeView(v.pNode, m_pMemory));
+    if (v.first && v.second)
+      return value_type(NodeView(v.first, m_pMemory),
+                        NodeView(v.second, m_pMemory));
+    return value_type();
+  }
+
+  proxy operator->() const { return proxy(**this); }
+
+ private:
+  const_node_iterator m_iterator;
+  memory_holder* m_pMemory;
+};
+}  // namespace detail
+
+inline NodeView::NodeView() : m_pNode(NULL), m_pMemory(NULL) {}
+
+inline NodeView::NodeView(const Node& node) : m_pNode(NULL), m_pMemory(NULL) {
+  if (!node.m_isValid)
+    return;
+  node.EnsureNodeExists();
+  m_pNode = node.m_pNode;
+  m_pMemory = node.m_pMemory.get();
+}
+
+inline NodeView::NodeView(const detail::node* pNode,
+                          detail::memory_holder* pMemory)
+    : m_pNode(pNode), m_pMemory(pMemory) {}
+
+inline Mark NodeView::Mark() const {
+  if (!m_pNode)
+    throw InvalidNode();
+  return m_pNode->mark();
+}
+
+inline NodeType::value NodeView::Type() const {
+  if (!m_pNode)
+    throw InvalidNode();
+  return m_pNode->type();
+}
+
+inline bool NodeView::IsDefined() const {
+  return m_pNode ? m_pNode->is_defined() : false;
+}
+
+// access
+template <typename T>
+inline T NodeView::as() const {
+  return ToNode().as<T>();
+}
+
+template <>
+inline std::string NodeView::as<std::string>() const {
+  if (Type() != NodeType::Scalar)
+    throw TypedBadConversion<std::string>(Mark());
+  return Scalar();
+}
+
+template <typename T, typename S>
+inline T NodeView::as(const S& fallback) const {
+  return ToNode().as<T>(fallback);
+}
+
+template <typename T>
+inline bool NodeView::try_as(T& value) const {
+  return m_pNode && ToNode().try_as(value);
+}
+
+template <>
+inline bool NodeView::try_as<std::string>(std::string& value) const {
+  if (!m_pNode || m_pNode->type() != NodeType::Scalar)
+    return false;
+  value = m_pNode->scalar();
+  return true;
+}
+
+inline const std::string& NodeView::Scalar() const {
+  if (!m_pNode)
+    throw InvalidNode();
+  return m_pNode->scalar();
+}
+
+inline const std::string& NodeView::Tag() const {
+  if (!m_pNode)
+    throw InvalidNode();
+  return m_pNode->tag();
+}
+
+inline EmitterStyle::value NodeView::Style() const {
+  if (!m_pNode)
+    throw InvalidNode();
+  return m_pNode->style();
+}
+
+inline bool NodeView::is(const NodeView& rhs) const {
+  if (!m_pNode || !rhs.m_pNode)
+    throw InvalidNode();
+  return m_pNode->is(*rhs.m_pNode);
+}
+
+// size/iterator
+inline std::size_t NodeView::size() const {
+  if (!m_pNode)
+    throw InvalidNode();
+  return m_pNode->size();
+}
+
+inline NodeView::const_iterator NodeView::begin() const {
+  return m_pNode ? const_iterator(m_pNode->begin(), m_pMemory)
+                 : const_iterator();
+}
+
+inline NodeView::const_iterator NodeView::end() const {
+  return m_pNode ? const_iterator(m_pNode->end(), m_pMemory)
+                 : const_iterator();
+}
+
+// indexing
+template <typename Key>
+inline NodeView NodeView::operator[](const Key& key) const {
+  if (!m_pNode)
+    throw InvalidNode();
+  return NodeView(m_pNode->get(detail::to_key(key), *m_pMemory), m_pMemory);
+}
+
+template <typename Key>
+inline NodeView NodeView::find(const Key& key) const {
+  if (!m_pNode || m_pNode->type() == NodeType::Scalar)
+    return NodeView();
+  return NodeView(m_pNode->get(detail::to_key(key), *m_pMemory), m_pMemory);
+}
+
+inline Node NodeView::ToNode() const {
+  if (!m_pNode)
+    return Node(Node::ZombieNode);
+  return Node(const_cast<detail::node&>(*m_pNode),
+              m_pMemory->shared_from_this());
+}
+
+template <typename Key>
+inline NodeView Node::find(const Key& key) const {
+  if (!m_isValid || !m_pNode)
+    return NodeView();
+  return NodeView(m_pNode, m_pMemory.get()).find(key);
+}
+}
+
+#endif  // NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
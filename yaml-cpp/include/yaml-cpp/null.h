@@ -8,6 +8,7 @@
 #endif
 
 #include "yaml-cpp/dll.h"
+#include "yaml-cpp/stringref.h"
 #include <string>
 
 namespace YAML {
@@ -19,6 +20,7 @@ inline bool operator!=(const _Null&, const _Null&) { return false; }
 
 YAML_CPP_API bool IsNull(const Node& node);  // old API only
 YAML_CPP_API bool IsNullString(const std::string& str);
+YAML_CPP_API bool IsNullString(const StringRef& str);
 
 extern YAML_CPP_API _Null Null;
 }
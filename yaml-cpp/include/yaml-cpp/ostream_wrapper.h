@@ -7,25 +7,54 @@
 #pragma once
 #endif
 
+#include <cstddef>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
 #include "yaml-cpp/dll.h"
 
 namespace YAML {
+/**
+ * Where the emitter's output goes: an internal buffer (see {@link str}), a
+ * std::ostream, or a file descriptor. Keeps track of the row and column
+ * that the output has reached.
+ */
 class YAML_CPP_API ostream_wrapper {
  public:
   ostream_wrapper();
   explicit ostream_wrapper(std::ostream& stream);
+
+  /**
+   * Writes to an open file descriptor, which is neither closed nor flushed
+   * (beyond what {@link flush} writes to it) by the wrapper. The output is
+   * collected into blocks of {@code blockSize} bytes, each written with a
+   * single system call; anything larger than a block is written directly.
+   */
+  explicit ostream_wrapper(int fd, std::size_t blockSize = 64 * 1024);
+
+  /** Flushes anything that's still buffered for a file descriptor. */
   ~ostream_wrapper();
 
   void write(const std::string& str);
   void write(const char* str, std::size_t size);
 
+  /**
+   * Writes out whatever is buffered for a file descriptor; otherwise it
+   * does nothing.
+   */
+  void flush();
+
+  /**
+   * Returns false once writing to a file descriptor has failed; nothing
+   * more is written to it after that.
+   */
+  bool good() const { return m_good; }
+
   void set_comment() { m_comment = true; }
 
   const char* str() const {
-    if (m_pStream) {
+    if (m_pStream || m_fd >= 0) {
       return 0;
     } else {
       m_buffer[m_pos] = '\0';
@@ -39,11 +68,17 @@ class YAML_CPP_API ostream_wrapper {
   bool comment() const { return m_comment; }
 
  private:
-  void update_pos(char ch);
+  void update_pos(const char* str, std::size_t size);
+  void write_fd(const char* str, std::size_t size);
 
  private:
+  // the internal buffer holds [0, m_pos), plus room for a '\0' (and grows
+  // geometrically); for a file descriptor it holds [0, m_fill)
   mutable std::vector<char> m_buffer;
   std::ostream* const m_pStream;
+  const int m_fd;
+  std::size_t m_fill;
+  bool m_good;
 
   std::size_t m_pos;
   std::size_t m_row, m_col;
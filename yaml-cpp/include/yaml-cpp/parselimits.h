@@ -0,0 +1,51 @@
+#ifndef PARSELIMITS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define PARSELIMITS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+
+#include "yaml-cpp/dll.h"
+
+namespace YAML {
+/**
+ * Limits on what a single document may hold, for input that can't be
+ * trusted. Each is counted as the document is parsed, and the parser throws
+ * a ParserException, with the mark where the limit was passed, as soon as it
+ * is; so a document that would be too big is never built.
+ *
+ * An alias counts as everything its anchor's node holds, as if it were
+ * expanded (except that an alias to a collection it's still inside of counts
+ * as one node), since that's what a consumer that visits it might see; so a
+ * few lines of aliases to aliases can't stand for billions of nodes.
+ *
+ * Every limit is unlimited by default.
+ */
+struct YAML_CPP_API ParseLimits {
+  static const std::size_t Unlimited = static_cast<std::size_t>(-1);
+
+  ParseLimits()
+      : maxNodes(Unlimited),
+        maxDepth(Unlimited),
+        maxAliases(Unlimited),
+        maxScalarBytes(Unlimited) {}
+
+  /** The number of nodes, with aliases counted as expanded. */
+  std::size_t maxNodes;
+
+  /** How deeply collections may be nested in each other. */
+  std::size_t maxDepth;
+
+  /** The number of aliases, each counted once, where it appears. */
+  std::size_t maxAliases;
+
+  /** The bytes of scalar text, with aliases counted as expanded. */
+  std::size_t maxScalarBytes;
+};
+}
+
+#endif  // PARSELIMITS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -7,17 +7,22 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <ios>
 #include <memory>
+#include <string>
 
 #include "yaml-cpp/dll.h"
+#include "yaml-cpp/mark.h"
 #include "yaml-cpp/noncopyable.h"
 
 namespace YAML {
+class EventCursor;
 class EventHandler;
 class Node;
 class Scanner;
 struct Directives;
+struct ParseLimits;
 struct Token;
 
 /**
@@ -35,6 +40,13 @@ class YAML_CPP_API Parser : private noncopyable {
    */
   explicit Parser(std::istream& in);
 
+  /**
+   * Constructs a parser over memory-resident input. The parser shares
+   * ownership of the input, and scalars that appear verbatim in it are
+   * reported by {@link EventHandler::OnScalarRef} as references into it.
+   */
+  explicit Parser(std::shared_ptr<const std::string> input);
+
   ~Parser();
 
   /** Evaluates to true if the parser has some valid input to be read. */
@@ -46,10 +58,33 @@ class YAML_CPP_API Parser : private noncopyable {
    */
   void Load(std::istream& in);
 
+  /**
+   * Resets the parser with the given memory-resident input. Any existing
+   * state is erased.
+   */
+  void Load(std::shared_ptr<const std::string> input);
+
+  /**
+   * Resets the parser with part of the given memory-resident input: the
+   * {@code size} bytes from the start of a line, at {@code start}. Marks are
+   * reported relative to all of the input, and the directives in effect for
+   * {@code context} (if any) carry over, just as if this parser had read
+   * everything before {@code start} itself.
+   */
+  void Load(std::shared_ptr<const std::string> input, const Mark& start,
+            std::size_t size, const Parser* context = nullptr);
+
+  /**
+   * Sets the limits that each document handled from now on is held to (see
+   * {@link ParseLimits}); they're kept when the parser is loaded again.
+   */
+  void SetLimits(const ParseLimits& limits);
+
   /**
    * Handles the next document by calling events on the {@code eventHandler}.
    *
-   * @throw a ParserException on error.
+   * @throw a ParserException on error, or if the document passes one of the
+   * limits.
    * @return false if there are no more documents
    */
   bool HandleNextDocument(EventHandler& eventHandler);
@@ -57,6 +92,8 @@ class YAML_CPP_API Parser : private noncopyable {
   void PrintTokens(std::ostream& out);
 
  private:
+  friend class EventCursor;  // pulls its events straight from the scanner
+
   /**
    * Reads any directives that are next in the queue, setting the internal
    * {@code m_pDirectives} state.
@@ -78,8 +115,12 @@ class YAML_CPP_API Parser : private noncopyable {
   void HandleTagDirective(const Token& token);
 
  private:
+  std::shared_ptr<const std::string> m_pInput;
+  std::unique_ptr<std::streambuf> m_pInputBuffer;
+  std::unique_ptr<std::istream> m_pInputStream;
   std::unique_ptr<Scanner> m_pScanner;
   std::unique_ptr<Directives> m_pDirectives;
+  std::unique_ptr<ParseLimits> m_pLimits;
 };
 }
 
@@ -0,0 +1,56 @@
+#ifndef STRINGREF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define STRINGREF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace YAML {
+/**
+ * A non-owning reference to a run of characters (typically a piece of a
+ * retained input buffer). Whoever hands one out is responsible for keeping
+ * the characters alive for as long as the reference is used.
+ */
+class StringRef {
+ public:
+  StringRef() : m_data(nullptr), m_size(0) {}
+  StringRef(const char* data, std::size_t size)
+      : m_data(data), m_size(size) {}
+  StringRef(const std::string& str) : m_data(str.data()), m_size(str.size()) {}
+
+  const char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  /** Returns true if this refers to something (possibly empty). */
+  bool valid() const { return m_data != nullptr; }
+
+  char operator[](std::size_t i) const { return m_data[i]; }
+
+  std::string str() const {
+    return m_data ? std::string(m_data, m_size) : std::string();
+  }
+
+  // the address check only saves the memcmp when both refer to the same
+  // characters, like two of a document's keys that were interned (until it's
+  // frozen, which copies them); a lookup by a caller's string never does
+  bool operator==(const StringRef& rhs) const {
+    return m_size == rhs.m_size &&
+           (m_data == rhs.m_data || m_size == 0 ||
+            std::memcmp(m_data, rhs.m_data, m_size) == 0);
+  }
+  bool operator!=(const StringRef& rhs) const { return !(*this == rhs); }
+
+ private:
+  const char* m_data;
+  std::size_t m_size;
+};
+}
+
+#endif  // STRINGREF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
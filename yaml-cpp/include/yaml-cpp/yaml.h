@@ -8,6 +8,8 @@
 #endif
 
 #include "yaml-cpp/parser.h"
+#include "yaml-cpp/parselimits.h"
+#include "yaml-cpp/eventcursor.h"
 #include "yaml-cpp/emitter.h"
 #include "yaml-cpp/emitterstyle.h"
 #include "yaml-cpp/stlemitter.h"
@@ -17,8 +19,11 @@
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/convert.h"
 #include "yaml-cpp/node/iterator.h"
+#include "yaml-cpp/node/view.h"
+#include "yaml-cpp/node/path.h"
 #include "yaml-cpp/node/detail/impl.h"
 #include "yaml-cpp/node/parse.h"
 #include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/pack.h"
 
 #endif  // YAML_H_62B23520_7C8E_11DE_8A39_0800200C9A66
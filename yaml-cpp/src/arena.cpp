@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#include "arena.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_data.h"
+#include "yaml-cpp/node/detail/node_ref.h"
+#include "yaml-cpp/node/ptr.h"
+
+namespace YAML {
+namespace detail {
+arena::arena()
+    : m_pos(nullptr), m_end(nullptr), m_nextBlockSize(FirstBlockSize) {}
+
+arena::~arena() { destroy_nodes(); }
+
+node& arena::create_node() {
+  shared_node_data pData =
+      std::allocate_shared<node_data>(arena_allocator<node_data>(*this));
+  shared_node_ref pRef =
+      std::allocate_shared<node_ref>(arena_allocator<node_ref>(*this), pData);
+
+  void* pStorage = allocate(sizeof(node), alignof(node));
+  m_nodes.push_back(static_cast<node*>(pStorage));
+  return *new (pStorage) node(pRef);
+}
+
+void arena::destroy_nodes() {
+  for (std::vector<node*>::const_iterator it = m_nodes.begin();
+       it != m_nodes.end(); ++it)
+    (*it)->~node();
+  m_nodes.clear();
+}
+
+void* arena::allocate(std::size_t size, std::size_t alignment) {
+  std::size_t padding =
+      (alignment - reinterpret_cast<std::uintptr_t>(m_pos) % alignment) %
+      alignment;
+  if (!m_pos || size + padding > static_cast<std::size_t>(m_end - m_pos)) {
+    // blocks grow as the arena does, so that small documents stay small
+    std::size_t blockSize = std::max<std::size_t>(m_nextBlockSize,
+                                                  size + alignment);
+    m_blocks.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+    m_pos = m_blocks.back().get();
+    m_end = m_pos + blockSize;
+    m_nextBlockSize = std::min<std::size_t>(2 * m_nextBlockSize, MaxBlockSize);
+
+    padding =
+        (alignment - reinterpret_cast<std::uintptr_t>(m_pos) % alignment) %
+        alignment;
+  }
+
+  char* pResult = m_pos + padding;
+  m_pos = pResult + size;
+  return pResult;
+}
+}
+}
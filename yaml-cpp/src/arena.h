@@ -0,0 +1,89 @@
+#ifndef ARENA_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define ARENA_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "yaml-cpp/noncopyable.h"
+
+namespace YAML {
+namespace detail {
+class node;
+
+/**
+ * Bump-allocated storage for the nodes of a document, along with their refs
+ * and data (and the control blocks of the shared pointers to those). Nothing
+ * is given back until the whole arena goes, and then it's a handful of large
+ * blocks, rather than a few small allocations per node.
+ *
+ * A node can share the ref or data of a node in another arena (its memory
+ * will have merged that arena in), so arenas that go together must all
+ * {@link destroy_nodes} before any of them releases its storage.
+ */
+class arena : private noncopyable {
+ public:
+  arena();
+  ~arena();
+
+  node& create_node();
+
+  /** Returns every node created here, in order. */
+  const std::vector<node*>& nodes() const { return m_nodes; }
+
+  /** Destroys every node, but keeps their storage. */
+  void destroy_nodes();
+
+  void* allocate(std::size_t size, std::size_t alignment);
+
+ private:
+  enum { FirstBlockSize = 1024, MaxBlockSize = 64 * 1024 };
+
+  std::vector<std::unique_ptr<char[]>> m_blocks;
+  char* m_pos;
+  char* m_end;
+  std::size_t m_nextBlockSize;
+
+  std::vector<node*> m_nodes;
+};
+
+/** A minimal allocator over an arena; deallocation does nothing. */
+template <typename T>
+class arena_allocator {
+ public:
+  typedef T value_type;
+
+  explicit arena_allocator(arena& owner) : m_pArena(&owner) {}
+  template <typename U>
+  arena_allocator(const arena_allocator<U>& rhs) : m_pArena(rhs.m_pArena) {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(m_pArena->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, std::size_t) {}
+
+  template <typename U>
+  bool operator==(const arena_allocator<U>& rhs) const {
+    return m_pArena == rhs.m_pArena;
+  }
+  template <typename U>
+  bool operator!=(const arena_allocator<U>& rhs) const {
+    return m_pArena != rhs.m_pArena;
+  }
+
+ private:
+  template <typename U>
+  friend class arena_allocator;
+
+  arena* m_pArena;
+};
+}
+}
+
+#endif  // ARENA_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,26 +1,166 @@
 #include "yaml-cpp/binary.h"
 
 #include <cctype>
+#include <cstring>
+
+// the vector kernels below are built for x86 whatever the target, and only
+// used if the CPU running them turns out to have the instructions
+#if (defined(__x86_64__) || defined(__i386__)) &&                  \
+    ((defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 5) || \
+     (defined(__clang__) && __clang_major__ >= 4))
+#define YAML_CPP_BASE64_X86
+#include <immintrin.h>
+#endif
 
 namespace YAML {
 static const char encoding[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
+// EncodingPairs
+// . The two characters for each 12 bits of input, so that three bytes take
+//   two lookups rather than four.
+struct EncodingPairs {
+  EncodingPairs() {
+    for (unsigned i = 0; i < 4096; i++) {
+      pairs[2 * i] = encoding[i >> 6];
+      pairs[2 * i + 1] = encoding[i & 0x3f];
+    }
+  }
+
+  char pairs[2 * 4096];
+};
+
+// Encode kernels
+// . Each encodes as many whole groups of three bytes from the start of
+//   'data' as it can, a vector at a time, and returns how many bytes that
+//   was; whatever's left is done the scalar way.
+// . Each reads four bytes past the last group it encodes, so it stops short
+//   of the end.
+typedef std::size_t (*EncodeKernel)(const unsigned char *data,
+                                    std::size_t size, char *out);
+
+static std::size_t EncodeNone(const unsigned char * /* data */,
+                              std::size_t /* size */, char * /* out */) {
+  return 0;
+}
+
+#ifdef YAML_CPP_BASE64_X86
+// EncodeSSSE3
+// . 12 bytes to 16 characters: each three bytes are shuffled into a 32-bit
+//   word (as bytes 1, 0, 2, 1), where two multiplies move each 6 bits into
+//   a byte of its own; then each of those gets the offset that takes its
+//   range (A-Z, a-z, 0-9, + or /) to its characters.
+__attribute__((target("ssse3"))) static std::size_t EncodeSSSE3(
+    const unsigned char *data, std::size_t size, char *out) {
+  const __m128i spread =
+      _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  const __m128i offsets = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+  std::size_t done = 0;
+  for (; done + 16 <= size; done += 12, out += 16) {
+    const __m128i in = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + done)),
+        spread);
+    const __m128i hi =
+        _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                        _mm_set1_epi32(0x04000040));
+    const __m128i lo =
+        _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                        _mm_set1_epi32(0x01000010));
+    const __m128i digits = _mm_or_si128(hi, lo);
+
+    // 0 for 0-51 (so a-z), 1-12 for 52-63, and then 13 for 0-25 (A-Z)
+    __m128i range = _mm_subs_epu8(digits, _mm_set1_epi8(51));
+    range = _mm_or_si128(
+        range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), digits),
+                             _mm_set1_epi8(13)));
+    const __m128i chars =
+        _mm_add_epi8(digits, _mm_shuffle_epi8(offsets, range));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), chars);
+  }
+  return done;
+}
+
+// EncodeAVX2
+// . As EncodeSSSE3, with 12 bytes in each half, so 24 bytes to 32
+//   characters.
+__attribute__((target("avx2"))) static std::size_t EncodeAVX2(
+    const unsigned char *data, std::size_t size, char *out) {
+  const __m256i spread = _mm256_setr_epi8(
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5,
+      4, 7, 6, 8, 7, 10, 9, 11, 10);
+  const __m256i offsets = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+  std::size_t done = 0;
+  for (; done + 28 <= size; done += 24, out += 32) {
+    const __m128i first =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + done));
+    const __m128i second =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + done + 12));
+    const __m256i in = _mm256_shuffle_epi8(
+        _mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1),
+        spread);
+    const __m256i hi =
+        _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                           _mm256_set1_epi32(0x04000040));
+    const __m256i lo =
+        _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                           _mm256_set1_epi32(0x01000010));
+    const __m256i digits = _mm256_or_si256(hi, lo);
+
+    __m256i range = _mm256_subs_epu8(digits, _mm256_set1_epi8(51));
+    range = _mm256_or_si256(
+        range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), digits),
+                                _mm256_set1_epi8(13)));
+    const __m256i chars =
+        _mm256_add_epi8(digits, _mm256_shuffle_epi8(offsets, range));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), chars);
+  }
+  return done;
+}
+#endif
+
+static EncodeKernel ChooseEncodeKernel() {
+#ifdef YAML_CPP_BASE64_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return EncodeAVX2;
+  if (__builtin_cpu_supports("ssse3"))
+    return EncodeSSSE3;
+#endif
+  return EncodeNone;
+}
+
 std::string EncodeBase64(const unsigned char *data, std::size_t size) {
   const char PAD = '=';
+  static const EncodingPairs encodingPairs;
+  static const EncodeKernel encodeKernel = ChooseEncodeKernel();
+  const char *const pairs = encodingPairs.pairs;
 
   std::string ret;
-  ret.resize(4 * size / 3 + 3);
+  ret.resize((size + 2) / 3 * 4);
+  if (ret.empty())
+    return ret;
   char *out = &ret[0];
 
+  const std::size_t vectored = encodeKernel(data, size, out);
+  data += vectored;
+  out += vectored / 3 * 4;
+  size -= vectored;
+
   std::size_t chunks = size / 3;
   std::size_t remainder = size % 3;
 
-  for (std::size_t i = 0; i < chunks; i++, data += 3) {
-    *out++ = encoding[data[0] >> 2];
-    *out++ = encoding[((data[0] & 0x3) << 4) | (data[1] >> 4)];
-    *out++ = encoding[((data[1] & 0xf) << 2) | (data[2] >> 6)];
-    *out++ = encoding[data[2] & 0x3f];
+  for (std::size_t i = 0; i < chunks; i++, data += 3, out += 4) {
+    const unsigned value = (data[0] << 16) | (data[1] << 8) | data[2];
+    std::memcpy(out, pairs + 2 * (value >> 12), 2);
+    std::memcpy(out + 2, pairs + 2 * (value & 0xfff), 2);
   }
 
   switch (remainder) {
@@ -40,7 +180,6 @@ std::string EncodeBase64(const unsigned char *data, std::size_t size) {
       break;
   }
 
-  ret.resize(out - &ret[0]);
   return ret;
 }
 
@@ -65,32 +204,203 @@ static const unsigned char decoding[] = {
     255,
 };
 
+// DecodingQuads
+// . For each place in a group of four characters, the bits that each
+//   character stands for, already shifted into place. Anything that isn't a
+//   plain base64 digit (whitespace, padding, or garbage) sets a bit above the
+//   24 that the group decodes to, so that one test of the whole group sends
+//   it the slow way.
+struct DecodingQuads {
+  static const unsigned SLOW = 1u << 24;
+
+  DecodingQuads() {
+    for (unsigned c = 0; c < 256; c++) {
+      const unsigned d = decoding[c];
+      const bool slow = d == 255 || c == '=';
+      for (unsigned i = 0; i < 4; i++)
+        quads[i][c] = slow ? SLOW : d << (18 - 6 * i);
+    }
+  }
+
+  unsigned quads[4][256];
+};
+
+// Decode kernels
+// . Each decodes as many groups of plain base64 digits from the start of
+//   'in' as it can, a vector at a time, and returns how many characters that
+//   was (stopping at a vector with anything else in it, for the scalar way
+//   to deal with); 'room' is how much it may write to 'out', which is a
+//   little more than what it decodes.
+typedef std::size_t (*DecodeKernel)(const unsigned char *in, std::size_t size,
+                                    unsigned char *out, std::size_t room);
+
+static std::size_t DecodeNone(const unsigned char * /* in */,
+                              std::size_t /* size */,
+                              unsigned char * /* out */,
+                              std::size_t /* room */) {
+  return 0;
+}
+
+#ifdef YAML_CPP_BASE64_X86
+// DecodeSSSE3
+// . 16 characters to 12 bytes. Each character's high and low nibbles look
+//   up bits that only have one in common if it isn't a digit; then its high
+//   nibble (or '/') looks up the offset that takes it to its 6 bits, and two
+//   multiply-adds pack each four of those into three bytes.
+__attribute__((target("ssse3"))) static std::size_t DecodeSSSE3(
+    const unsigned char *in, std::size_t size, unsigned char *out,
+    std::size_t room) {
+  const __m128i lowBits =
+      _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                    0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+  const __m128i highBits =
+      _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10,
+                    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  const __m128i offsets =
+      _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i pack =
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+  std::size_t done = 0;
+  for (; done + 16 <= size && done / 4 * 3 + 16 <= room; done += 16) {
+    const __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + done));
+    const __m128i high =
+        _mm_and_si128(_mm_srli_epi32(chars, 4), _mm_set1_epi8(0x0f));
+    const __m128i low = _mm_and_si128(chars, _mm_set1_epi8(0x0f));
+    const __m128i invalid =
+        _mm_and_si128(_mm_shuffle_epi8(lowBits, low),
+                      _mm_shuffle_epi8(highBits, high));
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())))
+      break;
+
+    const __m128i slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+    const __m128i digits = _mm_add_epi8(
+        chars, _mm_shuffle_epi8(offsets, _mm_add_epi8(slash, high)));
+    const __m128i pairs =
+        _mm_maddubs_epi16(digits, _mm_set1_epi32(0x01400140));
+    const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + done / 4 * 3),
+                     _mm_shuffle_epi8(words, pack));
+  }
+  return done;
+}
+
+// DecodeAVX2
+// . As DecodeSSSE3, 32 characters to 24 bytes (12 from each half).
+__attribute__((target("avx2"))) static std::size_t DecodeAVX2(
+    const unsigned char *in, std::size_t size, unsigned char *out,
+    std::size_t room) {
+  const __m256i lowBits = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                    0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a));
+  const __m256i highBits = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10,
+                    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10));
+  const __m256i offsets = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+  const __m256i pack = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+  const __m256i together = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+  std::size_t done = 0;
+  for (; done + 32 <= size && done / 4 * 3 + 32 <= room; done += 32) {
+    const __m256i chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + done));
+    const __m256i high =
+        _mm256_and_si256(_mm256_srli_epi32(chars, 4), _mm256_set1_epi8(0x0f));
+    const __m256i low = _mm256_and_si256(chars, _mm256_set1_epi8(0x0f));
+    const __m256i invalid =
+        _mm256_and_si256(_mm256_shuffle_epi8(lowBits, low),
+                         _mm256_shuffle_epi8(highBits, high));
+    if (_mm256_movemask_epi8(
+            _mm256_cmpgt_epi8(invalid, _mm256_setzero_si256())))
+      break;
+
+    const __m256i slash = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/'));
+    const __m256i digits = _mm256_add_epi8(
+        chars, _mm256_shuffle_epi8(offsets, _mm256_add_epi8(slash, high)));
+    const __m256i pairs =
+        _mm256_maddubs_epi16(digits, _mm256_set1_epi32(0x01400140));
+    const __m256i words =
+        _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    const __m256i bytes = _mm256_permutevar8x32_epi32(
+        _mm256_shuffle_epi8(words, pack), together);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + done / 4 * 3),
+                        bytes);
+  }
+  return done;
+}
+#endif
+
+static DecodeKernel ChooseDecodeKernel() {
+#ifdef YAML_CPP_BASE64_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return DecodeAVX2;
+  if (__builtin_cpu_supports("ssse3"))
+    return DecodeSSSE3;
+#endif
+  return DecodeNone;
+}
+
 std::vector<unsigned char> DecodeBase64(const std::string &input) {
   typedef std::vector<unsigned char> ret_type;
-  if (input.empty())
-    return ret_type();
+  static const DecodingQuads decodingQuads;
+  static const DecodeKernel decodeKernel = ChooseDecodeKernel();
+  const unsigned(&quads)[4][256] = decodingQuads.quads;
 
-  ret_type ret(3 * input.size() / 4 + 1);
+  // every four characters make (at most) three bytes
+  const std::size_t size = input.size();
+  if (size < 4)
+    return ret_type();
+  ret_type ret(3 * (size / 4));
   unsigned char *out = &ret[0];
+  const unsigned char *in = reinterpret_cast<const unsigned char *>(&input[0]);
 
   unsigned value = 0;
-  for (std::size_t i = 0, cnt = 0; i < input.size(); i++) {
-    if (std::isspace(input[i])) {
+  std::size_t cnt = 0;
+  unsigned char prev = 0;
+  for (std::size_t i = 0; i < size;) {
+    if (cnt % 4 == 0) {
+      // whole vectors of plain digits, and then groups of them, four
+      // characters at a time
+      const std::size_t vectored =
+          decodeKernel(in + i, size - i, out, ret.size() - (out - &ret[0]));
+      i += vectored;
+      out += vectored / 4 * 3;
+      for (; i + 4 <= size; i += 4, out += 3) {
+        const unsigned group = quads[0][in[i]] | quads[1][in[i + 1]] |
+                               quads[2][in[i + 2]] | quads[3][in[i + 3]];
+        if (group & DecodingQuads::SLOW)
+          break;
+        out[0] = static_cast<unsigned char>(group >> 16);
+        out[1] = static_cast<unsigned char>(group >> 8);
+        out[2] = static_cast<unsigned char>(group);
+      }
+      if (i == size)
+        break;
+    }
+
+    // and then whatever broke that up, a character at a time
+    const unsigned char c = in[i++];
+    if (std::isspace(c)) {
       // skip newlines
       continue;
     }
-    unsigned char d = decoding[static_cast<unsigned>(input[i])];
+    unsigned char d = decoding[c];
     if (d == 255)
       return ret_type();
 
     value = (value << 6) | d;
     if (cnt % 4 == 3) {
       *out++ = value >> 16;
-      if (i > 0 && input[i - 1] != '=')
+      if (prev != '=')
         *out++ = value >> 8;
-      if (input[i] != '=')
+      if (c != '=')
         *out++ = value;
     }
+    prev = c;
     ++cnt;
   }
 
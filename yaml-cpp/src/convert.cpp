@@ -1,4 +1,11 @@
 #include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+#include <locale>
+#include <sstream>
 
 #include "yaml-cpp/node/convert.h"
 
@@ -39,32 +46,239 @@ bool IsFlexibleCase(const std::string& str) {
   std::string rest = str.substr(1);
   return firstcaps && (IsEntirely(rest, IsLower) || IsEntirely(rest, IsUpper));
 }
+
+// what std::ws skips, in the classic locale
+bool IsSpace(char ch) { return ch == ' ' || ('\t' <= ch && ch <= '\r'); }
+
+bool IsDigit(char ch) { return '0' <= ch && ch <= '9'; }
+
+// the value of a digit in any base up to 16 (and 16 for anything else)
+unsigned DigitValue(char ch) {
+  if (IsDigit(ch))
+    return static_cast<unsigned>(ch - '0');
+  if ('a' <= ch && ch <= 'f')
+    return static_cast<unsigned>(ch - 'a' + 10);
+  if ('A' <= ch && ch <= 'F')
+    return static_cast<unsigned>(ch - 'A' + 10);
+  return 16;
+}
+
+bool IsAllSpace(const char* begin, const char* end) {
+  for (; begin != end; ++begin) {
+    if (!IsSpace(*begin))
+      return false;
+  }
+  return true;
+}
+
+// the integers, and powers of ten, that T holds exactly
+template <typename T>
+struct ExactRange {
+  static const int digits = std::numeric_limits<T>::digits;
+  // 5^k fits in 'digits' bits as long as k <= digits * log(2) / log(5)
+  static const int maxPower = digits * 3 / 7;
+
+  ExactRange()
+      : maxMantissa(digits >= 64 ? ULLONG_MAX : 1ULL << (digits % 64)) {
+    powers[0] = 1;
+    for (int i = 1; i <= maxPower; i++)
+      powers[i] = powers[i - 1] * 10;
+  }
+
+  unsigned long long maxMantissa;
+  T powers[maxPower + 1];
+};
+
+// ParseFloat
+// . Reads the same numbers that a stream does: a sign, digits with at most
+//   one decimal point, and an exponent, then nothing but whitespace.
+// . Short enough numbers (which is most of them) are worked out exactly with
+//   a single multiplication or division (since both operands are exact in T,
+//   that rounds correctly); the rest are handed to a stream in the classic
+//   locale, which also decides what's too big.
+template <typename T>
+bool ParseFloat(const YAML::StringRef& input, T& rhs) {
+  const char* const begin = input.data();
+  const char* const end = begin + input.size();
+  const char* p = begin;
+
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+
+  // up to 19 significant digits, which always fit
+  unsigned long long mantissa = 0;
+  int significant = 0, exponent = 0;
+  bool exact = true, digits = false;
+  for (; p != end && IsDigit(*p); ++p) {
+    digits = true;
+    const unsigned digit = static_cast<unsigned>(*p - '0');
+    if (significant < 19 && (mantissa > 0 || digit > 0)) {
+      mantissa = mantissa * 10 + digit;
+      significant++;
+    } else if (significant == 19) {
+      exponent++;
+      exact = exact && digit == 0;
+    }
+  }
+  if (p != end && *p == '.') {
+    for (++p; p != end && IsDigit(*p); ++p) {
+      digits = true;
+      const unsigned digit = static_cast<unsigned>(*p - '0');
+      if (significant < 19 && (mantissa > 0 || digit > 0)) {
+        mantissa = mantissa * 10 + digit;
+        significant++;
+        exponent--;
+      } else if (significant < 19) {
+        exponent--;
+      } else {
+        exact = exact && digit == 0;
+      }
+    }
+  }
+  if (!digits)
+    return false;
+
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negativeExponent = false;
+    if (p != end && (*p == '-' || *p == '+'))
+      negativeExponent = *p++ == '-';
+    if (p == end || !IsDigit(*p))
+      return false;
+    int value = 0;
+    for (; p != end && IsDigit(*p); ++p) {
+      if (value < 100000)
+        value = value * 10 + (*p - '0');
+    }
+    exponent += negativeExponent ? -value : value;
+  }
+
+  const char* const last = p;
+  if (!IsAllSpace(last, end))
+    return false;
+
+  // with excess precision (FLT_EVAL_METHOD != 0), a float or double result
+  // would be rounded twice
+  static const ExactRange<T> range;
+  const bool fast = FLT_EVAL_METHOD == 0 ||
+                    std::numeric_limits<T>::digits ==
+                        std::numeric_limits<long double>::digits;
+  if (fast && exact && mantissa <= range.maxMantissa &&
+      exponent >= -range.maxPower && exponent <= range.maxPower) {
+    T value = static_cast<T>(mantissa);
+    if (exponent < 0)
+      value /= range.powers[-exponent];
+    else
+      value *= range.powers[exponent];
+    rhs = negative ? -value : value;
+    return true;
+  }
+
+  std::istringstream stream(std::string(begin, last));
+  stream.imbue(std::locale::classic());
+  T value = 0;
+  if (!(stream >> value))
+    return false;
+  rhs = value;
+  return true;
+}
+
+// IsOneOf
+// . Returns true if 'input' is any of the 'count' spellings.
+bool IsOneOf(const YAML::StringRef& input, const char* const spellings[],
+             std::size_t count) {
+  for (std::size_t i = 0; i < count; i++) {
+    if (input == YAML::StringRef(spellings[i], std::strlen(spellings[i])))
+      return true;
+  }
+  return false;
+}
+
+// (as in conversion::IsInfinity and so on)
+const char* const infinities[] = {".inf",  ".Inf",  ".INF",
+                                  "+.inf", "+.Inf", "+.INF"};
+const char* const negativeInfinities[] = {"-.inf", "-.Inf", "-.INF"};
+const char* const nans[] = {".nan", ".NaN", ".NAN"};
+
+template <typename T>
+bool DecodeFloat(const YAML::StringRef& input, T& rhs) {
+  if (ParseFloat(input, rhs))
+    return true;
+  if (IsOneOf(input, infinities, 6)) {
+    rhs = std::numeric_limits<T>::infinity();
+    return true;
+  }
+  if (IsOneOf(input, negativeInfinities, 3)) {
+    rhs = -std::numeric_limits<T>::infinity();
+    return true;
+  }
+  if (IsOneOf(input, nans, 3)) {
+    rhs = std::numeric_limits<T>::quiet_NaN();
+    return true;
+  }
+  return false;
+}
+
+// FormatFloat
+// . Writes what a stream would, with snprintf (which is what the stream uses
+//   too), but always with a '.' for the decimal point, regardless of the C
+//   locale.
+template <typename T>
+std::string FormatFloat(const char* format, T value) {
+  char buffer[64];
+  const int precision = std::numeric_limits<T>::digits10 + 1;
+  int size = std::snprintf(buffer, sizeof(buffer), format, precision, value);
+  if (size < 0)
+    return std::string();
+  if (static_cast<std::size_t>(size) >= sizeof(buffer))
+    size = sizeof(buffer) - 1;
+
+  std::string output(buffer, static_cast<std::size_t>(size));
+  const char* point = std::localeconv()->decimal_point;
+  if (point[0] != '.' || point[1] != '\0') {
+    const std::string::size_type pos = output.find(point);
+    if (pos != std::string::npos)
+      output.replace(pos, std::strlen(point), ".");
+  }
+  return output;
+}
 }
 
 namespace YAML {
 bool convert<bool>::decode(const Node& node, bool& rhs) {
   if (!node.IsScalar())
     return false;
+  return conversion::DecodeBool(StringRef(node.Scalar()), rhs);
+}
 
+namespace conversion {
+bool DecodeBool(const StringRef& input, bool& rhs) {
   // we can't use iostream bool extraction operators as they don't
   // recognize all possible values in the table below (taken from
   // http://yaml.org/type/bool.html)
   static const struct {
-    std::string truename, falsename;
+    const char* truename;
+    const char* falsename;
   } names[] = {
       {"y", "n"}, {"yes", "no"}, {"true", "false"}, {"on", "off"},
   };
 
-  if (!IsFlexibleCase(node.Scalar()))
+  // none of them is longer than "false"
+  if (input.size() > 5)
+    return false;
+  const std::string str(input.data(), input.size());
+  if (!IsFlexibleCase(str))
     return false;
 
+  const std::string lower = tolower(str);
   for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
-    if (names[i].truename == tolower(node.Scalar())) {
+    if (lower == names[i].truename) {
       rhs = true;
       return true;
     }
 
-    if (names[i].falsename == tolower(node.Scalar())) {
+    if (lower == names[i].falsename) {
       rhs = false;
       return true;
     }
@@ -72,4 +286,79 @@ bool convert<bool>::decode(const Node& node, bool& rhs) {
 
   return false;
 }
+
+bool ParseInteger(const StringRef& input, bool& negative,
+                  unsigned long long& magnitude) {
+  const char* p = input.data();
+  const char* const end = p + input.size();
+
+  negative = false;
+  if (p != end && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+
+  // a leading 0 means octal, and 0x hex (which then needs a digit)
+  unsigned base = 10;
+  bool digits = false;
+  if (p != end && *p == '0') {
+    ++p;
+    base = 8;
+    digits = true;
+    if (p != end && (*p == 'x' || *p == 'X')) {
+      ++p;
+      base = 16;
+      digits = false;
+    }
+  }
+
+  magnitude = 0;
+  for (; p != end; ++p) {
+    const unsigned digit = DigitValue(*p);
+    if (digit >= base)
+      break;
+    if (magnitude > (ULLONG_MAX - digit) / base)
+      return false;
+    magnitude = magnitude * base + digit;
+    digits = true;
+  }
+  return digits && IsAllSpace(p, end);
+}
+
+std::string FormatInteger(long long value) {
+  if (value >= 0)
+    return FormatInteger(static_cast<unsigned long long>(value));
+  std::string output =
+      FormatInteger(0 - static_cast<unsigned long long>(value));
+  output.insert(output.begin(), '-');
+  return output;
+}
+
+std::string FormatInteger(unsigned long long value) {
+  char buffer[24];
+  char* const end = buffer + sizeof(buffer);
+  char* p = end;
+  do {
+    *--p = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  return std::string(p, end);
+}
+
+bool DecodeFloat(const StringRef& input, float& rhs) {
+  return ::DecodeFloat(input, rhs);
+}
+
+bool DecodeFloat(const StringRef& input, double& rhs) {
+  return ::DecodeFloat(input, rhs);
+}
+
+bool DecodeFloat(const StringRef& input, long double& rhs) {
+  return ::DecodeFloat(input, rhs);
+}
+
+std::string EncodeFloat(float rhs) { return FormatFloat("%.*g", rhs); }
+
+std::string EncodeFloat(double rhs) { return FormatFloat("%.*g", rhs); }
+
+std::string EncodeFloat(long double rhs) { return FormatFloat("%.*Lg", rhs); }
+}
 }
@@ -0,0 +1,244 @@
+#include "docsplitter.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace YAML {
+namespace {
+// IsMarkerLine
+// . Returns true if the line is the document marker "---" or "...", followed
+//   by nothing or whitespace.
+bool IsMarkerLine(const char* line, const char* end, char ch) {
+  if (end - line < 3 || line[0] != ch || line[1] != ch || line[2] != ch) {
+    return false;
+  }
+  return end - line == 3 || line[3] == ' ' || line[3] == '\t' ||
+         line[3] == '\r' || line[3] == '\n';
+}
+
+// IsBlankLine
+// . Returns true if the line is empty, or holds nothing but a comment.
+bool IsBlankLine(const char* line, const char* end) {
+  for (; line != end; ++line) {
+    switch (*line) {
+      case ' ':
+      case '\t':
+      case '\r':
+        break;
+      case '\n':
+      case '#':
+        return true;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+// IsSequenceEntry
+// . Returns true if the line starts with a block sequence entry.
+bool IsSequenceEntry(const char* line, const char* end) {
+  return line[0] == '-' &&
+         (end - line == 1 || line[1] == ' ' || line[1] == '\t' ||
+          line[1] == '\r' || line[1] == '\n');
+}
+
+// IsSimpleKey
+// . Returns true if the line starts with something that can only be a
+//   simple key, when it's at column 0 inside a block map.
+bool IsSimpleKey(const char* line) {
+  switch (line[0]) {
+    case ' ':
+    case '\t':
+    case '\r':
+    case '\n':
+    case '-':
+    case '?':
+    case ':':
+    case ',':
+    case '[':
+    case ']':
+    case '{':
+    case '}':
+    case '#':
+    case '&':
+    case '*':
+    case '!':
+    case '|':
+    case '>':
+    case '%':
+    case '@':
+    case '`':
+      return false;
+    default:
+      return true;
+  }
+}
+
+// IsUtf8
+// . Returns true if the stream would be read as UTF-8 (see Stream::Init);
+//   anything else has a NUL in the first four bytes, or a UTF-16 BOM.
+bool IsUtf8(const char* begin, const char* end) {
+  std::size_t intro = std::min<std::size_t>(4, end - begin);
+  if (std::memchr(begin, '\0', intro)) {
+    return false;
+  }
+  return !(intro >= 2 && ((begin[0] == '\xFE' && begin[1] == '\xFF') ||
+                          (begin[0] == '\xFF' && begin[1] == '\xFE')));
+}
+}
+
+std::vector<DocumentChunk> SplitDocuments(const std::string& input,
+                                          std::size_t chunkSize) {
+  const char* begin = input.data();
+  const char* end = begin + input.size();
+  if (input.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+    begin += 3;
+  }
+
+  std::vector<DocumentChunk> chunks(1);
+  DocumentChunk& first = chunks.front();
+  first.size = end - begin;
+  first.directivesSize = 0;
+  if (!IsUtf8(begin, end)) {
+    return chunks;
+  }
+
+  Mark line;                  // the start of the current line
+  bool betweenDocs = true;    // after a "..." (or at the start)
+  bool hasDirectives = false;
+  Mark directives;            // the directives being read, if any
+  Mark lastDirectives;        // and the last ones before a "---"
+  std::size_t lastDirectivesSize = 0;
+
+  for (const char* p = begin; p != end;) {
+    const char* eol =
+        static_cast<const char*>(std::memchr(p, '\n', end - p));
+    const char* next = eol ? eol + 1 : end;
+
+    if (IsMarkerLine(p, next, '-')) {
+      // a document starts here, or at its directives
+      Mark at = hasDirectives ? directives : line;
+      DocumentChunk& last = chunks.back();
+      if (at.pos > last.start.pos &&
+          static_cast<std::size_t>(at.pos - last.start.pos) >= chunkSize) {
+        last.size = at.pos - last.start.pos;
+        DocumentChunk chunk;
+        chunk.start = at;
+        chunk.size = 0;
+        chunk.directives = hasDirectives ? Mark() : lastDirectives;
+        chunk.directivesSize = hasDirectives ? 0 : lastDirectivesSize;
+        chunks.push_back(chunk);
+      }
+      if (hasDirectives) {
+        lastDirectives = directives;
+        lastDirectivesSize = line.pos - directives.pos;
+      }
+      betweenDocs = false;
+      hasDirectives = false;
+    } else if (*p == '%') {
+      if (!betweenDocs) {
+        break;  // could be a directive or part of a scalar
+      }
+      if (!hasDirectives) {
+        directives = line;
+        hasDirectives = true;
+      }
+    } else if (!IsBlankLine(p, next)) {
+      if (hasDirectives) {
+        break;  // directives that don't lead to a "---"
+      }
+      betweenDocs = IsMarkerLine(p, next, '.');
+    }
+
+    line.pos += static_cast<int>(next - p);
+    if (eol) {
+      line.line++;
+    }
+    p = next;
+  }
+
+  DocumentChunk& last = chunks.back();
+  last.size = (end - begin) - last.start.pos;
+  return chunks;
+}
+
+std::vector<DocumentChunk> SplitRootCollection(const std::string& input,
+                                               std::size_t chunkSize) {
+  const char* begin = input.data();
+  const char* end = begin + input.size();
+  if (input.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+    begin += 3;
+  }
+
+  std::vector<DocumentChunk> chunks(1);
+  DocumentChunk& first = chunks.front();
+  first.size = end - begin;
+  first.directivesSize = 0;
+  if (!IsUtf8(begin, end)) {
+    return chunks;
+  }
+
+  enum { Prologue, Sequence, Map } root = Prologue;
+  Mark line;  // the start of the current line
+  bool hasDirectives = false;
+  bool hasDocumentStart = false;
+  Mark directives;
+  std::size_t directivesSize = 0;
+
+  const char* p = begin;
+  for (; p != end;) {
+    const char* eol =
+        static_cast<const char*>(std::memchr(p, '\n', end - p));
+    const char* next = eol ? eol + 1 : end;
+
+    if (root == Prologue) {
+      if (IsBlankLine(p, next)) {
+      } else if (*p == '%' && !hasDocumentStart) {
+        if (!hasDirectives) {
+          directives = line;
+          hasDirectives = true;
+        }
+      } else if (IsMarkerLine(p, next, '-') && !hasDocumentStart &&
+                 IsBlankLine(p + 3, next)) {
+        hasDocumentStart = true;
+        if (hasDirectives) {
+          directivesSize = line.pos - directives.pos;
+        }
+      } else if ((hasDirectives && !hasDocumentStart) ||
+                 IsMarkerLine(p, next, '-') || IsMarkerLine(p, next, '.')) {
+        return chunks;
+      } else if (IsSequenceEntry(p, next)) {
+        root = Sequence;
+      } else if (IsSimpleKey(p)) {
+        root = Map;
+      } else {
+        return chunks;
+      }
+    } else if (IsMarkerLine(p, next, '-') || IsMarkerLine(p, next, '.')) {
+      break;  // the end of the document
+    } else if (root == Sequence ? IsSequenceEntry(p, next) : IsSimpleKey(p)) {
+      DocumentChunk& last = chunks.back();
+      if (static_cast<std::size_t>(line.pos - last.start.pos) >= chunkSize) {
+        last.size = line.pos - last.start.pos;
+        DocumentChunk chunk;
+        chunk.start = line;
+        chunk.size = 0;
+        chunk.directives = directives;
+        chunk.directivesSize = directivesSize;
+        chunks.push_back(chunk);
+      }
+    }
+
+    line.pos += static_cast<int>(next - p);
+    if (eol) {
+      line.line++;
+    }
+    p = next;
+  }
+
+  DocumentChunk& last = chunks.back();
+  last.size = line.pos - last.start.pos;
+  return chunks;
+}
+}
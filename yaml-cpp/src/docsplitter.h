@@ -0,0 +1,74 @@
+#ifndef DOCSPLITTER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define DOCSPLITTER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+/**
+ * A run of whole documents in a YAML stream, which can be parsed on its own
+ * (with {@link Parser::Load}) and gives the same events as it would have as
+ * part of the whole stream.
+ */
+struct DocumentChunk {
+  Mark start;  // the start of the chunk's first line
+  std::size_t size;
+
+  // The last directives before the chunk, if they carry over to it (that
+  // is, if the chunk doesn't open with directives of its own); parse them
+  // first, and hand that parser in as the context.
+  Mark directives;
+  std::size_t directivesSize;
+};
+
+/**
+ * Splits a YAML stream into chunks of at least {@code chunkSize} bytes (bar
+ * the last), at line-start document markers.
+ *
+ * The only markers used are those that can't be part of a scalar or a
+ * collection in a valid stream: a line-start "---" always ends a plain
+ * scalar, and no block scalar can reach column 0. Inside a quoted scalar or
+ * a flow collection it's an error, and the chunk before fails to parse too,
+ * so it's up to the caller to parse sequentially from there to get the same
+ * error. Directives are only recognized between a "..." and a "---"; if a
+ * '%' line turns up anywhere else, it's ambiguous, so the rest of the input
+ * goes in the last chunk.
+ *
+ * Positions count from after any byte order mark, as marks do. Input that
+ * isn't UTF-8 comes back in one chunk.
+ */
+std::vector<DocumentChunk> SplitDocuments(const std::string& input,
+                                          std::size_t chunkSize);
+
+/**
+ * Splits the first document of a YAML stream, if its root is a block
+ * sequence or map at column 0, into chunks of at least {@code chunkSize}
+ * bytes (bar the last), at the line-start entries of its root. Each chunk
+ * parses as a collection of the same kind, holding some of the entries.
+ *
+ * A line that starts at column 0 inside the root is either a new entry, or
+ * the rest of a quoted scalar or flow collection; in the latter case (and
+ * if there's an alias to an anchor in an earlier chunk) the chunk before
+ * won't parse, so the caller must then fall back to a sequential parse.
+ * Map entries are only split at keys that start simply (not with an
+ * indicator, tag or anchor), and the document must start with a bare
+ * "---", if any. Directives before it carry over to every chunk after the
+ * first.
+ *
+ * The last chunk ends at the end of the document; if the document can't be
+ * split, it comes back in one chunk.
+ */
+std::vector<DocumentChunk> SplitRootCollection(const std::string& input,
+                                               std::size_t chunkSize);
+}
+
+#endif  // DOCSPLITTER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,94 @@
+#include "documentlimits.h"
+
+#include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
+
+namespace YAML {
+const std::size_t ParseLimits::Unlimited;
+
+namespace {
+// SaturatingAdd
+// . Aliases to aliases double what they stand for at each level, which
+//   overflows soon enough when nothing is limited; it stays at the maximum.
+std::size_t SaturatingAdd(std::size_t a, std::size_t b) {
+  return a > ParseLimits::Unlimited - b ? ParseLimits::Unlimited : a + b;
+}
+}
+
+DocumentLimits::DocumentLimits(const ParseLimits& limits)
+    : m_limits(limits), m_nodes(0), m_scalarBytes(0), m_aliases(0) {}
+
+void DocumentLimits::Count(EventType::value type, const Mark& mark,
+                           anchor_t anchor, std::size_t scalarBytes) {
+  switch (type) {
+    case EventType::DocumentStart:
+    case EventType::DocumentEnd:
+      break;
+    case EventType::Null:
+    case EventType::Scalar:
+      Add(mark, 1, scalarBytes);
+      Define(anchor, 1, scalarBytes);
+      break;
+    case EventType::Alias: {
+      if (m_aliases >= m_limits.maxAliases) {
+        throw ParserException(mark, ErrorMsg::TOO_MANY_ALIASES);
+      }
+      m_aliases++;
+
+      // an alias to a collection that's still open is a cycle, and only
+      // one node
+      if (anchor < m_anchors.size() && m_anchors[anchor].complete) {
+        Add(mark, m_anchors[anchor].nodes, m_anchors[anchor].scalarBytes);
+      } else {
+        Add(mark, 1, 0);
+      }
+      break;
+    }
+    case EventType::SequenceStart:
+    case EventType::MapStart: {
+      if (m_open.size() >= m_limits.maxDepth) {
+        throw ParserException(mark, ErrorMsg::TOO_DEEP);
+      }
+      const Open open = {anchor, m_nodes, m_scalarBytes};
+      m_open.push_back(open);
+      Add(mark, 1, 0);
+      break;
+    }
+    case EventType::SequenceEnd:
+    case EventType::MapEnd: {
+      if (m_open.empty()) {
+        break;
+      }
+      const Open& open = m_open.back();
+      Define(open.anchor, m_nodes - open.nodes,
+             m_scalarBytes - open.scalarBytes);
+      m_open.pop_back();
+      break;
+    }
+  }
+}
+
+void DocumentLimits::Add(const Mark& mark, std::size_t nodes,
+                         std::size_t scalarBytes) {
+  m_nodes = SaturatingAdd(m_nodes, nodes);
+  if (m_nodes > m_limits.maxNodes) {
+    throw ParserException(mark, ErrorMsg::TOO_MANY_NODES);
+  }
+  m_scalarBytes = SaturatingAdd(m_scalarBytes, scalarBytes);
+  if (m_scalarBytes > m_limits.maxScalarBytes) {
+    throw ParserException(mark, ErrorMsg::TOO_MUCH_SCALAR);
+  }
+}
+
+void DocumentLimits::Define(anchor_t anchor, std::size_t nodes,
+                            std::size_t scalarBytes) {
+  if (anchor == NullAnchor) {
+    return;
+  }
+  if (anchor >= m_anchors.size()) {
+    const Expansion none = {false, 0, 0};
+    m_anchors.resize(anchor + 1, none);
+  }
+  const Expansion expansion = {true, nodes, scalarBytes};
+  m_anchors[anchor] = expansion;
+}
+}
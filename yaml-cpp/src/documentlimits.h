@@ -0,0 +1,67 @@
+#ifndef DOCUMENTLIMITS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define DOCUMENTLIMITS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <vector>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/eventcursor.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/noncopyable.h"
+#include "yaml-cpp/parselimits.h"
+
+namespace YAML {
+/**
+ * Counts one document's events against a {@link ParseLimits}, as they're
+ * parsed. It keeps how much each anchor's node held, so that an alias adds
+ * what it would have if it were expanded, in constant time.
+ */
+class DocumentLimits : private noncopyable {
+ public:
+  explicit DocumentLimits(const ParseLimits& limits);
+
+  /**
+   * Counts the next event: {@code anchor} is the node's own for a node, and
+   * the one it refers to for an alias, and {@code scalarBytes} is the size
+   * of a scalar's text.
+   *
+   * @throw a ParserException, at {@code mark}, if it passes a limit.
+   */
+  void Count(EventType::value type, const Mark& mark, anchor_t anchor,
+             std::size_t scalarBytes = 0);
+
+ private:
+  // a collection that's open, and the counts from before it started
+  struct Open {
+    anchor_t anchor;
+    std::size_t nodes;
+    std::size_t scalarBytes;
+  };
+
+  // what an anchor's node held, once it's complete
+  struct Expansion {
+    bool complete;
+    std::size_t nodes;
+    std::size_t scalarBytes;
+  };
+
+  void Add(const Mark& mark, std::size_t nodes, std::size_t scalarBytes);
+  void Define(anchor_t anchor, std::size_t nodes, std::size_t scalarBytes);
+
+ private:
+  ParseLimits m_limits;
+  std::size_t m_nodes;
+  std::size_t m_scalarBytes;
+  std::size_t m_aliases;
+  std::vector<Open> m_open;
+  std::vector<Expansion> m_anchors;  // by anchor
+};
+}
+
+#endif  // DOCUMENTLIMITS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
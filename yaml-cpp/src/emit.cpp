@@ -1,9 +1,234 @@
 #include "yaml-cpp/node/emit.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 #include "yaml-cpp/emitfromevents.h"
 #include "yaml-cpp/emitter.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/type.h"
+#include "emitparallel.h"
 #include "nodeevents.h"
+#include "parallel.h"
 
 namespace YAML {
+namespace {
+// TreeEvents
+// . Replays a tree's events, as NodeEvents does, for a tree without aliases
+//   (so without anchors); and without materializing its scalars, so that
+//   several threads can replay parts of the same tree at once.
+class TreeEvents {
+ public:
+  explicit TreeEvents(EventHandler& handler) : m_handler(handler) {}
+
+  void operator()(const detail::node& node) {
+    switch (node.type()) {
+      case NodeType::Undefined:
+        break;
+      case NodeType::Null:
+        m_handler.OnNull(Mark(), NullAnchor);
+        break;
+      case NodeType::Scalar: {
+        const StringRef scalar = node.scalar_ref();
+        m_scalar.assign(scalar.data(), scalar.size());
+        m_handler.OnScalar(Mark(), node.tag(), NullAnchor, m_scalar);
+        break;
+      }
+      case NodeType::Sequence:
+      case NodeType::Map:
+        Start(node);
+        for (detail::const_node_iterator it = node.begin(); it != node.end();
+             ++it)
+          Entry(*it);
+        End(node);
+        break;
+    }
+  }
+
+  void Start(const detail::node& collection) {
+    if (collection.type() == NodeType::Sequence)
+      m_handler.OnSequenceStart(Mark(), collection.tag(), NullAnchor,
+                                collection.style());
+    else
+      m_handler.OnMapStart(Mark(), collection.tag(), NullAnchor,
+                           collection.style());
+  }
+
+  void Entry(const detail::const_node_iterator::value_type& entry) {
+    if (entry.pNode) {
+      (*this)(*entry.pNode);
+    } else {
+      (*this)(*entry.first);
+      (*this)(*entry.second);
+    }
+  }
+
+  // an entry that stands in for the ones before a run, so that the run is
+  // emitted as it would be after them
+  void Placeholder(const detail::node& collection) {
+    m_handler.OnNull(Mark(), NullAnchor);
+    if (collection.type() == NodeType::Map)
+      m_handler.OnNull(Mark(), NullAnchor);
+  }
+
+  void End(const detail::node& collection) {
+    if (collection.type() == NodeType::Sequence)
+      m_handler.OnSequenceEnd();
+    else
+      m_handler.OnMapEnd();
+  }
+
+ private:
+  EventHandler& m_handler;
+  std::string m_scalar;
+};
+
+const detail::node& Child(
+    const detail::const_node_iterator::value_type& entry) {
+  return entry.pNode ? *entry.pNode : *entry.second;
+}
+
+bool IsBlockCollection(const detail::node& node) {
+  return (node.type() == NodeType::Sequence ||
+          node.type() == NodeType::Map) &&
+         node.style() != EmitterStyle::Flow && node.begin() != node.end();
+}
+
+std::size_t CountNodes(const detail::node& node) {
+  std::size_t count = 1;
+  for (detail::const_node_iterator it = node.begin(); it != node.end(); ++it) {
+    if (it->pNode) {
+      count += CountNodes(*it->pNode);
+    } else {
+      count += CountNodes(*it->first) + CountNodes(*it->second);
+    }
+  }
+  return count;
+}
+
+// Split
+// . Where a tree is cut up to be emitted in parallel: the path from the root
+//   down to one large block collection (and the entry of each collection on
+//   the way that leads on), and where each run of its entries starts.
+struct Split {
+  std::vector<const detail::node*> path;
+  std::vector<detail::const_node_iterator> via;
+  std::vector<detail::const_node_iterator> runs;  // and then its end
+};
+
+// FindSplit
+// . Goes down from the root, through block collections, into whichever
+//   entry holds most of the tree, and splits the collection where no one
+//   entry does. Everything on the way must be in block style, since that's
+//   all that lets a run of entries be emitted the same way on its own: each
+//   one starts on a new line, whatever came before it.
+// . Runs start at defined entries (an undefined one emits nothing), so that
+//   the first isn't empty. Like the parser's chunks, they aim for a few per
+//   thread, so that uneven ones even out, but not so short that setting up
+//   an emitter for each one starts to show; and there's no point unless
+//   there are at least two.
+bool FindSplit(const detail::node& root, unsigned threads,
+               std::size_t minRunSize, Split& split) {
+  const std::size_t RunsPerThread = 8;
+  const detail::node* pNode = &root;
+  std::size_t nodes = CountNodes(root);
+  while (true) {
+    if (!IsBlockCollection(*pNode))
+      return false;
+    split.path.push_back(pNode);
+
+    detail::const_node_iterator largest = pNode->end();
+    std::size_t largestNodes = 0;
+    for (detail::const_node_iterator it = pNode->begin(); it != pNode->end();
+         ++it) {
+      const std::size_t count = CountNodes(Child(*it));
+      if (count > largestNodes) {
+        largest = it;
+        largestNodes = count;
+      }
+    }
+    if (largestNodes <= nodes / 2)
+      break;
+    split.via.push_back(largest);
+    pNode = &Child(*largest);
+    nodes = largestNodes;
+  }
+
+  const detail::node& collection = *pNode;
+  const std::size_t runSize =
+      std::max(minRunSize, nodes / (threads * RunsPerThread));
+  std::size_t count = 0;
+  bool defined = false;
+  for (detail::const_node_iterator it = collection.begin();
+       it != collection.end(); ++it) {
+    const bool isDefined = !it->pNode || it->pNode->is_defined();
+    if (split.runs.empty() || (count >= runSize && defined && isDefined)) {
+      split.runs.push_back(it);
+      count = 0;
+      defined = false;
+    }
+    defined = defined || isDefined;
+    count += it->pNode ? CountNodes(*it->pNode)
+                       : CountNodes(*it->first) + CountNodes(*it->second);
+  }
+  split.runs.push_back(collection.end());
+  return split.runs.size() > 2;
+}
+
+// EmitFirstRun
+// . Emits the whole tree, but with only the first run of the split
+//   collection's entries; returns where, in the output, the rest of them go.
+std::size_t EmitFirstRun(const Split& split, std::size_t level, Emitter& out,
+                         TreeEvents& events) {
+  const detail::node& node = *split.path[level];
+  std::size_t cut = 0;
+  events.Start(node);
+  if (level + 1 == split.path.size()) {
+    for (detail::const_node_iterator it = split.runs[0]; it != split.runs[1];
+         ++it)
+      events.Entry(*it);
+    cut = out.size();
+  } else {
+    for (detail::const_node_iterator it = node.begin(); it != node.end();
+         ++it) {
+      if (it != split.via[level]) {
+        events.Entry(*it);
+        continue;
+      }
+      if (it->first)
+        events(*it->first);
+      cut = EmitFirstRun(split, level + 1, out, events);
+    }
+  }
+  events.End(node);
+  return cut;
+}
+
+// EmitRun
+// . Emits just the path down to the split collection, a placeholder entry,
+//   and then one of its runs; returns where the run starts in the output.
+std::size_t EmitRun(const Split& split, std::size_t run, TreeEvents& events,
+                    const Emitter& out) {
+  for (std::size_t i = 0; i < split.via.size(); i++) {
+    events.Start(*split.path[i]);
+    if (split.via[i]->first)
+      events(*split.via[i]->first);
+  }
+  const detail::node& collection = *split.path.back();
+  events.Start(collection);
+  events.Placeholder(collection);
+  const std::size_t start = out.size();
+  for (detail::const_node_iterator it = split.runs[run];
+       it != split.runs[run + 1]; ++it)
+    events.Entry(*it);
+  return start;
+}
+}
+
 Emitter& operator<<(Emitter& out, const Node& node) {
   EmitFromEvents emitFromEvents(out);
   NodeEvents events(node);
@@ -22,4 +247,71 @@ std::string Dump(const Node& node) {
   emitter << node;
   return emitter.c_str();
 }
+
+std::string DumpParallel(const Node& node, unsigned threads) {
+  const std::size_t MinRunSize = 4096;
+  return DumpInRuns(node, threads, MinRunSize);
+}
+
+std::string DumpInRuns(const Node& node, unsigned threads,
+                       std::size_t minRunSize) {
+  if (threads == 0) {
+    threads = DefaultThreadCount();
+  }
+  if (threads == 1) {
+    return Dump(node);
+  }
+
+  NodeEvents events(node);
+  Split split;
+  if (!events.Root() || events.HasAliases() ||
+      !FindSplit(*events.Root(), threads, minRunSize, split)) {
+    Emitter emitter;
+    EmitFromEvents emitFromEvents(emitter);
+    events.Emit(emitFromEvents);
+    return emitter.c_str();
+  }
+
+  // each run is emitted on its own, and the first one along with everything
+  // around the split collection; if any of them fails (the emitter gives up
+  // on, say, a bad tag) the whole tree is emitted again, sequentially, to
+  // fail the same way
+  const std::size_t runs = split.runs.size() - 1;
+  std::vector<std::string> text(runs);
+  std::size_t cut = 0;
+  std::vector<char> failed(runs, 0);
+  ParallelFor(runs, threads, [&](std::size_t i) {
+    try {
+      Emitter out;
+      EmitFromEvents emitFromEvents(out);
+      TreeEvents tree(emitFromEvents);
+      if (i == 0) {
+        cut = EmitFirstRun(split, 0, out, tree);
+        text[i].assign(out.c_str(), out.size());
+      } else {
+        const std::size_t start = EmitRun(split, i, tree, out);
+        text[i].assign(out.c_str() + start, out.size() - start);
+      }
+      failed[i] = !out.good();
+    } catch (...) {
+      failed[i] = 1;
+    }
+  });
+  if (std::find(failed.begin(), failed.end(), 1) != failed.end()) {
+    return Dump(node);
+  }
+
+  std::size_t size = text[0].size();
+  for (std::size_t i = 1; i < runs; i++) {
+    size += text[i].size();
+  }
+  std::string all;
+  all.reserve(size);
+  all.append(text[0], 0, cut);
+  for (std::size_t i = 1; i < runs; i++) {
+    all += text[i];
+  }
+  all.append(text[0], cut, std::string::npos);
+  return all;
+}
 }  // namespace YAML
@@ -0,0 +1,25 @@
+#ifndef EMITPARALLEL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define EMITPARALLEL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+
+namespace YAML {
+class Node;
+
+/**
+ * Does the work of {@link DumpParallel}, with runs of at least
+ * {@code minRunSize} nodes (which tests can make small enough to split small
+ * documents).
+ */
+std::string DumpInRuns(const Node& node, unsigned threads,
+                       std::size_t minRunSize);
+}
+
+#endif  // EMITPARALLEL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
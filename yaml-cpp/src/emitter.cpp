@@ -1,4 +1,5 @@
 #include <sstream>
+#include <type_traits>
 
 #include "emitterutils.h"
 #include "indentation.h"  // IWYU pragma: keep
@@ -16,16 +17,25 @@ Emitter::Emitter() : m_pState(new EmitterState) {}
 Emitter::Emitter(std::ostream& stream)
     : m_pState(new EmitterState), m_stream(stream) {}
 
+Emitter::Emitter(int fd) : m_pState(new EmitterState), m_stream(fd) {}
+
 Emitter::~Emitter() {}
 
 const char* Emitter::c_str() const { return m_stream.str(); }
 
 std::size_t Emitter::size() const { return m_stream.pos(); }
 
+bool Emitter::Flush() {
+  m_stream.flush();
+  return good();
+}
+
 // state checking
-bool Emitter::good() const { return m_pState->good(); }
+bool Emitter::good() const { return m_pState->good() && m_stream.good(); }
 
 const std::string Emitter::GetLastError() const {
+  if (m_pState->good() && !m_stream.good())
+    return ErrorMsg::OUTPUT_FAILED;
   return m_pState->GetLastError();
 }
 
@@ -650,6 +660,73 @@ void Emitter::SpaceOrIndentTo(bool requireSpace, std::size_t indent) {
   m_stream << IndentTo(indent);
 }
 
+namespace {
+template <typename T>
+bool IsNegative(T value, std::true_type /* is_signed */) {
+  return value < 0;
+}
+
+template <typename T>
+bool IsNegative(T, std::false_type /* is_signed */) {
+  return false;
+}
+
+// WriteIntegral
+// . Writes a number as a stream would: negative in decimal, and as the bits
+//   of its own size otherwise.
+template <typename T>
+void WriteIntegral(ostream_wrapper& out, T value, EMITTER_MANIP intFormat) {
+  typedef typename std::make_unsigned<T>::type Unsigned;
+  const bool negative = intFormat == Dec &&
+                        IsNegative(value, std::is_signed<T>());
+  const unsigned long long magnitude =
+      negative
+          ? 0 - static_cast<unsigned long long>(static_cast<long long>(value))
+          : static_cast<Unsigned>(value);
+  Utils::WriteInteger(out, magnitude, negative, intFormat);
+}
+}
+
+void Emitter::WriteIntegralValue(short value) {
+  WriteIntegral(m_stream, value, m_pState->GetIntFormat());
+}
+
+void Emitter::WriteIntegralValue(unsigned short value) {
+  WriteIntegral(m_stream, value, m_pState->GetIntFormat());
+}
+
+void Emitter::WriteIntegralValue(int value) {
+  WriteIntegral(m_stream, value, m_pState->GetIntFormat());
+}
+
+void Emitter::WriteIntegralValue(unsigned int value) {
+  WriteIntegral(m_stream, value, m_pState->GetIntFormat());
+}
+
+void Emitter::WriteIntegralValue(long value) {
+  WriteIntegral(m_stream, value, m_pState->GetIntFormat());
+}
+
+void Emitter::WriteIntegralValue(unsigned long value) {
+  WriteIntegral(m_stream, value, m_pState->GetIntFormat());
+}
+
+void Emitter::WriteIntegralValue(long long value) {
+  WriteIntegral(m_stream, value, m_pState->GetIntFormat());
+}
+
+void Emitter::WriteIntegralValue(unsigned long long value) {
+  WriteIntegral(m_stream, value, m_pState->GetIntFormat());
+}
+
+void Emitter::WriteStreamableValue(float value) {
+  Utils::WriteFloat(m_stream, value, GetFloatPrecision());
+}
+
+void Emitter::WriteStreamableValue(double value) {
+  Utils::WriteFloat(m_stream, value, GetDoublePrecision());
+}
+
 void Emitter::PrepareIntegralStream(std::stringstream& stream) const {
 
   switch (m_pState->GetIntFormat()) {
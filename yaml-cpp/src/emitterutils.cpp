@@ -1,4 +1,10 @@
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 
 #include "emitterutils.h"
@@ -151,78 +157,164 @@ void WriteCodePoint(ostream_wrapper& out, int codePoint) {
   }
 }
 
-bool IsValidPlainScalar(const std::string& str, FlowType::value flowType,
-                        bool allowOnlyAscii) {
-  // check against null
-  if (IsNullString(str)) {
-    return false;
-  }
+// CharClass
+// . What each byte means for the styles a string can be written in; see
+//   ClassifyScalar.
+enum CharClass {
+  NOT_PLAIN = 1,          // can't be anywhere in a plain scalar
+  NOT_PLAIN_IN_FLOW = 2,  // ... in a flow collection
+  NOT_PLAIN_START = 4,    // can't start a plain scalar
+  NOT_PLAIN_START_IN_FLOW = 8,
+  PLAIN_START_CONTEXT = 16,  // ... depending on what follows it
+  PLAIN_CONTEXT = 32,        // depends on what's around it
+  NON_ASCII = 64,
+  NEWLINE = 128
+};
+
+class CharClassTable {
+ public:
+  CharClassTable() {
+    for (int ch = 0; ch < 256; ch++) {
+      m_classes[ch] = ch >= 0x80 ? NON_ASCII : 0;
+    }
 
-  // check the start
-  const RegEx& start = (flowType == FlowType::Flow ? Exp::PlainScalarInFlow()
-                                                   : Exp::PlainScalar());
-  if (!start.Matches(str)) {
-    return false;
-  }
+    // what isn't printable (Exp::NotPrintable), and tabs and breaks; a '\r'
+    // only breaks a line before a '\n'
+    for (int ch = 0; ch < 0x20; ch++) {
+      if (ch != '\r')
+        Add(static_cast<char>(ch), NOT_PLAIN);
+    }
+    Add('\x7F', NOT_PLAIN);
+    Add('\n', NEWLINE);
 
-  // and check the end for plain whitespace (which can't be faithfully kept in a
-  // plain scalar)
-  if (!str.empty() && *str.rbegin() == ' ') {
-    return false;
+    // the starts that Exp::PlainScalar and Exp::PlainScalarInFlow rule out
+    Add(" ,[]{}#&*!|>\'\"%@`", NOT_PLAIN_START | NOT_PLAIN_START_IN_FLOW);
+    Add("?", NOT_PLAIN_START_IN_FLOW);
+    Add("-?:", PLAIN_START_CONTEXT);
+
+    // Exp::EndScalarInFlow (and ':' and ' ', in any context)
+    Add(",?[]{}", NOT_PLAIN_IN_FLOW);
+    Add(": \xC2\xEF", PLAIN_CONTEXT);
   }
 
-  // then check until something is disallowed
-  static const RegEx& disallowed_flow =
-      Exp::EndScalarInFlow() || (Exp::BlankOrBreak() + Exp::Comment()) ||
-      Exp::NotPrintable() || Exp::Utf8_ByteOrderMark() || Exp::Break() ||
-      Exp::Tab();
-  static const RegEx& disallowed_block =
-      Exp::EndScalar() || (Exp::BlankOrBreak() + Exp::Comment()) ||
-      Exp::NotPrintable() || Exp::Utf8_ByteOrderMark() || Exp::Break() ||
-      Exp::Tab();
-  const RegEx& disallowed =
-      flowType == FlowType::Flow ? disallowed_flow : disallowed_block;
+  int operator[](char ch) const {
+    return m_classes[static_cast<unsigned char>(ch)];
+  }
 
-  StringCharSource buffer(str.c_str(), str.size());
-  while (buffer) {
-    if (disallowed.Matches(buffer)) {
-      return false;
-    }
-    if (allowOnlyAscii && (0x80 <= static_cast<unsigned char>(buffer[0]))) {
-      return false;
-    }
-    ++buffer;
+ private:
+  void Add(char ch, int classes) {
+    m_classes[static_cast<unsigned char>(ch)] |= classes;
+  }
+  void Add(const char* chars, int classes) {
+    for (; *chars; chars++)
+      Add(*chars, classes);
   }
 
-  return true;
+ private:
+  unsigned char m_classes[256];
+};
+
+const CharClassTable& CharClasses() {
+  static const CharClassTable table;
+  return table;
 }
 
-bool IsValidSingleQuotedScalar(const std::string& str, bool escapeNonAscii) {
-  // TODO: check for non-printable characters?
-  for (std::size_t i = 0; i < str.size(); i++) {
-    if (escapeNonAscii && (0x80 <= static_cast<unsigned char>(str[i]))) {
-      return false;
-    }
-    if (str[i] == '\n') {
+struct ScalarTraits {
+  bool plain;
+  bool plainInFlow;
+  bool newline;
+  bool nonAscii;
+};
+
+bool IsBlankOrBreakAt(const std::string& str, std::size_t i) {
+  if (i >= str.size())
+    return false;
+  switch (str[i]) {
+    case ' ':
+    case '\t':
+    case '\n':
+      return true;
+    case '\r':
+      return i + 1 < str.size() && str[i + 1] == '\n';
+    default:
       return false;
-    }
   }
-  return true;
 }
 
-bool IsValidLiteralScalar(const std::string& str, FlowType::value flowType,
-                          bool escapeNonAscii) {
-  if (flowType == FlowType::Flow) {
-    return false;
+// PlainInContext
+// . For the bytes marked PLAIN_CONTEXT (other than at the start), returns
+//   whether the plain scalar can go on past the one at i:
+//   ": " or ':' at the end (Exp::EndScalar), " #" (a comment), a character
+//   that isn't printable (Exp::NotPrintable), or a byte order mark.
+// . A ':' before a tab or a break, or (in a flow collection) before one of
+//   ",]}", is already ruled out by what follows it.
+bool PlainInContext(const std::string& str, std::size_t i) {
+  const std::size_t size = str.size();
+  switch (str[i]) {
+    case ':':
+      return i + 1 < size && str[i + 1] != ' ';
+    case ' ':
+      return i + 1 == size || str[i + 1] != '#';
+    case '\xC2':
+      if (i + 1 < size) {
+        const unsigned char next = static_cast<unsigned char>(str[i + 1]);
+        return next < 0x80 || next == 0x85 || next > 0x9F;
+      }
+      return true;
+    case '\xEF':
+      return i + 2 >= size || str[i + 1] != '\xBB' || str[i + 2] != '\xBF';
+    default:
+      return true;
   }
+}
 
-  // TODO: check for non-printable characters?
-  for (std::size_t i = 0; i < str.size(); i++) {
-    if (escapeNonAscii && (0x80 <= static_cast<unsigned char>(str[i]))) {
-      return false;
+// ClassifyScalar
+// . Works out, in a single pass with a table lookup per byte, everything
+//   that ComputeStringFormat needs to know about a string: whether it can
+//   be plain (in a block or a flow collection), and whether it has
+//   newlines or non-ASCII characters.
+// . A plain scalar follows the rules of Exp::PlainScalar (or
+//   Exp::PlainScalarInFlow) at the start, and then can't have anything in
+//   it that would end it early, or that isn't printable; it can't be a
+//   null, or end in a space.
+ScalarTraits ClassifyScalar(const std::string& str) {
+  const CharClassTable& classes = CharClasses();
+  const std::size_t size = str.size();
+  ScalarTraits traits = {true, true, false, false};
+
+  if (IsNullString(str) || str[size - 1] == ' ') {
+    traits.plain = traits.plainInFlow = false;
+  } else {
+    const int start = classes[str[0]];
+    if (start & NOT_PLAIN_START)
+      traits.plain = false;
+    if (start & NOT_PLAIN_START_IN_FLOW)
+      traits.plainInFlow = false;
+    if (start & PLAIN_START_CONTEXT) {
+      // "-?:" before a blank or a break, or on its own; in a flow
+      // collection, "-:" before a blank
+      if (size == 1 || IsBlankOrBreakAt(str, 1))
+        traits.plain = false;
+      if (str[0] != '?' && size > 1 && (str[1] == ' ' || str[1] == '\t'))
+        traits.plainInFlow = false;
     }
   }
-  return true;
+
+  int all = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    const int c = classes[str[i]];
+    all |= c;
+    if ((c & PLAIN_CONTEXT) && !PlainInContext(str, i))
+      all |= NOT_PLAIN | NOT_PLAIN_IN_FLOW;
+  }
+
+  if (all & NOT_PLAIN)
+    traits.plain = traits.plainInFlow = false;
+  if (all & NOT_PLAIN_IN_FLOW)
+    traits.plainInFlow = false;
+  traits.newline = (all & NEWLINE) != 0;
+  traits.nonAscii = (all & NON_ASCII) != 0;
+  return traits;
 }
 
 void WriteDoubleQuoteEscapeSequence(ostream_wrapper& out, int codePoint) {
@@ -258,27 +350,86 @@ bool WriteAliasName(ostream_wrapper& out, const std::string& str) {
   }
   return true;
 }
+
+bool ReadsBack(const char* str, float value) {
+  return std::strtof(str, NULL) == value;
+}
+
+bool ReadsBack(const char* str, double value) {
+  return std::strtod(str, NULL) == value;
+}
+
+// WriteFloatingPoint
+// . Writes what a stream would, with snprintf (which is what the stream uses
+//   too), but always with a '.' for the decimal point, regardless of the C
+//   locale.
+// . For the shortest form, tries the precisions from digits10 up; any
+//   shorter form that reads back would be what %g writes at digits10 (with
+//   its trailing zeros dropped), so the first one that reads back is it.
+//   That doesn't hold for subnormals, which have fewer digits, so they're
+//   tried from 1.
+template <typename T>
+void WriteFloatingPoint(ostream_wrapper& out, T value, std::size_t precision) {
+  char buffer[64];
+  int size = 0;
+  if (precision > 0 || value != value ||
+      value == std::numeric_limits<T>::infinity() ||
+      value == -std::numeric_limits<T>::infinity()) {
+    size = std::snprintf(buffer, sizeof(buffer), "%.*g",
+                         static_cast<int>(precision), value);
+  } else {
+    const bool subnormal =
+        value != 0 && std::fabs(value) < std::numeric_limits<T>::min();
+    for (int digits = subnormal ? 1 : std::numeric_limits<T>::digits10;;
+         digits++) {
+      size = std::snprintf(buffer, sizeof(buffer), "%.*g", digits, value);
+      if (digits >= std::numeric_limits<T>::max_digits10 ||
+          ReadsBack(buffer, value))
+        break;
+    }
+  }
+  if (size < 0)
+    return;
+  if (static_cast<std::size_t>(size) >= sizeof(buffer))
+    size = sizeof(buffer) - 1;
+
+  const char* point = std::localeconv()->decimal_point;
+  if (point[0] != '.' || point[1] != '\0') {
+    char* pos = std::strstr(buffer, point);
+    if (pos) {
+      const std::size_t length = std::strlen(point);
+      *pos = '.';
+      std::memmove(pos + 1, pos + length, buffer + size - (pos + length));
+      size -= static_cast<int>(length - 1);
+    }
+  }
+  out.write(buffer, static_cast<std::size_t>(size));
+}
 }
 
 StringFormat::value ComputeStringFormat(const std::string& str,
                                         EMITTER_MANIP strFormat,
                                         FlowType::value flowType,
                                         bool escapeNonAscii) {
+  const ScalarTraits traits = ClassifyScalar(str);
+  const bool flow = flowType == FlowType::Flow;
+  const bool escaped = escapeNonAscii && traits.nonAscii;
+
   switch (strFormat) {
     case Auto:
-      if (IsValidPlainScalar(str, flowType, escapeNonAscii)) {
+      if ((flow ? traits.plainInFlow : traits.plain) && !escaped) {
         return StringFormat::Plain;
       }
       return StringFormat::DoubleQuoted;
     case SingleQuoted:
-      if (IsValidSingleQuotedScalar(str, escapeNonAscii)) {
+      if (!traits.newline && !escaped) {
         return StringFormat::SingleQuoted;
       }
       return StringFormat::DoubleQuoted;
     case DoubleQuoted:
       return StringFormat::DoubleQuoted;
     case Literal:
-      if (IsValidLiteralScalar(str, flowType, escapeNonAscii)) {
+      if (!flow && !escaped) {
         return StringFormat::Literal;
       }
       return StringFormat::DoubleQuoted;
@@ -475,9 +626,54 @@ bool WriteTagWithPrefix(ostream_wrapper& out, const std::string& prefix,
 }
 
 bool WriteBinary(ostream_wrapper& out, const Binary& binary) {
-  WriteDoubleQuotedString(out, EncodeBase64(binary.data(), binary.size()),
-                          false);
+  // base64 never needs escaping, so it's written as it is
+  const std::string encoded = EncodeBase64(binary.data(), binary.size());
+  out << "\"";
+  out.write(encoded);
+  out << "\"";
   return true;
 }
+void WriteInteger(ostream_wrapper& out, unsigned long long value,
+                  bool negative, EMITTER_MANIP intFormat) {
+  static const char hexDigits[] = "0123456789abcdef";
+
+  char buffer[32];
+  char* const end = buffer + sizeof(buffer);
+  char* p = end;
+  switch (intFormat) {
+    case Hex:
+      do {
+        *--p = hexDigits[value & 0xF];
+        value >>= 4;
+      } while (value > 0);
+      *--p = 'x';
+      *--p = '0';
+      break;
+    case Oct:
+      do {
+        *--p = static_cast<char>('0' + (value & 7));
+        value >>= 3;
+      } while (value > 0);
+      *--p = '0';
+      break;
+    default:
+      do {
+        *--p = static_cast<char>('0' + value % 10);
+        value /= 10;
+      } while (value > 0);
+      if (negative)
+        *--p = '-';
+      break;
+  }
+  out.write(p, static_cast<std::size_t>(end - p));
+}
+
+void WriteFloat(ostream_wrapper& out, float value, std::size_t precision) {
+  WriteFloatingPoint(out, value, precision);
+}
+
+void WriteFloat(ostream_wrapper& out, double value, std::size_t precision) {
+  WriteFloatingPoint(out, value, precision);
+}
 }
 }
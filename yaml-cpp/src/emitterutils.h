@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <string>
 
 #include "emitterstate.h"
@@ -44,6 +45,14 @@ bool WriteTag(ostream_wrapper& out, const std::string& str, bool verbatim);
 bool WriteTagWithPrefix(ostream_wrapper& out, const std::string& prefix,
                         const std::string& tag);
 bool WriteBinary(ostream_wrapper& out, const Binary& binary);
+
+// writes the digits of a number, in the given base (Dec, Hex or Oct)
+void WriteInteger(ostream_wrapper& out, unsigned long long value,
+                  bool negative, EMITTER_MANIP intFormat);
+// writes a number with the given number of significant digits, as a stream
+// would; 0 means the fewest that read back as the same value
+void WriteFloat(ostream_wrapper& out, float value, std::size_t precision);
+void WriteFloat(ostream_wrapper& out, double value, std::size_t precision);
 }
 }
 
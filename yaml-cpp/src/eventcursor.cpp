@@ -0,0 +1,155 @@
+#include "yaml-cpp/eventcursor.h"
+
+#include <cassert>
+
+#include "directives.h"  // IWYU pragma: keep
+#include "scanner.h"     // IWYU pragma: keep
+#include "singledocparser.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+
+namespace YAML {
+EventCursor::EventCursor(std::istream& in)
+    : m_parser(in), m_pEvent(new ParserEvent), m_hasEvent(false) {}
+
+EventCursor::EventCursor(std::shared_ptr<const std::string> input)
+    : m_parser(std::move(input)),
+      m_pEvent(new ParserEvent),
+      m_hasEvent(false) {}
+
+EventCursor::~EventCursor() {}
+
+bool EventCursor::Next() {
+  m_hasEvent = false;
+  if (!m_parser.m_pScanner)
+    return false;
+
+  while (1) {
+    if (!m_pDocument) {
+      m_parser.ParseDirectives();
+      if (m_parser.m_pScanner->empty())
+        return false;
+      m_pDocument.reset(
+          new SingleDocParser(*m_parser.m_pScanner, *m_parser.m_pDirectives));
+    }
+
+    if (m_pDocument->NextEvent(*m_pEvent)) {
+      m_hasEvent = true;
+      return true;
+    }
+
+    // on to the next document (if any)
+    m_pDocument.reset();
+  }
+}
+
+void EventCursor::Skip() {
+  if (m_hasEvent)
+    m_pDocument->SkipCollection(*m_pEvent);
+}
+
+// ReadNumbers
+// . Takes plain entries straight from the parser for as long as it has them,
+//   and events otherwise; only the events that end the sequence, and those
+//   in the way of a nested collection, are ever made.
+// . Carries on to the end after an entry that isn't a number, so that the
+//   cursor is somewhere sensible when that's thrown.
+template <typename T>
+bool EventCursor::ReadNumbers(std::vector<T>& values) {
+  if (!m_hasEvent || m_pEvent->type != EventType::SequenceStart)
+    return false;
+
+  const std::size_t depth = Depth();
+  bool failed = false;
+  YAML::Mark failure;
+  while (true) {
+    StringRef scalar;
+    YAML::Mark mark;
+    if (!m_pDocument->NextPlainEntry(scalar, mark)) {
+      if (!Next() || Depth() < depth)
+        break;
+      mark = m_pEvent->mark;
+      if (m_pEvent->type == EventType::Scalar)
+        scalar = ScalarRef();
+      else
+        Skip();
+    }
+    if (failed)
+      continue;
+
+    T value;
+    if (scalar.valid() && conversion::DecodeNumber(scalar, value)) {
+      values.push_back(value);
+    } else {
+      failed = true;
+      failure = mark;
+    }
+  }
+
+  if (failed)
+    throw TypedBadConversion<T>(failure);
+  return true;
+}
+
+template YAML_CPP_API bool EventCursor::ReadNumbers(std::vector<char>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(std::vector<signed char>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(
+    std::vector<unsigned char>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(std::vector<short>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(
+    std::vector<unsigned short>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(std::vector<int>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(std::vector<unsigned>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(std::vector<long>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(
+    std::vector<unsigned long>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(std::vector<long long>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(
+    std::vector<unsigned long long>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(std::vector<float>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(std::vector<double>&);
+template YAML_CPP_API bool EventCursor::ReadNumbers(
+    std::vector<long double>&);
+
+EventType::value EventCursor::Type() const {
+  assert(m_hasEvent);
+  return m_pEvent->type;
+}
+
+const Mark& EventCursor::Mark() const {
+  assert(m_hasEvent);
+  return m_pEvent->mark;
+}
+
+const std::string& EventCursor::Tag() const {
+  assert(m_hasEvent);
+  return m_pEvent->tag;
+}
+
+anchor_t EventCursor::Anchor() const {
+  assert(m_hasEvent);
+  return m_pEvent->anchor;
+}
+
+EmitterStyle::value EventCursor::Style() const {
+  assert(m_hasEvent);
+  return m_pEvent->style;
+}
+
+std::string EventCursor::Scalar() const {
+  return ScalarRef().str();
+}
+
+StringRef EventCursor::ScalarRef() const {
+  assert(m_hasEvent);
+  if (m_pEvent->scalarRef.valid())
+    return m_pEvent->scalarRef;
+  if (m_pEvent->pScalar)
+    return StringRef(*m_pEvent->pScalar);
+  return StringRef();
+}
+
+std::size_t EventCursor::Depth() const {
+  return m_pDocument ? m_pDocument->depth() : 0;
+}
+}
@@ -22,8 +22,11 @@ BadDereference::~BadDereference() YAML_CPP_NOEXCEPT {}
 BadSubscript::~BadSubscript() YAML_CPP_NOEXCEPT {}
 BadPushback::~BadPushback() YAML_CPP_NOEXCEPT {}
 BadInsert::~BadInsert() YAML_CPP_NOEXCEPT {}
+FrozenNode::~FrozenNode() YAML_CPP_NOEXCEPT {}
 EmitterException::~EmitterException() YAML_CPP_NOEXCEPT {}
 BadFile::~BadFile() YAML_CPP_NOEXCEPT {}
+BadPath::~BadPath() YAML_CPP_NOEXCEPT {}
+BadPackedData::~BadPackedData() YAML_CPP_NOEXCEPT {}
 }
 
 #undef YAML_CPP_NOEXCEPT
@@ -109,8 +109,11 @@ inline const RegEx& Value() {
   static const RegEx e = RegEx(':') + (BlankOrBreak() || RegEx());
   return e;
 }
+// wherever a plain scalar in flow ends at a ':' (see EndScalarInFlow), it's
+// a value; otherwise the ':' would start a scalar that ends before it starts
 inline const RegEx& ValueInFlow() {
-  static const RegEx e = RegEx(':') + (BlankOrBreak() || RegEx(",}", REGEX_OR));
+  static const RegEx e =
+      RegEx(':') + (BlankOrBreak() || RegEx() || RegEx(",]}", REGEX_OR));
   return e;
 }
 inline const RegEx& ValueInJSONFlow() {
@@ -182,6 +185,14 @@ inline const RegEx& EscSingleQuote() {
   static const RegEx e = RegEx("\'\'");
   return e;
 }
+inline const RegEx& EndSingleQuotedScalar() {
+  static const RegEx e = RegEx('\'') && !EscSingleQuote();
+  return e;
+}
+inline const RegEx& EndDoubleQuotedScalar() {
+  static const RegEx e = RegEx('\"');
+  return e;
+}
 inline const RegEx& EscBreak() {
   static const RegEx e = RegEx('\\') + Break();
   return e;
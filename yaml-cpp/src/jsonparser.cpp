@@ -0,0 +1,494 @@
+#include "jsonparser.h"
+
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
+#include "yaml-cpp/stringref.h"
+
+namespace YAML {
+namespace {
+// the tags the YAML parser gives JSON's nodes
+const std::string PlainTag = "?";
+const std::string QuotedTag = "!";
+
+// StringChars
+// . The characters that can appear in a string as they are: anything but a
+//   quote, a backslash, a control character or the start of a multi-byte
+//   character (which needs checking).
+struct StringChars {
+  StringChars() {
+    for (int ch = 0; ch < 256; ch++)
+      plain[ch] = ch >= 0x20 && ch < 0x80 && ch != '"' && ch != '\\';
+  }
+  bool plain[256];
+};
+
+const StringChars stringChars;
+
+inline bool IsDigit(char ch) { return '0' <= ch && ch <= '9'; }
+
+bool IsBOM(const std::string& input) {
+  return input.compare(0, 3, "\xEF\xBB\xBF") == 0;
+}
+
+// Utf8Length
+// . The length of the well-formed UTF-8 sequence at 'p', which starts with
+//   a byte of 0x80 or more, or 0 if it isn't one.
+std::size_t Utf8Length(const unsigned char* p, const unsigned char* end) {
+  std::size_t length = 0;
+  unsigned char low = 0x80, high = 0xBF;
+  if (p[0] >= 0xC2 && p[0] <= 0xDF) {
+    length = 2;
+  } else if (p[0] >= 0xE0 && p[0] <= 0xEF) {
+    length = 3;
+    if (p[0] == 0xE0)
+      low = 0xA0;
+    else if (p[0] == 0xED)
+      high = 0x9F;  // no surrogates
+  } else if (p[0] >= 0xF0 && p[0] <= 0xF4) {
+    length = 4;
+    if (p[0] == 0xF0)
+      low = 0x90;
+    else if (p[0] == 0xF4)
+      high = 0x8F;  // nothing past U+10FFFF
+  } else {
+    return 0;
+  }
+
+  if (static_cast<std::size_t>(end - p) < length || p[1] < low ||
+      p[1] > high)
+    return 0;
+  for (std::size_t i = 2; i < length; i++) {
+    if (p[i] < 0x80 || p[i] > 0xBF)
+      return 0;
+  }
+  return length;
+}
+
+void AppendUtf8(std::string& out, unsigned value) {
+  if (value <= 0x7F) {
+    out += static_cast<char>(value);
+  } else if (value <= 0x7FF) {
+    out += static_cast<char>(0xC0 + (value >> 6));
+    out += static_cast<char>(0x80 + (value & 0x3F));
+  } else if (value <= 0xFFFF) {
+    out += static_cast<char>(0xE0 + (value >> 12));
+    out += static_cast<char>(0x80 + ((value >> 6) & 0x3F));
+    out += static_cast<char>(0x80 + (value & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 + (value >> 18));
+    out += static_cast<char>(0x80 + ((value >> 12) & 0x3F));
+    out += static_cast<char>(0x80 + ((value >> 6) & 0x3F));
+    out += static_cast<char>(0x80 + (value & 0x3F));
+  }
+}
+}
+
+JsonParser::JsonParser(std::shared_ptr<const std::string> input,
+                       const ParseLimits* pLimits)
+    : m_pInput(std::move(input)),
+      m_line(0),
+      m_pLimits(pLimits ? new DocumentLimits(*pLimits) : nullptr) {
+  if (!m_pInput) {
+    m_pInput = std::make_shared<const std::string>();
+  }
+  m_begin = m_pInput->data() + (IsBOM(*m_pInput) ? 3 : 0);
+  m_cur = m_begin;
+  m_end = m_pInput->data() + m_pInput->size();
+  m_lineStart = m_begin;
+}
+
+bool JsonParser::LooksLikeJson(const std::string& input) {
+  for (std::size_t i = IsBOM(input) ? 3 : 0; i < input.size(); i++) {
+    switch (input[i]) {
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+        break;
+      case '{':
+      case '[':
+        return true;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+// HandleDocument
+// . Reads a value at a time, without recursing, so that deep nesting costs
+//   nothing but the stack of open collections: after each value, it closes
+//   whatever it finished, up to the separator before the next one.
+void JsonParser::HandleDocument(EventHandler& eventHandler) {
+  SkipWhitespace();
+  eventHandler.OnDocumentStart(Here());
+  m_inMap.clear();
+
+  while (1) {
+    if (Value(eventHandler)) {
+      continue;
+    }
+
+    while (!m_inMap.empty()) {
+      SkipWhitespace();
+      const bool inMap = m_inMap.back();
+      if (m_cur != m_end && *m_cur == ',') {
+        ++m_cur;
+        if (inMap) {
+          Key(eventHandler);
+        }
+        break;
+      }
+      if (m_cur == m_end || *m_cur != (inMap ? '}' : ']')) {
+        throw ParserException(Here(), inMap ? ErrorMsg::END_OF_MAP_FLOW
+                                            : ErrorMsg::END_OF_SEQ_FLOW);
+      }
+      ++m_cur;
+      m_inMap.pop_back();
+      Count(inMap ? EventType::MapEnd : EventType::SequenceEnd, Mark());
+      if (inMap) {
+        eventHandler.OnMapEnd();
+      } else {
+        eventHandler.OnSequenceEnd();
+      }
+    }
+
+    if (m_inMap.empty()) {
+      break;
+    }
+  }
+
+  SkipWhitespace();
+  if (m_cur != m_end) {
+    throw ParserException(Here(), ErrorMsg::JSON_TRAILING);
+  }
+  eventHandler.OnDocumentEnd();
+}
+
+// Value
+// . Reads a value; if it opens a collection that isn't empty, it reads up
+//   to its first value, and returns true.
+bool JsonParser::Value(EventHandler& eventHandler) {
+  SkipWhitespace();
+  if (m_cur == m_end) {
+    throw ParserException(Here(), ErrorMsg::JSON_VALUE);
+  }
+
+  switch (*m_cur) {
+    case '{':
+    case '[': {
+      const bool isMap = *m_cur == '{';
+      const Mark mark = Here();
+      ++m_cur;
+      Count(isMap ? EventType::MapStart : EventType::SequenceStart, mark);
+      if (isMap) {
+        eventHandler.OnMapStart(mark, PlainTag, NullAnchor,
+                                EmitterStyle::Flow);
+      } else {
+        eventHandler.OnSequenceStart(mark, PlainTag, NullAnchor,
+                                     EmitterStyle::Flow);
+      }
+
+      SkipWhitespace();
+      if (m_cur != m_end && *m_cur == (isMap ? '}' : ']')) {
+        ++m_cur;
+        Count(isMap ? EventType::MapEnd : EventType::SequenceEnd, Mark());
+        if (isMap) {
+          eventHandler.OnMapEnd();
+        } else {
+          eventHandler.OnSequenceEnd();
+        }
+        return false;
+      }
+      m_inMap.push_back(isMap);
+      if (isMap) {
+        Key(eventHandler);
+      }
+      return true;
+    }
+    case '"':
+      String(eventHandler);
+      return false;
+    case 't':
+      Literal(eventHandler, "true", 4);
+      return false;
+    case 'f':
+      Literal(eventHandler, "false", 5);
+      return false;
+    case 'n':
+      Literal(eventHandler, "null", 4);
+      return false;
+    default:
+      if (*m_cur == '-' || IsDigit(*m_cur)) {
+        Number(eventHandler);
+        return false;
+      }
+      throw ParserException(Here(), ErrorMsg::JSON_VALUE);
+  }
+}
+
+// Key
+// . Reads a map's key, and the ':' after it.
+void JsonParser::Key(EventHandler& eventHandler) {
+  SkipWhitespace();
+  if (m_cur == m_end || *m_cur != '"') {
+    throw ParserException(Here(), ErrorMsg::JSON_KEY);
+  }
+  String(eventHandler);
+
+  SkipWhitespace();
+  if (m_cur == m_end || *m_cur != ':') {
+    throw ParserException(Here(), ErrorMsg::JSON_COLON);
+  }
+  ++m_cur;
+}
+
+// String
+// . Scans ahead for the closing quote; if there's nothing to decode on the
+//   way, the string is reported as it is in the input.
+void JsonParser::String(EventHandler& eventHandler) {
+  const Mark mark = Here();
+  const char* const begin = ++m_cur;
+  bool decoded = false;
+  const char* copied = begin;  // how far the input's been copied to m_scalar
+
+  while (1) {
+    while (m_cur != m_end &&
+           stringChars.plain[static_cast<unsigned char>(*m_cur)]) {
+      ++m_cur;
+    }
+    if (m_cur == m_end) {
+      throw ParserException(Here(), ErrorMsg::EOF_IN_SCALAR);
+    }
+
+    const unsigned char ch = static_cast<unsigned char>(*m_cur);
+    if (ch == '"') {
+      break;
+    } else if (ch == '\\') {
+      if (!decoded) {
+        m_scalar.clear();
+        decoded = true;
+      }
+      m_scalar.append(copied, m_cur);
+      Decode();
+      copied = m_cur;
+    } else if (ch >= 0x80) {
+      const std::size_t length =
+          Utf8Length(reinterpret_cast<const unsigned char*>(m_cur),
+                     reinterpret_cast<const unsigned char*>(m_end));
+      if (length == 0) {
+        throw ParserException(Here(), ErrorMsg::CHAR_IN_SCALAR);
+      }
+      m_cur += length;
+    } else {
+      throw ParserException(Here(), ErrorMsg::CHAR_IN_SCALAR);
+    }
+  }
+
+  const char* const end = m_cur++;
+  if (!decoded) {
+    Count(EventType::Scalar, mark, end - begin);
+    eventHandler.OnScalarRef(mark, QuotedTag, NullAnchor,
+                             StringRef(begin, end - begin));
+    return;
+  }
+
+  // as the YAML parser does, offer the handler our copy, and keep a buffer
+  // the same size for the next one
+  m_scalar.append(copied, end);
+  Count(EventType::Scalar, mark, m_scalar.size());
+  const std::size_t capacity = m_scalar.capacity();
+  eventHandler.OnScalarMove(mark, QuotedTag, NullAnchor, std::move(m_scalar));
+  m_scalar.clear();
+  m_scalar.reserve(capacity);
+}
+
+// Decode
+// . Decodes the escape at the current position into m_scalar, and moves past
+//   it.
+void JsonParser::Decode() {
+  if (m_end - m_cur < 2) {
+    m_cur = m_end;
+    throw ParserException(Here(), ErrorMsg::EOF_IN_SCALAR);
+  }
+
+  const char ch = m_cur[1];
+  m_cur += 2;
+  switch (ch) {
+    case '"':
+    case '\\':
+    case '/':
+      m_scalar += ch;
+      return;
+    case 'b':
+      m_scalar += '\b';
+      return;
+    case 'f':
+      m_scalar += '\f';
+      return;
+    case 'n':
+      m_scalar += '\n';
+      return;
+    case 'r':
+      m_scalar += '\r';
+      return;
+    case 't':
+      m_scalar += '\t';
+      return;
+    case 'u':
+      break;
+    default:
+      throw ParserException(Here(),
+                            std::string(ErrorMsg::INVALID_ESCAPE) + ch);
+  }
+
+  // \uXXXX, and a high surrogate must be followed by a low one
+  unsigned value = 0;
+  for (int unit = 0; unit < 2; unit++) {
+    if (m_end - m_cur < 4) {
+      m_cur = m_end;
+      throw ParserException(Here(), ErrorMsg::EOF_IN_SCALAR);
+    }
+    unsigned code = 0;
+    for (int i = 0; i < 4; i++) {
+      const char digit = *m_cur++;
+      code <<= 4;
+      if (IsDigit(digit))
+        code += digit - '0';
+      else if ('a' <= digit && digit <= 'f')
+        code += digit - 'a' + 10;
+      else if ('A' <= digit && digit <= 'F')
+        code += digit - 'A' + 10;
+      else
+        throw ParserException(Here(), ErrorMsg::INVALID_HEX);
+    }
+
+    if (unit == 0 && code >= 0xD800 && code <= 0xDBFF &&
+        m_end - m_cur >= 2 && m_cur[0] == '\\' && m_cur[1] == 'u') {
+      value = code;
+      m_cur += 2;
+      continue;
+    }
+    if (unit == 1) {
+      if (code < 0xDC00 || code > 0xDFFF) {
+        std::stringstream msg;
+        msg << ErrorMsg::INVALID_UNICODE << value;
+        throw ParserException(Here(), msg.str());
+      }
+      code = 0x10000 + ((value - 0xD800) << 10) + (code - 0xDC00);
+    } else if (code >= 0xD800 && code <= 0xDFFF) {
+      std::stringstream msg;
+      msg << ErrorMsg::INVALID_UNICODE << code;
+      throw ParserException(Here(), msg.str());
+    }
+    AppendUtf8(m_scalar, code);
+    return;
+  }
+}
+
+// Number
+// . -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?, which is a plain scalar
+//   to YAML.
+void JsonParser::Number(EventHandler& eventHandler) {
+  const Mark mark = Here();
+  const char* const begin = m_cur;
+
+  if (*m_cur == '-') {
+    ++m_cur;
+  }
+  if (m_cur != m_end && *m_cur == '0') {
+    ++m_cur;
+  } else if (m_cur != m_end && IsDigit(*m_cur)) {
+    while (m_cur != m_end && IsDigit(*m_cur))
+      ++m_cur;
+  } else {
+    throw ParserException(Here(), ErrorMsg::JSON_NUMBER);
+  }
+
+  if (m_cur != m_end && *m_cur == '.') {
+    ++m_cur;
+    if (m_cur == m_end || !IsDigit(*m_cur)) {
+      throw ParserException(Here(), ErrorMsg::JSON_NUMBER);
+    }
+    while (m_cur != m_end && IsDigit(*m_cur))
+      ++m_cur;
+  }
+
+  if (m_cur != m_end && (*m_cur == 'e' || *m_cur == 'E')) {
+    ++m_cur;
+    if (m_cur != m_end && (*m_cur == '+' || *m_cur == '-')) {
+      ++m_cur;
+    }
+    if (m_cur == m_end || !IsDigit(*m_cur)) {
+      throw ParserException(Here(), ErrorMsg::JSON_NUMBER);
+    }
+    while (m_cur != m_end && IsDigit(*m_cur))
+      ++m_cur;
+  }
+
+  Count(EventType::Scalar, mark, m_cur - begin);
+  eventHandler.OnScalarRef(mark, PlainTag, NullAnchor,
+                           StringRef(begin, m_cur - begin));
+}
+
+void JsonParser::Literal(EventHandler& eventHandler, const char* text,
+                         std::size_t size) {
+  if (static_cast<std::size_t>(m_end - m_cur) < size ||
+      std::memcmp(m_cur, text, size) != 0) {
+    throw ParserException(Here(), ErrorMsg::JSON_VALUE);
+  }
+
+  const Mark mark = Here();
+  const char* const begin = m_cur;
+  m_cur += size;
+  if (*text == 'n') {
+    Count(EventType::Null, mark);
+    eventHandler.OnNull(mark, NullAnchor);
+  } else {
+    Count(EventType::Scalar, mark, size);
+    eventHandler.OnScalarRef(mark, PlainTag, NullAnchor,
+                             StringRef(begin, size));
+  }
+}
+
+void JsonParser::Count(EventType::value type, const Mark& mark,
+                       std::size_t scalarBytes) {
+  if (m_pLimits) {
+    m_pLimits->Count(type, mark, NullAnchor, scalarBytes);
+  }
+}
+
+void JsonParser::SkipWhitespace() {
+  for (; m_cur != m_end; ++m_cur) {
+    switch (*m_cur) {
+      case '\n':
+        m_line++;
+        m_lineStart = m_cur + 1;
+        break;
+      case ' ':
+      case '\t':
+      case '\r':
+        break;
+      default:
+        return;
+    }
+  }
+}
+
+// Here
+// . The mark at the current position; as in Stream, columns count bytes,
+//   and only '\n' starts a new line.
+Mark JsonParser::Here() const {
+  Mark mark;
+  mark.pos = static_cast<int>(m_cur - m_begin);
+  mark.line = m_line;
+  mark.column = static_cast<int>(m_cur - m_lineStart);
+  return mark;
+}
+}
@@ -0,0 +1,89 @@
+#ifndef JSONPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define JSONPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "documentlimits.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/noncopyable.h"
+
+namespace YAML {
+class EventHandler;
+
+/**
+ * Parses a single document of strict JSON (RFC 8259, in UTF-8) from
+ * memory-resident input, without going through the Scanner: there's no
+ * indentation or simple keys to track, and each token is known from its
+ * first character.
+ *
+ * It gives the same events, with the same marks, that {@link Parser} would
+ * for the same input: a string is a scalar tagged "!", a number, true or
+ * false is one tagged "?", null is a null, and arrays and objects are flow
+ * sequences and maps. Scalars with nothing to decode are reported by
+ * {@link EventHandler::OnScalarRef}, as references into the input.
+ *
+ * Strict JSON allows a few things that YAML doesn't, which it accepts: keys
+ * longer than 1024 characters, or on a different line from their ':',
+ * characters outside the BMP written as surrogate pairs, and a carriage
+ * return on its own as whitespace. And where the YAML parser keeps the
+ * whitespace after a number (or true, false or null) up to a tab, as part
+ * of the scalar, this leaves it out.
+ *
+ * If it's given {@link ParseLimits}, it holds the document to them, just
+ * as the YAML parser would.
+ */
+class JsonParser : private noncopyable {
+ public:
+  explicit JsonParser(std::shared_ptr<const std::string> input,
+                      const ParseLimits* pLimits = nullptr);
+
+  /**
+   * Whether the input might be JSON worth trying this on: it opens (after
+   * any byte order mark and whitespace) with an object or an array.
+   */
+  static bool LooksLikeJson(const std::string& input);
+
+  /**
+   * Handles the document by calling events on the {@code eventHandler}.
+   *
+   * @throw a ParserException if the input isn't strict JSON, or passes a
+   * limit; the events so far have been handled by then.
+   */
+  void HandleDocument(EventHandler& eventHandler);
+
+ private:
+  bool Value(EventHandler& eventHandler);
+  void Key(EventHandler& eventHandler);
+  void String(EventHandler& eventHandler);
+  void Decode();
+  void Number(EventHandler& eventHandler);
+  void Literal(EventHandler& eventHandler, const char* text, std::size_t size);
+  void Count(EventType::value type, const Mark& mark,
+             std::size_t scalarBytes = 0);
+  void SkipWhitespace();
+  Mark Here() const;
+
+ private:
+  std::shared_ptr<const std::string> m_pInput;
+  const char* m_begin;  // positions count from here, after any BOM
+  const char* m_cur;
+  const char* m_end;
+  int m_line;
+  const char* m_lineStart;
+
+  std::vector<bool> m_inMap;  // for each open collection
+  std::string m_scalar;       // a string with escapes, decoded
+
+  std::unique_ptr<DocumentLimits> m_pLimits;
+};
+}
+
+#endif  // JSONPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,26 +1,172 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "stringpool.h"
+#include "yaml-cpp/exceptions.h"
 #include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node.h"  // IWYU pragma: keep
 #include "yaml-cpp/node/ptr.h"
+#include "yaml-cpp/noncopyable.h"
 
 namespace YAML {
 namespace detail {
 
+// memory_group
+// . Owns everything that memories merged with each other (however
+//   indirectly) have allocated. A node in one can take on the ref or data
+//   of a node in another, and with them the arena that holds them, the
+//   string pool that holds its tag, and the input its scalar refers to; and
+//   either memory may be the last to go. So it all goes at once, along with
+//   the last of them.
+// . Groups merge by moving the smaller one's contents into the larger, and
+//   pointing the smaller one at it, so that the memories still holding the
+//   smaller one keep the larger one alive.
+struct memory_group : private noncopyable {
+  memory_group() {}
+  ~memory_group();
+
+  static std::shared_ptr<memory_group> root(
+      std::shared_ptr<memory_group> pGroup);
+  static std::shared_ptr<memory_group> merge(
+      const std::shared_ptr<memory_group>& pLhs,
+      const std::shared_ptr<memory_group>& pRhs);
+
+  std::size_t size() const {
+    return arenas.size() + stringPools.size() + nodes.size() + inputs.size();
+  }
+  void retain(const shared_input& input) {
+    if (std::find(inputs.begin(), inputs.end(), input) == inputs.end())
+      inputs.push_back(input);
+  }
+
+  // (declared first, so that they're released last)
+  std::vector<shared_arena> arenas;
+  std::vector<shared_string_pool> stringPools;
+  std::vector<shared_node> nodes;
+  std::vector<shared_input> inputs;
+
+  std::shared_ptr<memory_group> pMergedInto;
+};
+
+memory_group::~memory_group() {
+  // A node can share the ref or data of any other node here, and those may
+  // live in any of the arenas, so all the nodes go before any arena does.
+  nodes.clear();
+  for (std::size_t i = 0; i < arenas.size(); i++)
+    arenas[i]->destroy_nodes();
+}
+
+std::shared_ptr<memory_group> memory_group::root(
+    std::shared_ptr<memory_group> pGroup) {
+  while (pGroup->pMergedInto)
+    pGroup = pGroup->pMergedInto;
+  return pGroup;
+}
+
+std::shared_ptr<memory_group> memory_group::merge(
+    const std::shared_ptr<memory_group>& pLhs,
+    const std::shared_ptr<memory_group>& pRhs) {
+  std::shared_ptr<memory_group> pInto = root(pLhs);
+  std::shared_ptr<memory_group> pFrom = root(pRhs);
+  if (pInto == pFrom)
+    return pInto;
+  if (pInto->size() < pFrom->size())
+    std::swap(pInto, pFrom);
+
+  pInto->arenas.insert(pInto->arenas.end(), pFrom->arenas.begin(),
+                       pFrom->arenas.end());
+  pInto->stringPools.insert(pInto->stringPools.end(),
+                            pFrom->stringPools.begin(),
+                            pFrom->stringPools.end());
+  pInto->nodes.insert(pInto->nodes.end(), pFrom->nodes.begin(),
+                      pFrom->nodes.end());
+  for (std::size_t i = 0; i < pFrom->inputs.size(); i++)
+    pInto->retain(pFrom->inputs[i]);
+
+  pFrom->arenas.clear();
+  pFrom->stringPools.clear();
+  pFrom->nodes.clear();
+  pFrom->inputs.clear();
+  pFrom->pMergedInto = pInto;
+  return pInto;
+}
+
 void memory_holder::merge(memory_holder& rhs) {
   if (m_pMemory == rhs.m_pMemory)
     return;
+  if (frozen() || rhs.frozen())
+    throw FrozenNode();
 
   m_pMemory->merge(*rhs.m_pMemory);
   rhs.m_pMemory = m_pMemory;
 }
 
+memory::~memory() {}
+
+memory_group& memory::group() {
+  if (!m_pGroup)
+    m_pGroup = std::make_shared<memory_group>();
+  else if (m_pGroup->pMergedInto)
+    m_pGroup = memory_group::root(m_pGroup);
+  return *m_pGroup;
+}
+
 node& memory::create_node() {
+  if (m_frozen)
+    throw FrozenNode();
+  if (m_pArena)
+    return m_pArena->create_node();
+
   shared_node pNode(new node);
-  m_nodes.insert(pNode);
+  group().nodes.push_back(pNode);
+  m_nodes.insert(pNode.get());
   return *pNode;
 }
 
 void memory::merge(const memory& rhs) {
+  m_arenas.insert(rhs.m_arenas.begin(), rhs.m_arenas.end());
   m_nodes.insert(rhs.m_nodes.begin(), rhs.m_nodes.end());
+  if (!rhs.m_pGroup)
+    return;
+  if (!m_pGroup)
+    m_pGroup = memory_group::root(rhs.m_pGroup);
+  else
+    m_pGroup = memory_group::merge(m_pGroup, rhs.m_pGroup);
+}
+
+void memory::freeze() {
+  if (m_frozen)
+    return;
+
+  for (Nodes::const_iterator it = m_nodes.begin(); it != m_nodes.end(); ++it)
+    (*it)->freeze();
+  for (Arenas::const_iterator it = m_arenas.begin(); it != m_arenas.end();
+       ++it) {
+    const std::vector<node*>& nodes = (*it)->nodes();
+    for (std::size_t i = 0; i < nodes.size(); i++)
+      nodes[i]->freeze();
+  }
+  m_frozen = true;
+}
+
+void memory::use_arena() {
+  shared_arena pArena = std::make_shared<arena>();
+  group().arenas.push_back(pArena);
+  m_arenas.insert(pArena.get());
+  m_pArena = pArena.get();
 }
+
+const std::string& memory::intern(const StringRef& str) {
+  if (!m_pStrings) {
+    shared_string_pool pStrings = std::make_shared<string_pool>();
+    group().stringPools.push_back(pStrings);
+    m_pStrings = pStrings.get();
+  }
+  return m_pStrings->intern(str);
+}
+
+void memory::retain(const shared_input& input) { group().retain(input); }
 }
 }
@@ -1,12 +1,318 @@
 #include "yaml-cpp/node/node.h"
+
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "nodebuilder.h"
 #include "nodeevents.h"
+#include "stringpool.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/type.h"
 
 namespace YAML {
+namespace {
+// a plain scalar's "?" is what an untagged node has anyway
+const std::string& NormalTag(const detail::node& node) {
+  static const std::string none;
+  return node.tag() == "?" ? none : node.tag();
+}
+
+std::size_t Combine(std::size_t seed, std::size_t value) {
+  return seed ^ (value + static_cast<std::size_t>(0x9e3779b97f4a7c15ULL) +
+                 (seed << 6) + (seed >> 2));
+}
+
+// Spread
+// . Mixes all the bits of a hash into each other, so that summing them (which
+//   is how the entries of a map are combined, regardless of their order)
+//   doesn't lose much.
+std::size_t Spread(std::size_t hash) {
+  unsigned long long x = hash;
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return static_cast<std::size_t>(x);
+}
+
+// StructuralHash
+// . Hashes a tree in one traversal, keeping the hash of each frozen
+//   collection on the way.
+// . A collection that (through an alias) contains itself hashes as a
+//   constant, where it recurs; since what's around it then depends on where
+//   the traversal came in, nothing is kept for a collection that reaches
+//   one of those.
+// . A collection that an alias refers to is hashed once per traversal, and
+//   remembered for the rest of it, so that a tree of aliases to aliases costs
+//   what its distinct nodes do, rather than what it would expand to.
+class StructuralHash {
+ public:
+  StructuralHash() : m_cyclic(false) {}
+
+  std::size_t operator()(const detail::node& node) {
+    const NodeType::value type = node.type();
+    std::size_t hash = static_cast<std::size_t>(type);
+    switch (type) {
+      case NodeType::Undefined:
+      case NodeType::Null:
+        return hash;
+      case NodeType::Scalar:
+        hash = Combine(hash, detail::hash_string(node.scalar_ref()));
+        return Combine(hash, detail::hash_string(StringRef(NormalTag(node))));
+      case NodeType::Sequence:
+      case NodeType::Map:
+        break;
+    }
+
+    if (node.cached_hash(hash))
+      return hash;
+    const bool shared = node.is_shared();
+    if (shared) {
+      Memo::const_iterator it = m_memo.find(node.ref());
+      if (it != m_memo.end())
+        return it->second;
+    }
+    for (std::size_t i = 0; i < m_stack.size(); i++) {
+      if (m_stack[i] == node.ref()) {
+        m_cyclic = true;
+        return hash;
+      }
+    }
+
+    const bool wasCyclic = m_cyclic;
+    m_cyclic = false;
+    m_stack.push_back(node.ref());
+    hash = Combine(hash, detail::hash_string(StringRef(NormalTag(node))));
+    std::size_t entries = 0;
+    for (detail::const_node_iterator it = node.begin(); it != node.end();
+         ++it) {
+      const detail::const_node_iterator::value_type& entry = *it;
+      if (entry.pNode) {
+        hash = Combine(hash, (*this)(*entry.pNode));
+      } else if (entry.first && entry.second) {
+        const std::size_t key = (*this)(*entry.first);
+        entries += Spread(Combine(key, (*this)(*entry.second)));
+      }
+    }
+    if (type == NodeType::Map)
+      hash = Combine(hash, entries);
+    m_stack.pop_back();
+
+    if (!m_cyclic) {
+      node.cache_hash(hash);
+      if (shared)
+        m_memo[node.ref()] = hash;
+    }
+    m_cyclic = m_cyclic || wasCyclic;
+    return hash;
+  }
+
+ private:
+  typedef std::unordered_map<const detail::node_ref*, std::size_t> Memo;
+
+  std::vector<const detail::node_ref*> m_stack;
+  bool m_cyclic;  // since the current collection started
+  Memo m_memo;
+};
+
+// StructuralEquality
+// . Compares two trees, without looking further once the two sides are the
+//   same node_ref, or (for frozen collections that have been hashed) have
+//   different hashes.
+// . Maps are compared in whatever order the left side has; each of its
+//   entries is matched with an equal one on the right that isn't matched yet,
+//   looked for first at the same place, then by its key's text, and only then
+//   by searching the whole map. So a map with duplicate keys is equal to
+//   another just when its entries are, counting each one as often as it
+//   appears, which is also how it's hashed.
+// . A pair of collections that's already being compared (because of an alias
+//   cycle) is taken to be equal, where it recurs.
+// . The result for a pair that includes a collection an alias refers to is
+//   remembered for the rest of the comparison. An unequal one always is,
+//   since taking pairs to be equal can't make anything unequal; an equal one
+//   only if it didn't depend on taking a recurring pair to be.
+class StructuralEquality {
+ public:
+  StructuralEquality() : m_assumed(false) {}
+
+  bool operator()(const detail::node& lhs, const detail::node& rhs) {
+    if (lhs.is(rhs))
+      return true;
+
+    const NodeType::value type = lhs.type();
+    if (type != rhs.type())
+      return false;
+    switch (type) {
+      case NodeType::Undefined:
+      case NodeType::Null:
+        return true;
+      case NodeType::Scalar:
+        return lhs.scalar_ref() == rhs.scalar_ref() &&
+               NormalTag(lhs) == NormalTag(rhs);
+      case NodeType::Sequence:
+      case NodeType::Map:
+        break;
+    }
+
+    std::size_t lhsHash = 0, rhsHash = 0;
+    if (lhs.cached_hash(lhsHash) && rhs.cached_hash(rhsHash) &&
+        lhsHash != rhsHash)
+      return false;
+    if (lhs.size() != rhs.size() || NormalTag(lhs) != NormalTag(rhs))
+      return false;
+
+    const std::pair<const detail::node_ref*, const detail::node_ref*> pair(
+        lhs.ref(), rhs.ref());
+    const bool shared = lhs.is_shared() || rhs.is_shared();
+    if (shared) {
+      Memo::const_iterator it = m_memo.find(pair);
+      if (it != m_memo.end())
+        return it->second;
+    }
+    for (std::size_t i = 0; i < m_stack.size(); i++) {
+      if (m_stack[i] == pair) {
+        m_assumed = true;
+        return true;
+      }
+    }
+
+    const bool wasAssumed = m_assumed;
+    m_assumed = false;
+    m_stack.push_back(pair);
+    const bool equal = type == NodeType::Sequence ? SequencesEqual(lhs, rhs)
+                                                  : MapsEqual(lhs, rhs);
+    m_stack.pop_back();
+
+    if (shared && (!equal || !m_assumed))
+      m_memo[pair] = equal;
+    m_assumed = m_assumed || wasAssumed;
+    return equal;
+  }
+
+ private:
+  typedef std::unordered_map<const detail::node*, std::size_t> Positions;
+
+  bool SequencesEqual(const detail::node& lhs, const detail::node& rhs) {
+    detail::const_node_iterator r = rhs.begin();
+    for (detail::const_node_iterator l = lhs.begin(); l != lhs.end();
+         ++l, ++r) {
+      if (!(*this)(*l->pNode, *r->pNode))
+        return false;
+    }
+    return true;
+  }
+
+  bool MapsEqual(const detail::node& lhs, const detail::node& rhs) {
+    std::vector<bool> used(rhs.size(), false);
+    Positions positions;  // of the right side's keys, once they're needed
+
+    detail::const_node_iterator r = rhs.begin();
+    std::size_t i = 0;
+    for (detail::const_node_iterator l = lhs.begin(); l != lhs.end();
+         ++l, ++r, ++i) {
+      const detail::node& key = *l->first;
+      const detail::node& value = *l->second;
+      if (Match(key, value, *r->first, *r->second, i, used))
+        continue;
+
+      // the entry with the key's text, if there is one, and it's somewhere
+      // else; each entry is only ever tried once for each key, since trying
+      // one again would compare the same values again (at every level)
+      std::size_t found = i;
+      if (key.type() == NodeType::Scalar) {
+        const StringRef text = key.scalar_ref();
+        detail::node* pKey = NULL;
+        const detail::node* pValue =
+            rhs.find_key(text, detail::hash_string(text), &pKey);
+        if (pValue) {
+          if (positions.empty())
+            Index(rhs, positions);
+          const Positions::const_iterator at = positions.find(pKey);
+          if (at != positions.end() && at->second != i) {
+            found = at->second;
+            if (Match(key, value, *pKey, *pValue, found, used))
+              continue;
+          }
+        }
+      }
+
+      if (!FindPair(key, value, rhs, used, i, found))
+        return false;
+    }
+    return true;
+  }
+
+  // the position of each of the map's keys, in iteration order
+  static void Index(const detail::node& map, Positions& positions) {
+    std::size_t i = 0;
+    for (detail::const_node_iterator it = map.begin(); it != map.end();
+         ++it, ++i)
+      positions.insert(std::make_pair(it->first, i));
+  }
+
+  // if the entry at {@code position} isn't used yet, and is equal, uses it
+  bool Match(const detail::node& key, const detail::node& value,
+             const detail::node& otherKey, const detail::node& otherValue,
+             std::size_t position, std::vector<bool>& used) {
+    if (used[position] || !(*this)(key, otherKey) ||
+        !(*this)(value, otherValue))
+      return false;
+    used[position] = true;
+    return true;
+  }
+
+  // searches the rest of the map, besides the entries already tried
+  bool FindPair(const detail::node& key, const detail::node& value,
+                const detail::node& map, std::vector<bool>& used,
+                std::size_t tried, std::size_t alsoTried) {
+    std::size_t i = 0;
+    for (detail::const_node_iterator it = map.begin(); it != map.end();
+         ++it, ++i) {
+      if (i != tried && i != alsoTried &&
+          Match(key, value, *it->first, *it->second, i, used))
+        return true;
+    }
+    return false;
+  }
+
+ private:
+  typedef std::pair<const detail::node_ref*, const detail::node_ref*> Pair;
+  typedef std::map<Pair, bool> Memo;
+
+  std::vector<Pair> m_stack;
+  bool m_assumed;  // since the current pair started
+  Memo m_memo;
+};
+}
+
 Node Clone(const Node& node) {
   NodeEvents events(node);
   NodeBuilder builder;
   events.Emit(builder);
   return builder.Root();
 }
+
+std::size_t DeepHash(const Node& node) {
+  if (!node.m_isValid)
+    throw InvalidNode();
+  if (!node.m_pNode)
+    return static_cast<std::size_t>(NodeType::Null);
+  return StructuralHash()(*node.m_pNode);
+}
+
+bool DeepEquals(const Node& lhs, const Node& rhs) {
+  if (!lhs.m_isValid || !rhs.m_isValid)
+    throw InvalidNode();
+  if (!lhs.m_pNode || !rhs.m_pNode) {
+    const detail::node* pNode = lhs.m_pNode ? lhs.m_pNode : rhs.m_pNode;
+    return !pNode || pNode->type() == NodeType::Null;
+  }
+  return StructuralEquality()(*lhs.m_pNode, *rhs.m_pNode);
+}
 }
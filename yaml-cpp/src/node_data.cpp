@@ -1,7 +1,9 @@
 #include <assert.h>
 #include <iterator>
 #include <sstream>
+#include <utility>
 
+#include "stringpool.h"
 #include "yaml-cpp/exceptions.h"
 #include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node.h"  // IWYU pragma: keep
@@ -12,6 +14,11 @@
 
 namespace YAML {
 namespace detail {
+namespace {
+// the number of times any map's key (in any document) has had its type or
+// text changed, so that an index built before one did isn't trusted
+std::atomic<std::size_t> keyGeneration(0);
+}
 
 const std::string& node_data::empty_scalar() {
     static const std::string svalue;
@@ -19,13 +26,36 @@ const std::string& node_data::empty_scalar() {
 }
 
 node_data::node_data()
-    : m_isDefined(false),
-      m_mark(Mark::null_mark()),
+    : m_mark(Mark::null_mark()),
       m_type(NodeType::Null),
       m_style(EmitterStyle::Default),
-      m_seqSize(0) {}
+      m_isDefined(false),
+      m_isKey(false),
+      m_hasParent(false),
+      m_isShared(false),
+      m_pTag(&empty_scalar()) {}
+
+node_data::collection_data::collection_data()
+    : seqSize(0),
+      unindexedKeys(0),
+      indexGeneration(0),
+      frozen(false),
+      hashed(false),
+      hash(0) {}
+
+node_data::collection_data& node_data::collection() const {
+  if (!m_pCollection)
+    m_pCollection.reset(new collection_data);
+  return *m_pCollection;
+}
+
+void node_data::key_changed() {
+  keyGeneration.fetch_add(1, std::memory_order_relaxed);
+}
 
 void node_data::mark_defined() {
+  if (m_isKey && !m_isDefined)
+    key_changed();
   if (m_type == NodeType::Undefined)
     m_type = NodeType::Null;
   m_isDefined = true;
@@ -34,6 +64,8 @@ void node_data::mark_defined() {
 void node_data::set_mark(const Mark& mark) { m_mark = mark; }
 
 void node_data::set_type(NodeType::value type) {
+  if (m_isKey)
+    key_changed();
   if (type == NodeType::Undefined) {
     m_type = type;
     m_isDefined = false;
@@ -51,6 +83,7 @@ void node_data::set_type(NodeType::value type) {
       break;
     case NodeType::Scalar:
       m_scalar.clear();
+      m_scalarRef = StringRef();
       break;
     case NodeType::Sequence:
       reset_sequence();
@@ -64,19 +97,88 @@ void node_data::set_type(NodeType::value type) {
   }
 }
 
-void node_data::set_tag(const std::string& tag) { m_tag = tag; }
+void node_data::set_tag(const std::string* pInterned) {
+  assert(pInterned);
+  m_pTag = pInterned;
+}
 
 void node_data::set_style(EmitterStyle::value style) { m_style = style; }
 
 void node_data::set_null() {
+  if (m_isKey)
+    key_changed();
   m_isDefined = true;
   m_type = NodeType::Null;
 }
 
 void node_data::set_scalar(const std::string& scalar) {
+  if (m_isKey)
+    key_changed();
   m_isDefined = true;
   m_type = NodeType::Scalar;
   m_scalar = scalar;
+  m_scalarRef = StringRef();
+}
+
+void node_data::set_scalar(std::string&& scalar) {
+  if (m_isKey)
+    key_changed();
+  m_isDefined = true;
+  m_type = NodeType::Scalar;
+  m_scalar = std::move(scalar);
+  m_scalarRef = StringRef();
+}
+
+void node_data::set_scalar_ref(const StringRef& scalar) {
+  if (m_isKey)
+    key_changed();
+  m_isDefined = true;
+  m_type = NodeType::Scalar;
+  m_scalar.clear();
+  m_scalarRef = scalar;
+}
+
+void node_data::freeze() {
+  if (m_scalarRef.valid())
+    materialize_scalar();
+
+  switch (m_type) {
+    case NodeType::Sequence:
+      compute_seq_size();
+      collection().frozen = true;
+      break;
+    case NodeType::Map:
+      compute_map_size();
+      // an index that's there may be out of date, and a frozen map won't
+      // check
+      if (map().size() >= IndexThreshold)
+        build_index();
+      else
+        collection().pIndex.reset();
+      collection().frozen = true;
+      break;
+    default:
+      break;
+  }
+}
+
+bool node_data::cached_hash(std::size_t& hash) const {
+  if (!m_pCollection || !m_pCollection->hashed.load(std::memory_order_acquire))
+    return false;
+  hash = m_pCollection->hash.load(std::memory_order_relaxed);
+  return true;
+}
+
+void node_data::cache_hash(std::size_t hash) const {
+  if (!m_pCollection || !m_pCollection->frozen)
+    return;
+  m_pCollection->hash.store(hash, std::memory_order_relaxed);
+  m_pCollection->hashed.store(true, std::memory_order_release);
+}
+
+void node_data::materialize_scalar() const {
+  m_scalar.assign(m_scalarRef.data(), m_scalarRef.size());
+  m_scalarRef = StringRef();
 }
 
 // size/iterator
@@ -87,10 +189,10 @@ std::size_t node_data::size() const {
   switch (m_type) {
     case NodeType::Sequence:
       compute_seq_size();
-      return m_seqSize;
+      return collection().seqSize;
     case NodeType::Map:
       compute_map_size();
-      return m_map.size() - m_undefinedPairs.size();
+      return map().size() - collection().undefinedPairs.size();
     default:
       return 0;
   }
@@ -98,16 +200,19 @@ std::size_t node_data::size() const {
 }
 
 void node_data::compute_seq_size() const {
-  while (m_seqSize < m_sequence.size() && m_sequence[m_seqSize]->is_defined())
-    m_seqSize++;
+  collection_data& data = collection();
+  while (data.seqSize < data.sequence.size() &&
+         data.sequence[data.seqSize]->is_defined())
+    data.seqSize++;
 }
 
 void node_data::compute_map_size() const {
-  kv_pairs::iterator it = m_undefinedPairs.begin();
-  while (it != m_undefinedPairs.end()) {
+  kv_pairs& pairs = collection().undefinedPairs;
+  kv_pairs::iterator it = pairs.begin();
+  while (it != pairs.end()) {
     kv_pairs::iterator jt = std::next(it);
     if (it->first->is_defined() && it->second->is_defined())
-      m_undefinedPairs.erase(it);
+      pairs.erase(it);
     it = jt;
   }
 }
@@ -118,9 +223,9 @@ const_node_iterator node_data::begin() const {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.begin());
+      return const_node_iterator(sequence().begin());
     case NodeType::Map:
-      return const_node_iterator(m_map.begin(), m_map.end());
+      return const_node_iterator(map().begin(), map().end());
     default:
       return const_node_iterator();
   }
@@ -132,9 +237,9 @@ node_iterator node_data::begin() {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.begin());
+      return node_iterator(sequence().begin());
     case NodeType::Map:
-      return node_iterator(m_map.begin(), m_map.end());
+      return node_iterator(map().begin(), map().end());
     default:
       return node_iterator();
   }
@@ -146,9 +251,9 @@ const_node_iterator node_data::end() const {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.end());
+      return const_node_iterator(sequence().end());
     case NodeType::Map:
-      return const_node_iterator(m_map.end(), m_map.end());
+      return const_node_iterator(map().end(), map().end());
     default:
       return const_node_iterator();
   }
@@ -160,9 +265,9 @@ node_iterator node_data::end() {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.end());
+      return node_iterator(sequence().end());
     case NodeType::Map:
-      return node_iterator(m_map.end(), m_map.end());
+      return node_iterator(map().end(), map().end());
     default:
       return node_iterator();
   }
@@ -178,7 +283,8 @@ void node_data::push_back(node& node, shared_memory_holder /* pMemory */) {
   if (m_type != NodeType::Sequence)
     throw BadPushback();
 
-  m_sequence.push_back(&node);
+  node.add_parent();
+  sequence().push_back(&node);
 }
 
 void node_data::insert(node& key, node& value, shared_memory_holder pMemory) {
@@ -198,12 +304,12 @@ void node_data::insert(node& key, node& value, shared_memory_holder pMemory) {
 }
 
 // indexing
-node* node_data::get(node& key, shared_memory_holder /* pMemory */) const {
+node* node_data::get(node& key, memory_holder& /* memory */) const {
   if (m_type != NodeType::Map) {
     return nullptr;
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
+  for (node_map::const_iterator it = map().begin(); it != map().end(); ++it) {
     if (it->first->is(key))
       return it->second;
   }
@@ -224,7 +330,7 @@ node& node_data::get(node& key, shared_memory_holder pMemory) {
       throw BadSubscript();
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
+  for (node_map::const_iterator it = map().begin(); it != map().end(); ++it) {
     if (it->first->is(key))
       return *it->second;
   }
@@ -238,17 +344,17 @@ bool node_data::remove(node& key, shared_memory_holder /* pMemory */) {
   if (m_type != NodeType::Map)
     return false;
 
-  kv_pairs::iterator it = m_undefinedPairs.begin();
-  while (it != m_undefinedPairs.end()) {
+  kv_pairs::iterator it = undefined_pairs().begin();
+  while (it != undefined_pairs().end()) {
     kv_pairs::iterator jt = std::next(it);
     if (it->first->is(key))
-      m_undefinedPairs.erase(it);
+      undefined_pairs().erase(it);
     it = jt;
   }
 
-  for (node_map::iterator it = m_map.begin(); it != m_map.end(); ++it) {
+  for (node_map::iterator it = map().begin(); it != map().end(); ++it) {
     if (it->first->is(key)) {
-      m_map.erase(it);
+      erase_map_pair(it);
       return true;
     }
   }
@@ -257,20 +363,126 @@ bool node_data::remove(node& key, shared_memory_holder /* pMemory */) {
 }
 
 void node_data::reset_sequence() {
-  m_sequence.clear();
-  m_seqSize = 0;
+  collection_data& data = collection();
+  data.sequence.clear();
+  data.seqSize = 0;
 }
 
 void node_data::reset_map() {
-  m_map.clear();
-  m_undefinedPairs.clear();
+  collection_data& data = collection();
+  data.map.clear();
+  data.undefinedPairs.clear();
+  data.pIndex.reset();
 }
 
 void node_data::insert_map_pair(node& key, node& value) {
-  m_map.emplace_back(&key, &value);
+  key.add_parent();
+  value.add_parent();
+  append_map_pair(key, value);
+}
+
+void node_data::append_map_pair(node& key, node& value) {
+  map().emplace_back(&key, &value);
+  key.mark_key();
 
   if (!key.is_defined() || !value.is_defined())
-    m_undefinedPairs.emplace_back(&key, &value);
+    undefined_pairs().emplace_back(&key, &value);
+
+  collection_data& data = collection();
+  if (data.pIndex) {
+    if (key.type() == NodeType::Scalar)
+      data.pIndex->emplace(hash_string(key.scalar_ref()), data.map.size() - 1);
+    else
+      data.unindexedKeys++;
+  }
+}
+
+void node_data::erase_map_pair(node_map::iterator it) {
+  map().erase(it);
+
+  // everything after it has moved, so start over (the next lookup by string
+  // will build it again)
+  collection().pIndex.reset();
+}
+
+node* node_data::find_key(const StringRef& key, std::size_t hash,
+                          node** pKey) const {
+  if (!m_isDefined || m_type != NodeType::Map)
+    return NULL;
+
+  node_map::const_iterator it;
+  if (!find_indexed(key, hash, it)) {
+    for (it = map().begin(); it != map().end(); ++it) {
+      const node& candidate = *it->first;
+      if (candidate.type() == NodeType::Scalar && candidate.scalar_ref() == key)
+        break;
+    }
+  }
+  if (it == map().end())
+    return NULL;
+  if (pKey)
+    *pKey = it->first;
+  return it->second;
+}
+
+bool node_data::find_indexed(const StringRef& key,
+                             node_map::const_iterator& it) const {
+  return find_indexed(key, hash_string(key), it);
+}
+
+// find_indexed
+// . Looks a key up by its text (whose hash is given), through the index
+//   (which is built first, if the map is big enough for it to be worth it).
+// . Returns false if the index can't tell, and the map has to be searched.
+// . The index is built again if a key (of any map) has changed since it was
+//   built, say through an iterator, unless the map is frozen (since then its
+//   keys are too, and it may be read from other threads).
+bool node_data::find_indexed(const StringRef& key, std::size_t hash,
+                             node_map::const_iterator& it) const {
+  collection_data& data = collection();
+  if (!data.pIndex ||
+      (!data.frozen &&
+       data.indexGeneration !=
+           keyGeneration.load(std::memory_order_relaxed))) {
+    if (data.map.size() < IndexThreshold) {
+      data.pIndex.reset();
+      return false;
+    }
+    build_index();
+  }
+
+  // different keys can hash the same, so each candidate is checked
+  typedef key_index::const_iterator entry_iterator;
+  std::pair<entry_iterator, entry_iterator> entries =
+      data.pIndex->equal_range(hash);
+  std::size_t first = data.map.size();
+  for (entry_iterator entry = entries.first; entry != entries.second;
+       ++entry) {
+    const node& candidate = *data.map[entry->second].first;
+    if (entry->second < first && candidate.type() == NodeType::Scalar &&
+        candidate.scalar_ref() == key)
+      first = entry->second;
+  }
+
+  it = data.map.begin() + first;
+  if (first < data.map.size())
+    return true;
+  return data.unindexedKeys == 0 && entries.first == entries.second;
+}
+
+void node_data::build_index() const {
+  collection_data& data = collection();
+  data.pIndex.reset(new key_index);
+  data.pIndex->reserve(data.map.size());
+  data.unindexedKeys = 0;
+  data.indexGeneration = keyGeneration.load(std::memory_order_relaxed);
+  for (std::size_t i = 0; i < data.map.size(); i++) {
+    const node& key = *data.map[i].first;
+    if (key.type() == NodeType::Scalar)
+      data.pIndex->emplace(hash_string(key.scalar_ref()), i);
+    else
+      data.unindexedKeys++;
+  }
 }
 
 void node_data::convert_to_map(shared_memory_holder pMemory) {
@@ -295,13 +507,14 @@ void node_data::convert_sequence_to_map(shared_memory_holder pMemory) {
   assert(m_type == NodeType::Sequence);
 
   reset_map();
-  for (std::size_t i = 0; i < m_sequence.size(); i++) {
+  for (std::size_t i = 0; i < sequence().size(); i++) {
     std::stringstream stream;
     stream << i;
 
     node& key = pMemory->create_node();
     key.set_scalar(stream.str());
-    insert_map_pair(key, *m_sequence[i]);
+    key.add_parent();
+    append_map_pair(key, *sequence()[i]);
   }
 
   reset_sequence();
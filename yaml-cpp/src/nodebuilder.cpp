@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <cassert>
+#include <utility>
 
 #include "nodebuilder.h"
 #include "yaml-cpp/node/detail/node.h"
@@ -11,7 +12,21 @@ namespace YAML {
 struct Mark;
 
 NodeBuilder::NodeBuilder()
-    : m_pMemory(new detail::memory_holder), m_pRoot(nullptr), m_mapDepth(0) {
+    : m_pMemory(new detail::memory_holder),
+      m_pRoot(nullptr),
+      m_inputRetained(false),
+      m_mapDepth(0) {
+  m_pMemory->use_arena();
+  m_anchors.push_back(nullptr);  // since the anchors start at 1
+}
+
+NodeBuilder::NodeBuilder(detail::shared_input input)
+    : m_pMemory(new detail::memory_holder),
+      m_pRoot(nullptr),
+      m_pInput(std::move(input)),
+      m_inputRetained(false),
+      m_mapDepth(0) {
+  m_pMemory->use_arena();
   m_anchors.push_back(nullptr);  // since the anchors start at 1
 }
 
@@ -24,6 +39,23 @@ Node NodeBuilder::Root() {
   return Node(*m_pRoot, m_pMemory);
 }
 
+void NodeBuilder::Splice(NodeBuilder& rhs) {
+  assert(m_pRoot && rhs.m_pRoot);
+  assert(m_pRoot->type() == rhs.m_pRoot->type());
+  m_pMemory->merge(*rhs.m_pMemory);
+
+  detail::node& root = *m_pRoot;
+  const bool isMap = root.type() == NodeType::Map;
+  for (detail::node_iterator it = rhs.m_pRoot->begin();
+       it != rhs.m_pRoot->end(); ++it) {
+    if (isMap) {
+      root.insert(*it->first, *it->second, m_pMemory);
+    } else {
+      root.push_back(*it->pNode, m_pMemory);
+    }
+  }
+}
+
 void NodeBuilder::OnDocumentStart(const Mark&) {}
 
 void NodeBuilder::OnDocumentEnd() {}
@@ -36,22 +68,62 @@ void NodeBuilder::OnNull(const Mark& mark, anchor_t anchor) {
 
 void NodeBuilder::OnAlias(const Mark& /* mark */, anchor_t anchor) {
   detail::node& node = *m_anchors[anchor];
+  node.mark_shared();
   Push(node);
   Pop();
 }
 
 void NodeBuilder::OnScalar(const Mark& mark, const std::string& tag,
                            anchor_t anchor, const std::string& value) {
+  // keys tend to repeat, so they share one copy each
+  const bool isKey = NextIsKey();
+  detail::node& node = Push(mark, anchor);
+  if (isKey)
+    node.set_scalar_ref(m_pMemory->intern(value));
+  else
+    node.set_scalar(value);
+  node.set_tag(&m_pMemory->intern(tag));
+  Pop();
+}
+
+void NodeBuilder::OnScalarRef(const Mark& mark, const std::string& tag,
+                              anchor_t anchor, const StringRef& value) {
+  if (!m_pInput) {
+    OnScalarMove(mark, tag, anchor, value.str());
+    return;
+  }
+
+  // only documents that actually refer to the input hold on to it
+  if (!m_inputRetained) {
+    m_pMemory->retain(m_pInput);
+    m_inputRetained = true;
+  }
+
   detail::node& node = Push(mark, anchor);
-  node.set_scalar(value);
-  node.set_tag(tag);
+  node.set_scalar_ref(value);
+  node.set_tag(&m_pMemory->intern(tag));
+  Pop();
+}
+
+void NodeBuilder::OnScalarMove(const Mark& mark, const std::string& tag,
+                               anchor_t anchor, std::string&& value) {
+  // keys are interned anyway, and a buffer that's mostly slack isn't worth
+  // keeping
+  if (NextIsKey() || value.capacity() > 2 * value.size()) {
+    OnScalar(mark, tag, anchor, value);
+    return;
+  }
+
+  detail::node& node = Push(mark, anchor);
+  node.set_scalar(std::move(value));
+  node.set_tag(&m_pMemory->intern(tag));
   Pop();
 }
 
 void NodeBuilder::OnSequenceStart(const Mark& mark, const std::string& tag,
                                   anchor_t anchor, EmitterStyle::value style) {
   detail::node& node = Push(mark, anchor);
-  node.set_tag(tag);
+  node.set_tag(&m_pMemory->intern(tag));
   node.set_type(NodeType::Sequence);
   node.set_style(style);
 }
@@ -62,7 +134,7 @@ void NodeBuilder::OnMapStart(const Mark& mark, const std::string& tag,
                              anchor_t anchor, EmitterStyle::value style) {
   detail::node& node = Push(mark, anchor);
   node.set_type(NodeType::Map);
-  node.set_tag(tag);
+  node.set_tag(&m_pMemory->intern(tag));
   node.set_style(style);
   m_mapDepth++;
 }
@@ -81,10 +153,13 @@ detail::node& NodeBuilder::Push(const Mark& mark, anchor_t anchor) {
   return node;
 }
 
+bool NodeBuilder::NextIsKey() const {
+  return !m_stack.empty() && m_stack.back()->type() == NodeType::Map &&
+         m_keys.size() < m_mapDepth;
+}
+
 void NodeBuilder::Push(detail::node& node) {
-  const bool needsKey =
-      (!m_stack.empty() && m_stack.back()->type() == NodeType::Map &&
-       m_keys.size() < m_mapDepth);
+  const bool needsKey = NextIsKey();
 
   m_stack.push_back(&node);
   if (needsKey)
@@ -27,10 +27,18 @@ class Node;
 class NodeBuilder : public EventHandler {
  public:
   NodeBuilder();
+
+  // scalars passed to OnScalarRef must refer to 'input', which the built
+  // nodes will then keep alive
+  explicit NodeBuilder(detail::shared_input input);
   virtual ~NodeBuilder();
 
   Node Root();
 
+  // appends the entries of rhs's root collection (which must be the same
+  // kind as ours) to our root, and shares its memory
+  void Splice(NodeBuilder& rhs);
+
   virtual void OnDocumentStart(const Mark& mark);
   virtual void OnDocumentEnd();
 
@@ -38,6 +46,10 @@ class NodeBuilder : public EventHandler {
   virtual void OnAlias(const Mark& mark, anchor_t anchor);
   virtual void OnScalar(const Mark& mark, const std::string& tag,
                         anchor_t anchor, const std::string& value);
+  virtual void OnScalarRef(const Mark& mark, const std::string& tag,
+                           anchor_t anchor, const StringRef& value);
+  virtual void OnScalarMove(const Mark& mark, const std::string& tag,
+                            anchor_t anchor, std::string&& value);
 
   virtual void OnSequenceStart(const Mark& mark, const std::string& tag,
                                anchor_t anchor, EmitterStyle::value style);
@@ -51,11 +63,14 @@ class NodeBuilder : public EventHandler {
   detail::node& Push(const Mark& mark, anchor_t anchor);
   void Push(detail::node& node);
   void Pop();
+  bool NextIsKey() const;
   void RegisterAnchor(anchor_t anchor, detail::node& node);
 
  private:
   detail::shared_memory_holder m_pMemory;
   detail::node* m_pRoot;
+  detail::shared_input m_pInput;
+  bool m_inputRetained;
 
   typedef std::vector<detail::node*> Nodes;
   Nodes m_stack;
@@ -20,7 +20,7 @@ anchor_t NodeEvents::AliasManager::LookupAnchor(
 }
 
 NodeEvents::NodeEvents(const Node& node)
-    : m_pMemory(node.m_pMemory), m_root(node.m_pNode) {
+    : m_pMemory(node.m_pMemory), m_root(node.m_pNode), m_hasAliases(false) {
   if (m_root)
     Setup(*m_root);
 }
@@ -28,8 +28,10 @@ NodeEvents::NodeEvents(const Node& node)
 void NodeEvents::Setup(const detail::node& node) {
   int& refCount = m_refCount[node.ref()];
   refCount++;
-  if (refCount > 1)
+  if (refCount > 1) {
+    m_hasAliases = true;
     return;
+  }
 
   if (node.type() == NodeType::Sequence) {
     for (detail::const_node_iterator it = node.begin(); it != node.end(); ++it)
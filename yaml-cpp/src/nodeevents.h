@@ -29,6 +29,12 @@ class NodeEvents {
 
   void Emit(EventHandler& handler);
 
+  /** Returns the root of the tree, or NULL if the node is empty. */
+  const detail::node* Root() const { return m_root; }
+
+  /** Returns whether any node appears in the tree more than once. */
+  bool HasAliases() const { return m_hasAliases; }
+
  private:
   class AliasManager {
    public:
@@ -55,6 +61,7 @@ class NodeEvents {
  private:
   detail::shared_memory_holder m_pMemory;
   detail::node* m_root;
+  bool m_hasAliases;
 
   typedef std::map<const detail::node_ref*, int> RefCount;
   RefCount m_refCount;
@@ -4,7 +4,20 @@ namespace YAML {
 _Null Null;
 
 bool IsNullString(const std::string& str) {
-  return str.empty() || str == "~" || str == "null" || str == "Null" ||
-         str == "NULL";
+  return IsNullString(StringRef(str));
+}
+
+bool IsNullString(const StringRef& str) {
+  switch (str.size()) {
+    case 0:
+      return true;
+    case 1:
+      return str[0] == '~';
+    case 4:
+      return str == StringRef("null", 4) || str == StringRef("Null", 4) ||
+             str == StringRef("NULL", 4);
+    default:
+      return false;
+  }
 }
 }
@@ -1,57 +1,134 @@
 #include "yaml-cpp/ostream_wrapper.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace YAML {
 ostream_wrapper::ostream_wrapper()
     : m_buffer(1, '\0'),
       m_pStream(nullptr),
+      m_fd(-1),
+      m_fill(0),
+      m_good(true),
       m_pos(0),
       m_row(0),
       m_col(0),
       m_comment(false) {}
 
 ostream_wrapper::ostream_wrapper(std::ostream& stream)
-    : m_pStream(&stream), m_pos(0), m_row(0), m_col(0), m_comment(false) {}
+    : m_pStream(&stream),
+      m_fd(-1),
+      m_fill(0),
+      m_good(true),
+      m_pos(0),
+      m_row(0),
+      m_col(0),
+      m_comment(false) {}
 
-ostream_wrapper::~ostream_wrapper() {}
+ostream_wrapper::ostream_wrapper(int fd, std::size_t blockSize)
+    : m_buffer(std::max<std::size_t>(blockSize, 1)),
+      m_pStream(nullptr),
+      m_fd(fd),
+      m_fill(0),
+      m_good(fd >= 0),
+      m_pos(0),
+      m_row(0),
+      m_col(0),
+      m_comment(false) {}
 
-void ostream_wrapper::write(const std::string& str) {
-  if (m_pStream) {
-    m_pStream->write(str.c_str(), str.size());
-  } else {
-    m_buffer.resize(std::max(m_buffer.size(), m_pos + str.size() + 1));
-    std::copy(str.begin(), str.end(), m_buffer.begin() + m_pos);
-  }
+ostream_wrapper::~ostream_wrapper() { flush(); }
 
-  for (std::size_t i = 0; i < str.size(); i++) {
-    update_pos(str[i]);
-  }
+void ostream_wrapper::write(const std::string& str) {
+  write(str.data(), str.size());
 }
 
 void ostream_wrapper::write(const char* str, std::size_t size) {
   if (m_pStream) {
     m_pStream->write(str, size);
+  } else if (m_fd >= 0) {
+    if (m_fill + size > m_buffer.size())
+      flush();
+    if (size >= m_buffer.size()) {
+      write_fd(str, size);
+    } else {
+      std::memcpy(&m_buffer[m_fill], str, size);
+      m_fill += size;
+    }
   } else {
-    m_buffer.resize(std::max(m_buffer.size(), m_pos + size + 1));
-    std::copy(str, str + size, m_buffer.begin() + m_pos);
+    if (m_pos + size + 1 > m_buffer.size())
+      m_buffer.resize(std::max(m_pos + size + 1, 2 * m_buffer.size()));
+    std::memcpy(&m_buffer[m_pos], str, size);
   }
 
-  for (std::size_t i = 0; i < size; i++) {
-    update_pos(str[i]);
+  update_pos(str, size);
+}
+
+void ostream_wrapper::flush() {
+  if (m_fd >= 0 && m_fill > 0) {
+    write_fd(&m_buffer[0], m_fill);
+    m_fill = 0;
   }
 }
 
-void ostream_wrapper::update_pos(char ch) {
-  m_pos++;
-  m_col++;
+// update_pos
+// . Finds the newlines with memchr, rather than looking at each character;
+//   only the last one matters for the column.
+// . The emitter writes a lot of single characters, which don't need that.
+void ostream_wrapper::update_pos(const char* str, std::size_t size) {
+  if (size == 1) {
+    m_pos++;
+    m_col++;
+    if (*str == '\n') {
+      m_row++;
+      m_col = 0;
+      m_comment = false;
+    }
+    return;
+  }
 
-  if (ch == '\n') {
+  const char* const end = str + size;
+  const char* last = nullptr;
+  for (const char* p = str; p != end; p++) {
+    p = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (!p)
+      break;
     m_row++;
-    m_col = 0;
+    last = p;
+  }
+
+  m_pos += size;
+  if (last) {
+    m_col = end - last - 1;
     m_comment = false;
+  } else {
+    m_col += size;
+  }
+}
+
+void ostream_wrapper::write_fd(const char* str, std::size_t size) {
+  while (m_good && size > 0) {
+#ifdef _WIN32
+    const unsigned chunk =
+        static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30));
+    const int written = ::_write(m_fd, str, chunk);
+#else
+    const ssize_t written = ::write(m_fd, str, size);
+#endif
+    if (written <= 0) {
+      if (written == 0 || errno != EINTR)
+        m_good = false;
+      continue;
+    }
+    str += written;
+    size -= static_cast<std::size_t>(written);
   }
 }
 }
@@ -0,0 +1,680 @@
+#include "yaml-cpp/node/pack.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "nodebuilder.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+
+// The packed form, with every number a little-endian uint32:
+//
+//   header:  "YAMLPACK", version, flags (1 if there are marks), the size of
+//            the whole thing, and the offset of the root's record
+//   node:    a byte with the type (bits 0-2), whether it's shared (bit 3),
+//            and the style (bits 4-5); the offset of its tag (or 0 for none);
+//            if there are marks, its mark's pos, line and column; and then
+//            - for a scalar, the length of its text, and the text
+//            - for a collection, the number of entries, and the offset of
+//              a table of the offsets of each entry (or key and value); for
+//              a map of IndexThreshold entries or more, that's followed by
+//              the number of its scalar keys, and then the index of each of
+//              those entries, in order of their keys' text
+//   tag:     its length, and its text
+//
+// Records are written as they're first reached, from the top down, so a
+// node that isn't shared comes after whatever it's in; a shared node is
+// written once, and referred to from everywhere it appears.
+
+namespace YAML {
+namespace {
+const char Magic[8] = {'Y', 'A', 'M', 'L', 'P', 'A', 'C', 'K'};
+const std::uint32_t Version = 1;
+const std::uint32_t MarksFlag = 1;
+const std::size_t HeaderSize = 24;
+const std::size_t IndexThreshold = 32;  // as for a Node's maps
+
+const unsigned TypeMask = 7;
+const unsigned SharedBit = 8;
+const unsigned StyleShift = 4;
+
+void SetU32(char* out, std::uint32_t value) {
+  out[0] = static_cast<char>(value);
+  out[1] = static_cast<char>(value >> 8);
+  out[2] = static_cast<char>(value >> 16);
+  out[3] = static_cast<char>(value >> 24);
+}
+
+bool KeyLess(const std::pair<StringRef, std::uint32_t>& lhs,
+             const std::pair<StringRef, std::uint32_t>& rhs) {
+  const int compare = std::memcmp(lhs.first.data(), rhs.first.data(),
+                                  std::min(lhs.first.size(), rhs.first.size()));
+  return compare < 0 || (compare == 0 && lhs.first.size() < rhs.first.size());
+}
+
+int CompareText(const StringRef& lhs, const std::string& rhs) {
+  const int compare =
+      std::memcmp(lhs.data(), rhs.data(), std::min(lhs.size(), rhs.size()));
+  if (compare != 0)
+    return compare;
+  return lhs.size() < rhs.size() ? -1 : lhs.size() > rhs.size() ? 1 : 0;
+}
+
+// Record
+// . The fixed part of a node's record.
+struct Record {
+  NodeType::value type;
+  EmitterStyle::value style;
+  bool shared;
+  std::uint32_t tag;
+  Mark mark;
+  std::size_t body;
+};
+
+// Reader
+// . Reads from packed data, checking that everything it reads is in it.
+class Reader {
+ public:
+  explicit Reader(const PackedDocument& document)
+      : m_data(reinterpret_cast<const unsigned char*>(document.data())),
+        m_size(document.size()),
+        m_marks(document.HasMarks()) {}
+
+  std::uint32_t U32(std::size_t offset) const {
+    if (offset > m_size || m_size - offset < 4)
+      throw BadPackedData();
+    const unsigned char* p = m_data + offset;
+    return static_cast<std::uint32_t>(p[0]) |
+           (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) |
+           (static_cast<std::uint32_t>(p[3]) << 24);
+  }
+
+  StringRef Text(std::size_t offset) const {
+    const std::uint32_t length = U32(offset);
+    if (m_size - offset - 4 < length)
+      throw BadPackedData();
+    return StringRef(reinterpret_cast<const char*>(m_data) + offset + 4,
+                     length);
+  }
+
+  Record Read(std::size_t offset) const {
+    if (offset < HeaderSize || offset >= m_size)
+      throw BadPackedData();
+    const unsigned kind = m_data[offset];
+    const unsigned style = kind >> StyleShift;
+    if ((kind & TypeMask) > NodeType::Map || style > EmitterStyle::Flow)
+      throw BadPackedData();
+
+    Record record;
+    record.type = static_cast<NodeType::value>(kind & TypeMask);
+    record.style = static_cast<EmitterStyle::value>(style);
+    record.shared = (kind & SharedBit) != 0;
+    record.tag = U32(offset + 1);
+    record.body = offset + 5;
+    if (m_marks) {
+      record.mark.pos = static_cast<int>(U32(record.body));
+      record.mark.line = static_cast<int>(U32(record.body + 4));
+      record.mark.column = static_cast<int>(U32(record.body + 8));
+      record.body += 12;
+    } else {
+      record.mark = Mark::null_mark();
+    }
+    return record;
+  }
+
+  std::string Tag(const Record& record) const {
+    return record.tag ? Text(record.tag).str() : std::string();
+  }
+
+  // the offsets of a collection's count, and its table
+  std::uint32_t Count(const Record& record) const {
+    return U32(record.body);
+  }
+  std::size_t Table(const Record& record) const {
+    return U32(record.body + 4);
+  }
+
+ private:
+  const unsigned char* m_data;
+  std::size_t m_size;
+  bool m_marks;
+};
+
+// OffsetSet
+// . The offsets of the records that have been reached, as a bit for each four
+//   bytes of the document (since no record is shorter), in pages that are
+//   made when they're first needed, so a small tree in a large document only
+//   needs a few.
+class OffsetSet {
+ public:
+  OffsetSet() : m_page(0), m_pBits(NULL) {}
+
+  // whether the offset is new (and adds it)
+  bool Insert(std::size_t offset) {
+    const std::size_t page = offset / PageBytes + 1;
+    if (page != m_page) {
+      std::unique_ptr<std::uint64_t[]>& pBits = m_pages[page];
+      if (!pBits)
+        pBits.reset(new std::uint64_t[PageBytes / 4 / 64]());
+      m_page = page;
+      m_pBits = pBits.get();
+    }
+    const std::size_t bit = offset % PageBytes / 4;
+    const std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+    if (m_pBits[bit / 64] & mask)
+      return false;
+    m_pBits[bit / 64] |= mask;
+    return true;
+  }
+
+ private:
+  static const std::size_t PageBytes = 16384;
+
+  std::unordered_map<std::size_t, std::unique_ptr<std::uint64_t[]>> m_pages;
+  std::size_t m_page;  // the last one used, plus 1
+  std::uint64_t* m_pBits;
+};
+
+// Unpacker
+// . Replays a packed tree's events to a NodeBuilder; each shared node is
+//   given an anchor, the first time it's reached, and is an alias after
+//   that.
+// . A node that isn't shared must come after whatever it's in, and can only
+//   be reached once, so corrupt data can't send this round in circles, or
+//   have it read the same records over and over.
+// . The collections it's in the middle of are kept on a stack of its own,
+//   so a deep tree can't run it out of call stack.
+class Unpacker {
+ public:
+  Unpacker(const PackedDocument& document, bool refer, NodeBuilder& builder)
+      : m_reader(document), m_refer(refer), m_builder(builder), m_anchor(0) {}
+
+  void operator()(std::size_t offset) {
+    Visit(offset, 0);
+    while (!m_collections.empty()) {
+      Collection& collection = m_collections.back();
+      if (collection.next == collection.entries) {
+        if (collection.type == NodeType::Sequence)
+          m_builder.OnSequenceEnd();
+        else
+          m_builder.OnMapEnd();
+        m_collections.pop_back();
+        continue;
+      }
+      const std::size_t entry = collection.table + 4 * collection.next++;
+      Visit(m_reader.U32(entry), collection.offset);
+    }
+  }
+
+ private:
+  // a collection that's been started, with the offsets of its entries (or
+  // keys and values) in its table
+  struct Collection {
+    NodeType::value type;
+    std::size_t offset;
+    std::size_t table;
+    std::size_t entries;
+    std::size_t next;
+  };
+
+  void Visit(std::size_t offset, std::size_t parent) {
+    const Record record = m_reader.Read(offset);
+    if (record.type == NodeType::Undefined) {
+      // only the root can be undefined, since nothing else is written
+      if (parent)
+        throw BadPackedData();
+      return;
+    }
+
+    anchor_t anchor = NullAnchor;
+    if (record.shared) {
+      std::unordered_map<std::size_t, anchor_t>::const_iterator it =
+          m_anchors.find(offset);
+      if (it != m_anchors.end()) {
+        m_builder.OnAlias(record.mark, it->second);
+        return;
+      }
+      anchor = ++m_anchor;
+      m_anchors.insert(std::make_pair(offset, anchor));
+    } else if (offset <= parent || !m_reached.Insert(offset)) {
+      throw BadPackedData();
+    }
+
+    switch (record.type) {
+      case NodeType::Undefined:
+        break;
+      case NodeType::Null:
+        m_builder.OnNull(record.mark, anchor);
+        break;
+      case NodeType::Scalar: {
+        const StringRef text = m_reader.Text(record.body);
+        if (m_refer)
+          m_builder.OnScalarRef(record.mark, Tag(record), anchor, text);
+        else
+          m_builder.OnScalar(record.mark, Tag(record), anchor, text.str());
+        break;
+      }
+      case NodeType::Sequence:
+      case NodeType::Map: {
+        const Collection collection = {
+            record.type, offset, m_reader.Table(record),
+            std::size_t(m_reader.Count(record)) *
+                (record.type == NodeType::Map ? 2 : 1),
+            0};
+        if (record.type == NodeType::Sequence)
+          m_builder.OnSequenceStart(record.mark, Tag(record), anchor,
+                                    record.style);
+        else
+          m_builder.OnMapStart(record.mark, Tag(record), anchor, record.style);
+        m_collections.push_back(collection);
+        break;
+      }
+    }
+  }
+
+  // tags repeat, so each is read once
+  const std::string& Tag(const Record& record) {
+    std::unordered_map<std::uint32_t, std::string>::iterator it =
+        m_tags.find(record.tag);
+    if (it == m_tags.end())
+      it = m_tags.insert(std::make_pair(record.tag, m_reader.Tag(record)))
+               .first;
+    return it->second;
+  }
+
+ private:
+  Reader m_reader;
+  bool m_refer;
+  NodeBuilder& m_builder;
+  anchor_t m_anchor;
+  std::unordered_map<std::size_t, anchor_t> m_anchors;
+  OffsetSet m_reached;  // the nodes that aren't shared
+  std::vector<Collection> m_collections;
+  std::unordered_map<std::uint32_t, std::string> m_tags;
+};
+
+Node Unpack(const PackedDocument& document, std::size_t offset,
+            const std::shared_ptr<const std::string>& input) {
+  NodeBuilder builder(input);
+  Unpacker unpacker(document, input != nullptr, builder);
+  builder.OnDocumentStart(Mark());
+  unpacker(offset);
+  builder.OnDocumentEnd();
+  return builder.Root();
+}
+}
+
+// NodePacker
+// . Writes a tree's records from the top down, patching each collection's
+//   count and table in once its entries have been written. A node that's
+//   reached again is marked as shared, where it was first written.
+class NodePacker {
+ public:
+  explicit NodePacker(bool marks) : m_marks(marks) {}
+
+  std::string Pack(const Node& node) {
+    if (!node.m_isValid)
+      throw InvalidNode();
+    m_out.assign(Magic, sizeof(Magic));
+    PutU32(Version);
+    PutU32(m_marks ? MarksFlag : 0);
+    PutU32(0);
+    PutU32(0);
+
+    std::uint32_t root = 0;
+    if (node.m_pNode) {
+      root = Write(*node.m_pNode);
+    } else {
+      root = Here();
+      m_out += static_cast<char>(NodeType::Null);
+      PutU32(0);
+      if (m_marks)
+        PutMark(Mark::null_mark());
+    }
+    const std::uint32_t size = Here();
+    SetU32(&m_out[16], size);
+    SetU32(&m_out[20], root);
+    return std::move(m_out);
+  }
+
+ private:
+  std::uint32_t Write(const detail::node& node) {
+    std::unordered_map<const detail::node_ref*, std::uint32_t>::const_iterator
+        it = m_offsets.find(node.ref());
+    if (it != m_offsets.end()) {
+      m_out[it->second] = static_cast<char>(m_out[it->second] | SharedBit);
+      return it->second;
+    }
+
+    const std::uint32_t tag = node.tag().empty() ? 0 : Tag(node.tag());
+    const std::uint32_t offset = Here();
+    m_offsets.insert(std::make_pair(node.ref(), offset));
+    m_out += static_cast<char>(node.type() | (node.style() << StyleShift));
+    PutU32(tag);
+    if (m_marks)
+      PutMark(node.mark());
+
+    switch (node.type()) {
+      case NodeType::Undefined:
+      case NodeType::Null:
+        break;
+      case NodeType::Scalar: {
+        const StringRef text = node.scalar_ref();
+        PutU32(Size(text.size()));
+        m_out.append(text.data(), text.size());
+        break;
+      }
+      case NodeType::Sequence:
+      case NodeType::Map:
+        WriteEntries(node);
+        break;
+    }
+    return offset;
+  }
+
+  void WriteEntries(const detail::node& node) {
+    const std::size_t body = m_out.size();
+    PutU32(0);
+    PutU32(0);
+
+    std::vector<std::uint32_t> entries;
+    std::vector<std::pair<StringRef, std::uint32_t>> keys;
+    for (detail::const_node_iterator it = node.begin(); it != node.end();
+         ++it) {
+      if (it->pNode) {
+        if (it->pNode->is_defined())
+          entries.push_back(Write(*it->pNode));
+        continue;
+      }
+      if (it->first->type() == NodeType::Scalar)
+        keys.push_back(std::make_pair(
+            it->first->scalar_ref(),
+            static_cast<std::uint32_t>(entries.size() / 2)));
+      entries.push_back(Write(*it->first));
+      entries.push_back(Write(*it->second));
+    }
+
+    const bool isMap = node.type() == NodeType::Map;
+    const std::size_t count = isMap ? entries.size() / 2 : entries.size();
+    const std::uint32_t table = Here();
+    for (std::size_t i = 0; i < entries.size(); i++)
+      PutU32(entries[i]);
+    if (isMap && count >= IndexThreshold) {
+      std::stable_sort(keys.begin(), keys.end(), KeyLess);
+      PutU32(static_cast<std::uint32_t>(keys.size()));
+      for (std::size_t i = 0; i < keys.size(); i++)
+        PutU32(keys[i].second);
+    }
+    SetU32(&m_out[body], static_cast<std::uint32_t>(count));
+    SetU32(&m_out[body + 4], table);
+  }
+
+  // tags are written once each, wherever they're first needed
+  std::uint32_t Tag(const std::string& tag) {
+    std::unordered_map<std::string, std::uint32_t>::const_iterator it =
+        m_tags.find(tag);
+    if (it != m_tags.end())
+      return it->second;
+    const std::uint32_t offset = Here();
+    PutU32(Size(tag.size()));
+    m_out += tag;
+    m_tags.insert(std::make_pair(tag, offset));
+    return offset;
+  }
+
+  void PutU32(std::uint32_t value) {
+    char bytes[4];
+    SetU32(bytes, value);
+    m_out.append(bytes, 4);
+  }
+
+  void PutMark(const Mark& mark) {
+    PutU32(static_cast<std::uint32_t>(mark.pos));
+    PutU32(static_cast<std::uint32_t>(mark.line));
+    PutU32(static_cast<std::uint32_t>(mark.column));
+  }
+
+  std::uint32_t Here() const { return Size(m_out.size()); }
+
+  static std::uint32_t Size(std::size_t size) {
+    if (size > 0xffffffffu)
+      throw BadPackedData();
+    return static_cast<std::uint32_t>(size);
+  }
+
+ private:
+  bool m_marks;
+  std::string m_out;
+  std::unordered_map<const detail::node_ref*, std::uint32_t> m_offsets;
+  std::unordered_map<std::string, std::uint32_t> m_tags;
+};
+
+std::string Pack(const Node& node, bool marks) {
+  return NodePacker(marks).Pack(node);
+}
+
+PackedNode::PackedNode() : m_pDocument(NULL), m_offset(0) {}
+
+PackedNode::PackedNode(const PackedDocument* pDocument, std::size_t offset)
+    : m_pDocument(pDocument), m_offset(offset) {}
+
+Mark PackedNode::Mark() const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  return Reader(*m_pDocument).Read(m_offset).mark;
+}
+
+NodeType::value PackedNode::Type() const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  return Reader(*m_pDocument).Read(m_offset).type;
+}
+
+bool PackedNode::IsDefined() const {
+  return m_pDocument && Type() != NodeType::Undefined;
+}
+
+StringRef PackedNode::ScalarRef() const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  const Reader reader(*m_pDocument);
+  const Record record = reader.Read(m_offset);
+  if (record.type != NodeType::Scalar)
+    return StringRef("", 0);
+  return reader.Text(record.body);
+}
+
+std::string PackedNode::Scalar() const { return ScalarRef().str(); }
+
+std::string PackedNode::Tag() const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  const Reader reader(*m_pDocument);
+  return reader.Tag(reader.Read(m_offset));
+}
+
+EmitterStyle::value PackedNode::Style() const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  return Reader(*m_pDocument).Read(m_offset).style;
+}
+
+bool PackedNode::is(const PackedNode& rhs) const {
+  if (!m_pDocument || !rhs.m_pDocument)
+    throw InvalidNode();
+  return m_pDocument == rhs.m_pDocument && m_offset == rhs.m_offset;
+}
+
+std::size_t PackedNode::size() const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  const Reader reader(*m_pDocument);
+  const Record record = reader.Read(m_offset);
+  if (record.type != NodeType::Sequence && record.type != NodeType::Map)
+    return 0;
+  return reader.Count(record);
+}
+
+PackedNode PackedNode::Key(std::size_t index) const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  const Reader reader(*m_pDocument);
+  const Record record = reader.Read(m_offset);
+  if (record.type != NodeType::Map || index >= reader.Count(record))
+    return PackedNode();
+  return PackedNode(m_pDocument, reader.U32(reader.Table(record) + 8 * index));
+}
+
+PackedNode PackedNode::Value(std::size_t index) const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  const Reader reader(*m_pDocument);
+  const Record record = reader.Read(m_offset);
+  if (record.type != NodeType::Map || index >= reader.Count(record))
+    return PackedNode();
+  return PackedNode(m_pDocument,
+                    reader.U32(reader.Table(record) + 8 * index + 4));
+}
+
+PackedNode PackedNode::operator[](std::size_t index) const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  const Reader reader(*m_pDocument);
+  const Record record = reader.Read(m_offset);
+  if (record.type == NodeType::Map)
+    return (*this)[std::to_string(index)];
+  if (record.type != NodeType::Sequence || index >= reader.Count(record))
+    return PackedNode();
+  return PackedNode(m_pDocument, reader.U32(reader.Table(record) + 4 * index));
+}
+
+PackedNode PackedNode::operator[](const std::string& key) const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  const Reader reader(*m_pDocument);
+  const Record record = reader.Read(m_offset);
+  if (record.type != NodeType::Map)
+    return PackedNode();
+
+  const std::uint32_t count = reader.Count(record);
+  const std::size_t table = reader.Table(record);
+  if (count >= IndexThreshold) {
+    // the first of the keys in order that isn't before this one
+    const std::size_t index = table + 8 * std::size_t(count);
+    std::size_t lo = 0, hi = reader.U32(index);
+    while (lo < hi) {
+      const std::size_t mid = lo + (hi - lo) / 2;
+      const std::uint32_t entry = reader.U32(index + 4 + 4 * mid);
+      const Record keyRecord = reader.Read(reader.U32(table + 8 * entry));
+      if (CompareText(reader.Text(keyRecord.body), key) < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo == reader.U32(index))
+      return PackedNode();
+    const std::uint32_t entry = reader.U32(index + 4 + 4 * lo);
+    const Record keyRecord = reader.Read(reader.U32(table + 8 * entry));
+    if (CompareText(reader.Text(keyRecord.body), key) != 0)
+      return PackedNode();
+    return Value(entry);
+  }
+
+  for (std::uint32_t i = 0; i < count; i++) {
+    const Record keyRecord = reader.Read(reader.U32(table + 8 * i));
+    if (keyRecord.type == NodeType::Scalar &&
+        CompareText(reader.Text(keyRecord.body), key) == 0)
+      return Value(i);
+  }
+  return PackedNode();
+}
+
+Node PackedNode::ToNode() const {
+  if (!m_pDocument)
+    throw InvalidNode();
+  return Unpack(*m_pDocument, m_offset, m_pDocument->m_pString);
+}
+
+PackedDocument::PackedDocument(std::shared_ptr<const std::string> data)
+    : m_pStorage(data),
+      m_pString(data),
+      m_data(data ? data->data() : ""),
+      m_size(data ? data->size() : 0),
+      m_marks(false),
+      m_root(0) {
+  if (!data)
+    throw BadPackedData();
+  ReadHeader();
+}
+
+PackedDocument::PackedDocument(std::shared_ptr<const void> storage,
+                               const char* data, std::size_t size)
+    : m_pStorage(storage),
+      m_data(data),
+      m_size(size),
+      m_marks(false),
+      m_root(0) {
+  ReadHeader();
+}
+
+void PackedDocument::ReadHeader() {
+  if (m_size < HeaderSize || std::memcmp(m_data, Magic, sizeof(Magic)) != 0)
+    throw BadPackedData();
+  const Reader reader(*this);
+  const std::uint32_t flags = reader.U32(12);
+  if (reader.U32(8) != Version || (flags & ~MarksFlag) != 0 ||
+      reader.U32(16) != m_size)
+    throw BadPackedData();
+  m_marks = (flags & MarksFlag) != 0;
+  m_root = reader.U32(20);
+  reader.Read(m_root);
+}
+
+PackedDocument PackedDocument::MapFile(const std::string& filename) {
+#ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw BadFile();
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    throw BadFile();
+  }
+  const std::size_t size = static_cast<std::size_t>(info.st_size);
+  void* address =
+      size ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  close(fd);
+  if (address != MAP_FAILED) {
+    std::shared_ptr<const void> storage(
+        address, [size](const void* p) { munmap(const_cast<void*>(p), size); });
+    return PackedDocument(storage, static_cast<const char*>(address), size);
+  }
+#endif
+
+  std::ifstream fin(filename.c_str(), std::ios::binary);
+  if (!fin)
+    throw BadFile();
+  std::stringstream contents;
+  contents << fin.rdbuf();
+  return PackedDocument(std::make_shared<const std::string>(contents.str()));
+}
+
+PackedNode PackedDocument::Root() const { return PackedNode(this, m_root); }
+
+Node PackedDocument::ToNode() const { return Root().ToNode(); }
+}
@@ -0,0 +1,28 @@
+#ifndef PARALLEL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define PARALLEL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <functional>
+
+namespace YAML {
+/**
+ * Calls {@code fn} once for each index in [0, count), on up to
+ * {@code threads} threads (0 means one per core), including the calling
+ * thread, and returns once they've all been handled. Indices are handed out
+ * in increasing order, but may finish in any order. {@code fn} must not
+ * throw; capture any errors per index instead.
+ */
+void ParallelFor(std::size_t count, unsigned threads,
+                 const std::function<void(std::size_t)>& fn);
+
+/** Returns the number of threads that {@code threads} == 0 stands for. */
+unsigned DefaultThreadCount();
+}
+
+#endif  // PARALLEL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
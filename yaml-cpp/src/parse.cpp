@@ -1,14 +1,153 @@
 #include "yaml-cpp/node/parse.h"
 
+#include <algorithm>
+#include <exception>
 #include <fstream>
+#include <map>
 #include <sstream>
 
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/parselimits.h"
 #include "yaml-cpp/parser.h"
+#include "docsplitter.h"
+#include "jsonparser.h"
 #include "nodebuilder.h"
+#include "parallel.h"
 
 namespace YAML {
+namespace {
+// LoadDocument
+// . The parser's next document (or a null node, if there isn't one), held to
+//   {@code pLimits}, if there are any.
+Node LoadDocument(Parser& parser,
+                  const std::shared_ptr<const std::string>& input,
+                  const ParseLimits* pLimits) {
+  if (pLimits) {
+    parser.SetLimits(*pLimits);
+  }
+  NodeBuilder builder(input);
+  if (!parser.HandleNextDocument(builder)) {
+    return Node();
+  }
+
+  return builder.Root();
+}
+
+// LoadDocuments
+// . Appends the rest of the parser's documents to {@code docs}.
+void LoadDocuments(Parser& parser,
+                   const std::shared_ptr<const std::string>& input,
+                   std::vector<Node>& docs) {
+  while (1) {
+    NodeBuilder builder(input);
+    if (!parser.HandleNextDocument(builder)) {
+      break;
+    }
+    docs.push_back(builder.Root());
+  }
+}
+
+// ChunkSize
+// . Parallel chunks aim for a few per thread, so that uneven ones even out,
+//   but not so short that setting up a parser for each one starts to show.
+std::size_t ChunkSize(const std::string& input, unsigned threads) {
+  const std::size_t MinChunkSize = 16 * 1024;
+  const std::size_t ChunksPerThread = 8;
+  return std::max(MinChunkSize, input.size() / (threads * ChunksPerThread));
+}
+
+// ChunkContexts
+// . The directives that carry over into each chunk, read up front, once
+//   each. If they're malformed, then so is the chunk they came from, so the
+//   error surfaces there.
+class ChunkContexts {
+ public:
+  ChunkContexts(const std::shared_ptr<const std::string>& input,
+                const std::vector<DocumentChunk>& chunks) {
+    for (const DocumentChunk& chunk : chunks) {
+      if (chunk.directivesSize == 0 ||
+          m_contexts.count(chunk.directives.pos)) {
+        continue;
+      }
+      std::unique_ptr<Parser> pContext(new Parser);
+      pContext->Load(input, chunk.directives, chunk.directivesSize);
+      try {
+        NodeBuilder builder(input);
+        pContext->HandleNextDocument(builder);
+      } catch (const ParserException&) {
+      }
+      m_contexts[chunk.directives.pos] = std::move(pContext);
+    }
+  }
+
+  const Parser* operator()(const DocumentChunk& chunk) const {
+    return chunk.directivesSize > 0
+               ? m_contexts.find(chunk.directives.pos)->second.get()
+               : nullptr;
+  }
+
+ private:
+  std::map<int, std::unique_ptr<Parser>> m_contexts;
+};
+
+Node ParseJson(const std::shared_ptr<const std::string>& input,
+               const ParseLimits* pLimits) {
+  JsonParser parser(input, pLimits);
+  NodeBuilder builder(input);
+  parser.HandleDocument(builder);
+  return builder.Root();
+}
+
+std::shared_ptr<const std::string> ReadFile(const std::string& filename) {
+  std::ifstream fin(filename.c_str());
+  if (!fin) {
+    throw BadFile();
+  }
+  std::stringstream contents;
+  contents << fin.rdbuf();
+  return std::make_shared<const std::string>(contents.str());
+}
+
+Node LoadInput(const std::shared_ptr<const std::string>& input,
+               const ParseLimits* pLimits, bool detectJson) {
+  if (detectJson && input && JsonParser::LooksLikeJson(*input)) {
+    try {
+      return ParseJson(input, pLimits);
+    } catch (const ParserException&) {
+    }
+  }
+
+  Parser parser(input);
+  return LoadDocument(parser, input, pLimits);
+}
+
+Node LoadFileInput(const std::string& filename, const ParseLimits* pLimits,
+                   bool detectJson) {
+  if (detectJson) {
+    return LoadInput(ReadFile(filename), pLimits, true);
+  }
+
+  std::ifstream fin(filename.c_str());
+  if (!fin) {
+    throw BadFile();
+  }
+  Parser parser(fin);
+  return LoadDocument(parser, nullptr, pLimits);
+}
+
+Node LoadJsonInput(const std::shared_ptr<const std::string>& input,
+                   const ParseLimits* pLimits) {
+  try {
+    return ParseJson(input, pLimits);
+  } catch (const ParserException&) {
+    // if it's malformed YAML too, report that, just as Load would
+    LoadInput(input, pLimits, false);
+    throw;
+  }
+}
+}
+
 Node Load(const std::string& input) {
   std::stringstream stream(input);
   return Load(stream);
@@ -21,20 +160,52 @@ Node Load(const char* input) {
 
 Node Load(std::istream& input) {
   Parser parser(input);
-  NodeBuilder builder;
-  if (!parser.HandleNextDocument(builder)) {
-    return Node();
-  }
+  return LoadDocument(parser, nullptr, nullptr);
+}
 
-  return builder.Root();
+Node Load(const std::string& input, const ParseLimits& limits) {
+  std::stringstream stream(input);
+  return Load(stream, limits);
 }
 
-Node LoadFile(const std::string& filename) {
-  std::ifstream fin(filename.c_str());
-  if (!fin) {
-    throw BadFile();
-  }
-  return Load(fin);
+Node Load(std::istream& input, const ParseLimits& limits) {
+  Parser parser(input);
+  return LoadDocument(parser, nullptr, &limits);
+}
+
+Node Load(std::shared_ptr<const std::string> input, bool detectJson) {
+  return LoadInput(input, nullptr, detectJson);
+}
+
+Node Load(std::shared_ptr<const std::string> input, const ParseLimits& limits,
+          bool detectJson) {
+  return LoadInput(input, &limits, detectJson);
+}
+
+Node LoadFile(const std::string& filename, bool detectJson) {
+  return LoadFileInput(filename, nullptr, detectJson);
+}
+
+Node LoadFile(const std::string& filename, const ParseLimits& limits,
+              bool detectJson) {
+  return LoadFileInput(filename, &limits, detectJson);
+}
+
+Node LoadJson(std::shared_ptr<const std::string> input) {
+  return LoadJsonInput(input, nullptr);
+}
+
+Node LoadJson(std::shared_ptr<const std::string> input,
+              const ParseLimits& limits) {
+  return LoadJsonInput(input, &limits);
+}
+
+Node LoadJson(const std::string& input) {
+  return LoadJson(std::make_shared<const std::string>(input));
+}
+
+Node LoadJsonFile(const std::string& filename) {
+  return LoadJson(ReadFile(filename));
 }
 
 std::vector<Node> LoadAll(const std::string& input) {
@@ -62,6 +233,24 @@ std::vector<Node> LoadAll(std::istream& input) {
   return docs;
 }
 
+std::vector<Node> LoadAll(std::shared_ptr<const std::string> input) {
+  std::vector<Node> docs;
+
+  Parser parser(input);
+  LoadDocuments(parser, input, docs);
+  return docs;
+}
+
+std::vector<Node> LoadAll(std::shared_ptr<const std::string> input,
+                          const ParseLimits& limits) {
+  std::vector<Node> docs;
+
+  Parser parser(input);
+  parser.SetLimits(limits);
+  LoadDocuments(parser, input, docs);
+  return docs;
+}
+
 std::vector<Node> LoadAllFromFile(const std::string& filename) {
   std::ifstream fin(filename.c_str());
   if (!fin) {
@@ -69,4 +258,114 @@ std::vector<Node> LoadAllFromFile(const std::string& filename) {
   }
   return LoadAll(fin);
 }
+
+std::vector<Node> LoadAllParallel(std::shared_ptr<const std::string> input,
+                                  unsigned threads) {
+  if (!input) {
+    input = std::make_shared<const std::string>();
+  }
+  if (threads == 0) {
+    threads = DefaultThreadCount();
+  }
+
+  const std::vector<DocumentChunk> chunks =
+      SplitDocuments(*input, ChunkSize(*input, threads));
+  if (threads == 1 || chunks.size() == 1) {
+    return LoadAll(input);
+  }
+
+  const ChunkContexts context(input, chunks);
+
+  std::vector<std::vector<Node>> docs(chunks.size());
+  std::vector<std::exception_ptr> errors(chunks.size());
+  ParallelFor(chunks.size(), threads, [&](std::size_t i) {
+    try {
+      Parser parser;
+      parser.Load(input, chunks[i].start, chunks[i].size, context(chunks[i]));
+      LoadDocuments(parser, input, docs[i]);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  });
+
+  std::vector<Node> all;
+  for (std::size_t i = 0; i < chunks.size(); i++) {
+    if (errors[i]) {
+      // report the error exactly as a sequential parse would, by doing one
+      // from here on (the chunk may only have failed because it was cut off)
+      Parser parser;
+      parser.Load(input, chunks[i].start, input->size(), context(chunks[i]));
+      LoadDocuments(parser, input, all);
+      return all;
+    }
+    all.insert(all.end(), docs[i].begin(), docs[i].end());
+  }
+  return all;
+}
+
+std::vector<Node> LoadAllParallel(const std::string& input, unsigned threads) {
+  return LoadAllParallel(std::make_shared<const std::string>(input), threads);
+}
+
+std::vector<Node> LoadAllFromFileParallel(const std::string& filename,
+                                          unsigned threads) {
+  return LoadAllParallel(ReadFile(filename), threads);
+}
+
+Node LoadParallel(std::shared_ptr<const std::string> input, unsigned threads) {
+  if (!input) {
+    input = std::make_shared<const std::string>();
+  }
+  if (threads == 0) {
+    threads = DefaultThreadCount();
+  }
+
+  const std::vector<DocumentChunk> chunks =
+      SplitRootCollection(*input, ChunkSize(*input, threads));
+  if (threads == 1 || chunks.size() == 1) {
+    return Load(input);
+  }
+
+  // a chunk that doesn't parse on its own is left out, and then the whole
+  // document is parsed again, sequentially
+  const ChunkContexts context(input, chunks);
+  std::vector<std::unique_ptr<NodeBuilder>> builders(chunks.size());
+  ParallelFor(chunks.size(), threads, [&](std::size_t i) {
+    try {
+      Parser parser;
+      parser.Load(input, chunks[i].start, chunks[i].size, context(chunks[i]));
+      std::unique_ptr<NodeBuilder> pBuilder(new NodeBuilder(input));
+      if (parser.HandleNextDocument(*pBuilder) && !parser) {
+        builders[i] = std::move(pBuilder);
+      }
+    } catch (...) {
+    }
+  });
+
+  // and each one must give a plain block collection of the same kind
+  for (std::size_t i = 0; i < builders.size(); i++) {
+    if (!builders[i]) {
+      return Load(input);
+    }
+    const Node root = builders[i]->Root();
+    if ((!root.IsMap() && !root.IsSequence()) || root.Tag() != "?" ||
+        root.Style() != EmitterStyle::Block ||
+        root.Type() != builders.front()->Root().Type()) {
+      return Load(input);
+    }
+  }
+
+  for (std::size_t i = 1; i < builders.size(); i++) {
+    builders.front()->Splice(*builders[i]);
+  }
+  return builders.front()->Root();
+}
+
+Node LoadParallel(const std::string& input, unsigned threads) {
+  return LoadParallel(std::make_shared<const std::string>(input), threads);
+}
+
+Node LoadFileParallel(const std::string& filename, unsigned threads) {
+  return LoadParallel(ReadFile(filename), threads);
+}
 }  // namespace YAML
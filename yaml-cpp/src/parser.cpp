@@ -1,20 +1,41 @@
+#include <algorithm>
 #include <cstdio>
+#include <istream>
 #include <sstream>
+#include <streambuf>
+#include <utility>
 
 #include "directives.h"  // IWYU pragma: keep
 #include "scanner.h"     // IWYU pragma: keep
 #include "singledocparser.h"
 #include "token.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
+#include "yaml-cpp/parselimits.h"
 #include "yaml-cpp/parser.h"
 
 namespace YAML {
 class EventHandler;
 
+namespace {
+// InputBuffer
+// . Reads straight out of the retained input, without copying it.
+class InputBuffer : public std::streambuf {
+ public:
+  InputBuffer(const char* data, std::size_t size) {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+}
+
 Parser::Parser() {}
 
 Parser::Parser(std::istream& in) { Load(in); }
 
+Parser::Parser(std::shared_ptr<const std::string> input) {
+  Load(std::move(input));
+}
+
 Parser::~Parser() {}
 
 Parser::operator bool() const {
@@ -22,10 +43,64 @@ Parser::operator bool() const {
 }
 
 void Parser::Load(std::istream& in) {
+  m_pScanner.reset();
+  m_pInputStream.reset();
+  m_pInputBuffer.reset();
+  m_pInput.reset();
+
   m_pScanner.reset(new Scanner(in));
   m_pDirectives.reset(new Directives);
 }
 
+void Parser::Load(std::shared_ptr<const std::string> input) {
+  m_pScanner.reset();
+  m_pInputStream.reset();
+  m_pInputBuffer.reset();
+
+  m_pInput = std::move(input);
+  if (!m_pInput) {
+    m_pInput = std::make_shared<const std::string>();
+  }
+  m_pInputBuffer.reset(new InputBuffer(m_pInput->data(), m_pInput->size()));
+  m_pInputStream.reset(new std::istream(m_pInputBuffer.get()));
+  m_pScanner.reset(new Scanner(*m_pInputStream, StringRef(*m_pInput)));
+  m_pDirectives.reset(new Directives);
+}
+
+void Parser::Load(std::shared_ptr<const std::string> input, const Mark& start,
+                  std::size_t size, const Parser* context) {
+  m_pScanner.reset();
+  m_pInputStream.reset();
+  m_pInputBuffer.reset();
+
+  m_pInput = std::move(input);
+  if (!m_pInput) {
+    m_pInput = std::make_shared<const std::string>();
+  }
+
+  // positions count from after any byte order mark
+  std::size_t offset = static_cast<std::size_t>(start.pos);
+  if (m_pInput->compare(0, 3, "\xEF\xBB\xBF") == 0) {
+    offset += 3;
+  }
+  offset = std::min(offset, m_pInput->size());
+  size = std::min(size, m_pInput->size() - offset);
+
+  m_pInputBuffer.reset(new InputBuffer(m_pInput->data() + offset, size));
+  m_pInputStream.reset(new std::istream(m_pInputBuffer.get()));
+  m_pScanner.reset(
+      new Scanner(*m_pInputStream, StringRef(*m_pInput), start));
+  if (context && context->m_pDirectives) {
+    m_pDirectives.reset(new Directives(*context->m_pDirectives));
+  } else {
+    m_pDirectives.reset(new Directives);
+  }
+}
+
+void Parser::SetLimits(const ParseLimits& limits) {
+  m_pLimits.reset(new ParseLimits(limits));
+}
+
 bool Parser::HandleNextDocument(EventHandler& eventHandler) {
   if (!m_pScanner.get())
     return false;
@@ -35,7 +110,7 @@ bool Parser::HandleNextDocument(EventHandler& eventHandler) {
     return false;
   }
 
-  SingleDocParser sdp(*m_pScanner, *m_pDirectives);
+  SingleDocParser sdp(*m_pScanner, *m_pDirectives, m_pLimits.get());
   sdp.HandleDocument(eventHandler);
   return true;
 }
@@ -0,0 +1,159 @@
+#include "yaml-cpp/node/path.h"
+
+#include <limits>
+
+#include "stringpool.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/memory.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+namespace {
+bool IsKeyChar(char ch) {
+  return ch != '.' && ch != '[' && ch != ']' && ch != '*';
+}
+
+bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+}
+
+Path::Path(const std::string& expression) : m_expression(expression) {
+  Compile();
+}
+
+NodeView Path::Find(const NodeView& root) const {
+  struct First : public Visitor {
+    virtual bool operator()(const NodeView& match) {
+      first = match;
+      return false;
+    }
+    NodeView first;
+  } visitor;
+  Visit(root, visitor);
+  return visitor.first;
+}
+
+// Compile
+// . Splits the expression into steps, and hashes each key.
+// . Throws BadPath if it isn't a path.
+void Path::Compile() {
+  const std::string& expr = m_expression;
+  std::size_t i = 0;
+  while (i < expr.size()) {
+    Step step;
+    step.kind = Step::Key;
+    step.hash = 0;
+    step.index = 0;
+
+    if (expr[i] == '[') {
+      i++;
+      if (i < expr.size() && expr[i] == '*') {
+        step.kind = Step::Wildcard;
+        i++;
+      } else if (i < expr.size() && IsDigit(expr[i])) {
+        step.kind = Step::Index;
+        for (; i < expr.size() && IsDigit(expr[i]); i++) {
+          const std::size_t digit = static_cast<std::size_t>(expr[i] - '0');
+          if (step.index > (std::numeric_limits<std::size_t>::max() - digit) /
+                               10)
+            throw BadPath(expr);
+          step.index = step.index * 10 + digit;
+          step.key += expr[i];
+        }
+      } else if (i < expr.size() && expr[i] == '"') {
+        for (i++; i < expr.size() && expr[i] != '"'; i++) {
+          if (expr[i] == '\\' && i + 1 < expr.size())
+            i++;
+          step.key += expr[i];
+        }
+        if (i++ >= expr.size())
+          throw BadPath(expr);
+      } else if (i < expr.size() && expr[i] == '\'') {
+        for (i++; i < expr.size(); i++) {
+          if (expr[i] == '\'') {
+            if (i + 1 >= expr.size() || expr[i + 1] != '\'')
+              break;
+            i++;
+          }
+          step.key += expr[i];
+        }
+        if (i++ >= expr.size())
+          throw BadPath(expr);
+      } else {
+        throw BadPath(expr);
+      }
+
+      if (i >= expr.size() || expr[i] != ']')
+        throw BadPath(expr);
+      i++;
+    } else {
+      // every key but the first comes after a dot
+      if (!m_steps.empty()) {
+        if (expr[i] != '.')
+          throw BadPath(expr);
+        i++;
+      }
+
+      if (i < expr.size() && expr[i] == '*') {
+        step.kind = Step::Wildcard;
+        i++;
+      } else {
+        const std::size_t start = i;
+        while (i < expr.size() && IsKeyChar(expr[i]))
+          i++;
+        if (i == start)
+          throw BadPath(expr);
+        step.key = expr.substr(start, i - start);
+      }
+    }
+
+    if (step.kind != Step::Wildcard)
+      step.hash = detail::hash_string(StringRef(step.key));
+    m_steps.push_back(step);
+  }
+}
+
+void Path::Visit(const NodeView& root, Visitor& visitor) const {
+  if (root.m_pNode)
+    Visit(0, *root.m_pNode, *root.m_pMemory, visitor);
+}
+
+// Visit
+// . Takes each way that the steps from 'step' on match from 'node', depth
+//   first, and hands each match to the visitor.
+// . Returns false once the visitor has said to stop.
+bool Path::Visit(std::size_t step, const detail::node& node,
+                 detail::memory_holder& memory, Visitor& visitor) const {
+  if (step == m_steps.size())
+    return !node.is_defined() || visitor(NodeView(&node, &memory));
+
+  const Step& current = m_steps[step];
+  const detail::node* pNext = NULL;
+  switch (current.kind) {
+    case Step::Key:
+      pNext = node.find_key(StringRef(current.key), current.hash);
+      break;
+    case Step::Index:
+      if (node.type() == NodeType::Sequence)
+        pNext = node.get(current.index, memory);
+      else
+        pNext = node.find_key(StringRef(current.key), current.hash);
+      break;
+    case Step::Wildcard:
+      if (node.type() != NodeType::Sequence && node.type() != NodeType::Map)
+        return true;
+      for (detail::const_node_iterator it = node.begin(); it != node.end();
+           ++it) {
+        const detail::const_node_iterator::value_type& entry = *it;
+        const detail::node* pEntry = entry.pNode ? entry.pNode : entry.second;
+        if (pEntry && !Visit(step + 1, *pEntry, memory, visitor))
+          return false;
+      }
+      return true;
+  }
+
+  return !pNext || Visit(step + 1, *pNext, memory, visitor);
+}
+}
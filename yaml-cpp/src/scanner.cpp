@@ -14,6 +14,21 @@ Scanner::Scanner(std::istream& in)
       m_simpleKeyAllowed(false),
       m_canBeJSONFlow(false) {}
 
+Scanner::Scanner(std::istream& in, const StringRef& retained)
+    : INPUT(in, retained),
+      m_startedStream(false),
+      m_endedStream(false),
+      m_simpleKeyAllowed(false),
+      m_canBeJSONFlow(false) {}
+
+Scanner::Scanner(std::istream& in, const StringRef& retained,
+                 const Mark& start)
+    : INPUT(in, retained, start),
+      m_startedStream(false),
+      m_endedStream(false),
+      m_simpleKeyAllowed(false),
+      m_canBeJSONFlow(false) {}
+
 Scanner::~Scanner() {}
 
 bool Scanner::empty() {
@@ -240,10 +255,7 @@ const RegEx& Scanner::GetValueRegex() const {
 void Scanner::StartStream() {
   m_startedStream = true;
   m_simpleKeyAllowed = true;
-  std::unique_ptr<IndentMarker> pIndent(
-      new IndentMarker(-1, IndentMarker::NONE));
-  m_indentRefs.push_back(std::move(pIndent));
-  m_indents.push(&m_indentRefs.back());
+  m_indents.push(AcquireIndent(IndentMarker(-1, IndentMarker::NONE)));
 }
 
 void Scanner::EndStream() {
@@ -260,8 +272,7 @@ void Scanner::EndStream() {
 }
 
 Token* Scanner::PushToken(Token::TYPE type) {
-  m_tokens.push(Token(type, INPUT.mark()));
-  return &m_tokens.back();
+  return &m_tokens.push(type, INPUT.mark());
 }
 
 Token::TYPE Scanner::GetStartTokenFor(IndentMarker::INDENT_TYPE type) const {
@@ -285,8 +296,7 @@ Scanner::IndentMarker* Scanner::PushIndentTo(int column,
     return nullptr;
   }
 
-  std::unique_ptr<IndentMarker> pIndent(new IndentMarker(column, type));
-  IndentMarker& indent = *pIndent;
+  IndentMarker indent(column, type);
   const IndentMarker& lastIndent = *m_indents.top();
 
   // is this actually an indentation?
@@ -303,9 +313,9 @@ Scanner::IndentMarker* Scanner::PushIndentTo(int column,
   indent.pStartToken = PushToken(GetStartTokenFor(type));
 
   // and then the indent
-  m_indents.push(&indent);
-  m_indentRefs.push_back(std::move(pIndent));
-  return &m_indentRefs.back();
+  IndentMarker* pIndent = AcquireIndent(indent);
+  m_indents.push(pIndent);
+  return pIndent;
 }
 
 void Scanner::PopIndentToHere() {
@@ -353,8 +363,10 @@ void Scanner::PopAllIndents() {
 }
 
 void Scanner::PopIndent() {
-  const IndentMarker& indent = *m_indents.top();
+  IndentMarker* pIndent = m_indents.top();
+  const IndentMarker& indent = *pIndent;
   m_indents.pop();
+  m_retiredIndents.push_back(pIndent);
 
   if (indent.status != IndentMarker::VALID) {
     InvalidateSimpleKey();
@@ -362,10 +374,31 @@ void Scanner::PopIndent() {
   }
 
   if (indent.type == IndentMarker::SEQ) {
-    m_tokens.push(Token(Token::BLOCK_SEQ_END, INPUT.mark()));
+    m_tokens.push(Token::BLOCK_SEQ_END, INPUT.mark());
   } else if (indent.type == IndentMarker::MAP) {
-    m_tokens.push(Token(Token::BLOCK_MAP_END, INPUT.mark()));
+    m_tokens.push(Token::BLOCK_MAP_END, INPUT.mark());
+  }
+}
+
+Scanner::IndentMarker* Scanner::AcquireIndent(const IndentMarker& indent) {
+  // a simple key may still point at a retired marker, so we only recycle
+  // them when there are no simple keys around
+  if (m_simpleKeys.empty()) {
+    m_freeIndents.insert(m_freeIndents.end(), m_retiredIndents.begin(),
+                         m_retiredIndents.end());
+    m_retiredIndents.clear();
+  }
+
+  if (m_freeIndents.empty()) {
+    std::unique_ptr<IndentMarker> pIndent(new IndentMarker(indent));
+    m_indentRefs.push_back(std::move(pIndent));
+    return &m_indentRefs.back();
   }
+
+  IndentMarker* pIndent = m_freeIndents.back();
+  m_freeIndents.pop_back();
+  *pIndent = indent;
+  return pIndent;
 }
 
 int Scanner::GetTopIndent() const {
@@ -10,14 +10,15 @@
 #include <cstddef>
 #include <ios>
 #include <map>
-#include <queue>
 #include <set>
 #include <stack>
 #include <string>
+#include <vector>
 
 #include "ptr_vector.h"
 #include "stream.h"
 #include "token.h"
+#include "tokenqueue.h"
 #include "yaml-cpp/mark.h"
 
 namespace YAML {
@@ -30,6 +31,19 @@ class RegEx;
 class Scanner {
  public:
   explicit Scanner(std::istream &in);
+
+  /**
+   * Scans memory-resident input; {@code retained} holds the same bytes as
+   * {@code in}, and scalars may refer to it instead of copying.
+   */
+  Scanner(std::istream &in, const StringRef &retained);
+
+  /**
+   * Scans part of memory-resident input, which {@code in} reads from the
+   * line that starts at {@code start}. The end of a part mustn't fall in a
+   * scalar, so a quoted scalar that runs into it is an error.
+   */
+  Scanner(std::istream &in, const StringRef &retained, const Mark &start);
   ~Scanner();
 
   /** Returns true if there are no more tokens to be read. */
@@ -115,6 +129,12 @@ class Scanner {
 
   /** Pops a single indent, pushing the proper token. */
   void PopIndent();
+
+  /**
+   * Returns a recycled indent marker if one is free (or allocates one),
+   * initialized to {@code indent}.
+   */
+  IndentMarker *AcquireIndent(const IndentMarker &indent);
   int GetTopIndent() const;
 
   // checking input
@@ -174,16 +194,21 @@ class Scanner {
   Stream INPUT;
 
   // the output (tokens)
-  std::queue<Token> m_tokens;
+  TokenQueue m_tokens;
 
   // state info
   bool m_startedStream, m_endedStream;
   bool m_simpleKeyAllowed;
   bool m_canBeJSONFlow;
-  std::stack<SimpleKey> m_simpleKeys;
-  std::stack<IndentMarker *> m_indents;
-  ptr_vector<IndentMarker> m_indentRefs;  // for "garbage collection"
-  std::stack<FLOW_MARKER> m_flows;
+  std::stack<SimpleKey, std::vector<SimpleKey>> m_simpleKeys;
+  std::stack<IndentMarker *, std::vector<IndentMarker *>> m_indents;
+  std::stack<FLOW_MARKER, std::vector<FLOW_MARKER>> m_flows;
+
+  // indent markers are owned by m_indentRefs, and recycled: popped markers
+  // are retired, and become free once no simple key can refer to them
+  ptr_vector<IndentMarker> m_indentRefs;
+  std::vector<IndentMarker *> m_retiredIndents;
+  std::vector<IndentMarker *> m_freeIndents;
 };
 }
 
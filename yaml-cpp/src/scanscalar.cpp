@@ -8,6 +8,104 @@
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 
 namespace YAML {
+namespace {
+// ScalarBuffer
+// . Accumulates the scalar. When referring to retained input, it only tracks
+//   the run of input that makes up the scalar, and falls back to copying
+//   once the scalar stops matching the input (an escape, or a fold).
+// . Folds are held back as pending, since they're usually trimmed at the end.
+class ScalarBuffer {
+ public:
+  ScalarBuffer(std::string& scalar, bool refer)
+      : m_refer(refer), m_pRun(nullptr), m_runSize(0), m_scalar(scalar) {
+    m_scalar.clear();
+  }
+
+  std::size_t size() const {
+    return m_refer ? m_runSize + m_pending.size() : m_scalar.size();
+  }
+
+  // a character read from the input at 'at' (if retained)
+  void push_input(const char* at, char ch) {
+    if (m_refer) {
+      if (m_pending.empty()) {
+        if (m_runSize == 0)
+          m_pRun = at;
+        if (at == m_pRun + m_runSize) {
+          m_runSize++;
+          return;
+        }
+      }
+      materialize();
+    }
+    m_scalar += ch;
+  }
+
+  // characters that don't appear in the input as-is
+  void append(const std::string& str) {
+    if (m_refer)
+      materialize();
+    m_scalar += str;
+  }
+
+  void fold(const std::string& str) {
+    if (m_refer)
+      m_pending += str;
+    else
+      m_scalar += str;
+  }
+
+  void erase(std::size_t pos) {
+    if (!m_refer) {
+      m_scalar.erase(pos);
+    } else if (pos <= m_runSize) {
+      m_runSize = pos;
+      m_pending.clear();
+    } else {
+      m_pending.erase(pos - m_runSize);
+    }
+  }
+
+  std::size_t find_last_not_of(char ch) const {
+    if (!m_refer)
+      return m_scalar.find_last_not_of(ch);
+
+    std::size_t pos = m_pending.find_last_not_of(ch);
+    if (pos != std::string::npos)
+      return m_runSize + pos;
+    for (std::size_t i = m_runSize; i > 0; i--) {
+      if (m_pRun[i - 1] != ch)
+        return i - 1;
+    }
+    return std::string::npos;
+  }
+
+  // finish
+  // . Sets 'ref' if we still match the input (and otherwise, the scalar has
+  //   been written out).
+  void finish(StringRef& ref) {
+    if (m_refer && !m_pending.empty())
+      materialize();
+    if (m_refer)
+      ref = (m_runSize > 0 ? StringRef(m_pRun, m_runSize) : StringRef("", 0));
+  }
+
+ private:
+  void materialize() {
+    m_scalar.assign(m_pRun ? m_pRun : "", m_runSize);
+    m_scalar += m_pending;
+    m_pending.clear();
+    m_refer = false;
+  }
+
+  bool m_refer;
+  const char* m_pRun;
+  std::size_t m_runSize;
+  std::string m_pending;
+  std::string& m_scalar;
+};
+}
+
 // ScanScalar
 // . This is where the scalar magic happens.
 //
@@ -18,15 +116,18 @@ namespace YAML {
 //
 // . Depending on the parameters given, we store or stop
 //   and different places in the above flow.
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
+void ScanScalar(Stream& INPUT, ScanScalarParams& params,
+                std::string& output) {
   bool foundNonEmptyLine = false;
+  bool foundEnd = false;
   bool pastOpeningBreak = (params.fold == FOLD_FLOW);
   bool emptyLine = false, moreIndented = false;
   int foldedNewlineCount = 0;
   bool foldedNewlineStartedMoreIndented = false;
   std::size_t lastEscapedChar = std::string::npos;
-  std::string scalar;
+  ScalarBuffer scalar(output, params.referInput && INPUT.retained());
   params.leadingSpaces = false;
+  params.ref = StringRef();
 
   if (!params.end) {
     params.end = &Exp::Empty();
@@ -67,15 +168,16 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
       // escape this?
       if (INPUT.peek() == params.escape) {
-        scalar += Exp::Escape(INPUT);
+        scalar.append(Exp::Escape(INPUT));
         lastNonWhitespaceChar = scalar.size();
         lastEscapedChar = scalar.size();
         continue;
       }
 
       // otherwise, just add the damn character
+      const char* at = INPUT.retained();
       char ch = INPUT.get();
-      scalar += ch;
+      scalar.push_input(at, ch);
       if (ch != ' ' && ch != '\t') {
         lastNonWhitespaceChar = scalar.size();
       }
@@ -101,6 +203,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
       if (params.eatEnd) {
         INPUT.eat(n);
       }
+      foundEnd = true;
       break;
     }
 
@@ -159,32 +262,32 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     if (pastOpeningBreak) {
       switch (params.fold) {
         case DONT_FOLD:
-          scalar += "\n";
+          scalar.fold("\n");
           break;
         case FOLD_BLOCK:
           if (!emptyLine && !nextEmptyLine && !moreIndented &&
               !nextMoreIndented && INPUT.column() >= params.indent) {
-            scalar += " ";
+            scalar.fold(" ");
           } else if (nextEmptyLine) {
             foldedNewlineCount++;
           } else {
-            scalar += "\n";
+            scalar.fold("\n");
           }
 
           if (!nextEmptyLine && foldedNewlineCount > 0) {
-            scalar += std::string(foldedNewlineCount - 1, '\n');
+            scalar.fold(std::string(foldedNewlineCount - 1, '\n'));
             if (foldedNewlineStartedMoreIndented ||
                 nextMoreIndented | !foundNonEmptyLine) {
-              scalar += "\n";
+              scalar.fold("\n");
             }
             foldedNewlineCount = 0;
           }
           break;
         case FOLD_FLOW:
           if (nextEmptyLine) {
-            scalar += "\n";
+            scalar.fold("\n");
           } else if (!emptyLine && !nextEmptyLine && !escapedNewline) {
-            scalar += " ";
+            scalar.fold(" ");
           }
           break;
       }
@@ -201,6 +304,13 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     }
   }
 
+  // a quoted scalar is let off running into the end of the input (after a
+  // line break, anyway), but the end of a partial stream may well have cut
+  // it short
+  if (params.eatEnd && !foundEnd && INPUT.partial()) {
+    throw ParserException(INPUT.mark(), ErrorMsg::EOF_IN_SCALAR);
+  }
+
   // post-processing
   if (params.trimTrailingSpaces) {
     std::size_t pos = scalar.find_last_not_of(' ');
@@ -223,7 +333,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
         }
       }
       if (pos == std::string::npos) {
-        scalar.erase();
+        scalar.erase(0);
       } else if (pos + 1 < scalar.size()) {
         scalar.erase(pos + 2);
       }
@@ -236,7 +346,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
         }
       }
       if (pos == std::string::npos) {
-        scalar.erase();
+        scalar.erase(0);
       } else if (pos < scalar.size()) {
         scalar.erase(pos + 1);
       }
@@ -245,6 +355,6 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
       break;
   }
 
-  return scalar;
+  scalar.finish(params.ref);
 }
 }
@@ -11,6 +11,7 @@
 
 #include "regex_yaml.h"
 #include "stream.h"
+#include "yaml-cpp/stringref.h"
 
 namespace YAML {
 enum CHOMP { STRIP = -1, CLIP, KEEP };
@@ -30,6 +31,7 @@ struct ScanScalarParams {
         chomp(CLIP),
         onDocIndicator(NONE),
         onTabInIndentation(NONE),
+        referInput(false),
         leadingSpaces(false) {}
 
   // input:
@@ -52,12 +54,17 @@ struct ScanScalarParams {
   ACTION onDocIndicator;      // what do we do if we see a document indicator?
   ACTION onTabInIndentation;  // what do we do if we see a tab where we should
                               // be seeing indentation spaces
+  bool referInput;  // may we refer to the input instead of copying (if it's
+                    // retained)?
 
   // output:
   bool leadingSpaces;
+  StringRef ref;  // if valid, the scalar is this run of the retained input
+                  // (and the output string is left empty)
 };
 
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& info);
+// Scans into 'scalar' (replacing its contents, but keeping its capacity).
+void ScanScalar(Stream& INPUT, ScanScalarParams& info, std::string& scalar);
 }
 
 #endif  // SCANSCALAR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,8 +1,9 @@
 #include <algorithm>
+#include <cassert>
 #include <cstdio>
 #include <sstream>
+#include <utility>
 
-#include "collectionstack.h"  // IWYU pragma: keep
 #include "scanner.h"
 #include "singledocparser.h"
 #include "tag.h"
@@ -14,11 +15,28 @@
 #include "yaml-cpp/null.h"
 
 namespace YAML {
-SingleDocParser::SingleDocParser(Scanner& scanner, const Directives& directives)
+namespace {
+void SetEvent(ParserEvent& event, EventType::value type, const Mark& mark) {
+  event.type = type;
+  event.mark = mark;
+  event.tag.clear();
+  event.anchor = NullAnchor;
+  event.style = EmitterStyle::Default;
+  event.pScalar = nullptr;
+  event.scalarRef = StringRef();
+}
+}
+
+SingleDocParser::SingleDocParser(Scanner& scanner,
+                                 const Directives& directives,
+                                 const ParseLimits* pLimits)
     : m_scanner(scanner),
       m_directives(directives),
-      m_pCollectionStack(new CollectionStack),
-      m_curAnchor(0) {}
+      m_popPending(false),
+      m_curAnchor(0),
+      m_pLimits(pLimits ? new DocumentLimits(*pLimits) : nullptr) {
+  PushFrame(CollectionType::NoCollection, Start, Mark());
+}
 
 SingleDocParser::~SingleDocParser() {}
 
@@ -29,26 +47,251 @@ void SingleDocParser::HandleDocument(EventHandler& eventHandler) {
   assert(!m_scanner.empty());  // guaranteed that there are tokens
   assert(!m_curAnchor);
 
-  eventHandler.OnDocumentStart(m_scanner.peek().mark);
+  ParserEvent event;
+  while (NextEvent(event)) {
+    if (m_pLimits) {
+      std::size_t scalarBytes = 0;
+      if (event.type == EventType::Scalar)
+        scalarBytes = event.scalarRef.valid() ? event.scalarRef.size()
+                                              : event.pScalar->size();
+      m_pLimits->Count(event.type, event.mark, event.anchor, scalarBytes);
+    }
+
+    switch (event.type) {
+      case EventType::DocumentStart:
+        eventHandler.OnDocumentStart(event.mark);
+        break;
+      case EventType::DocumentEnd:
+        eventHandler.OnDocumentEnd();
+        break;
+      case EventType::Null:
+        eventHandler.OnNull(event.mark, event.anchor);
+        break;
+      case EventType::Alias:
+        eventHandler.OnAlias(event.mark, event.anchor);
+        break;
+      case EventType::Scalar:
+        if (event.scalarRef.valid())
+          eventHandler.OnScalarRef(event.mark, event.tag, event.anchor,
+                                   event.scalarRef);
+        else
+          HandleScalarMove(eventHandler, event);
+        break;
+      case EventType::SequenceStart:
+        eventHandler.OnSequenceStart(event.mark, event.tag, event.anchor,
+                                     event.style);
+        break;
+      case EventType::SequenceEnd:
+        eventHandler.OnSequenceEnd();
+        break;
+      case EventType::MapStart:
+        eventHandler.OnMapStart(event.mark, event.tag, event.anchor,
+                                event.style);
+        break;
+      case EventType::MapEnd:
+        eventHandler.OnMapEnd();
+        break;
+    }
+  }
+}
+
+// HandleScalarMove
+// . Offers the handler the scalar's own copy. If it takes it, the token it
+//   came from gets a buffer of the same size, since otherwise scanning into
+//   it again would grow it a character at a time (which costs more than the
+//   copy that was saved).
+void SingleDocParser::HandleScalarMove(EventHandler& eventHandler,
+                                       ParserEvent& event) {
+  const std::size_t capacity = event.pScalar->capacity();
+  eventHandler.OnScalarMove(event.mark, event.tag, event.anchor,
+                            std::move(*event.pScalar));
+  event.pScalar->reserve(capacity);
+}
+
+// NextEvent
+// . Runs the innermost frame until it gives an event. Each step either gives
+//   one itself, or starts a node (which always gives one).
+// . Throws a ParserException on error.
+bool SingleDocParser::NextEvent(ParserEvent& event) {
+  // a scalar's token stays in the queue for as long as it's the last event
+  if (m_popPending) {
+    m_scanner.pop();
+    m_popPending = false;
+  }
+
+  Frame& frame = m_frames.back();
+  switch (frame.type) {
+    case CollectionType::NoCollection:
+      break;
+    case CollectionType::BlockSeq:
+      return NextInBlockSequence(frame, event);
+    case CollectionType::FlowSeq:
+      return NextInFlowSequence(frame, event);
+    case CollectionType::BlockMap:
+      return NextInBlockMap(frame, event);
+    case CollectionType::FlowMap:
+      return NextInFlowMap(frame, event);
+    case CollectionType::CompactMap:
+      return NextInCompactMap(frame, event);
+  }
+
+  // the document itself
+  switch (frame.phase) {
+    case Start:
+      SetEvent(event, EventType::DocumentStart, m_scanner.peek().mark);
+
+      // eat doc start
+      if (m_scanner.peek().type == Token::DOC_START)
+        m_scanner.pop();
+      frame.phase = Value;
+      return true;
+    case Value:
+      // recurse!
+      frame.phase = End;
+      HandleNode(event);
+      return true;
+    case End:
+      SetEvent(event, EventType::DocumentEnd, m_scanner.mark());
+
+      // and finally eat any doc ends we see
+      while (!m_scanner.empty() && m_scanner.peek().type == Token::DOC_END)
+        m_scanner.pop();
+      frame.phase = Done;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// SkipCollection
+// . Skips the tokens of a block or flow collection by counting brackets;
+//   compact maps have none, so they just have their events dropped.
+void SingleDocParser::SkipCollection(ParserEvent& event) {
+  if (event.type != EventType::SequenceStart &&
+      event.type != EventType::MapStart)
+    return;
+
+  const Frame& frame = m_frames.back();
+  if (frame.type == CollectionType::CompactMap) {
+    const std::size_t depth = m_frames.size();
+    while (NextEvent(event) && m_frames.size() >= depth) {
+    }
+    return;
+  }
+
+  const CollectionType::value type = frame.type;
+  const char* error = ErrorMsg::END_OF_SEQ;
+  switch (type) {
+    case CollectionType::FlowSeq:
+      error = ErrorMsg::END_OF_SEQ_FLOW;
+      break;
+    case CollectionType::BlockMap:
+      error = ErrorMsg::END_OF_MAP;
+      break;
+    case CollectionType::FlowMap:
+      error = ErrorMsg::END_OF_MAP_FLOW;
+      break;
+    default:
+      break;
+  }
 
-  // eat doc start
-  if (m_scanner.peek().type == Token::DOC_START)
+  int depth = 0;
+  Mark mark;
+  do {
+    if (m_scanner.empty())
+      throw ParserException(m_scanner.mark(), error);
+
+    const Token& token = m_scanner.peek();
+    switch (token.type) {
+      case Token::BLOCK_SEQ_START:
+      case Token::BLOCK_MAP_START:
+      case Token::FLOW_SEQ_START:
+      case Token::FLOW_MAP_START:
+        depth++;
+        break;
+      case Token::BLOCK_SEQ_END:
+      case Token::BLOCK_MAP_END:
+      case Token::FLOW_SEQ_END:
+      case Token::FLOW_MAP_END:
+        depth--;
+        break;
+      case Token::ANCHOR:
+        // so that later anchors get the same numbers
+        RegisterAnchor(token.value);
+        break;
+      case Token::DOC_START:
+      case Token::DOC_END:
+        throw ParserException(token.mark, error);
+      default:
+        break;
+    }
+    mark = token.mark;
     m_scanner.pop();
+  } while (depth > 0);
+
+  m_frames.pop_back();
+  SetEvent(event,
+           type == CollectionType::BlockSeq || type == CollectionType::FlowSeq
+               ? EventType::SequenceEnd
+               : EventType::MapEnd,
+           mark);
+}
 
-  // recurse!
-  HandleNode(eventHandler);
+// NextPlainEntry
+// . Does what NextInFlowSequence would, up to the entry itself; that's as
+//   far as it goes if the entry is anything but a plain (or quoted) scalar,
+//   which leaves the frame ready for NextEvent to carry on from there.
+bool SingleDocParser::NextPlainEntry(StringRef& scalar, Mark& mark) {
+  if (m_frames.back().type != CollectionType::FlowSeq)
+    return false;
 
-  eventHandler.OnDocumentEnd();
+  if (m_popPending) {
+    m_scanner.pop();
+    m_popPending = false;
+  }
 
-  // and finally eat any doc ends we see
-  while (!m_scanner.empty() && m_scanner.peek().type == Token::DOC_END)
+  Frame& frame = m_frames.back();
+  if (frame.phase == Start) {
     m_scanner.pop();
+    frame.phase = Entry;
+  }
+
+  if (frame.phase == Separator) {
+    if (m_scanner.empty())
+      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
+
+    Token& token = m_scanner.peek();
+    if (token.type == Token::FLOW_ENTRY)
+      m_scanner.pop();
+    else if (token.type != Token::FLOW_SEQ_END)
+      throw ParserException(token.mark, ErrorMsg::END_OF_SEQ_FLOW);
+    frame.phase = Entry;
+  }
+
+  if (m_scanner.empty())
+    return false;
+
+  Token& token = m_scanner.peek();
+  if (token.type != Token::PLAIN_SCALAR &&
+      token.type != Token::NON_PLAIN_SCALAR)
+    return false;
+  scalar = token.ref.valid() ? token.ref : StringRef(token.value);
+  if (token.type == Token::PLAIN_SCALAR && IsNullString(scalar))
+    return false;
+
+  mark = token.mark;
+  frame.phase = Separator;
+  m_popPending = true;
+  return true;
 }
 
-void SingleDocParser::HandleNode(EventHandler& eventHandler) {
+// HandleNode
+// . Starts a node, which gives exactly one event: either the whole node, or
+//   the start of a collection (whose frame is pushed).
+void SingleDocParser::HandleNode(ParserEvent& event) {
   // an empty node *is* a possibility
   if (m_scanner.empty()) {
-    eventHandler.OnNull(m_scanner.mark(), NullAnchor);
+    SetEvent(event, EventType::Null, m_scanner.mark());
     return;
   }
 
@@ -57,27 +300,30 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
 
   // special case: a value node by itself must be a map, with no header
   if (m_scanner.peek().type == Token::VALUE) {
-    eventHandler.OnMapStart(mark, "?", NullAnchor, EmitterStyle::Default);
-    HandleMap(eventHandler);
-    eventHandler.OnMapEnd();
+    SetEvent(event, EventType::MapStart, mark);
+    event.tag = "?";
+    PushFrame(CollectionType::CompactMap, Start, mark);
     return;
   }
 
   // special case: an alias node
   if (m_scanner.peek().type == Token::ALIAS) {
-    eventHandler.OnAlias(mark, LookupAnchor(mark, m_scanner.peek().value));
+    SetEvent(event, EventType::Alias, mark);
+    event.anchor = LookupAnchor(mark, m_scanner.peek().value);
     m_scanner.pop();
     return;
   }
 
-  std::string tag;
-  anchor_t anchor;
-  ParseProperties(tag, anchor);
+  SetEvent(event, EventType::Null, mark);
+  std::string& tag = event.tag;
+  ParseProperties(tag, event.anchor);
 
-  const Token& token = m_scanner.peek();
+  Token& token = m_scanner.peek();
 
-  if (token.type == Token::PLAIN_SCALAR && IsNullString(token.value)) {
-    eventHandler.OnNull(mark, anchor);
+  if (token.type == Token::PLAIN_SCALAR &&
+      (token.ref.valid() ? IsNullString(token.ref)
+                         : IsNullString(token.value))) {
+    tag.clear();
     m_scanner.pop();
     return;
   }
@@ -90,36 +336,39 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
   switch (token.type) {
     case Token::PLAIN_SCALAR:
     case Token::NON_PLAIN_SCALAR:
-      eventHandler.OnScalar(mark, tag, anchor, token.value);
-      m_scanner.pop();
+      event.type = EventType::Scalar;
+      if (token.ref.valid())
+        event.scalarRef = token.ref;
+      else
+        event.pScalar = &token.value;
+      m_popPending = true;
       return;
     case Token::FLOW_SEQ_START:
-      eventHandler.OnSequenceStart(mark, tag, anchor, EmitterStyle::Flow);
-      HandleSequence(eventHandler);
-      eventHandler.OnSequenceEnd();
+      event.type = EventType::SequenceStart;
+      event.style = EmitterStyle::Flow;
+      PushFrame(CollectionType::FlowSeq, Start, mark);
       return;
     case Token::BLOCK_SEQ_START:
-      eventHandler.OnSequenceStart(mark, tag, anchor, EmitterStyle::Block);
-      HandleSequence(eventHandler);
-      eventHandler.OnSequenceEnd();
+      event.type = EventType::SequenceStart;
+      event.style = EmitterStyle::Block;
+      PushFrame(CollectionType::BlockSeq, Start, mark);
       return;
     case Token::FLOW_MAP_START:
-      eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Flow);
-      HandleMap(eventHandler);
-      eventHandler.OnMapEnd();
+      event.type = EventType::MapStart;
+      event.style = EmitterStyle::Flow;
+      PushFrame(CollectionType::FlowMap, Start, mark);
       return;
     case Token::BLOCK_MAP_START:
-      eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Block);
-      HandleMap(eventHandler);
-      eventHandler.OnMapEnd();
+      event.type = EventType::MapStart;
+      event.style = EmitterStyle::Block;
+      PushFrame(CollectionType::BlockMap, Start, mark);
       return;
     case Token::KEY:
       // compact maps can only go in a flow sequence
-      if (m_pCollectionStack->GetCurCollectionType() ==
-          CollectionType::FlowSeq) {
-        eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Flow);
-        HandleMap(eventHandler);
-        eventHandler.OnMapEnd();
+      if (m_frames.back().type == CollectionType::FlowSeq) {
+        event.type = EventType::MapStart;
+        event.style = EmitterStyle::Flow;
+        PushFrame(CollectionType::CompactMap, Key, mark);
         return;
       }
       break;
@@ -127,157 +376,161 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
       break;
   }
 
-  if (tag == "?")
-    eventHandler.OnNull(mark, anchor);
-  else
-    eventHandler.OnScalar(mark, tag, anchor, "");
-}
-
-void SingleDocParser::HandleSequence(EventHandler& eventHandler) {
-  // split based on start token
-  switch (m_scanner.peek().type) {
-    case Token::BLOCK_SEQ_START:
-      HandleBlockSequence(eventHandler);
-      break;
-    case Token::FLOW_SEQ_START:
-      HandleFlowSequence(eventHandler);
-      break;
-    default:
-      break;
+  if (tag == "?") {
+    tag.clear();
+  } else {
+    event.type = EventType::Scalar;
+    m_emptyScalar.clear();
+    event.pScalar = &m_emptyScalar;
   }
 }
 
-void SingleDocParser::HandleBlockSequence(EventHandler& eventHandler) {
+// Each of the NextIn... functions below takes its frame one step. They may
+// start a node, which can push a frame (and so invalidate 'frame'), so that
+// always comes last.
+
+bool SingleDocParser::NextInBlockSequence(Frame& frame, ParserEvent& event) {
   // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::BlockSeq);
+  if (frame.phase == Start) {
+    m_scanner.pop();
+    frame.phase = Entry;
+  }
 
-  while (1) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ);
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ);
 
-    Token token = m_scanner.peek();
-    if (token.type != Token::BLOCK_ENTRY && token.type != Token::BLOCK_SEQ_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_SEQ);
+  const Token& token = m_scanner.peek();
+  const Token::TYPE type = token.type;
+  const Mark mark = token.mark;
+  if (type != Token::BLOCK_ENTRY && type != Token::BLOCK_SEQ_END)
+    throw ParserException(mark, ErrorMsg::END_OF_SEQ);
 
-    m_scanner.pop();
-    if (token.type == Token::BLOCK_SEQ_END)
-      break;
+  m_scanner.pop();
+  if (type == Token::BLOCK_SEQ_END) {
+    EndCollection(event, EventType::SequenceEnd, mark);
+    return true;
+  }
 
-    // check for null
-    if (!m_scanner.empty()) {
-      const Token& token = m_scanner.peek();
-      if (token.type == Token::BLOCK_ENTRY ||
-          token.type == Token::BLOCK_SEQ_END) {
-        eventHandler.OnNull(token.mark, NullAnchor);
-        continue;
-      }
+  // check for null
+  if (!m_scanner.empty()) {
+    const Token& token = m_scanner.peek();
+    if (token.type == Token::BLOCK_ENTRY ||
+        token.type == Token::BLOCK_SEQ_END) {
+      SetEvent(event, EventType::Null, token.mark);
+      return true;
     }
-
-    HandleNode(eventHandler);
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::BlockSeq);
+  HandleNode(event);
+  return true;
 }
 
-void SingleDocParser::HandleFlowSequence(EventHandler& eventHandler) {
+bool SingleDocParser::NextInFlowSequence(Frame& frame, ParserEvent& event) {
   // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::FlowSeq);
-
-  while (1) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
-
-    // first check for end
-    if (m_scanner.peek().type == Token::FLOW_SEQ_END) {
-      m_scanner.pop();
-      break;
-    }
-
-    // then read the node
-    HandleNode(eventHandler);
+  if (frame.phase == Start) {
+    m_scanner.pop();
+    frame.phase = Entry;
+  }
 
+  // now eat the separator (or could be a sequence end, which we ignore - but
+  // if it's neither, then it's a bad node)
+  if (frame.phase == Separator) {
     if (m_scanner.empty())
       throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
 
-    // now eat the separator (or could be a sequence end, which we ignore - but
-    // if it's neither, then it's a bad node)
     Token& token = m_scanner.peek();
     if (token.type == Token::FLOW_ENTRY)
       m_scanner.pop();
     else if (token.type != Token::FLOW_SEQ_END)
       throw ParserException(token.mark, ErrorMsg::END_OF_SEQ_FLOW);
+    frame.phase = Entry;
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::FlowSeq);
-}
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
 
-void SingleDocParser::HandleMap(EventHandler& eventHandler) {
-  // split based on start token
-  switch (m_scanner.peek().type) {
-    case Token::BLOCK_MAP_START:
-      HandleBlockMap(eventHandler);
-      break;
-    case Token::FLOW_MAP_START:
-      HandleFlowMap(eventHandler);
-      break;
-    case Token::KEY:
-      HandleCompactMap(eventHandler);
-      break;
-    case Token::VALUE:
-      HandleCompactMapWithNoKey(eventHandler);
-      break;
-    default:
-      break;
+  // first check for end
+  if (m_scanner.peek().type == Token::FLOW_SEQ_END) {
+    const Mark mark = m_scanner.peek().mark;
+    m_scanner.pop();
+    EndCollection(event, EventType::SequenceEnd, mark);
+    return true;
   }
+
+  // then read the node
+  frame.phase = Separator;
+  HandleNode(event);
+  return true;
 }
 
-void SingleDocParser::HandleBlockMap(EventHandler& eventHandler) {
+bool SingleDocParser::NextInBlockMap(Frame& frame, ParserEvent& event) {
   // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::BlockMap);
+  if (frame.phase == Start) {
+    m_scanner.pop();
+    frame.phase = Key;
+  }
 
-  while (1) {
+  if (frame.phase == Key) {
     if (m_scanner.empty())
       throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP);
 
-    Token token = m_scanner.peek();
+    const Token& token = m_scanner.peek();
+    const Mark mark = token.mark;
     if (token.type != Token::KEY && token.type != Token::VALUE &&
         token.type != Token::BLOCK_MAP_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_MAP);
+      throw ParserException(mark, ErrorMsg::END_OF_MAP);
 
     if (token.type == Token::BLOCK_MAP_END) {
       m_scanner.pop();
-      break;
+      EndCollection(event, EventType::MapEnd, mark);
+      return true;
     }
 
     // grab key (if non-null)
+    frame.mark = mark;
+    frame.phase = Value;
     if (token.type == Token::KEY) {
       m_scanner.pop();
-      HandleNode(eventHandler);
+      HandleNode(event);
     } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
-    }
-
-    // now grab value (optional)
-    if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
+      SetEvent(event, EventType::Null, mark);
     }
+    return true;
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::BlockMap);
+  // now grab value (optional)
+  frame.phase = Key;
+  if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
+    m_scanner.pop();
+    HandleNode(event);
+  } else {
+    SetEvent(event, EventType::Null, frame.mark);
+  }
+  return true;
 }
 
-void SingleDocParser::HandleFlowMap(EventHandler& eventHandler) {
+bool SingleDocParser::NextInFlowMap(Frame& frame, ParserEvent& event) {
   // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::FlowMap);
+  if (frame.phase == Start) {
+    m_scanner.pop();
+    frame.phase = Key;
+  }
 
-  while (1) {
+  // now eat the separator (or could be a map end, which we ignore - but if
+  // it's neither, then it's a bad node)
+  if (frame.phase == Separator) {
+    if (m_scanner.empty())
+      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
+
+    Token& nextToken = m_scanner.peek();
+    if (nextToken.type == Token::FLOW_ENTRY)
+      m_scanner.pop();
+    else if (nextToken.type != Token::FLOW_MAP_END)
+      throw ParserException(nextToken.mark, ErrorMsg::END_OF_MAP_FLOW);
+    frame.phase = Key;
+  }
+
+  if (frame.phase == Key) {
     if (m_scanner.empty())
       throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
 
@@ -286,72 +539,81 @@ void SingleDocParser::HandleFlowMap(EventHandler& eventHandler) {
     // first check for end
     if (token.type == Token::FLOW_MAP_END) {
       m_scanner.pop();
-      break;
+      EndCollection(event, EventType::MapEnd, mark);
+      return true;
     }
 
     // grab key (if non-null)
+    frame.mark = mark;
+    frame.phase = Value;
     if (token.type == Token::KEY) {
       m_scanner.pop();
-      HandleNode(eventHandler);
+      HandleNode(event);
     } else {
-      eventHandler.OnNull(mark, NullAnchor);
+      SetEvent(event, EventType::Null, mark);
     }
-
-    // now grab value (optional)
-    if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(mark, NullAnchor);
-    }
-
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
-
-    // now eat the separator (or could be a map end, which we ignore - but if
-    // it's neither, then it's a bad node)
-    Token& nextToken = m_scanner.peek();
-    if (nextToken.type == Token::FLOW_ENTRY)
-      m_scanner.pop();
-    else if (nextToken.type != Token::FLOW_MAP_END)
-      throw ParserException(nextToken.mark, ErrorMsg::END_OF_MAP_FLOW);
+    return true;
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::FlowMap);
-}
-
-// . Single "key: value" pair in a flow sequence
-void SingleDocParser::HandleCompactMap(EventHandler& eventHandler) {
-  m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
-
-  // grab key
-  Mark mark = m_scanner.peek().mark;
-  m_scanner.pop();
-  HandleNode(eventHandler);
-
   // now grab value (optional)
+  frame.phase = Separator;
   if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
     m_scanner.pop();
-    HandleNode(eventHandler);
+    HandleNode(event);
   } else {
-    eventHandler.OnNull(mark, NullAnchor);
+    SetEvent(event, EventType::Null, frame.mark);
   }
-
-  m_pCollectionStack->PopCollectionType(CollectionType::CompactMap);
+  return true;
 }
 
-// . Single ": value" pair in a flow sequence
-void SingleDocParser::HandleCompactMapWithNoKey(EventHandler& eventHandler) {
-  m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
-
-  // null key
-  eventHandler.OnNull(m_scanner.peek().mark, NullAnchor);
+// . Single "key: value" pair in a flow sequence, or a ": value" pair (that
+//   starts in phase Start, rather than Key).
+bool SingleDocParser::NextInCompactMap(Frame& frame, ParserEvent& event) {
+  switch (frame.phase) {
+    case Start:
+      // null key
+      SetEvent(event, EventType::Null, m_scanner.peek().mark);
+      frame.phase = Entry;
+      return true;
+    case Entry:
+      // grab value
+      m_scanner.pop();
+      frame.phase = End;
+      HandleNode(event);
+      return true;
+    case Key:
+      // grab key
+      frame.mark = m_scanner.peek().mark;
+      m_scanner.pop();
+      frame.phase = Value;
+      HandleNode(event);
+      return true;
+    case Value:
+      // now grab value (optional)
+      frame.phase = End;
+      if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
+        m_scanner.pop();
+        HandleNode(event);
+      } else {
+        SetEvent(event, EventType::Null, frame.mark);
+      }
+      return true;
+    default:
+      EndCollection(event, EventType::MapEnd, m_scanner.mark());
+      return true;
+  }
+}
 
-  // grab value
-  m_scanner.pop();
-  HandleNode(eventHandler);
+void SingleDocParser::PushFrame(CollectionType::value type, Phase phase,
+                                const Mark& mark) {
+  Frame frame = {type, phase, mark};
+  m_frames.push_back(frame);
+}
 
-  m_pCollectionStack->PopCollectionType(CollectionType::CompactMap);
+void SingleDocParser::EndCollection(ParserEvent& event, EventType::value type,
+                                    const Mark& mark) {
+  m_frames.pop_back();
+  SetEvent(event, type, mark);
 }
 
 // ParseProperties
@@ -10,38 +10,103 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "collectionstack.h"
+#include "documentlimits.h"
 #include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/eventcursor.h"
+#include "yaml-cpp/mark.h"
 #include "yaml-cpp/noncopyable.h"
+#include "yaml-cpp/stringref.h"
 
 namespace YAML {
-class CollectionStack;
 class EventHandler;
 class Node;
 class Scanner;
 struct Directives;
-struct Mark;
 struct Token;
 
+/**
+ * One event of a document, as pulled from {@link SingleDocParser}. A scalar
+ * either refers to the input, or to a string that stays put until the next
+ * event is pulled (and isn't read after that, so it may be moved from).
+ */
+struct ParserEvent {
+  EventType::value type;
+  Mark mark;
+  std::string tag;
+  anchor_t anchor;
+  EmitterStyle::value style;
+  std::string* pScalar;
+  StringRef scalarRef;
+};
+
+/**
+ * Parses a single document. It's a state machine over the scanner's tokens,
+ * with one frame per open collection, so it can either be pulled from (one
+ * event at a time) or run to completion, pushing its events to a handler.
+ */
 class SingleDocParser : private noncopyable {
  public:
-  SingleDocParser(Scanner& scanner, const Directives& directives);
+  SingleDocParser(Scanner& scanner, const Directives& directives,
+                  const ParseLimits* pLimits = nullptr);
   ~SingleDocParser();
 
+  /**
+   * Handles the document by calling events on the {@code eventHandler}; if
+   * there are limits, each event is counted against them first.
+   *
+   * @throw a ParserException on error, or if the document passes a limit.
+   */
   void HandleDocument(EventHandler& eventHandler);
 
+  /**
+   * Reads the next event into {@code event}; returns false once the
+   * document has ended.
+   */
+  bool NextEvent(ParserEvent& event);
+
+  /**
+   * If the last event started a collection, skips to its end, which then
+   * becomes the last event.
+   */
+  void SkipCollection(ParserEvent& event);
+
+  /**
+   * If the innermost collection is a flow sequence, and its next entry is a
+   * scalar with no properties (and isn't null), reads it straight from its
+   * token, without making an event: {@code scalar} is good until the next
+   * call. Otherwise, returns false, and the entry comes from NextEvent.
+   */
+  bool NextPlainEntry(StringRef& scalar, Mark& mark);
+
+  /** The number of collections that are open. */
+  std::size_t depth() const { return m_frames.size() - 1; }
+
  private:
-  void HandleNode(EventHandler& eventHandler);
+  // where a frame is up to; each collection only uses some of these
+  enum Phase { Start, Key, Value, Entry, Separator, End, Done };
+
+  struct Frame {
+    CollectionType::value type;  // NoCollection for the document itself
+    Phase phase;
+    Mark mark;
+  };
 
-  void HandleSequence(EventHandler& eventHandler);
-  void HandleBlockSequence(EventHandler& eventHandler);
-  void HandleFlowSequence(EventHandler& eventHandler);
+  void HandleNode(ParserEvent& event);
+  void HandleScalarMove(EventHandler& eventHandler, ParserEvent& event);
 
-  void HandleMap(EventHandler& eventHandler);
-  void HandleBlockMap(EventHandler& eventHandler);
-  void HandleFlowMap(EventHandler& eventHandler);
-  void HandleCompactMap(EventHandler& eventHandler);
-  void HandleCompactMapWithNoKey(EventHandler& eventHandler);
+  bool NextInBlockSequence(Frame& frame, ParserEvent& event);
+  bool NextInFlowSequence(Frame& frame, ParserEvent& event);
+  bool NextInBlockMap(Frame& frame, ParserEvent& event);
+  bool NextInFlowMap(Frame& frame, ParserEvent& event);
+  bool NextInCompactMap(Frame& frame, ParserEvent& event);
+
+  void PushFrame(CollectionType::value type, Phase phase, const Mark& mark);
+  void EndCollection(ParserEvent& event, EventType::value type,
+                     const Mark& mark);
 
   void ParseProperties(std::string& tag, anchor_t& anchor);
   void ParseTag(std::string& tag);
@@ -53,12 +118,16 @@ class SingleDocParser : private noncopyable {
  private:
   Scanner& m_scanner;
   const Directives& m_directives;
-  std::unique_ptr<CollectionStack> m_pCollectionStack;
+  std::vector<Frame> m_frames;
+  bool m_popPending;  // the last event's token is still in the queue
+  std::string m_emptyScalar;
 
   typedef std::map<std::string, anchor_t> Anchors;
   Anchors m_anchors;
 
   anchor_t m_curAnchor;
+
+  std::unique_ptr<DocumentLimits> m_pLimits;
 };
 }
 
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <iostream>
 
 #include "stream.h"
@@ -166,7 +167,7 @@ inline char Utf8Adjust(unsigned long ch, unsigned char lead_bits,
       static_cast<unsigned char>(header | ((ch >> rshift) & mask)));
 }
 
-inline void QueueUnicodeCodepoint(std::deque<char>& q, unsigned long ch) {
+inline void QueueUnicodeCodepoint(CharQueue& q, unsigned long ch) {
   // We are not allowed to queue the Stream::eof() codepoint, so
   // replace it with CP_REPLACEMENT_CHARACTER
   if (static_cast<unsigned long>(Stream::eof()) == ch) {
@@ -192,12 +193,55 @@ inline void QueueUnicodeCodepoint(std::deque<char>& q, unsigned long ch) {
 
 Stream::Stream(std::istream& input)
     : m_input(input),
+      m_pRetained(nullptr),
+      m_partial(false),
       m_pPrefetched(new unsigned char[YAML_PREFETCH_SIZE]),
       m_nPrefetchedAvailable(0),
       m_nPrefetchedUsed(0) {
+  Init();
+}
+
+Stream::Stream(std::istream& input, const StringRef& retained)
+    : m_input(input),
+      m_pRetained(nullptr),
+      m_partial(false),
+      m_pPrefetched(new unsigned char[YAML_PREFETCH_SIZE]),
+      m_nPrefetchedAvailable(0),
+      m_nPrefetchedUsed(0) {
+  Init();
+  Retain(retained);
+}
+
+Stream::Stream(std::istream& input, const StringRef& retained,
+               const Mark& start)
+    : m_input(input),
+      m_mark(start),
+      m_pRetained(nullptr),
+      m_partial(true),
+      m_pPrefetched(new unsigned char[YAML_PREFETCH_SIZE]),
+      m_nPrefetchedAvailable(0),
+      m_nPrefetchedUsed(0) {
+  Init();
+  Retain(retained);
+}
+
+// Retain
+// . Characters only line up with bytes in UTF-8; a byte order mark has been
+//   eaten by now (if it's in what we read), so skip it in the buffer too.
+void Stream::Retain(const StringRef& retained) {
+  if (m_charSet == utf8 && retained.valid()) {
+    m_pRetained = retained.data();
+    if (retained.size() >= 3 &&
+        std::memcmp(m_pRetained, "\xEF\xBB\xBF", 3) == 0)
+      m_pRetained += 3;
+  }
+}
+
+void Stream::Init() {
   typedef std::istream::traits_type char_traits;
 
-  if (!input)
+  m_charSet = utf8;
+  if (!m_input)
     return;
 
   // Determine (or guess) the character-set by reading the BOM, if any.  See
@@ -206,16 +250,16 @@ Stream::Stream(std::istream& input)
   int nIntroUsed = 0;
   UtfIntroState state = uis_start;
   for (; !s_introFinalState[state];) {
-    std::istream::int_type ch = input.get();
+    std::istream::int_type ch = m_input.get();
     intro[nIntroUsed++] = ch;
     UtfIntroCharType charType = IntroCharTypeOf(ch);
     UtfIntroState newState = s_introTransitions[state][charType];
     int nUngets = s_introUngetCount[state][charType];
     if (nUngets > 0) {
-      input.clear();
+      m_input.clear();
       for (; nUngets > 0; --nUngets) {
         if (char_traits::eof() != intro[--nIntroUsed])
-          input.putback(char_traits::to_char_type(intro[nIntroUsed]));
+          m_input.putback(char_traits::to_char_type(intro[nIntroUsed]));
       }
     }
     state = newState;
@@ -9,19 +9,61 @@
 
 #include "yaml-cpp/noncopyable.h"
 #include "yaml-cpp/mark.h"
+#include "yaml-cpp/stringref.h"
 #include <cstddef>
-#include <deque>
 #include <ios>
 #include <iostream>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace YAML {
+// A FIFO of characters that reuses its storage; the stream's readahead is
+// only ever a few characters, so we shift it down occasionally rather than
+// (like std::deque) allocating and freeing blocks as we go.
+class CharQueue {
+ public:
+  CharQueue() : m_start(0) {}
+
+  bool empty() const { return m_start == m_data.size(); }
+  std::size_t size() const { return m_data.size() - m_start; }
+  char operator[](std::size_t i) const { return m_data[m_start + i]; }
+
+  void push_back(char ch) { m_data.push_back(ch); }
+  void pop_front() {
+    m_start++;
+    if (m_start == m_data.size()) {
+      m_data.clear();
+      m_start = 0;
+    } else if (m_start >= 64 && m_start * 2 >= m_data.size()) {
+      m_data.erase(m_data.begin(), m_data.begin() + m_start);
+      m_start = 0;
+    }
+  }
+
+ private:
+  std::vector<char> m_data;
+  std::size_t m_start;
+};
+
 class Stream : private noncopyable {
  public:
   friend class StreamCharSource;
 
   Stream(std::istream& input);
+
+  /**
+   * Constructs a stream over memory-resident input; {@code retained} must be
+   * the same bytes that {@code input} reads, and must outlive the stream.
+   */
+  Stream(std::istream& input, const StringRef& retained);
+
+  /**
+   * Constructs a stream over part of memory-resident input: {@code input}
+   * reads {@code retained} from the line that starts at {@code start} up to
+   * some later line. Marks are still reported relative to all of it.
+   */
+  Stream(std::istream& input, const StringRef& retained, const Mark& start);
   ~Stream();
 
   operator bool() const;
@@ -40,14 +82,33 @@ class Stream : private noncopyable {
   int column() const { return m_mark.column; }
   void ResetColumn() { m_mark.column = 0; }
 
+  /**
+   * Returns the retained input at the current position, or null if the input
+   * isn't memory-resident (or isn't UTF-8, so positions don't map to bytes).
+   */
+  const char* retained() const {
+    return m_pRetained ? m_pRetained + m_mark.pos : nullptr;
+  }
+
+  /**
+   * Returns true if the stream reads just part of its input, so that its end
+   * isn't necessarily the end of the input.
+   */
+  bool partial() const { return m_partial; }
+
  private:
   enum CharacterSet { utf8, utf16le, utf16be, utf32le, utf32be };
 
+  void Init();
+  void Retain(const StringRef& retained);
+
   std::istream& m_input;
   Mark m_mark;
+  const char* m_pRetained;
+  bool m_partial;
 
   CharacterSet m_charSet;
-  mutable std::deque<char> m_readahead;
+  mutable CharQueue m_readahead;
   unsigned char* const m_pPrefetched;
   mutable size_t m_nPrefetchedAvailable;
   mutable size_t m_nPrefetchedUsed;
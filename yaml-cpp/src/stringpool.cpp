@@ -0,0 +1,30 @@
+#include "stringpool.h"
+
+namespace YAML {
+namespace detail {
+const std::string& string_pool::intern(const StringRef& str) {
+  std::unordered_map<StringRef, const std::string*, hash>::const_iterator it =
+      m_index.find(str);
+  if (it != m_index.end())
+    return *it->second;
+
+  m_strings.push_back(str.str());
+  const std::string& copy = m_strings.back();
+  m_index.emplace(StringRef(copy), &copy);
+  return copy;
+}
+
+std::size_t string_pool::hash::operator()(const StringRef& str) const {
+  return hash_string(str);
+}
+
+std::size_t hash_string(const StringRef& str) {
+  std::size_t hash = static_cast<std::size_t>(14695981039346656037ULL);
+  for (std::size_t i = 0; i < str.size(); i++) {
+    hash ^= static_cast<unsigned char>(str.data()[i]);
+    hash *= static_cast<std::size_t>(1099511628211ULL);
+  }
+  return hash;
+}
+}
+}
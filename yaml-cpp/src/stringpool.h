@@ -0,0 +1,42 @@
+#ifndef STRINGPOOL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define STRINGPOOL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "yaml-cpp/noncopyable.h"
+#include "yaml-cpp/stringref.h"
+
+namespace YAML {
+namespace detail {
+/**
+ * Keeps one copy of each distinct string it's given. The copies never move,
+ * so they can be referred to for as long as the pool lives.
+ */
+class string_pool : private noncopyable {
+ public:
+  const std::string& intern(const StringRef& str);
+
+ private:
+  struct hash {
+    std::size_t operator()(const StringRef& str) const;
+  };
+
+  std::deque<std::string> m_strings;
+  std::unordered_map<StringRef, const std::string*, hash> m_index;
+};
+
+/** Hashes the characters of {@code str} (with FNV-1a). */
+std::size_t hash_string(const StringRef& str);
+}
+}
+
+#endif  // STRINGPOOL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
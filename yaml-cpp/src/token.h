@@ -8,6 +8,7 @@
 #endif
 
 #include "yaml-cpp/mark.h"
+#include "yaml-cpp/stringref.h"
 #include <iostream>
 #include <string>
 #include <vector>
@@ -51,7 +52,8 @@ struct Token {
       : status(VALID), type(type_), mark(mark_), data(0) {}
 
   friend std::ostream& operator<<(std::ostream& out, const Token& token) {
-    out << TokenNames[token.type] << std::string(": ") << token.value;
+    out << TokenNames[token.type] << std::string(": ")
+        << (token.ref.valid() ? token.ref.str() : token.value);
     for (std::size_t i = 0; i < token.params.size(); i++)
       out << std::string(" ") << token.params[i];
     return out;
@@ -61,6 +63,8 @@ struct Token {
   TYPE type;
   Mark mark;
   std::string value;
+  StringRef ref;  // for scalars, refers to the retained input (and then
+                  // 'value' is unused)
   std::vector<std::string> params;
   int data;
 };
@@ -0,0 +1,100 @@
+#ifndef TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "ptr_vector.h"
+#include "token.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/noncopyable.h"
+
+namespace YAML {
+/**
+ * A FIFO queue of tokens, stored in fixed-size blocks that are recycled once
+ * they're drained. Tokens never move while queued (the scanner keeps pointers
+ * to them), and slots are reused as-is, so once the queue has warmed up,
+ * pushing a token allocates nothing (its strings keep their capacity).
+ */
+class TokenQueue : private noncopyable {
+ public:
+  TokenQueue() : m_front(0), m_back(0), m_size(0) {}
+
+  bool empty() const { return m_size == 0; }
+  std::size_t size() const { return m_size; }
+
+  Token& front() { return (*m_active.front())[m_front]; }
+  const Token& front() const { return (*m_active.front())[m_front]; }
+  Token& back() { return (*m_active.back())[m_back - 1]; }
+
+  /** Enqueues a fresh token, and returns it to be filled in. */
+  Token& push(Token::TYPE type, const Mark& mark) {
+    Token& token = next_slot();
+    token.status = Token::VALID;
+    token.type = type;
+    token.mark = mark;
+    token.value.clear();
+    token.ref = StringRef();
+    token.params.clear();
+    token.data = 0;
+    return token;
+  }
+
+  Token& push(const Token& token) { return next_slot() = token; }
+
+  void pop() {
+    m_front++;
+    m_size--;
+    if (m_size == 0) {
+      // everything's drained, so start over at the top of this block
+      m_front = m_back = 0;
+    } else if (m_front == BlockSize) {
+      m_free.push_back(m_active.front());
+      m_active.erase(m_active.begin());
+      m_front = 0;
+    }
+  }
+
+ private:
+  enum { BlockSize = 64 };
+  typedef std::vector<Token> Block;
+
+  Token& next_slot() {
+    if (m_active.empty() || m_back == BlockSize) {
+      m_active.push_back(acquire_block());
+      m_back = 0;
+    }
+    m_size++;
+    return (*m_active.back())[m_back++];
+  }
+
+  Block* acquire_block() {
+    if (!m_free.empty()) {
+      Block* pBlock = m_free.back();
+      m_free.pop_back();
+      return pBlock;
+    }
+
+    std::unique_ptr<Block> pBlock(
+        new Block(BlockSize, Token(Token::DIRECTIVE, Mark::null_mark())));
+    m_blocks.push_back(std::move(pBlock));
+    return &m_blocks.back();
+  }
+
+ private:
+  ptr_vector<Block> m_blocks;  // owns every block
+  std::vector<Block*> m_active;
+  std::vector<Block*> m_free;
+  std::size_t m_front, m_back;  // positions in the first and last blocks
+  std::size_t m_size;
+};
+}
+
+#endif  // TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
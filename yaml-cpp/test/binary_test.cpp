@@ -0,0 +1,143 @@
+#include "yaml-cpp/binary.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+std::vector<unsigned char> Bytes(const std::string& str) {
+  return std::vector<unsigned char>(str.begin(), str.end());
+}
+
+std::string Encode(const std::string& str) {
+  return EncodeBase64(reinterpret_cast<const unsigned char*>(str.data()),
+                      str.size());
+}
+
+// one bit at a time, as the RFC describes it
+std::string ReferenceEncode(const std::vector<unsigned char>& data) {
+  static const char digits[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  const std::size_t bits = data.size() * 8;
+  for (std::size_t bit = 0; bit < bits; bit += 6) {
+    unsigned digit = 0;
+    for (std::size_t i = bit; i < bit + 6; i++) {
+      const bool set = i < bits && (data[i / 8] >> (7 - i % 8)) & 1;
+      digit = (digit << 1) | (set ? 1 : 0);
+    }
+    out += digits[digit];
+  }
+  while (out.size() % 4)
+    out += '=';
+  return out;
+}
+
+TEST(BinaryTest, KnownValues) {
+  EXPECT_EQ("", Encode(""));
+  EXPECT_EQ("Zg==", Encode("f"));
+  EXPECT_EQ("Zm8=", Encode("fo"));
+  EXPECT_EQ("Zm9v", Encode("foo"));
+  EXPECT_EQ("Zm9vYg==", Encode("foob"));
+  EXPECT_EQ("Zm9vYmE=", Encode("fooba"));
+  EXPECT_EQ("Zm9vYmFy", Encode("foobar"));
+
+  EXPECT_EQ(Bytes(""), DecodeBase64(""));
+  EXPECT_EQ(Bytes("f"), DecodeBase64("Zg=="));
+  EXPECT_EQ(Bytes("fo"), DecodeBase64("Zm8="));
+  EXPECT_EQ(Bytes("foo"), DecodeBase64("Zm9v"));
+  EXPECT_EQ(Bytes("foob"), DecodeBase64("Zm9vYg=="));
+  EXPECT_EQ(Bytes("fooba"), DecodeBase64("Zm9vYmE="));
+  EXPECT_EQ(Bytes("foobar"), DecodeBase64("Zm9vYmFy"));
+}
+
+TEST(BinaryTest, RoundTrip) {
+  std::mt19937 random(42);
+  for (std::size_t size = 0; size < 300; size++) {
+    std::vector<unsigned char> data(size);
+    for (unsigned char& byte : data)
+      byte = static_cast<unsigned char>(random());
+    const std::string encoded = EncodeBase64(data.data(), data.size());
+    EXPECT_EQ(ReferenceEncode(data), encoded);
+    EXPECT_EQ(data, DecodeBase64(encoded));
+  }
+}
+
+TEST(BinaryTest, Whitespace) {
+  std::mt19937 random(7);
+  std::vector<unsigned char> data(1000);
+  for (unsigned char& byte : data)
+    byte = static_cast<unsigned char>(random());
+  const std::string encoded = EncodeBase64(data.data(), data.size());
+
+  // wrapped in lines, and then with whitespace anywhere at all
+  std::string wrapped;
+  for (std::size_t i = 0; i < encoded.size(); i += 76)
+    wrapped += "  " + encoded.substr(i, 76) + "\n";
+  EXPECT_EQ(data, DecodeBase64(wrapped));
+
+  std::string scattered;
+  for (char c : encoded) {
+    scattered += c;
+    if (random() % 3 == 0)
+      scattered += " \t\r\n"[random() % 4];
+  }
+  EXPECT_EQ(data, DecodeBase64(scattered));
+  EXPECT_EQ(Bytes("A"), DecodeBase64("QQ=\n="));
+  EXPECT_EQ(Bytes("AB"), DecodeBase64("QU\tI\n="));
+}
+
+TEST(BinaryTest, Invalid) {
+  EXPECT_TRUE(DecodeBase64("Zm9v!m9v").empty());
+  EXPECT_TRUE(DecodeBase64("Zm9vYmFy\xFF").empty());
+  EXPECT_TRUE(DecodeBase64(std::string("Zm9v\0m9v", 8)).empty());
+}
+
+TEST(BinaryTest, InvalidAnywhere) {
+  // the characters either side of each range of digits, and ones that
+  // aren't ASCII, in every place, including the middle of a long run
+  std::mt19937 random(3);
+  std::vector<unsigned char> data(300);
+  for (unsigned char& byte : data)
+    byte = static_cast<unsigned char>(random());
+  const std::string encoded = EncodeBase64(data.data(), data.size());
+  const std::string invalid("*,-.:@[`{\x80\xC3\xFF\0", 13);
+  for (std::size_t i = 0; i < encoded.size(); i++) {
+    for (char c : invalid) {
+      std::string input = encoded;
+      input[i] = c;
+      EXPECT_TRUE(DecodeBase64(input).empty()) << i << " " << int(c);
+    }
+    EXPECT_EQ(data, DecodeBase64(encoded.substr(0, i) + "\n" +
+                                 encoded.substr(i)));
+  }
+}
+
+TEST(BinaryTest, LongInputs) {
+  // long enough for whole vectors, from every alignment, as one bit at a
+  // time would have it
+  std::mt19937 random(5);
+  std::vector<unsigned char> data(2000);
+  for (unsigned char& byte : data)
+    byte = static_cast<unsigned char>(random());
+  for (std::size_t offset = 0; offset < 32; offset++) {
+    for (std::size_t size : {24, 27, 28, 47, 48, 100, 1000, 1968}) {
+      const std::vector<unsigned char> part(data.begin() + offset,
+                                            data.begin() + offset + size);
+      const std::string encoded = EncodeBase64(&data[offset], size);
+      EXPECT_EQ(ReferenceEncode(part), encoded) << offset << " " << size;
+      EXPECT_EQ(part, DecodeBase64(encoded)) << offset << " " << size;
+      EXPECT_EQ(part, DecodeBase64(std::string(offset, ' ') + encoded));
+    }
+  }
+}
+
+TEST(BinaryTest, IncompleteGroup) {
+  EXPECT_EQ(Bytes("foo"), DecodeBase64("Zm9vYm"));
+  EXPECT_TRUE(DecodeBase64("Zm9").empty());
+}
+}  // namespace
+}  // namespace YAML
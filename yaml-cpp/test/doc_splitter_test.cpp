@@ -0,0 +1,133 @@
+#include "docsplitter.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+using YAML::DocumentChunk;
+using YAML::SplitDocuments;
+using YAML::SplitRootCollection;
+
+namespace {
+TEST(DocSplitterTest, OneChunkIfSmall) {
+  std::vector<DocumentChunk> chunks = SplitDocuments("--- a\n--- b\n", 1024);
+  ASSERT_EQ(1u, chunks.size());
+  EXPECT_EQ(0, chunks[0].start.pos);
+  EXPECT_EQ(12u, chunks[0].size);
+}
+
+TEST(DocSplitterTest, SplitsAtDocumentStarts) {
+  std::string input = "--- a\nb: c\n---\nd\n--- e\n";
+  std::vector<DocumentChunk> chunks = SplitDocuments(input, 1);
+  ASSERT_EQ(3u, chunks.size());
+  EXPECT_EQ(0, chunks[0].start.pos);
+  EXPECT_EQ(11u, chunks[0].size);
+  EXPECT_EQ(11, chunks[1].start.pos);
+  EXPECT_EQ(2, chunks[1].start.line);
+  EXPECT_EQ(0, chunks[1].start.column);
+  EXPECT_EQ(17, chunks[2].start.pos);
+  EXPECT_EQ(4, chunks[2].start.line);
+  EXPECT_EQ(6u, chunks[2].size);
+  EXPECT_EQ(0u, chunks[2].directivesSize);
+}
+
+TEST(DocSplitterTest, IgnoresMarkersThatArentAlone) {
+  std::vector<DocumentChunk> chunks = SplitDocuments("a\n---b\n ---\n", 1);
+  EXPECT_EQ(1u, chunks.size());
+}
+
+TEST(DocSplitterTest, ChunksStartAtTheirDirectives) {
+  std::string input = "--- a\n...\n%TAG ! !x\n\n--- b\n--- c\n";
+  std::vector<DocumentChunk> chunks = SplitDocuments(input, 1);
+  ASSERT_EQ(3u, chunks.size());
+  EXPECT_EQ(10, chunks[1].start.pos);
+  EXPECT_EQ(0u, chunks[1].directivesSize);
+
+  // and the ones after carry them over
+  EXPECT_EQ(10, chunks[2].directives.pos);
+  EXPECT_EQ(11u, chunks[2].directivesSize);
+}
+
+TEST(DocSplitterTest, StopsAtAmbiguousDirectives) {
+  std::string input = "--- a\n%TAG ! !x\n--- b\n--- c\n";
+  std::vector<DocumentChunk> chunks = SplitDocuments(input, 1);
+  ASSERT_EQ(1u, chunks.size());
+  EXPECT_EQ(input.size(), chunks[0].size);
+}
+
+TEST(DocSplitterTest, StopsAtDirectivesWithoutDocument) {
+  std::string input = "--- a\n...\n%TAG ! !x\nb\n--- c\n";
+  EXPECT_EQ(1u, SplitDocuments(input, 1).size());
+}
+
+TEST(DocSplitterTest, PositionsSkipByteOrderMark) {
+  std::vector<DocumentChunk> chunks =
+      SplitDocuments("\xEF\xBB\xBF--- a\n--- b\n", 1);
+  ASSERT_EQ(2u, chunks.size());
+  EXPECT_EQ(6, chunks[1].start.pos);
+  EXPECT_EQ(6u, chunks[1].size);
+}
+
+TEST(DocSplitterTest, OneChunkIfNotUtf8) {
+  std::string input("-\0-\0-\0\n\0a\0\n\0-\0-\0-\0\n\0b\0", 20);
+  EXPECT_EQ(1u, SplitDocuments(input, 1).size());
+}
+TEST(DocSplitterTest, SplitsRootMapAtKeys) {
+  std::string input = "a: 1\nb:\n  c: 2\n# comment\nd: [3,\n 4]\n";
+  std::vector<DocumentChunk> chunks = SplitRootCollection(input, 1);
+  ASSERT_EQ(3u, chunks.size());
+  EXPECT_EQ(0, chunks[0].start.pos);
+  EXPECT_EQ(5u, chunks[0].size);
+  EXPECT_EQ(5, chunks[1].start.pos);
+  EXPECT_EQ(1, chunks[1].start.line);
+  EXPECT_EQ(25, chunks[2].start.pos);
+  EXPECT_EQ(4, chunks[2].start.line);
+  EXPECT_EQ(input.size() - 25, chunks[2].size);
+}
+
+TEST(DocSplitterTest, SplitsRootSequenceAtEntries) {
+  std::string input = "- a\n- b: c\n  d: e\nf\n-\n";
+  std::vector<DocumentChunk> chunks = SplitRootCollection(input, 1);
+  ASSERT_EQ(3u, chunks.size());
+  EXPECT_EQ(4, chunks[1].start.pos);
+  EXPECT_EQ(20, chunks[2].start.pos);
+}
+
+TEST(DocSplitterTest, DoesntSplitRootMapAtIndicators) {
+  std::string input = "a:\n- 1\n? b\n: 2\n&c d: 3\n\"e\": 4\n";
+  std::vector<DocumentChunk> chunks = SplitRootCollection(input, 1);
+  ASSERT_EQ(2u, chunks.size());
+  EXPECT_EQ(23, chunks[1].start.pos);
+}
+
+TEST(DocSplitterTest, RootCollectionKeepsChunkSize) {
+  std::string input = "a: 1\nb: 2\nc: 3\nd: 4\n";
+  std::vector<DocumentChunk> chunks = SplitRootCollection(input, 8);
+  ASSERT_EQ(2u, chunks.size());
+  EXPECT_EQ(10, chunks[1].start.pos);
+}
+
+TEST(DocSplitterTest, RootCollectionAfterDirectives) {
+  std::string input = "%TAG ! !x\n--- # start\na: 1\nb: 2\n";
+  std::vector<DocumentChunk> chunks = SplitRootCollection(input, 1);
+  ASSERT_EQ(2u, chunks.size());
+  EXPECT_EQ(0u, chunks[0].directivesSize);
+  EXPECT_EQ(27, chunks[1].start.pos);
+  EXPECT_EQ(0, chunks[1].directives.pos);
+  EXPECT_EQ(10u, chunks[1].directivesSize);
+}
+
+TEST(DocSplitterTest, RootCollectionEndsWithDocument) {
+  std::string input = "a: 1\nb: 2\n---\nc: 3\n";
+  std::vector<DocumentChunk> chunks = SplitRootCollection(input, 1);
+  ASSERT_EQ(2u, chunks.size());
+  EXPECT_EQ(5u, chunks[1].size);
+}
+
+TEST(DocSplitterTest, RootCollectionNeedsBareDocumentStart) {
+  EXPECT_EQ(1u, SplitRootCollection("--- !tag\na: 1\nb: 2\n", 1).size());
+  EXPECT_EQ(1u, SplitRootCollection("!tag\na: 1\nb: 2\n", 1).size());
+  EXPECT_EQ(1u, SplitRootCollection("  a: 1\n  b: 2\n", 1).size());
+  EXPECT_EQ(1u, SplitRootCollection("[a,\nb]\n", 1).size());
+}
+}
@@ -0,0 +1,268 @@
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "emitterutils.h"
+#include "exp.h"
+#include "gtest/gtest.h"
+#include "regeximpl.h"
+#include "stringsource.h"
+#include "yaml-cpp/ostream_wrapper.h"
+#include "yaml-cpp/emitter.h"
+#include "yaml-cpp/null.h"
+
+namespace YAML {
+namespace {
+// the checks that ComputeStringFormat used to make with Exp's regular
+// expressions, a character at a time
+bool RegExPlain(const std::string& str, FlowType::value flowType,
+                bool allowOnlyAscii) {
+  if (IsNullString(str))
+    return false;
+  const RegEx& start = (flowType == FlowType::Flow ? Exp::PlainScalarInFlow()
+                                                   : Exp::PlainScalar());
+  if (!start.Matches(str))
+    return false;
+  if (!str.empty() && *str.rbegin() == ' ')
+    return false;
+
+  static const RegEx& disallowed_flow =
+      Exp::EndScalarInFlow() || (Exp::BlankOrBreak() + Exp::Comment()) ||
+      Exp::NotPrintable() || Exp::Utf8_ByteOrderMark() || Exp::Break() ||
+      Exp::Tab();
+  static const RegEx& disallowed_block =
+      Exp::EndScalar() || (Exp::BlankOrBreak() + Exp::Comment()) ||
+      Exp::NotPrintable() || Exp::Utf8_ByteOrderMark() || Exp::Break() ||
+      Exp::Tab();
+  const RegEx& disallowed =
+      flowType == FlowType::Flow ? disallowed_flow : disallowed_block;
+
+  StringCharSource buffer(str.c_str(), str.size());
+  while (buffer) {
+    if (disallowed.Matches(buffer))
+      return false;
+    if (allowOnlyAscii && (0x80 <= static_cast<unsigned char>(buffer[0])))
+      return false;
+    ++buffer;
+  }
+  return true;
+}
+
+StringFormat::value RegExFormat(const std::string& str,
+                                EMITTER_MANIP strFormat,
+                                FlowType::value flowType,
+                                bool escapeNonAscii) {
+  bool ascii = true, newline = false;
+  for (std::size_t i = 0; i < str.size(); i++) {
+    ascii = ascii && static_cast<unsigned char>(str[i]) < 0x80;
+    newline = newline || str[i] == '\n';
+  }
+  const bool escaped = escapeNonAscii && !ascii;
+
+  switch (strFormat) {
+    case Auto:
+      return RegExPlain(str, flowType, escapeNonAscii)
+                 ? StringFormat::Plain
+                 : StringFormat::DoubleQuoted;
+    case SingleQuoted:
+      return !newline && !escaped ? StringFormat::SingleQuoted
+                                  : StringFormat::DoubleQuoted;
+    case Literal:
+      return flowType != FlowType::Flow && !escaped
+                 ? StringFormat::Literal
+                 : StringFormat::DoubleQuoted;
+    default:
+      return StringFormat::DoubleQuoted;
+  }
+}
+
+void ExpectSameFormats(const std::string& str) {
+  const EMITTER_MANIP formats[] = {Auto, SingleQuoted, DoubleQuoted, Literal};
+  const FlowType::value flowTypes[] = {FlowType::NoType, FlowType::Flow,
+                                       FlowType::Block};
+  for (EMITTER_MANIP format : formats) {
+    for (FlowType::value flowType : flowTypes) {
+      for (bool escapeNonAscii : {false, true}) {
+        ASSERT_EQ(RegExFormat(str, format, flowType, escapeNonAscii),
+                  Utils::ComputeStringFormat(str, format, flowType,
+                                             escapeNonAscii))
+            << "'" << str << "' (" << str.size() << " bytes), format "
+            << format << ", flow type " << flowType << ", escaping "
+            << escapeNonAscii;
+      }
+    }
+  }
+}
+
+// the characters that mean something to some style, and a few that don't
+const std::string alphabet(
+    " \t\n\r#:-?,[]{}&*!|>'\"%@`~a0.\x01\x0B\x1F\x7F\xC2\x80\x85\x9F\xA0"
+    "\xEF\xBB\xBF\xE2",
+    38);
+
+TEST(EmitterUtilsTest, StringFormatMatchesRegExShortStrings) {
+  ExpectSameFormats(std::string());
+  ExpectSameFormats(std::string(1, '\0'));
+  ExpectSameFormats(std::string("a\0b", 3));
+  for (char a : alphabet) {
+    ExpectSameFormats(std::string(1, a));
+    for (char b : alphabet) {
+      ExpectSameFormats(std::string(1, a) + b);
+      for (char c : alphabet) {
+        ExpectSameFormats(std::string(1, a) + b + c);
+      }
+    }
+  }
+}
+
+TEST(EmitterUtilsTest, StringFormatMatchesRegExLongStrings) {
+  const char* const strings[] = {
+      "null",        "Null",          "NULL",         "nul",
+      "~~",          "hello world",   "hello #world", "hello# world",
+      "key: value",  "key:value",     "http://a/b",   "a, b",
+      "- item",      "-item",         "? key",        "?key",
+      ": value",     ":value",        "[1, 2]",       "a]b",
+      "trailing ",   " leading",      "caf\xC3\xA9",  "\xEF\xBB\xBFmark",
+      "a\xC2\x85z",  "a\xC2\x84z",    "line\r\nline", "line\rline",
+      "tab\there",   "1.5e+3",        "'quoted'",     "\"quoted\"",
+  };
+  for (const char* str : strings) {
+    ExpectSameFormats(str);
+  }
+
+  std::mt19937 random(7);
+  for (int i = 0; i < 20000; i++) {
+    std::string str(4 + random() % 12, ' ');
+    for (char& ch : str)
+      ch = alphabet[random() % alphabet.size()];
+    ExpectSameFormats(str);
+  }
+}
+template <typename T>
+std::string StreamFloat(T value, int precision) {
+  std::stringstream stream;
+  stream.precision(precision);
+  stream << value;
+  return stream.str();
+}
+
+template <typename T>
+std::string WriteFloat(T value, std::size_t precision) {
+  ostream_wrapper out;
+  Utils::WriteFloat(out, value, precision);
+  return out.str();
+}
+
+template <typename T>
+bool ReadsBack(const std::string& str, T value) {
+  std::stringstream stream(str);
+  T readBack = 0;
+  return (stream >> readBack) && readBack == value;
+}
+
+// the digits before any exponent, without leading or trailing zeros
+std::size_t SignificantDigits(const std::string& str) {
+  std::string digits;
+  for (std::size_t i = 0; i < str.size() && str[i] != 'e'; i++) {
+    if (str[i] >= '0' && str[i] <= '9' && (str[i] != '0' || !digits.empty()))
+      digits += str[i];
+  }
+  return digits.find_last_not_of('0') + 1;
+}
+
+template <typename T>
+void ExpectSameFloats(T value) {
+  for (int precision = 1; precision <= std::numeric_limits<T>::digits10 + 1;
+       precision++) {
+    ASSERT_EQ(StreamFloat(value, precision), WriteFloat(value, precision))
+        << "precision " << precision;
+  }
+
+  if (!std::isfinite(value))
+    return;
+
+  // the shortest form reads back, and nothing with fewer digits does
+  const std::string shortest = WriteFloat(value, 0);
+  ASSERT_TRUE(ReadsBack(shortest, value)) << shortest;
+  for (int precision = 1;; precision++) {
+    const std::string digits = StreamFloat(value, precision);
+    if (ReadsBack(digits, value)) {
+      ASSERT_EQ(SignificantDigits(digits), SignificantDigits(shortest))
+          << digits << " " << shortest;
+      break;
+    }
+  }
+}
+
+TEST(EmitterUtilsTest, FloatsMatchStream) {
+  const double doubles[] = {0.0,
+                            -0.0,
+                            1.0,
+                            0.1,
+                            1.0 / 3,
+                            1e-300,
+                            1e300,
+                            123456789012345678.0,
+                            std::numeric_limits<double>::max(),
+                            std::numeric_limits<double>::min(),
+                            std::numeric_limits<double>::denorm_min(),
+                            std::numeric_limits<double>::infinity(),
+                            -std::numeric_limits<double>::infinity(),
+                            std::numeric_limits<double>::quiet_NaN()};
+  for (double value : doubles) {
+    ExpectSameFloats(value);
+    ExpectSameFloats(static_cast<float>(value));
+  }
+
+  std::mt19937_64 random(11);
+  std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+  std::uniform_int_distribution<int> exponent(-40, 40);
+  for (int i = 0; i < 20000; i++) {
+    const double value = std::ldexp(mantissa(random), exponent(random));
+    ExpectSameFloats(value);
+    ExpectSameFloats(static_cast<float>(value));
+  }
+}
+
+template <typename T>
+std::string StreamInteger(T value, EMITTER_MANIP intFormat) {
+  std::stringstream stream;
+  if (intFormat == Hex)
+    stream << "0x" << std::hex;
+  if (intFormat == Oct)
+    stream << "0" << std::oct;
+  stream << value;
+  return stream.str();
+}
+
+template <typename T>
+void ExpectSameIntegers(T value) {
+  const EMITTER_MANIP formats[] = {Dec, Hex, Oct};
+  for (EMITTER_MANIP format : formats) {
+    Emitter out;
+    out << static_cast<EMITTER_MANIP>(format) << value;
+    ASSERT_EQ(StreamInteger(value, format), out.c_str()) << format;
+  }
+}
+
+TEST(EmitterUtilsTest, IntegersMatchStream) {
+  std::mt19937_64 random(13);
+  for (int i = 0; i < 2000; i++) {
+    const unsigned long long bits = random() >> (random() % 64);
+    ExpectSameIntegers(static_cast<short>(bits));
+    ExpectSameIntegers(static_cast<unsigned short>(bits));
+    ExpectSameIntegers(static_cast<int>(bits));
+    ExpectSameIntegers(static_cast<unsigned int>(bits));
+    ExpectSameIntegers(static_cast<long>(bits));
+    ExpectSameIntegers(static_cast<unsigned long>(bits));
+    ExpectSameIntegers(static_cast<long long>(bits));
+    ExpectSameIntegers(static_cast<unsigned long long>(bits));
+  }
+  ExpectSameIntegers(std::numeric_limits<long long>::min());
+  ExpectSameIntegers(std::numeric_limits<short>::min());
+}
+}
+}
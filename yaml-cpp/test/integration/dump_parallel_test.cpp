@@ -0,0 +1,166 @@
+#include "emitparallel.h"
+#include "specexamples.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <string>
+
+namespace YAML {
+namespace {
+// with runs of a node or two, everything that can be split is, at every
+// level, so even small documents are cut up every possible way
+void ExpectSameAsDump(const Node& node) {
+  const std::string expected = Dump(node);
+  for (unsigned threads = 2; threads <= 4; threads++) {
+    for (std::size_t runSize = 1; runSize <= 3; runSize++) {
+      EXPECT_EQ(expected, DumpInRuns(node, threads, runSize))
+          << threads << " threads, runs of " << runSize;
+    }
+  }
+  EXPECT_EQ(expected, DumpParallel(node, 4));
+}
+
+// for large documents, where gtest's diff of the two would take forever
+void ExpectSameAsDump(const Node& node, unsigned threads) {
+  const std::string expected = Dump(node);
+  const std::string actual = DumpParallel(node, threads);
+  EXPECT_EQ(expected.size(), actual.size());
+  EXPECT_TRUE(expected == actual);
+}
+
+std::string RandomScalar(std::mt19937& random) {
+  static const char* const scalars[] = {
+      "a",      "plain text", "",          "~",         "null",
+      "- dash", "key: value", "# hash",    "'quoted'",  "two\nlines",
+      "tail\n", " padded ",   "x\ty",      "true",      "12",
+      "\xC3\xA9t\xC3\xA9",   "[flow]",    "{a: b}",    "&anchor"};
+  const std::size_t count = sizeof(scalars) / sizeof(scalars[0]);
+  return scalars[random() % count];
+}
+
+Node RandomTree(std::mt19937& random, int depth) {
+  const unsigned kind = depth > 0 ? random() % 6 : random() % 2;
+  if (kind == 0) {
+    return Node(RandomScalar(random));
+  } else if (kind == 1) {
+    return Node(NodeType::Null);
+  }
+
+  Node node(kind % 2 ? NodeType::Map : NodeType::Sequence);
+  const unsigned entries = random() % 6;
+  for (unsigned i = 0; i < entries; i++) {
+    if (node.IsMap()) {
+      Node key = random() % 8 ? Node(RandomScalar(random) + std::to_string(i))
+                              : RandomTree(random, depth - 1);
+      node.force_insert(key, RandomTree(random, depth - 1));
+    } else {
+      node.push_back(RandomTree(random, depth - 1));
+    }
+  }
+  if (random() % 8 == 0) {
+    node.SetStyle(EmitterStyle::Flow);
+  }
+  if (random() % 8 == 0) {
+    node.SetTag("!local");
+  }
+  return node;
+}
+
+TEST(DumpParallelTest, SpecExamples) {
+  const char* const examples[] = {
+      ex2_1,  ex2_2,  ex2_3,  ex2_4,  ex2_5,  ex2_6,  ex2_7,  ex2_8,  ex2_9,
+      ex2_10, ex2_11, ex2_12, ex2_13, ex2_14, ex2_15, ex2_16, ex2_17, ex2_18,
+      ex2_23, ex2_24, ex2_25, ex2_26, ex2_27, ex2_28, ex5_3,  ex5_4,  ex5_5,
+      ex5_6,  ex5_7,  ex5_8,  ex5_11, ex5_12, ex5_13, ex5_14, ex6_1,  ex6_2,
+      ex6_3,  ex6_4,  ex6_5,  ex6_6,  ex6_7,  ex6_8,  ex6_9,  ex6_10, ex6_11,
+      ex6_12, ex6_13, ex6_14, ex6_15, ex6_16, ex6_17, ex6_18, ex6_19, ex6_20,
+      ex6_21, ex6_22, ex6_23, ex6_24, ex6_25, ex6_26, ex6_27a, ex6_27b,
+      ex6_28, ex6_29, ex7_1,  ex7_2,  ex7_3,  ex7_4,  ex7_5,  ex7_6,  ex7_7,
+      ex7_8,  ex7_9,  ex7_10, ex7_11, ex7_12, ex7_13, ex7_14, ex7_15, ex7_16,
+      ex7_17, ex7_18, ex7_19, ex7_20, ex7_21, ex7_22, ex7_23, ex7_24, ex8_1,
+      ex8_2,  ex8_3a, ex8_3b, ex8_3c, ex8_4,  ex8_5,  ex8_6,  ex8_7,  ex8_8,
+      ex8_9,  ex8_10, ex8_11, ex8_12, ex8_13, ex8_14, ex8_15, ex8_16, ex8_17,
+      ex8_18, ex8_19, ex8_20, ex8_21, ex8_22};
+  for (const char* example : examples) {
+    std::vector<Node> docs;
+    try {
+      docs = LoadAll(example);
+    } catch (const Exception&) {
+      continue;
+    }
+    for (const Node& doc : docs) {
+      ExpectSameAsDump(doc);
+    }
+  }
+}
+
+TEST(DumpParallelTest, RandomTrees) {
+  std::mt19937 random(42);
+  for (int i = 0; i < 300; i++) {
+    ExpectSameAsDump(RandomTree(random, 4));
+  }
+}
+
+TEST(DumpParallelTest, LargeNestedSequence) {
+  Node node;
+  node["name"] = "table";
+  for (int i = 0; i < 50000; i++) {
+    node["values"].push_back(i);
+    if (i % 1000 == 0) {
+      node["values"].push_back(std::string("line\n") + std::to_string(i));
+    }
+  }
+  node["end"] = true;
+  ExpectSameAsDump(node, 4);
+}
+
+TEST(DumpParallelTest, LargeSequenceOfMaps) {
+  Node node;
+  for (int i = 0; i < 10000; i++) {
+    Node record;
+    record["id"] = i;
+    record["tags"].push_back("x");
+    record["tags"].push_back(i % 3 ? "y" : "z");
+    record["tags"].SetStyle(EmitterStyle::Flow);
+    record["nested"]["list"].push_back(i);
+    node.push_back(record);
+  }
+  ExpectSameAsDump(node, 4);
+  ExpectSameAsDump(node, 0);
+  ExpectSameAsDump(node, 1);
+}
+
+TEST(DumpParallelTest, LongKeys) {
+  Node node;
+  for (int i = 0; i < 20; i++) {
+    node[std::string(2000, 'k') + std::to_string(i)] = i;
+    node[std::to_string(i)] = std::string(2000, 'v');
+  }
+  ExpectSameAsDump(node);
+}
+
+TEST(DumpParallelTest, Aliases) {
+  ExpectSameAsDump(Load("a: &x [1, 2]\nb: *x\nc:\n- 3\n- 4\n- 5\n"));
+  ExpectSameAsDump(Load("- &x a\n- b\n- c\n- *x\n"));
+}
+
+TEST(DumpParallelTest, EmitterError) {
+  // the emitter gives up on a bad tag, part way through
+  Node node;
+  for (int i = 0; i < 10; i++) {
+    node.push_back(i);
+  }
+  node[6].SetTag("bad tag");
+  ExpectSameAsDump(node);
+}
+
+TEST(DumpParallelTest, Empty) {
+  ExpectSameAsDump(Node());
+  ExpectSameAsDump(Node(NodeType::Sequence));
+  ExpectSameAsDump(Node(NodeType::Map));
+  ExpectSameAsDump(Node("scalar"));
+}
+}  // namespace
+}  // namespace YAML
@@ -3,6 +3,14 @@
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <limits>
+
+#ifdef _WIN32
+#include <io.h>
+#define fileno _fileno
+#endif
+
 namespace YAML {
 namespace {
 
@@ -903,8 +911,22 @@ TEST_F(EmitterTest, DefaultPrecision) {
   out << BeginSeq;
   out << 1.234f;
   out << 3.14159265358979;
+  out << 0.1 + 0.2 << 1.0f / 3;
+  out << EndSeq;
+  ExpectEmit("- 1.234\n- 3.14159265358979\n- 0.3\n- 0.3333333");
+}
+
+TEST_F(EmitterTest, DefaultPrecisionMatchesConvert) {
+  const double values[] = {0.1 + 0.2, 1.0 / 3, 1e30, -2.5e-20};
+  out << BeginSeq;
+  std::string expected;
+  for (double value : values) {
+    out << value << static_cast<float>(value);
+    expected += "- " + Node(value).Scalar() + "\n- " +
+                Node(static_cast<float>(value)).Scalar() + "\n";
+  }
   out << EndSeq;
-  ExpectEmit("- 1.234\n- 3.14159265358979");
+  ExpectEmit(expected.substr(0, expected.size() - 1));
 }
 
 TEST_F(EmitterTest, SetPrecision) {
@@ -915,6 +937,31 @@ TEST_F(EmitterTest, SetPrecision) {
   ExpectEmit("- 1.23\n- 3.14159");
 }
 
+TEST_F(EmitterTest, ShortestPrecision) {
+  out.SetDoublePrecision(0);
+  out.SetFloatPrecision(0);
+  out << BeginSeq;
+  out << 0.1 + 0.2 << 1.0 / 3 << 1e100 << 0.5;
+  out << 1.0f / 3 << 0.1f << 16777217.0f;
+  out << Precision(0) << 0.25 << -0.0;
+  out << EndSeq;
+  ExpectEmit(
+      "- 0.30000000000000004\n- 0.3333333333333333\n- 1e+100\n- 0.5\n"
+      "- 0.33333334\n- 0.1\n- 16777216\n- 0.25\n- -0");
+}
+
+TEST_F(EmitterTest, IntegerLimits) {
+  out << BeginSeq;
+  out << std::numeric_limits<long long>::min();
+  out << std::numeric_limits<unsigned long long>::max();
+  out << Hex << -1 << Hex << static_cast<short>(-1) << Hex << 0;
+  out << Oct << -1L << Oct << 0u;
+  out << EndSeq;
+  ExpectEmit(
+      "- -9223372036854775808\n- 18446744073709551615\n- 0xffffffff\n"
+      "- 0xffff\n- 0x0\n- 01777777777777777777777\n- 00");
+}
+
 TEST_F(EmitterTest, DashInBlockContext) {
   out << BeginMap;
   out << Key << "key" << Value << "-";
@@ -1034,5 +1081,32 @@ TEST_F(EmitterErrorTest, InvalidAlias) {
 
   ExpectEmitError(ErrorMsg::INVALID_ALIAS);
 }
+TEST(EmitterFileDescriptorTest, EmitsToFile) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_TRUE(file != NULL);
+  {
+    Emitter out(fileno(file));
+    out << BeginMap << Key << "name" << Value << "test";
+    out << Key << "list" << Value << BeginSeq << 1 << 2 << EndSeq;
+    out << EndMap;
+    EXPECT_EQ(NULL, out.c_str());
+    EXPECT_TRUE(out.Flush());
+    EXPECT_EQ(28, out.size());
+  }
+
+  std::rewind(file);
+  char buffer[64] = {0};
+  EXPECT_EQ(28, std::fread(buffer, 1, sizeof buffer - 1, file));
+  EXPECT_STREQ("name: test\nlist:\n  - 1\n  - 2", buffer);
+  std::fclose(file);
+}
+
+TEST(EmitterFileDescriptorTest, ReportsFailure) {
+  Emitter out(-1);
+  out << "Hello";
+  EXPECT_FALSE(out.Flush());
+  EXPECT_FALSE(out.good());
+  EXPECT_EQ(ErrorMsg::OUTPUT_FAILED, out.GetLastError());
+}
 }
 }
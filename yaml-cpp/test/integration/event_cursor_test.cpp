@@ -0,0 +1,351 @@
+#include "specexamples.h"   // IWYU pragma: keep
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+
+void LogMark(std::stringstream& log, const Mark& mark) {
+  log << "@" << mark.pos << ":" << mark.line << ":" << mark.column;
+}
+
+// Writes each event on a line of its own, in a form both the handler and the
+// cursor can produce (the handler gets no marks for the ends of things).
+class LoggingEventHandler : public EventHandler {
+ public:
+  explicit LoggingEventHandler(std::stringstream& log) : m_log(log) {}
+
+  virtual void OnDocumentStart(const Mark& mark) {
+    m_log << "DocumentStart";
+    LogMark(m_log, mark);
+    m_log << "\n";
+  }
+  virtual void OnDocumentEnd() { m_log << "DocumentEnd\n"; }
+  virtual void OnNull(const Mark& mark, anchor_t anchor) {
+    m_log << "Null &" << anchor;
+    LogMark(m_log, mark);
+    m_log << "\n";
+  }
+  virtual void OnAlias(const Mark& mark, anchor_t anchor) {
+    m_log << "Alias *" << anchor;
+    LogMark(m_log, mark);
+    m_log << "\n";
+  }
+  virtual void OnScalar(const Mark& mark, const std::string& tag,
+                        anchor_t anchor, const std::string& value) {
+    m_log << "Scalar " << tag << " &" << anchor;
+    LogMark(m_log, mark);
+    m_log << " " << value << "\n";
+  }
+  virtual void OnSequenceStart(const Mark& mark, const std::string& tag,
+                               anchor_t anchor, EmitterStyle::value style) {
+    m_log << "SequenceStart " << tag << " &" << anchor << " " << style;
+    LogMark(m_log, mark);
+    m_log << "\n";
+  }
+  virtual void OnSequenceEnd() { m_log << "SequenceEnd\n"; }
+  virtual void OnMapStart(const Mark& mark, const std::string& tag,
+                          anchor_t anchor, EmitterStyle::value style) {
+    m_log << "MapStart " << tag << " &" << anchor << " " << style;
+    LogMark(m_log, mark);
+    m_log << "\n";
+  }
+  virtual void OnMapEnd() { m_log << "MapEnd\n"; }
+
+ private:
+  std::stringstream& m_log;
+};
+
+std::string HandlerLog(const std::string& input) {
+  std::stringstream log;
+  std::stringstream stream(input);
+  LoggingEventHandler handler(log);
+  try {
+    Parser parser(stream);
+    while (parser.HandleNextDocument(handler)) {
+    }
+  } catch (const ParserException& e) {
+    log << "error: " << e.what() << "\n";
+  }
+  return log.str();
+}
+
+std::string CursorLog(EventCursor& cursor) {
+  std::stringstream log;
+  try {
+    while (cursor.Next()) {
+      switch (cursor.Type()) {
+        case EventType::DocumentStart:
+          log << "DocumentStart";
+          LogMark(log, cursor.Mark());
+          break;
+        case EventType::DocumentEnd:
+          log << "DocumentEnd";
+          break;
+        case EventType::Null:
+          log << "Null &" << cursor.Anchor();
+          LogMark(log, cursor.Mark());
+          break;
+        case EventType::Alias:
+          log << "Alias *" << cursor.Anchor();
+          LogMark(log, cursor.Mark());
+          break;
+        case EventType::Scalar:
+          log << "Scalar " << cursor.Tag() << " &" << cursor.Anchor();
+          LogMark(log, cursor.Mark());
+          log << " " << cursor.Scalar();
+          break;
+        case EventType::SequenceStart:
+          log << "SequenceStart " << cursor.Tag() << " &" << cursor.Anchor()
+              << " " << cursor.Style();
+          LogMark(log, cursor.Mark());
+          break;
+        case EventType::SequenceEnd:
+          log << "SequenceEnd";
+          break;
+        case EventType::MapStart:
+          log << "MapStart " << cursor.Tag() << " &" << cursor.Anchor() << " "
+              << cursor.Style();
+          LogMark(log, cursor.Mark());
+          break;
+        case EventType::MapEnd:
+          log << "MapEnd";
+          break;
+      }
+      log << "\n";
+    }
+  } catch (const ParserException& e) {
+    log << "error: " << e.what() << "\n";
+  }
+  return log.str();
+}
+
+void ExpectSameEvents(const std::string& input) {
+  std::string expected = HandlerLog(input);
+
+  std::stringstream stream(input);
+  EventCursor streamCursor(stream);
+  EXPECT_EQ(expected, CursorLog(streamCursor)) << input;
+
+  EventCursor retainedCursor(std::make_shared<const std::string>(input));
+  EXPECT_EQ(expected, CursorLog(retainedCursor)) << input;
+}
+
+TEST(EventCursorTest, SpecExamples) {
+  const char* examples[] = {
+      ex2_1,  ex2_2,  ex2_3,  ex2_4,  ex2_5,  ex2_6,  ex2_7,  ex2_8,  ex2_9,
+      ex2_10, ex2_11, ex2_12, ex2_13, ex2_14, ex2_15, ex2_16, ex2_17, ex2_18,
+      ex2_23, ex2_24, ex2_25, ex2_26, ex2_27, ex2_28, ex5_3,  ex5_4,  ex5_5,
+      ex5_6,  ex5_7,  ex5_8,  ex5_11, ex5_12, ex5_13, ex5_14, ex6_1,  ex6_2,
+      ex6_3,  ex6_4,  ex6_5,  ex6_6,  ex6_7,  ex6_8,  ex6_9,  ex6_10, ex6_11,
+      ex6_12, ex6_13, ex6_14, ex6_15, ex6_16, ex6_17, ex6_18, ex6_19, ex6_20,
+      ex6_21, ex6_22, ex6_23, ex6_24, ex6_25, ex6_26, ex6_27a, ex6_27b,
+      ex6_28, ex6_29, ex7_1,  ex7_2,  ex7_3,  ex7_4,  ex7_5,  ex7_6,  ex7_7,
+      ex7_8,  ex7_9,  ex7_10, ex7_11, ex7_12, ex7_13, ex7_14, ex7_15, ex7_16,
+      ex7_17, ex7_18, ex7_19, ex7_20, ex7_21, ex7_22, ex7_23, ex7_24, ex8_1,
+      ex8_2,  ex8_3a, ex8_3b, ex8_3c, ex8_4,  ex8_5,  ex8_6,  ex8_7,  ex8_8,
+      ex8_9,  ex8_10, ex8_11, ex8_12, ex8_13, ex8_14, ex8_15, ex8_16, ex8_17,
+      ex8_18, ex8_19, ex8_20, ex8_21, ex8_22};
+  for (std::size_t i = 0; i < sizeof(examples) / sizeof(examples[0]); i++) {
+    ExpectSameEvents(examples[i]);
+  }
+}
+
+TEST(EventCursorTest, SameEventsAsHandler) {
+  ExpectSameEvents("");
+  ExpectSameEvents("# just a comment\n");
+  ExpectSameEvents("a");
+  ExpectSameEvents("- \n- a\n-\n");
+  ExpectSameEvents("a:\nb: ~\n? c\n: d\n? e\n");
+  ExpectSameEvents("[a: b, : c, d, e: , [f: g]]");
+  ExpectSameEvents(": x\n");
+  ExpectSameEvents("{a, b: , : c, ? d}");
+  ExpectSameEvents("- &a !!str x\n- *a\n- &b [1, 2]\n- *b\n- !foo\n- &c\n");
+  ExpectSameEvents("--- a\n--- b\n...\n--- [c]\n...\n...\n");
+  ExpectSameEvents("%TAG ! tag:example.com,2000:\n--- !x a\n...\n--- !x b\n");
+  ExpectSameEvents("a: 'one'\nb: \"two\"\nc: |\n  three\nd: >\n  four\n");
+}
+
+TEST(EventCursorTest, SameErrorsAsHandler) {
+  ExpectSameEvents("---{header: {id: 1");
+  ExpectSameEvents("[a, b");
+  ExpectSameEvents("[a b]");
+  ExpectSameEvents("{a: b c}");
+  ExpectSameEvents("- a\nb: c\n");
+  ExpectSameEvents("a: b\n- c\n");
+  ExpectSameEvents("- *unknown\n");
+  ExpectSameEvents("&a &b x\n");
+  ExpectSameEvents("!a !b x\n");
+}
+
+TEST(EventCursorTest, Empty) {
+  std::stringstream stream;
+  EventCursor cursor(stream);
+  EXPECT_FALSE(cursor.Next());
+  EXPECT_FALSE(cursor.Next());
+}
+
+TEST(EventCursorTest, Depth) {
+  EventCursor cursor(std::make_shared<const std::string>("a: [b]\nc: d\n"));
+  std::size_t expected[] = {0, 1, 1, 2, 2, 1, 1, 1, 0, 0};
+  for (std::size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+    ASSERT_TRUE(cursor.Next());
+    EXPECT_EQ(expected[i], cursor.Depth()) << i;
+  }
+  EXPECT_FALSE(cursor.Next());
+}
+
+TEST(EventCursorTest, ScalarRefPointsIntoInput) {
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>("key: value\n");
+  EventCursor cursor(input);
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());  // map
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_EQ(EventType::Scalar, cursor.Type());
+  EXPECT_EQ(input->data(), cursor.ScalarRef().data());
+  EXPECT_EQ("key", cursor.Scalar());
+}
+
+TEST(EventCursorTest, SkipBlockAndFlowCollections) {
+  EventCursor cursor(std::make_shared<const std::string>(
+      "a:\n  b: {c: [1, 2], d: &x 3}\n  e:\n  - f\ng: *x\n"));
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());  // map
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_EQ("a", cursor.Scalar());
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_EQ(EventType::MapStart, cursor.Type());
+  EXPECT_EQ(2u, cursor.Depth());
+
+  cursor.Skip();
+  EXPECT_EQ(EventType::MapEnd, cursor.Type());
+  EXPECT_EQ(1u, cursor.Depth());
+
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_EQ("g", cursor.Scalar());
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_EQ(EventType::Alias, cursor.Type());
+  EXPECT_EQ(1u, cursor.Anchor());
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_EQ(EventType::MapEnd, cursor.Type());
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_EQ(EventType::DocumentEnd, cursor.Type());
+  EXPECT_FALSE(cursor.Next());
+}
+
+TEST(EventCursorTest, SkipCompactMap) {
+  EventCursor cursor(std::make_shared<const std::string>("[a: [1, 2], b]"));
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());  // sequence
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_EQ(EventType::MapStart, cursor.Type());
+
+  cursor.Skip();
+  EXPECT_EQ(EventType::MapEnd, cursor.Type());
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_EQ("b", cursor.Scalar());
+}
+
+TEST(EventCursorTest, SkipDoesNothingElsewhere) {
+  EventCursor cursor(std::make_shared<const std::string>("- a\n- b\n"));
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());  // sequence
+  ASSERT_TRUE(cursor.Next());
+  cursor.Skip();
+  EXPECT_EQ("a", cursor.Scalar());
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_EQ("b", cursor.Scalar());
+}
+
+TEST(EventCursorTest, SkipUnterminatedCollection) {
+  EventCursor cursor(std::make_shared<const std::string>("a: [1, 2\n"));
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());  // map
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_EQ(EventType::SequenceStart, cursor.Type());
+  EXPECT_THROW(cursor.Skip(), ParserException);
+}
+
+TEST(EventCursorTest, ReadNumbers) {
+  EventCursor cursor(std::make_shared<const std::string>(
+      "a: [1, 2.5, -3e2, 16, '5']\n"
+      "b: [!!float 6, &x 7, {c: d}, 8]\n"
+      "c:\n- 9\n- 10\n"));
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());  // map
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_TRUE(cursor.Next());
+
+  std::vector<double> values;
+  ASSERT_TRUE(cursor.ReadNumbers(values));
+  ASSERT_EQ(5u, values.size());
+  EXPECT_EQ(2.5, values[1]);
+  EXPECT_EQ(-300.0, values[2]);
+  EXPECT_EQ(5.0, values[4]);
+  EXPECT_EQ(EventType::SequenceEnd, cursor.Type());
+  EXPECT_EQ(1u, cursor.Depth());
+
+  // anything but a number still fails (at the end of the sequence)
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_TRUE(cursor.Next());
+  std::vector<int> numbers;
+  EXPECT_THROW(cursor.ReadNumbers(numbers), TypedBadConversion<int>);
+  EXPECT_EQ(EventType::SequenceEnd, cursor.Type());
+  ASSERT_EQ(2u, numbers.size());
+  EXPECT_EQ(7, numbers[1]);
+
+  // block sequences come through events
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_EQ("c", cursor.Scalar());
+  ASSERT_TRUE(cursor.Next());
+  numbers.clear();
+  ASSERT_TRUE(cursor.ReadNumbers(numbers));
+  ASSERT_EQ(2u, numbers.size());
+  EXPECT_EQ(10, numbers[1]);
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_EQ(EventType::MapEnd, cursor.Type());
+}
+
+TEST(EventCursorTest, ReadNumbersFromStream) {
+  std::stringstream input("[1, 2, ~, 3]\n--- [4, 5, 6]\n--- x\n");
+  EventCursor cursor(input);
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());
+  std::vector<long long> values;
+  EXPECT_THROW(cursor.ReadNumbers(values), TypedBadConversion<long long>);
+
+  ASSERT_TRUE(cursor.Next());  // document end
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_TRUE(cursor.ReadNumbers(values));
+  ASSERT_EQ(5u, values.size());
+  EXPECT_EQ(6, values[4]);
+
+  ASSERT_TRUE(cursor.Next());  // document end
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());
+  EXPECT_FALSE(cursor.ReadNumbers(values));
+  EXPECT_EQ("x", cursor.Scalar());
+}
+
+TEST(EventCursorTest, ReadNumbersUnterminated) {
+  EventCursor cursor(std::make_shared<const std::string>("a: [1, 2\n"));
+  ASSERT_TRUE(cursor.Next());  // document
+  ASSERT_TRUE(cursor.Next());  // map
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_EQ(EventType::SequenceStart, cursor.Type());
+  std::vector<float> values;
+  EXPECT_THROW(cursor.ReadNumbers(values), ParserException);
+}
+}
+}
@@ -0,0 +1,266 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace YAML {
+namespace {
+std::shared_ptr<const std::string> Input(const std::string& input) {
+  return std::make_shared<const std::string>(input);
+}
+
+// everything the two parsers give, node by node: kind, tag, style, mark and
+// text
+void ExpectSameNodes(const Node& expected, const Node& actual) {
+  ASSERT_EQ(expected.Type(), actual.Type());
+  EXPECT_EQ(expected.Tag(), actual.Tag());
+  EXPECT_EQ(expected.Style(), actual.Style());
+  EXPECT_EQ(expected.Mark().pos, actual.Mark().pos);
+  EXPECT_EQ(expected.Mark().line, actual.Mark().line);
+  EXPECT_EQ(expected.Mark().column, actual.Mark().column);
+  if (expected.IsScalar()) {
+    EXPECT_EQ(expected.Scalar(), actual.Scalar());
+  }
+  ASSERT_EQ(expected.size(), actual.size());
+
+  const_iterator it = actual.begin();
+  for (const_iterator e = expected.begin(); e != expected.end(); ++e, ++it) {
+    if (expected.IsMap()) {
+      ExpectSameNodes(e->first, it->first);
+      ExpectSameNodes(e->second, it->second);
+    } else {
+      ExpectSameNodes(*e, *it);
+    }
+  }
+}
+
+void ExpectSameAsLoad(const std::string& json) {
+  SCOPED_TRACE(json);
+  const Node expected = Load(Input(json));
+  ExpectSameNodes(expected, LoadJson(Input(json)));
+  ExpectSameNodes(expected, Load(Input(json), true));
+}
+
+// the message and mark, however it's thrown
+std::string LoadError(const std::string& input, bool json) {
+  try {
+    if (json)
+      LoadJson(input);
+    else
+      Load(Input(input));
+  } catch (const ParserException& e) {
+    return e.what();
+  }
+  return "";
+}
+
+// after a value, no tabs (see JsonThatIsntYaml)
+std::string Whitespace(std::mt19937& random, bool tabs = true) {
+  static const char* const whitespace[] = {"", "", " ", "\n  ", "\r\n",
+                                           " \n\n ", "\t", "\n\t"};
+  return whitespace[random() % (tabs ? 8 : 6)];
+}
+
+std::string RandomString(std::mt19937& random) {
+  static const char* const strings[] = {
+      "\"\"",           "\"plain\"",       "\"with space\"",
+      "\"a\\\"b\"",     "\"back\\\\slash\"", "\"\\/\\b\\f\\n\\r\\t\"",
+      "\"\\u0041\\u00e9\\u20AC\"",         "\"\xC3\xA9t\xC3\xA9\"",
+      "\"\xF0\x9F\x98\x80\"",               "\"- dash\"",
+      "\"key: value\"", "\"# hash\"",      "\"[flow]\"",
+      "\"null\"",       "\"\x7F\"",        "\"'single'\""};
+  return strings[random() % (sizeof(strings) / sizeof(strings[0]))];
+}
+
+std::string RandomValue(std::mt19937& random, int depth) {
+  static const char* const scalars[] = {
+      "0",    "-0",    "12",  "-3.25", "1e5",   "2.5E-3", "6.02e+23",
+      "true", "false", "null"};
+  const unsigned kind = depth > 0 ? random() % 5 : random() % 3;
+  if (kind == 0) {
+    return scalars[random() % (sizeof(scalars) / sizeof(scalars[0]))];
+  } else if (kind == 1 || kind == 2) {
+    return RandomString(random);
+  }
+
+  const bool isMap = kind == 3;
+  std::string value = isMap ? "{" : "[";
+  const unsigned entries = random() % 5;
+  for (unsigned i = 0; i < entries; i++) {
+    value += (i > 0 ? "," : "") + Whitespace(random);
+    if (isMap) {
+      // a key on a different line from its ':' isn't YAML
+      value += RandomString(random) + (random() % 2 ? " " : "") + ":" +
+               Whitespace(random);
+    }
+    value += RandomValue(random, depth - 1) + Whitespace(random, false);
+  }
+  return value + (isMap ? "}" : "]");
+}
+
+TEST(LoadJsonTest, SameAsLoad) {
+  ExpectSameAsLoad("{}");
+  ExpectSameAsLoad("[]");
+  ExpectSameAsLoad("  \n[1, \"two\", true, false, null, {\"a\": [-1.5e3]}]\n");
+  ExpectSameAsLoad("{\"a\":1,\"b\":{\"c\":[[],{}]},\"a\":\"again\"}");
+  ExpectSameAsLoad("\xEF\xBB\xBF{\"bom\": \"\\u00e9\"}");
+  ExpectSameAsLoad("[\"x\"\r\n,\r\n\t2]");
+}
+
+TEST(LoadJsonTest, RandomDocuments) {
+  std::mt19937 random(7);
+  for (int i = 0; i < 500; i++) {
+    ExpectSameAsLoad(Whitespace(random) + RandomValue(random, 4) +
+                     Whitespace(random, false));
+  }
+}
+
+TEST(LoadJsonTest, Values) {
+  const Node node = LoadJson(
+      "{\"name\": \"example\", \"count\": 3, \"ratio\": 0.5, \"ok\": true, "
+      "\"none\": null, \"list\": [\"a\\tb\", \"\\ud83d\\ude00\"]}");
+  EXPECT_EQ("example", node["name"].as<std::string>());
+  EXPECT_EQ(3, node["count"].as<int>());
+  EXPECT_EQ(0.5, node["ratio"].as<double>());
+  EXPECT_TRUE(node["ok"].as<bool>());
+  EXPECT_TRUE(node["none"].IsNull());
+  EXPECT_EQ("a\tb", node["list"][0].as<std::string>());
+  EXPECT_EQ("\xF0\x9F\x98\x80", node["list"][1].as<std::string>());
+  EXPECT_EQ("!", node["name"].Tag());
+  EXPECT_EQ("?", node["count"].Tag());
+  EXPECT_EQ(EmitterStyle::Flow, node.Style());
+}
+
+TEST(LoadJsonTest, DeepNesting) {
+  const int depth = 100000;
+  const Node node =
+      LoadJson(std::string(depth, '[') + "1" + std::string(depth, ']'));
+  EXPECT_TRUE(node.IsSequence());
+  EXPECT_EQ(1, node.size());
+}
+
+TEST(LoadJsonTest, JsonThatIsntYaml) {
+  // strict JSON allows these, and YAML doesn't
+  const std::string longKey(2000, 'k');
+  const std::string inputs[] = {"{\"" + longKey + "\": 1}", "{\"a\"\n: 1}",
+                                "[\"\\ud83d\\ude00\"]", "[\"a\"\r]"};
+  for (const std::string& input : inputs) {
+    EXPECT_THROW(Load(Input(input)), ParserException);
+    EXPECT_NO_THROW(LoadJson(input));
+    EXPECT_NO_THROW(Load(Input(input), true));
+  }
+  EXPECT_EQ(1, LoadJson("{\"" + longKey + "\": 1}")[longKey].as<int>());
+
+  // and the YAML parser keeps a tab after a plain scalar in a flow collection
+  EXPECT_EQ("1\t", Load(Input("[1\t]"))[0].Scalar());
+  EXPECT_EQ("1", LoadJson("[1\t]")[0].Scalar());
+  EXPECT_TRUE(LoadJson("[null\t]")[0].IsNull());
+}
+
+TEST(LoadJsonTest, YamlThatIsntJson) {
+  // Load falls back to the YAML parser, and LoadJson reports where it stops
+  // being JSON
+  const char* const inputs[][2] = {
+      {"{a: 1}", ErrorMsg::JSON_KEY},
+      {"[1, 2,]", ErrorMsg::JSON_VALUE},
+      {"[01]", ErrorMsg::END_OF_SEQ_FLOW},
+      {"[1.]", ErrorMsg::JSON_NUMBER},
+      {"{\"a\"}", ErrorMsg::JSON_COLON},
+      {"[1] # comment", ErrorMsg::JSON_TRAILING},
+      {"[\"\\x41\"]", "unknown escape character: x"},
+      {"[\"a\tb\"]", ErrorMsg::CHAR_IN_SCALAR},
+      {"[\"\xC3\"]", ErrorMsg::CHAR_IN_SCALAR},
+      {"", ErrorMsg::JSON_VALUE},
+      {"plain", ErrorMsg::JSON_VALUE},
+  };
+  for (const auto& input : inputs) {
+    SCOPED_TRACE(input[0]);
+    EXPECT_EQ(Dump(Load(Input(input[0]))), Dump(Load(Input(input[0]), true)));
+    try {
+      LoadJson(input[0]);
+      ADD_FAILURE() << "expected an exception";
+    } catch (const ParserException& e) {
+      EXPECT_EQ(input[1], e.msg);
+    }
+  }
+
+  // YAML that ends a flow collection just after a ':' isn't JSON either
+  const char* const values[][2] = {
+      {"[a:]", ErrorMsg::JSON_VALUE},
+      {"[:]", ErrorMsg::JSON_VALUE},
+      {"{a:}", ErrorMsg::JSON_KEY},
+  };
+  for (const auto& input : values) {
+    SCOPED_TRACE(input[0]);
+    EXPECT_TRUE(DeepEquals(Load(Input(input[0])), Load(Input(input[0]), true)));
+    try {
+      LoadJson(input[0]);
+      ADD_FAILURE() << "expected an exception";
+    } catch (const ParserException& e) {
+      EXPECT_EQ(input[1], e.msg);
+    }
+  }
+
+  try {
+    LoadJson("{\n  \"a\": [1, 2,]\n}");
+    ADD_FAILURE() << "expected an exception";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(1, e.mark.line);
+    EXPECT_EQ(13, e.mark.column);
+  }
+}
+
+TEST(LoadJsonTest, MalformedReportsTheSameError) {
+  // if it isn't YAML either, it's the same error as Load gives
+  const char* const inputs[] = {"[\"\\ud800\"]", "[1, 2",  "{\"a\" 1}",
+                                "{\"a\":[1}",     "[1]]",    "{a:",
+                                "{:",             "[\"a\":"};
+  for (const char* input : inputs) {
+    const std::string yamlError = LoadError(input, false);
+    EXPECT_FALSE(yamlError.empty()) << input;
+    EXPECT_EQ(yamlError, LoadError(input, true)) << input;
+  }
+  EXPECT_EQ("yaml-cpp: error at line 1, column 9: invalid unicode: 55296",
+            LoadError("[\"\\ud800\"]", true));
+
+  std::mt19937 random(11);
+  // with a character replaced, it may also be JSON that isn't YAML (see
+  // JsonThatIsntYaml), which is fine, as long as it isn't a carriage return
+  // left on its own
+  const char replacements[] = "{}[],:\"\\a1-.e x";
+  for (int i = 0; i < 500; i++) {
+    std::string input = RandomValue(random, 3);
+    const std::size_t at = random() % input.size();
+    if (input[at] == '\n') {
+      continue;
+    }
+    input[at] = replacements[random() % (sizeof(replacements) - 1)];
+
+    const std::string yamlError = LoadError(input, false);
+    const std::string jsonError = LoadError(input, true);
+    if (!yamlError.empty() && !jsonError.empty()) {
+      EXPECT_EQ(yamlError, jsonError) << input;
+    } else if (yamlError.empty() && jsonError.empty()) {
+      ExpectSameAsLoad(input);
+    }
+  }
+}
+
+TEST(LoadJsonTest, LoadJsonFile) {
+  const char* const filename = "load_json_test.json";
+  {
+    std::ofstream out(filename, std::ios::binary);
+    out << "{\"a\": [1, 2]}";
+  }
+  EXPECT_EQ(2, LoadJsonFile(filename)["a"][1].as<int>());
+  EXPECT_EQ(2, LoadFile(filename, true)["a"][1].as<int>());
+  std::remove(filename);
+  EXPECT_THROW(LoadJsonFile("no such file.json"), BadFile);
+}
+}  // namespace
+}  // namespace YAML
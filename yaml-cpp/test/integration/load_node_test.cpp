@@ -1,7 +1,12 @@
+#include "yaml-cpp/emitfromevents.h"
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
 
 #include "gtest/gtest.h"
 
+#include <sstream>
+#include <thread>
+#include <vector>
+
 namespace YAML {
 namespace {
 TEST(LoadNodeTest, Reassign) {
@@ -191,6 +196,99 @@ TEST(LoadNodeTest, ResetNode) {
   EXPECT_EQ(node, other);
 }
 
+TEST(LoadNodeTest, LoadedNodesOutliveTheirDocument) {
+  Node node;
+  {
+    Node doc = Load("a: [1, 2, 3]\nb: {c: d}\n");
+    node["a"] = doc["a"];
+    node["c"] = doc["b"]["c"];
+    node["a"].push_back(4);
+  }
+  EXPECT_EQ(4, node["a"].size());
+  EXPECT_EQ(4, node["a"][3].as<int>());
+  EXPECT_EQ("d", node["c"].as<std::string>());
+}
+
+TEST(LoadNodeTest, MixDocumentsAndHeapNodes) {
+  Node first = Load("- x\n- y\n");
+  Node heap;
+  heap["list"] = first;
+  {
+    Node second = Load("{k: v}");
+    second["list"] = heap["list"];
+    heap["map"] = second;
+    first = Node();
+  }
+  heap["list"].push_back("z");
+  EXPECT_EQ(3, heap["list"].size());
+  EXPECT_EQ("x", heap["list"][0].as<std::string>());
+  EXPECT_EQ("v", heap["map"]["k"].as<std::string>());
+  EXPECT_EQ(3, heap["map"]["list"].size());
+  EXPECT_EQ("z", heap["map"]["list"][2].as<std::string>());
+}
+
+TEST(LoadNodeTest, TagsAreSharedWithinADocument) {
+  Node doc = Load("- !x a\n- !x b\n- c\n- d\n");
+  EXPECT_EQ("!x", doc[0].Tag());
+  EXPECT_EQ(&doc[0].Tag(), &doc[1].Tag());
+  EXPECT_EQ(&doc[2].Tag(), &doc[3].Tag());
+}
+
+TEST(LoadNodeTest, InternedKeysAndTagsOutliveTheirDocument) {
+  Node node;
+  {
+    std::stringstream stream(
+        "- !x {a_long_key_that_needs_the_heap: 1}\n"
+        "- {a_long_key_that_needs_the_heap: 2}\n");
+    Node doc = Load(stream);
+    node["first"] = doc[0];
+    node["second"] = doc[1];
+  }
+  EXPECT_EQ("!x", node["first"].Tag());
+  EXPECT_EQ(1, node["first"]["a_long_key_that_needs_the_heap"].as<int>());
+  EXPECT_EQ(2, node["second"]["a_long_key_that_needs_the_heap"].as<int>());
+  EXPECT_EQ("a_long_key_that_needs_the_heap",
+            node["second"].begin()->first.as<std::string>());
+}
+
+TEST(LoadNodeTest, ScalarsTakenFromTheScanner) {
+  // these can't refer to the input, so the nodes take the scanner's copies
+  std::stringstream input;
+  for (int i = 0; i < 200; i++) {
+    input << "- \"" << std::string(i % 50, 'x') << "\\t" << i << "\"\n";
+  }
+  input << "- '" << std::string(100, 'y') << "'\n";
+
+  Node node = Load(input);
+  ASSERT_EQ(201, node.size());
+  for (int i = 0; i < 200; i++) {
+    EXPECT_EQ(std::string(i % 50, 'x') + "\t" + std::to_string(i),
+              node[i].as<std::string>());
+  }
+  EXPECT_EQ(std::string(100, 'y'), node[200].as<std::string>());
+}
+
+TEST(LoadNodeTest, ArenasOutliveReferencesFromOtherArenas) {
+  // d0's memory is merged into d1's, which is merged into d2's; then d1's
+  // arena takes on a ref from d3's, and d0 ends up the last to hold d1's
+  Node d0 = Node();
+  Node d2 = Load("b: 2");
+  Node d1 = Load("a: 1");
+  d1["k"] = d0;
+  d2["q"] = d1;
+  Node d3 = Load("c: 3");
+  Node a = d1["a"];
+  a = d3["c"];
+  EXPECT_EQ(3, d1["a"].as<int>());
+
+  d1 = Node();
+  d2 = Node();
+  d3 = Node();
+  a = Node();
+  EXPECT_TRUE(d0.IsNull());
+  d0 = Node();
+}
+
 TEST(LoadNodeTest, EmptyString) {
   Node node = Load("\"\"");
   EXPECT_TRUE(!node.IsNull());
@@ -234,6 +332,9 @@ TEST(NodeTest, IncompleteJson) {
        ErrorMsg::END_OF_MAP_FLOW},
       {"JSON map without end brace", "{\"access\":\"abc\"",
        ErrorMsg::END_OF_MAP_FLOW},
+      {"Plain key with colon at the end", "{a:", ErrorMsg::END_OF_MAP_FLOW},
+      {"Colon at the end", "{:", ErrorMsg::END_OF_MAP_FLOW},
+      {"Sequence with colon at the end", "[a:", ErrorMsg::END_OF_SEQ_FLOW},
   };
   for (const ParserExceptionTestCase test : tests) {
     try {
@@ -246,6 +347,17 @@ TEST(NodeTest, IncompleteJson) {
   }
 }
 
+TEST(NodeTest, FlowValueBeforeEnd) {
+  // a ':' just before the end of a flow collection is a value indicator
+  Node node = Load("[a:]");
+  ASSERT_TRUE(node.IsSequence());
+  ASSERT_TRUE(node[0].IsMap());
+  EXPECT_TRUE(node[0]["a"].IsNull());
+  EXPECT_TRUE(Load("[:]")[0].IsMap());
+  EXPECT_TRUE(Load("{a:}")["a"].IsNull());
+  EXPECT_EQ("b", Load("[a:, b]")[1].as<std::string>());
+}
+
 TEST(NodeTest, LoadTildeAsNull) {
   Node node = Load("~");
   ASSERT_TRUE(node.IsNull());
@@ -257,5 +369,363 @@ TEST(NodeTest, LoadTagWithParenthesis) {
     EXPECT_EQ(node.as<std::string>(), "foo");
 }
 
+TEST(LoadNodeTest, LoadRetainedInput) {
+  std::shared_ptr<const std::string> input = std::make_shared<const std::string>(
+      "plain: value\n"
+      "quoted: 'single'\n"
+      "escaped: \"tab\\there\"\n"
+      "doubled: 'it''s'\n"
+      "folded: one\n  two\n"
+      "nothing: ~\n"
+      "tagged: !foo bar\n"
+      "seq: [a, 'b', \"c\"]\n");
+  Node node = Load(input);
+  EXPECT_EQ("value", node["plain"].as<std::string>());
+  EXPECT_EQ("single", node["quoted"].as<std::string>());
+  EXPECT_EQ("tab\there", node["escaped"].as<std::string>());
+  EXPECT_EQ("it's", node["doubled"].as<std::string>());
+  EXPECT_EQ("one two", node["folded"].as<std::string>());
+  EXPECT_TRUE(node["nothing"].IsNull());
+  EXPECT_EQ("!foo", node["tagged"].Tag());
+  EXPECT_EQ("bar", node["tagged"].as<std::string>());
+  EXPECT_EQ("a", node["seq"][0].as<std::string>());
+  EXPECT_EQ("b", node["seq"][1].as<std::string>());
+  EXPECT_EQ("c", node["seq"][2].as<std::string>());
+}
+
+TEST(LoadNodeTest, RetainedInputOutlivesCaller) {
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>("foo: bar\nbaz: [1, 2]");
+  std::weak_ptr<const std::string> watch = input;
+  {
+    Node node = Load(input);
+    input.reset();
+    ASSERT_FALSE(watch.expired());
+    EXPECT_EQ("bar", node["foo"].as<std::string>());
+    EXPECT_EQ(2, node["baz"][1].as<int>());
+  }
+  EXPECT_TRUE(watch.expired());
+}
+
+TEST(LoadNodeTest, RetainedInputMergesWithOtherDocuments) {
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>("foo: bar");
+  std::weak_ptr<const std::string> watch = input;
+  Node doc = Load("{}");
+  {
+    Node other = Load(input);
+    doc["key"] = other["foo"];
+  }
+  input.reset();
+  ASSERT_FALSE(watch.expired());
+  EXPECT_EQ("bar", doc["key"].as<std::string>());
+}
+
+TEST(LoadNodeTest, RetainedInputScalarCanBeReassigned) {
+  Node node = Load(std::make_shared<const std::string>("foo: bar"));
+  node["foo"] = "baz";
+  EXPECT_EQ("baz", node["foo"].as<std::string>());
+  node["foo"] = Node(NodeType::Sequence);
+  EXPECT_TRUE(node["foo"].IsSequence());
+}
+
+TEST(LoadNodeTest, RetainedInputWithByteOrderMark) {
+  Node node = Load(std::make_shared<const std::string>(
+      "\xEF\xBB\xBF"
+      "foo: bar"));
+  EXPECT_EQ("bar", node["foo"].as<std::string>());
+}
+
+TEST(LoadNodeTest, LoadAllRetainedInput) {
+  std::vector<Node> docs = LoadAll(
+      std::make_shared<const std::string>("--- a\n--- 'b'\n---\nc: d\n"));
+  ASSERT_EQ(3, docs.size());
+  EXPECT_EQ("a", docs[0].as<std::string>());
+  EXPECT_EQ("b", docs[1].as<std::string>());
+  EXPECT_EQ("d", docs[2]["c"].as<std::string>());
+}
+
+// LogStream
+// . A stream of small documents, long enough to be parsed in parallel.
+std::string LogStream(int first, int count) {
+  std::stringstream stream;
+  for (int i = first; i < first + count; i++) {
+    stream << "---\nid: " << i << "\nlevel: info\nmessage: event " << i
+           << "\ntags: [a, b]\n";
+  }
+  return stream.str();
+}
+
+void ExpectSameAsLoadAll(const std::string& input) {
+  std::vector<Node> expected = LoadAll(input);
+  std::vector<Node> actual = LoadAllParallel(input, 4);
+  ASSERT_EQ(expected.size(), actual.size());
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(Dump(expected[i]), Dump(actual[i]));
+    EXPECT_EQ(expected[i].Tag(), actual[i].Tag());
+    EXPECT_EQ(expected[i].Mark().pos, actual[i].Mark().pos);
+    EXPECT_EQ(expected[i].Mark().line, actual[i].Mark().line);
+    EXPECT_EQ(expected[i].Mark().column, actual[i].Mark().column);
+  }
+}
+
+void ExpectSameErrorAsLoadAll(const std::string& input) {
+  std::string expected;
+  try {
+    LoadAll(input);
+    FAIL() << "LoadAll didn't throw";
+  } catch (const ParserException& e) {
+    expected = e.what();
+  }
+  try {
+    LoadAllParallel(input, 4);
+    FAIL() << "LoadAllParallel didn't throw";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(expected, e.what());
+  }
+}
+
+TEST(LoadNodeTest, LoadAllParallel) {
+  std::string input = LogStream(0, 5000);
+  std::vector<Node> docs = LoadAllParallel(input, 4);
+  ASSERT_EQ(5000, docs.size());
+  for (int i = 0; i < 5000; i++) {
+    EXPECT_EQ(i, docs[i]["id"].as<int>());
+  }
+  ExpectSameAsLoadAll(input);
+}
+
+TEST(LoadNodeTest, LoadAllParallelSmallInput) {
+  ExpectSameAsLoadAll("--- a\n--- b\n...\nc\n");
+  ExpectSameAsLoadAll("");
+}
+
+TEST(LoadNodeTest, LoadAllParallelWithDocumentEnds) {
+  std::string input = LogStream(0, 2000) + "...\nnext\n...\n" +
+                      LogStream(2000, 2000) + "...\n# done\n";
+  ExpectSameAsLoadAll(input);
+}
+
+TEST(LoadNodeTest, LoadAllParallelCarriesDirectivesOver) {
+  std::string input = "%TAG ! tag:first.com,2000:\n" + LogStream(0, 2000) +
+                      "--- !x a\n...\n%TAG ! tag:second.com,2000:\n" +
+                      LogStream(2000, 2000) + "--- !x b\n";
+  std::vector<Node> docs = LoadAllParallel(input, 4);
+  ASSERT_EQ(4002, docs.size());
+  EXPECT_EQ("tag:first.com,2000:x", docs[2000].Tag());
+  EXPECT_EQ("tag:second.com,2000:x", docs[4001].Tag());
+  ExpectSameAsLoadAll(input);
+}
+
+TEST(LoadNodeTest, LoadAllParallelAmbiguousDirective) {
+  // the %TAG line belongs to the scalar, so the tag isn't defined
+  std::string input = LogStream(0, 2000) + "--- b\n%TAG ! !foo\n---\n!x c\n" +
+                      LogStream(0, 2000);
+  std::vector<Node> docs = LoadAllParallel(input, 4);
+  ASSERT_EQ(4002, docs.size());
+  EXPECT_EQ("b %TAG ! !foo", docs[2000].as<std::string>());
+  EXPECT_EQ("!x", docs[2001].Tag());
+  ExpectSameAsLoadAll(input);
+}
+
+TEST(LoadNodeTest, LoadAllParallelWithByteOrderMark) {
+  ExpectSameAsLoadAll("\xEF\xBB\xBF" + LogStream(0, 5000));
+}
+
+TEST(LoadNodeTest, LoadAllParallelReportsFirstError) {
+  ExpectSameErrorAsLoadAll(LogStream(0, 2000) + "---\nkey: [a, b\n" +
+                           LogStream(0, 2000) + "---\n{\n" +
+                           LogStream(0, 2000));
+}
+
+TEST(LoadNodeTest, PartialInputCutsOffQuotedScalar) {
+  // on its own, a quoted scalar may run to the end of the input...
+  Emitter emitter;
+  EmitFromEvents handler(emitter);
+  Parser whole(std::make_shared<const std::string>("a: 'one\n"));
+  EXPECT_TRUE(whole.HandleNextDocument(handler));
+
+  // ...but not if that's only the end of part of it
+  Parser partial;
+  partial.Load(std::make_shared<const std::string>("a: 'one\nb: two'\n"),
+               Mark(), 8);
+  EXPECT_THROW(partial.HandleNextDocument(handler), ParserException);
+}
+
+TEST(LoadNodeTest, LoadAllParallelQuotedScalarAcrossDocuments) {
+  ExpectSameErrorAsLoadAll(LogStream(0, 2000) + "--- \"a\n---\nb\"\n" +
+                           LogStream(0, 2000));
+}
+
+TEST(LoadNodeTest, LoadAllParallelFlowCollectionAcrossDocuments) {
+  ExpectSameErrorAsLoadAll(LogStream(0, 2000) + "--- [a,\n---\nb]\n" +
+                           LogStream(0, 2000));
+}
+
+TEST(LoadNodeTest, LoadAllParallelBadDirective) {
+  ExpectSameErrorAsLoadAll(LogStream(0, 2000) + "...\n%YAML 2.0\n" +
+                           LogStream(0, 2000));
+}
+
+TEST(LoadNodeTest, LoadAllFromFileParallelBadFile) {
+  EXPECT_THROW(LoadAllFromFileParallel("doesnotexist.yaml"), BadFile);
+}
+
+// RootMap
+// . A document whose root is a block map, long enough to be parsed in
+//   parallel.
+std::string RootMap(int count) {
+  std::stringstream stream;
+  for (int i = 0; i < count; i++) {
+    stream << "key" << i << ":\n  id: " << i << "\n  name: 'entry " << i
+           << "'\n  tags: [a, b]\n";
+  }
+  return stream.str();
+}
+
+void ExpectSameAsLoad(const std::string& input) {
+  Node expected = Load(input);
+  Node actual = LoadParallel(input, 4);
+  EXPECT_EQ(Dump(expected), Dump(actual));
+  EXPECT_EQ(expected.size(), actual.size());
+  EXPECT_EQ(expected.Mark().pos, actual.Mark().pos);
+  EXPECT_EQ(expected.Mark().line, actual.Mark().line);
+}
+
+void ExpectSameErrorAsLoad(const std::string& input) {
+  std::string expected;
+  try {
+    Load(input);
+    FAIL() << "Load didn't throw";
+  } catch (const ParserException& e) {
+    expected = e.what();
+  }
+  try {
+    LoadParallel(input, 4);
+    FAIL() << "LoadParallel didn't throw";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(expected, e.what());
+  }
+}
+
+TEST(LoadNodeTest, LoadParallelMap) {
+  std::string input = RootMap(5000);
+  Node node = LoadParallel(input, 4);
+  ASSERT_TRUE(node.IsMap());
+  ASSERT_EQ(5000, node.size());
+  EXPECT_EQ(4999, node["key4999"]["id"].as<int>());
+  EXPECT_EQ(4 * 4999 + 1, node["key4999"]["id"].Mark().line);
+  ExpectSameAsLoad(input);
+}
+
+TEST(LoadNodeTest, LoadParallelSequence) {
+  std::stringstream stream;
+  for (int i = 0; i < 10000; i++) {
+    stream << "- id: " << i << "\n  values:\n  - " << i << "\n";
+  }
+  Node node = LoadParallel(stream.str(), 4);
+  ASSERT_TRUE(node.IsSequence());
+  ASSERT_EQ(10000, node.size());
+  EXPECT_EQ(9999, node[9999]["values"][0].as<int>());
+  ExpectSameAsLoad(stream.str());
+}
+
+TEST(LoadNodeTest, LoadParallelSmallInput) {
+  ExpectSameAsLoad("a: b\nc: d\n");
+  ExpectSameAsLoad("- a\n- b\n");
+  ExpectSameAsLoad("scalar");
+  ExpectSameAsLoad("");
+}
+
+TEST(LoadNodeTest, LoadParallelCarriesDirectivesOver) {
+  std::string input = "%TAG ! tag:example.com,2000:\n---\n" + RootMap(5000) +
+                      "last: !x value\n";
+  Node node = LoadParallel(input, 4);
+  EXPECT_EQ("tag:example.com,2000:x", node["last"].Tag());
+  ExpectSameAsLoad(input);
+}
+
+TEST(LoadNodeTest, LoadParallelCompactSequenceValues) {
+  std::stringstream stream;
+  for (int i = 0; i < 5000; i++) {
+    stream << "key" << i << ":\n- " << i << "\n- x\n";
+  }
+  ExpectSameAsLoad(stream.str());
+}
+
+TEST(LoadNodeTest, LoadParallelOnlyLoadsFirstDocument) {
+  ExpectSameAsLoad(RootMap(5000) + "---\nsecond: document\n");
+  ExpectSameAsLoad(RootMap(5000) + "...\n");
+}
+
+TEST(LoadNodeTest, LoadParallelQuotedScalarAcrossEntries) {
+  std::stringstream stream;
+  for (int i = 0; i < 5000; i++) {
+    stream << "quoted" << i << ": \"one\nkey: two\"\n";
+  }
+  Node node = LoadParallel(stream.str(), 4);
+  EXPECT_EQ("one key: two", node["quoted4999"].as<std::string>());
+  ExpectSameAsLoad(stream.str());
+}
+
+TEST(LoadNodeTest, LoadParallelFlowCollectionAcrossEntries) {
+  std::stringstream stream;
+  for (int i = 0; i < 5000; i++) {
+    stream << "flow" << i << ": [a,\nb]\n";
+  }
+  ExpectSameAsLoad(stream.str());
+}
+
+TEST(LoadNodeTest, LoadParallelAliasAcrossEntries) {
+  std::string input =
+      "first: &anchor [a, b]\n" + RootMap(5000) + "last: *anchor\n";
+  Node node = LoadParallel(input, 4);
+  EXPECT_TRUE(node["first"].is(node["last"]));
+  ExpectSameAsLoad(input);
+}
+
+TEST(LoadNodeTest, LoadParallelReportsError) {
+  ExpectSameErrorAsLoad(RootMap(2500) + "bad: [a, b\n" + RootMap(2500));
+  ExpectSameErrorAsLoad(RootMap(2500) + "bad: *unknown\n" + RootMap(2500));
+}
+
+TEST(LoadNodeTest, LoadFileParallelBadFile) {
+  EXPECT_THROW(LoadFileParallel("doesnotexist.yaml"), BadFile);
+}
+
+TEST(LoadNodeTest, ReadFrozenDocumentFromManyThreads) {
+  std::stringstream stream;
+  for (int i = 0; i < 1000; i++) {
+    stream << "key" << i << ": {id: " << i << ", tags: [a, b, c]}\n";
+  }
+  Node node = Load(std::make_shared<const std::string>(stream.str()));
+  node.Freeze();
+
+  std::vector<int> failures(4, 0);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < failures.size(); t++) {
+    threads.emplace_back([&node, &failures, t]() {
+      for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 1000; i++) {
+          Node entry = node["key" + std::to_string(i)];
+          if (entry["id"].as<int>() != i || entry["tags"][1].Scalar() != "b" ||
+              node["missing"])
+            failures[t]++;
+        }
+        std::size_t count = 0;
+        for (const_iterator it = node.begin(); it != node.end(); ++it)
+          count += it->second["tags"].size();
+        if (count != 3000)
+          failures[t]++;
+      }
+    });
+  }
+  for (std::size_t t = 0; t < threads.size(); t++)
+    threads[t].join();
+
+  for (std::size_t t = 0; t < failures.size(); t++)
+    EXPECT_EQ(0, failures[t]);
+  EXPECT_EQ(1000, node.size());
+}
 }  // namespace
 }  // namespace YAML
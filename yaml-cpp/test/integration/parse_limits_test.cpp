@@ -0,0 +1,183 @@
+#include "yaml-cpp/emitfromevents.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace YAML {
+namespace {
+// each level is a list of two aliases to the one before, so the last one
+// expands to 2^levels copies of the first
+std::string Laughs(int levels) {
+  std::string document = "a0: &a0 [lol]\n";
+  for (int i = 1; i <= levels; i++) {
+    const std::string prev = "*a" + std::to_string(i - 1);
+    document += "a" + std::to_string(i) + ": &a" + std::to_string(i) + " [" +
+                prev + ", " + prev + "]\n";
+  }
+  return document;
+}
+
+ParseLimits NodeLimit(std::size_t maxNodes) {
+  ParseLimits limits;
+  limits.maxNodes = maxNodes;
+  return limits;
+}
+
+// the exception's message, or "" if it loads
+std::string LoadError(const std::string& input, const ParseLimits& limits,
+                      bool json = false) {
+  try {
+    if (json)
+      LoadJson(std::make_shared<const std::string>(input), limits);
+    else
+      Load(input, limits);
+  } catch (const ParserException& e) {
+    return e.what();
+  }
+  return "";
+}
+
+void ExpectError(const std::string& input, const ParseLimits& limits,
+                 const char* msg, int line, int column) {
+  SCOPED_TRACE(input);
+  try {
+    Load(input, limits);
+    ADD_FAILURE() << "expected an exception";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(msg, e.msg);
+    EXPECT_EQ(line, e.mark.line);
+    EXPECT_EQ(column, e.mark.column);
+  }
+}
+
+TEST(ParseLimitsTest, UnlimitedByDefault) {
+  const ParseLimits limits;
+  EXPECT_EQ(ParseLimits::Unlimited, limits.maxNodes);
+  EXPECT_EQ(ParseLimits::Unlimited, limits.maxDepth);
+  EXPECT_EQ(ParseLimits::Unlimited, limits.maxAliases);
+  EXPECT_EQ(ParseLimits::Unlimited, limits.maxScalarBytes);
+
+  // the aliases are shared, not expanded, so this is cheap to load
+  const Node node = Load(Laughs(64), limits);
+  EXPECT_TRUE(node["a64"][0].is(node["a63"]));
+}
+
+TEST(ParseLimitsTest, BillionLaughs) {
+  // an alias counts as what it would expand to, so it fails at the first
+  // alias that goes past the limit: through level 7, there are
+  // 1 + 3 * (2^8 - 1) = 766 nodes, and the first alias on level 8 adds
+  // 3 * 2^7 - 1 = 383 more
+  ExpectError(Laughs(64), NodeLimit(1000), ErrorMsg::TOO_MANY_NODES, 8, 9);
+  EXPECT_NO_THROW(Load(Laughs(7), NodeLimit(766)));
+  ExpectError(Laughs(7), NodeLimit(765), ErrorMsg::TOO_MANY_NODES, 7, 14);
+
+  // and each "lol" counts, where it would be expanded to
+  ParseLimits limits;
+  limits.maxScalarBytes = 1000000;
+  ExpectError(Laughs(64), limits, ErrorMsg::TOO_MUCH_SCALAR, 18, 11);
+}
+
+TEST(ParseLimitsTest, Nodes) {
+  EXPECT_NO_THROW(Load("[1, 2]", NodeLimit(3)));
+  ExpectError("[1, 2]", NodeLimit(2), ErrorMsg::TOO_MANY_NODES, 0, 4);
+  ExpectError("a: 1\nb: 2\n", NodeLimit(4), ErrorMsg::TOO_MANY_NODES, 1, 3);
+
+  // an alias to a collection that contains it is one node
+  EXPECT_NO_THROW(Load("&a [1, *a]", NodeLimit(3)));
+
+  // and an alias is to the anchor's latest node
+  const std::string redefined = "[&a [1, 2], *a, &a 3, *a]";
+  EXPECT_NO_THROW(Load(redefined, NodeLimit(9)));
+  ExpectError(redefined, NodeLimit(8), ErrorMsg::TOO_MANY_NODES, 0, 22);
+}
+
+TEST(ParseLimitsTest, Depth) {
+  ParseLimits limits;
+  limits.maxDepth = 2;
+  EXPECT_NO_THROW(Load("[[1], {a: 2}]", limits));
+  ExpectError("[[[1]]]", limits, ErrorMsg::TOO_DEEP, 0, 2);
+  ExpectError("a:\n  b:\n    c: 1\n", limits, ErrorMsg::TOO_DEEP, 2, 4);
+
+  limits.maxDepth = 0;
+  EXPECT_NO_THROW(Load("scalar", limits));
+  ExpectError("[]", limits, ErrorMsg::TOO_DEEP, 0, 0);
+}
+
+TEST(ParseLimitsTest, Aliases) {
+  ParseLimits limits;
+  limits.maxAliases = 2;
+  EXPECT_NO_THROW(Load("[&a 1, *a, *a]", limits));
+  ExpectError("[&a 1, *a, *a, *a]", limits, ErrorMsg::TOO_MANY_ALIASES, 0,
+              15);
+}
+
+TEST(ParseLimitsTest, ScalarBytes) {
+  ParseLimits limits;
+  limits.maxScalarBytes = 6;
+  EXPECT_NO_THROW(Load("[&x abc, *x]", limits));
+  EXPECT_NO_THROW(Load("{ab: 'c''', e: \"\\x41\"}", limits));
+  ExpectError("[&x abc, *x, d]", limits, ErrorMsg::TOO_MUCH_SCALAR, 0, 13);
+  ExpectError("|\n  line one\n", limits, ErrorMsg::TOO_MUCH_SCALAR, 0, 0);
+
+  // and an alias counts its anchor's collection's scalars
+  limits.maxScalarBytes = 7;
+  ExpectError("[&x [ab, cd], *x]", limits, ErrorMsg::TOO_MUCH_SCALAR, 0,
+              14);
+}
+
+TEST(ParseLimitsTest, JsonGivesTheSameErrors) {
+  const char* const inputs[] = {
+      "[1, 2, 3]", "{\"a\": [true, null], \"b\": {}}",
+      "[[[[\"deep\"]]]]", "{\"text\": \"long \\\"escaped\\\" string\"}"};
+  ParseLimits limits[4];
+  limits[0].maxNodes = 3;
+  limits[1].maxDepth = 2;
+  limits[2].maxScalarBytes = 4;
+  limits[3].maxAliases = 0;
+  for (const char* input : inputs) {
+    for (const ParseLimits& limit : limits) {
+      SCOPED_TRACE(input);
+      const std::string expected = LoadError(input, limit);
+      EXPECT_EQ(expected, LoadError(input, limit, true));
+      try {
+        Load(std::make_shared<const std::string>(input), limit, true);
+        EXPECT_EQ("", expected);
+      } catch (const ParserException& e) {
+        EXPECT_EQ(expected, e.what());
+      }
+    }
+  }
+  EXPECT_NE("", LoadError("[1, 2, 3]", NodeLimit(3), true));
+}
+
+TEST(ParseLimitsTest, EachDocument) {
+  const std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>("- 1\n---\n- 2\n---\n[3, 4]\n");
+  EXPECT_THROW(LoadAll(input, NodeLimit(2)), ParserException);
+  EXPECT_NO_THROW(LoadAll(input, NodeLimit(3)));
+  EXPECT_EQ(3, LoadAll(input, NodeLimit(3)).size());
+}
+
+TEST(ParseLimitsTest, Parser) {
+  // a handler that re-emits what it's given, aliases and all, is held to
+  // them as well
+  std::stringstream laughs(Laughs(64));
+  Parser parser(laughs);
+  parser.SetLimits(NodeLimit(3));
+  std::stringstream out;
+  Emitter emitter(out);
+  EmitFromEvents handler(emitter);
+  EXPECT_THROW(parser.HandleNextDocument(handler), ParserException);
+
+  // and the limits stay with the parser when it's loaded again
+  std::stringstream documents("[1, 2]\n--- [1, 2, 3]\n");
+  parser.Load(documents);
+  EXPECT_TRUE(parser.HandleNextDocument(handler));
+  EXPECT_THROW(parser.HandleNextDocument(handler), ParserException);
+}
+}  // namespace
+}  // namespace YAML
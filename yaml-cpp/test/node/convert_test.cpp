@@ -0,0 +1,286 @@
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+// how numbers were converted before, with a stream, which the conversions
+// have to agree with exactly
+template <typename T>
+bool StreamDecode(const std::string& input, T& rhs) {
+  std::stringstream stream(input);
+  stream.unsetf(std::ios::dec);
+  if ((stream >> std::noskipws >> rhs) && (stream >> std::ws).eof())
+    return true;
+  if (std::numeric_limits<T>::has_infinity) {
+    if (conversion::IsInfinity(input)) {
+      rhs = std::numeric_limits<T>::infinity();
+      return true;
+    } else if (conversion::IsNegativeInfinity(input)) {
+      rhs = -std::numeric_limits<T>::infinity();
+      return true;
+    }
+  }
+  if (std::numeric_limits<T>::has_quiet_NaN && conversion::IsNaN(input)) {
+    rhs = std::numeric_limits<T>::quiet_NaN();
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+std::string StreamEncode(const T& rhs) {
+  std::stringstream stream;
+  stream.precision(std::numeric_limits<T>::digits10 + 1);
+  stream << rhs;
+  return stream.str();
+}
+
+template <typename T>
+bool Same(const T& lhs, const T& rhs) {
+  // compares NaNs as equal, and 0 and -0 as different
+  return std::memcmp(&lhs, &rhs, sizeof(T)) == 0 ||
+         (lhs != lhs && rhs != rhs);
+}
+
+template <>
+bool Same<long double>(const long double& lhs, const long double& rhs) {
+  // long double has padding, which memcmp would see
+  if (lhs != lhs || rhs != rhs)
+    return lhs != lhs && rhs != rhs;
+  return lhs == rhs && std::signbit(lhs) == std::signbit(rhs);
+}
+
+template <typename T>
+void ExpectDecodesAsStreamDoes(const std::string& input) {
+  T expected = T(), actual = T();
+  const bool expectedOk = StreamDecode(input, expected);
+  const bool actualOk = convert<T>::decode(Node(input), actual);
+  ASSERT_EQ(expectedOk, actualOk) << '"' << input << '"';
+  if (expectedOk) {
+    EXPECT_TRUE(Same(expected, actual)) << '"' << input << '"';
+  }
+}
+
+template <typename T>
+void ExpectEncodesAsStreamDoes(const T& value) {
+  EXPECT_EQ(StreamEncode(value), convert<T>::encode(value).Scalar());
+}
+
+// every string of up to four characters from an alphabet that makes most of
+// the interesting shapes of number
+std::vector<std::string> ShortInputs(const std::string& alphabet) {
+  std::vector<std::string> inputs(1);
+  for (std::size_t begin = 0, length = 1; length <= 4; length++) {
+    const std::size_t end = inputs.size();
+    for (std::size_t i = begin; i < end; i++) {
+      for (char ch : alphabet) {
+        inputs.push_back(inputs[i] + ch);
+      }
+    }
+    begin = end;
+  }
+  return inputs;
+}
+
+template <typename T>
+void ExpectIntegersAsStreamDoes() {
+  for (const std::string& input : ShortInputs("0178fx -+")) {
+    ExpectDecodesAsStreamDoes<T>(input);
+  }
+
+  typedef std::numeric_limits<T> limits;
+  const long long values[] = {
+      static_cast<long long>(limits::min()),
+      static_cast<long long>(limits::max()), 0, 1, -1, 42, -42};
+  for (long long value : values) {
+    const T typed = static_cast<T>(value);
+    ExpectEncodesAsStreamDoes(typed);
+    std::ostringstream text;
+    text << +typed;
+    const std::string plain = text.str();
+    ExpectDecodesAsStreamDoes<T>(plain);
+    ExpectDecodesAsStreamDoes<T>("-" + plain);
+    ExpectDecodesAsStreamDoes<T>(plain + "0");
+    ExpectDecodesAsStreamDoes<T>(plain + "9");
+    ExpectDecodesAsStreamDoes<T>(plain + " \t\r\n");
+    ExpectDecodesAsStreamDoes<T>(" " + plain);
+  }
+
+  const char* const others[] = {
+      "0x7f",     "0x80",    "0xff",   "0x100",   "-0x80",   "0177",
+      "0200",     "0377",    "0400",   "0X7FFF",  "0x8000",  "0xFFFF",
+      "0x10000",  "+0x1",    "-0",     "00",      "0x",      "0x0F",
+      "09",       "1e3",     "1.0",    "1_000",   "0b1",     ".inf",
+      "2147483647",          "2147483648",        "-2147483648",
+      "-2147483649",         "4294967295",        "4294967296",
+      "-4294967295",         "-4294967296",       "9223372036854775807",
+      "9223372036854775808", "-9223372036854775808",
+      "-9223372036854775809", "18446744073709551615",
+      "18446744073709551616", "-18446744073709551615",
+      "0xFFFFFFFFFFFFFFFF",  "0x10000000000000000",
+      "01777777777777777777777", "02000000000000000000000"};
+  for (const char* input : others) {
+    ExpectDecodesAsStreamDoes<T>(input);
+  }
+}
+
+TEST(ConvertTest, Integers) {
+  ExpectIntegersAsStreamDoes<short>();
+  ExpectIntegersAsStreamDoes<unsigned short>();
+  ExpectIntegersAsStreamDoes<int>();
+  ExpectIntegersAsStreamDoes<unsigned>();
+  ExpectIntegersAsStreamDoes<long>();
+  ExpectIntegersAsStreamDoes<unsigned long>();
+  ExpectIntegersAsStreamDoes<long long>();
+  ExpectIntegersAsStreamDoes<unsigned long long>();
+}
+
+TEST(ConvertTest, IntegerRules) {
+  EXPECT_EQ(31, Node("0x1f").as<int>());
+  EXPECT_EQ(15, Node("017").as<int>());
+  EXPECT_EQ(-16, Node("-0x10").as<int>());
+  EXPECT_EQ(65535, Node("-1").as<unsigned short>());
+  EXPECT_EQ(7, Node("7 \n").as<int>());
+  EXPECT_THROW(Node(" 7").as<int>(), TypedBadConversion<int>);
+  EXPECT_THROW(Node("08").as<int>(), TypedBadConversion<int>);
+  EXPECT_THROW(Node("0x").as<int>(), TypedBadConversion<int>);
+  EXPECT_THROW(Node("32768").as<short>(), TypedBadConversion<short>);
+  EXPECT_EQ("-9223372036854775808",
+            Node(std::numeric_limits<long long>::min()).Scalar());
+}
+
+TEST(ConvertTest, Characters) {
+  for (const std::string& input : ShortInputs("a0 \t")) {
+    ExpectDecodesAsStreamDoes<char>(input);
+    ExpectDecodesAsStreamDoes<signed char>(input);
+    ExpectDecodesAsStreamDoes<unsigned char>(input);
+  }
+  ExpectEncodesAsStreamDoes('a');
+  ExpectEncodesAsStreamDoes(static_cast<signed char>('-'));
+  ExpectEncodesAsStreamDoes(static_cast<unsigned char>(200));
+}
+
+template <typename T>
+void ExpectFloatsAsStreamDoes() {
+  for (const std::string& input : ShortInputs("019.e-+ x")) {
+    ExpectDecodesAsStreamDoes<T>(input);
+  }
+
+  const char* const others[] = {
+      ".inf",    "-.Inf",   "+.INF",  ".NaN",   "inf",     "nan",
+      "1e38",    "1e39",    "-1e39",  "1e308",  "1e309",   "1e4932",
+      "1e4933",  "1e-38",   "1e-46",  "1e-400", "1e-5000", "2.5e-324",
+      "0.1",     "0.3",     "3.14159265358979323846264338327950288",
+      "123456789012345678901234567890", "0.000000000000000000000001",
+      "9007199254740993", "9007199254740992.5",  "1.00000000000000000001",
+      "100000000000000000000000",       "1e22",  "1e23",    "4e-22",
+      "16777217", "8388608.5", "1e10",  "1e11",   "3.4028235e38",
+      "3.4028236e38",       "1.7976931348623157e308",
+      "1.7976931348623159e308", "0e99999999999", "1e+00000000000000001",
+      "-0.0",    "+0",      "1.5 ",   "1.5\t\n", " 1.5",  "1.5x",
+      "1,5",     "0x1p3",   "1e",     "1e+",    ".e1",    "1.e1",
+      ".5",      "5.",      "1.5.3",  "1e5.5",  "--1",    "+-1"};
+  for (const char* input : others) {
+    ExpectDecodesAsStreamDoes<T>(input);
+  }
+
+  std::mt19937_64 random(12345);
+  std::uniform_int_distribution<int> digits(1, 24);
+  std::uniform_int_distribution<int> exponents(-60, 60);
+  std::uniform_int_distribution<int> digit(0, 9);
+  for (int i = 0; i < 20000; i++) {
+    std::string input;
+    if (i % 3 == 0)
+      input += '-';
+    const int count = digits(random);
+    const int point = std::uniform_int_distribution<int>(0, count)(random);
+    for (int j = 0; j < count; j++) {
+      if (j == point)
+        input += '.';
+      input += static_cast<char>('0' + digit(random));
+    }
+    if (i % 2 == 0)
+      input += "e" + std::to_string(exponents(random));
+    ExpectDecodesAsStreamDoes<T>(input);
+  }
+
+  for (int i = 0; i < 20000; i++) {
+    double value;
+    const unsigned long long bits = random();
+    std::memcpy(&value, &bits, sizeof(value));
+    const T typed = static_cast<T>(value);
+    ExpectEncodesAsStreamDoes(typed);
+    ExpectDecodesAsStreamDoes<T>(StreamEncode(typed));
+  }
+
+  const T specials[] = {0, -T(0), 1, T(0.1), T(1) / 3, T(1e10), T(1e-10),
+                        std::numeric_limits<T>::max(),
+                        std::numeric_limits<T>::min(),
+                        std::numeric_limits<T>::denorm_min(),
+                        std::numeric_limits<T>::infinity(),
+                        -std::numeric_limits<T>::infinity(),
+                        std::numeric_limits<T>::quiet_NaN()};
+  for (const T& value : specials) {
+    ExpectEncodesAsStreamDoes(value);
+  }
+}
+
+TEST(ConvertTest, Floats) { ExpectFloatsAsStreamDoes<float>(); }
+
+TEST(ConvertTest, Doubles) { ExpectFloatsAsStreamDoes<double>(); }
+
+TEST(ConvertTest, LongDoubles) { ExpectFloatsAsStreamDoes<long double>(); }
+
+TEST(ConvertTest, FloatRules) {
+  EXPECT_EQ(0.1, Node("0.1").as<double>());
+  EXPECT_EQ(1.5, Node("1.5 ").as<double>());
+  EXPECT_EQ(100.0, Node("1.e2").as<double>());
+  EXPECT_TRUE(std::isinf(Node(".inf").as<double>()));
+  EXPECT_TRUE(std::isnan(Node(".nan").as<float>()));
+  EXPECT_EQ(0.0, Node("1e-400").as<double>());
+  EXPECT_THROW(Node("1e400").as<double>(), TypedBadConversion<double>);
+  EXPECT_THROW(Node("1e39").as<float>(), TypedBadConversion<float>);
+  EXPECT_THROW(Node("0x10").as<double>(), TypedBadConversion<double>);
+  EXPECT_EQ("0.3333333333333333", Node(1.0 / 3).Scalar());
+  EXPECT_EQ("0.3333333", Node(1.0f / 3).Scalar());
+  EXPECT_EQ("1e+20", Node(1e20).Scalar());
+}
+
+TEST(ConvertTest, NumericSequences) {
+  const Node node = Load("[1, 16, 2.5e1, '7', !!int 8]");
+  const std::vector<double> values = node.as<std::vector<double>>();
+  ASSERT_EQ(5u, values.size());
+  EXPECT_EQ(16.0, values[1]);
+  EXPECT_EQ(25.0, values[2]);
+  EXPECT_EQ(8.0, values[4]);
+  EXPECT_THROW(node.as<std::vector<int>>(), TypedBadConversion<int>);
+
+  try {
+    Load("[1, 2,\n [3]]").as<std::vector<int>>();
+    FAIL();
+  } catch (const TypedBadConversion<int>& e) {
+    EXPECT_EQ(1, e.mark.line);
+  }
+  EXPECT_THROW(Load("[1, ~]").as<std::vector<int>>(), TypedBadConversion<int>);
+
+  // anything else goes through as<T> as before
+  const std::vector<std::vector<int>> nested =
+      Load("[[1, 2], [3]]").as<std::vector<std::vector<int>>>();
+  ASSERT_EQ(2u, nested.size());
+  EXPECT_EQ(3, nested[1][0]);
+  EXPECT_EQ("b", Load("[a, b]").as<std::vector<std::string>>()[1]);
+}
+}  // namespace
+}  // namespace YAML
@@ -2,13 +2,19 @@
 #include "yaml-cpp/emitter.h"
 #include "yaml-cpp/node/convert.h"
 #include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/emit.h"
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/iterator.h"
+#include "yaml-cpp/node/parse.h"
+#include "yaml-cpp/node/path.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <chrono>
+#include <unordered_set>
+
 using ::testing::AnyOf;
 using ::testing::Eq;
 
@@ -173,6 +179,41 @@ TEST(NodeTest, UndefinedConstNodeWithFallback) {
   EXPECT_EQ(cn["undefined"].as<int>(3), 3);
 }
 
+TEST(NodeTest, MoveStringIn) {
+  std::string value(100, 'a');
+  const char* data = value.data();
+  Node node(std::move(value));
+  EXPECT_EQ(std::string(100, 'a'), node.as<std::string>());
+  EXPECT_EQ(data, node.Scalar().data());
+
+  Node map;
+  value.assign(100, 'b');
+  data = value.data();
+  map["key"] = std::move(value);
+  EXPECT_EQ(std::string(100, 'b'), map["key"].as<std::string>());
+  EXPECT_EQ(data, map["key"].Scalar().data());
+
+  map.Freeze();
+  EXPECT_THROW(map["key"] = std::string("c"), FrozenNode);
+}
+
+TEST(NodeTest, TryAs) {
+  Node node;
+  node["number"] = 5;
+  node["word"] = "five";
+  const Node& cn = node;
+
+  int value = 3;
+  EXPECT_TRUE(cn["number"].try_as(value));
+  EXPECT_EQ(5, value);
+  value = 3;
+  EXPECT_FALSE(cn["word"].try_as(value));
+  EXPECT_FALSE(cn["undefined"].try_as(value));
+  EXPECT_FALSE(Node().try_as(value));
+  EXPECT_EQ(3, value);
+  EXPECT_EQ(2, node.size());
+}
+
 TEST(NodeTest, MapIteratorWithUndefinedValues) {
   Node node;
   node["key"] = "value";
@@ -431,6 +472,481 @@ TEST(NodeTest, AccessNonexistentKeyOnConstNode) {
   ASSERT_FALSE(other["5"]);
 }
 
+TEST(NodeTest, LargeMapLookups) {
+  Node node;
+  for (int i = 0; i < 1000; i++) {
+    node["key" + std::to_string(i)] = i;
+  }
+  EXPECT_EQ(1000, node.size());
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(i, node["key" + std::to_string(i)].as<int>());
+  }
+  EXPECT_FALSE(node["missing"]);
+  EXPECT_EQ(1000, node.size());
+
+  // still in insertion order
+  int i = 0;
+  for (const_iterator it = node.begin(); it != node.end(); ++it, ++i) {
+    EXPECT_EQ("key" + std::to_string(i), it->first.as<std::string>());
+  }
+}
+
+TEST(NodeTest, LargeMapKeepsIndexAcrossChanges) {
+  Node node;
+  for (int i = 0; i < 100; i++) {
+    node[std::to_string(i)] = i;
+  }
+  EXPECT_EQ(5, node["5"].as<int>());
+
+  node["new"] = "value";
+  EXPECT_EQ("value", node["new"].as<std::string>());
+
+  EXPECT_TRUE(node.remove("5"));
+  EXPECT_FALSE(node.remove("5"));
+  EXPECT_FALSE(node["5"]);
+  EXPECT_EQ(6, node["6"].as<int>());
+  EXPECT_EQ(99, node["99"].as<int>());
+}
+
+TEST(NodeTest, LargeMapFindsFirstOfDuplicateKeys) {
+  Node node;
+  for (int i = 0; i < 100; i++) {
+    node.force_insert(std::to_string(i % 50), i);
+  }
+  EXPECT_EQ(100, node.size());
+  EXPECT_EQ(7, node["7"].as<int>());
+
+  node.remove("7");
+  EXPECT_EQ(57, node["7"].as<int>());
+}
+
+TEST(NodeTest, LargeMapStillDecodesNonStringKeys) {
+  Node node;
+  for (int i = 0; i < 100; i++) {
+    node["0x" + std::to_string(i)] = i;
+  }
+  // found by value, rather than by text
+  EXPECT_EQ(10, node[16].as<int>());
+  EXPECT_EQ(10, node["0x10"].as<int>());
+  EXPECT_FALSE(node["16"]);
+}
+
+TEST(NodeTest, LargeSequenceConvertedToMap) {
+  Node node;
+  for (int i = 0; i < 100; i++) {
+    node.push_back(i);
+  }
+  node["key"] = "value";
+  EXPECT_TRUE(node.IsMap());
+  EXPECT_EQ(42, node["42"].as<int>());
+  EXPECT_EQ("value", node["key"].as<std::string>());
+}
+
+TEST(NodeTest, LargeMapWithCollectionKeys) {
+  Node node;
+  for (int i = 0; i < 100; i++) {
+    node[std::to_string(i)] = i;
+  }
+  Node key;
+  node[key] = "undefined key";
+  EXPECT_EQ(3, node["3"].as<int>());
+  key = "later";
+  EXPECT_EQ("undefined key", node["later"].as<std::string>());
+}
+
+TEST(NodeTest, LargeMapWithKeyRenamedInPlace) {
+  Node node;
+  for (int i = 0; i < 40; i++) {
+    node["k" + std::to_string(i)] = i;
+  }
+  EXPECT_EQ(5, node["k5"].as<int>());  // builds the index
+
+  iterator it = node.begin();
+  Node key = it->first;
+  key = "renamed";
+  const Node& constNode = node;
+  EXPECT_EQ(0, constNode["renamed"].as<int>());
+  EXPECT_FALSE(constNode["k0"]);
+  EXPECT_EQ(0, Path("renamed").Find(node).as<int>());
+
+  node["renamed"] = 99;
+  EXPECT_EQ(40, node.size());
+  EXPECT_EQ(99, node.begin()->second.as<int>());
+
+  // the same through a key that's kept from before it was added, or that's
+  // made to refer to another node, or that wasn't a scalar at all
+  Node kept("kept");
+  node[kept] = 40;
+  Node list;
+  list.push_back(1);
+  node[list] = 41;
+  EXPECT_FALSE(constNode["held"]);
+  kept = "held";
+  EXPECT_EQ(40, constNode["held"].as<int>());
+  Node other = Load("other");
+  key = other;
+  EXPECT_EQ(99, constNode["other"].as<int>());
+  EXPECT_FALSE(constNode["list"]);
+  list = "list";
+  EXPECT_EQ(41, constNode["list"].as<int>());
+  EXPECT_EQ(42, node.size());
+}
+
+TEST(NodeTest, LargeMapMissesAndInserts) {
+  // a miss in the index is final, so neither takes a search of the map
+  Node node;
+  const int size = 50000;
+  for (int i = 0; i < size; i++) {
+    node["k" + std::to_string(i)] = i;
+  }
+  const Node& constNode = node;
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  for (int i = 0; i < 10000; i++) {
+    ASSERT_FALSE(constNode["missing" + std::to_string(i)]);
+  }
+  for (int i = 0; i < 10000; i++) {
+    node["added" + std::to_string(i)] = i;
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  EXPECT_EQ(size + 10000, node.size());
+}
+
+TEST(NodeTest, SetTagFromTemporary) {
+  Node node;
+  node.SetTag(std::string("!") + "temporary");
+  node.SetTag(node.Tag());
+  EXPECT_EQ("!temporary", node.Tag());
+
+  Node other;
+  other.SetTag("!temporary");
+  EXPECT_EQ("!temporary", other.Tag());
+}
+
+TEST(NodeTest, InternedStringsAreShared) {
+  detail::memory memory;
+  const std::string& a = memory.intern(std::string("name"));
+  const std::string& b = memory.intern(StringRef("name", 4));
+  EXPECT_EQ(&a, &b);
+  EXPECT_EQ("name", a);
+  EXPECT_NE(&a, &memory.intern(std::string("type")));
+  EXPECT_EQ("", memory.intern(StringRef()));
+}
+
+// Every node pays for a node, a node_ref and a node_data (plus a control
+// block for each of the last two), so any growth here is multiplied by the
+// size of every document; collections only pay for their storage when they
+// need it.
+TEST(NodeTest, Footprint) {
+  const std::size_t perNode = sizeof(detail::node) + sizeof(detail::node_ref) +
+                              sizeof(detail::node_data);
+  RecordProperty("sizeof_node", static_cast<int>(sizeof(detail::node)));
+  RecordProperty("sizeof_node_ref", static_cast<int>(sizeof(detail::node_ref)));
+  RecordProperty("sizeof_node_data",
+                 static_cast<int>(sizeof(detail::node_data)));
+  RecordProperty("bytes_per_node", static_cast<int>(perNode));
+
+  EXPECT_LE(sizeof(detail::node_data),
+            sizeof(Mark) + 2 * sizeof(int) + 3 * sizeof(void*) +
+                sizeof(std::string) + sizeof(StringRef));
+  EXPECT_LE(sizeof(detail::node_ref), 2 * sizeof(void*));
+  EXPECT_LE(perNode, 22 * sizeof(void*));
+}
+
+TEST(NodeTest, ConstLookupPastEndAddsNothing) {
+  // a const lookup one past the end of a sequence used to append an entry,
+  // which then hid anything pushed after it
+  Node node;
+  node.push_back(1);
+  const Node& constNode = node;
+  EXPECT_FALSE(constNode[1]);
+  node.push_back(2);
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ(2, node[1].as<int>());
+}
+
+TEST(NodeTest, FrozenLookupsAddNothing) {
+  Node node;
+  node["key"] = "value";
+  node["seq"].push_back(1);
+  node.Freeze();
+  EXPECT_TRUE(node.IsFrozen());
+  EXPECT_TRUE(node["key"].IsFrozen());
+
+  // even through a non-const node
+  EXPECT_EQ("value", node["key"].as<std::string>());
+  EXPECT_FALSE(node["missing"]);
+  EXPECT_FALSE(node["seq"][1]);
+  EXPECT_EQ(1, node["seq"][0].as<int>());
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ(1, node["seq"].size());
+}
+
+TEST(NodeTest, FrozenNodeRejectsChanges) {
+  Node node;
+  node["key"] = "value";
+  node["seq"].push_back(1);
+  node.Freeze();
+
+  EXPECT_THROW_REPRESENTATION_EXCEPTION(node["key"] = "other",
+                                        ErrorMsg::FROZEN_NODE);
+  EXPECT_THROW(node["missing"] = 1, InvalidNode);
+  EXPECT_THROW(node["seq"].push_back(2), FrozenNode);
+  EXPECT_THROW(node["seq"] = Node(NodeType::Map), FrozenNode);
+  EXPECT_THROW(node.remove("key"), FrozenNode);
+  EXPECT_THROW(node.force_insert("key", "again"), FrozenNode);
+  EXPECT_THROW(node.SetTag("!tag"), FrozenNode);
+  EXPECT_THROW(node.SetStyle(EmitterStyle::Flow), FrozenNode);
+
+  Node value = node["key"];
+  EXPECT_THROW(value = "other", FrozenNode);
+  for (iterator it = node.begin(); it != node.end(); ++it) {
+    EXPECT_THROW(it->second = 0, FrozenNode);
+  }
+  EXPECT_EQ("value", node["key"].as<std::string>());
+  EXPECT_EQ(2, node.size());
+}
+
+TEST(NodeTest, FrozenNodeRejectsMerges) {
+  Node frozen;
+  frozen["key"] = "value";
+  frozen.Freeze();
+
+  Node other;
+  other["a"] = 1;
+  EXPECT_THROW(other["a"] = frozen, FrozenNode);
+  EXPECT_THROW(other.push_back(frozen), FrozenNode);
+  EXPECT_THROW(frozen["key"] = other, FrozenNode);
+  EXPECT_FALSE(other.IsFrozen());
+  EXPECT_EQ(1, other["a"].as<int>());
+
+  // a handle with no node of its own can still be pointed at it
+  Node handle;
+  handle = frozen;
+  EXPECT_TRUE(handle.IsFrozen());
+  handle.reset(other);
+  EXPECT_FALSE(handle.IsFrozen());
+}
+
+TEST(NodeTest, FrozenNodeCanBeCloned) {
+  Node node;
+  node["key"] = "value";
+  node.Freeze();
+
+  Node copy = Clone(node);
+  EXPECT_FALSE(copy.IsFrozen());
+  copy["other"] = "value";
+  EXPECT_EQ(2, copy.size());
+  EXPECT_EQ(1, node.size());
+}
+
+TEST(NodeTest, FrozenLargeMap) {
+  Node node;
+  for (int i = 0; i < 1000; i++) {
+    node["a rather long key, number " + std::to_string(i)] = i;
+  }
+  node.Freeze();
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(i, node["a rather long key, number " + std::to_string(i)]
+                     .as<int>());
+  }
+  EXPECT_FALSE(node["a rather long key, number 1000"]);
+}
+
+TEST(NodeTest, DeepEquals) {
+  const char* const input = "{a: [1, 2, {b: c}], d: !x e, f: ~}";
+  Node lhs = Load(input);
+  Node rhs = Load(input);
+  EXPECT_FALSE(lhs == rhs);
+  EXPECT_TRUE(DeepEquals(lhs, rhs));
+  EXPECT_EQ(DeepHash(lhs), DeepHash(rhs));
+
+  // maps are unordered, and marks and styles don't matter
+  Node reordered = Load("f: \nd: !x e\na:\n  - 1\n  - 2\n  - b: c\n");
+  EXPECT_TRUE(DeepEquals(lhs, reordered));
+  EXPECT_EQ(DeepHash(lhs), DeepHash(reordered));
+
+  const char* const different[] = {
+      "{a: [1, 2, {b: c}], d: e, f: ~}",  "{a: [2, 1, {b: c}], d: !x e, f: ~}",
+      "{a: [1, 2, {b: x}], d: !x e, f: ~}", "{a: [1, 2, {b: c}], d: !x e}",
+      "{a: [1, 2, {b: c}], d: !x e, g: ~}", "[a, [1, 2, {b: c}], d, e, f, ~]"};
+  for (const char* other : different) {
+    EXPECT_FALSE(DeepEquals(lhs, Load(other))) << other;
+    EXPECT_FALSE(DeepEquals(Load(other), lhs)) << other;
+  }
+}
+
+TEST(NodeTest, DeepEqualsDuplicateKeys) {
+  // each entry is matched once, so one side can't use an entry for two
+  const Node twice = Load("{a: 1, a: 1}");
+  const Node once = Load("{a: 1, b: 2}");
+  EXPECT_FALSE(DeepEquals(twice, once));
+  EXPECT_FALSE(DeepEquals(once, twice));
+  EXPECT_NE(DeepHash(twice), DeepHash(once));
+
+  const Node lhs = Load("{a: 1, a: 2}");
+  const Node rhs = Load("{a: 2, a: 1}");
+  EXPECT_TRUE(DeepEquals(lhs, rhs));
+  EXPECT_TRUE(DeepEquals(rhs, lhs));
+  EXPECT_EQ(DeepHash(lhs), DeepHash(rhs));
+  EXPECT_FALSE(DeepEquals(lhs, Load("{a: 2, a: 2}")));
+
+  // the same for a map that's big enough to be indexed
+  std::string text = "{a: 1, a: 1";
+  std::string other = "{a: 1, b: 2";
+  for (int i = 0; i < 40; i++) {
+    const std::string entry = ", k" + std::to_string(i) + ": v";
+    text += entry;
+    other += entry;
+  }
+  EXPECT_FALSE(DeepEquals(Load(text + "}"), Load(other + "}")));
+  EXPECT_FALSE(DeepEquals(Load(other + "}"), Load(text + "}")));
+  EXPECT_TRUE(DeepEquals(Load(text + "}"), Load(text + "}")));
+}
+
+TEST(NodeTest, DeepEqualsDeepDifference) {
+  // each level's values are compared once, however the keys are found
+  const int depth = 200;
+  std::string lhs, rhs;
+  for (int i = 0; i < depth; i++) {
+    lhs += "{a: ";
+    rhs += "{a: ";
+  }
+  lhs += "1" + std::string(depth, '}');
+  rhs += "2" + std::string(depth, '}');
+  const Node left = Load(lhs), right = Load(rhs);
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  EXPECT_FALSE(DeepEquals(left, right));
+  EXPECT_FALSE(DeepEquals(right, left));
+  EXPECT_TRUE(DeepEquals(left, Load(lhs)));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST(NodeTest, DeepEqualsTags) {
+  // a plain scalar's "?" tag is the same as none at all, but "!" isn't
+  EXPECT_TRUE(DeepEquals(Load("a"), Node("a")));
+  EXPECT_EQ(DeepHash(Load("a")), DeepHash(Node("a")));
+  EXPECT_FALSE(DeepEquals(Load("'a'"), Node("a")));
+  EXPECT_FALSE(DeepEquals(Load("1"), Load("!!int 1")));
+
+  EXPECT_TRUE(DeepEquals(Node(), Load("~")));
+  EXPECT_TRUE(DeepEquals(Node(), Node(NodeType::Null)));
+  EXPECT_FALSE(DeepEquals(Node(), Node("")));
+
+  const Node map = Load("{a: 1}");
+  EXPECT_THROW(DeepEquals(map["b"], Node()), InvalidNode);
+  EXPECT_THROW(DeepHash(map["b"]), InvalidNode);
+}
+
+TEST(NodeTest, DeepEqualsAliases) {
+  Node node = Load("{a: &x [1, 2], b: *x, c: [1, 2]}");
+  EXPECT_TRUE(node["a"].is(node["b"]));
+  EXPECT_TRUE(DeepEquals(node["a"], node["b"]));
+  EXPECT_TRUE(DeepEquals(node["a"], node["c"]));
+  EXPECT_EQ(DeepHash(node["b"]), DeepHash(node["c"]));
+
+  // a node that contains itself
+  Node cycle;
+  cycle["self"] = cycle;
+  cycle["value"] = 1;
+  Node other;
+  other["self"] = other;
+  other["value"] = 1;
+  EXPECT_TRUE(DeepEquals(cycle, other));
+  EXPECT_EQ(DeepHash(cycle), DeepHash(other));
+  other["value"] = 2;
+  EXPECT_FALSE(DeepEquals(cycle, other));
+}
+
+TEST(NodeTest, DeepEqualsSharedNodes) {
+  // each level is two aliases to the one before, so expanded, the last one
+  // would be 2^60 nodes; each shared one is only visited once
+  std::string laughs = "- &a0 [lol]\n";
+  for (int i = 1; i <= 60; i++) {
+    const std::string prev = "*a" + std::to_string(i - 1);
+    laughs += "- &a" + std::to_string(i) + " [" + prev + ", " + prev + "]\n";
+  }
+  const Node node = Load(laughs);
+  const Node same = Load(laughs);
+  EXPECT_TRUE(DeepEquals(node, same));
+  EXPECT_EQ(DeepHash(node), DeepHash(same));
+  const Node different = Load(laughs.replace(7, 3, "lul"));
+  EXPECT_FALSE(DeepEquals(node, different));
+  EXPECT_NE(DeepHash(node), DeepHash(different));
+
+  // and it hashes as it would expanded
+  EXPECT_EQ(DeepHash(Load("[[[lol], [lol]], [[lol], [lol]]]")),
+            DeepHash(node[2]));
+  EXPECT_TRUE(DeepEquals(Load("[[[lol], [lol]], [[lol], [lol]]]"), node[2]));
+
+  // including where a shared node is in a cycle
+  const std::string cycle = "&a [&b [*a, 1], *b, *b]";
+  EXPECT_TRUE(DeepEquals(Load(cycle), Load(cycle)));
+  EXPECT_EQ(DeepHash(Load(cycle)), DeepHash(Load(cycle)));
+  EXPECT_FALSE(DeepEquals(Load(cycle), Load("&a [&b [*a, 1], *b, [*a, 2]]")));
+}
+
+TEST(NodeTest, DeepEqualsSharedWithoutAliases) {
+  // the same 2^60 trees as above, built by assigning and pushing the same
+  // nodes into more than one place instead of through aliases
+  Node assigned, pushed;
+  assigned["a0"].push_back("lol");
+  pushed.push_back(Node(NodeType::Sequence));
+  pushed[0].push_back("lol");
+  for (int i = 1; i <= 60; i++) {
+    const std::string name = "a" + std::to_string(i);
+    const std::string prev = "a" + std::to_string(i - 1);
+    assigned[name]["l"] = assigned[prev];
+    assigned[name]["r"] = assigned[name]["l"];
+
+    Node level;
+    level.push_back(pushed[i - 1]);
+    level.push_back(pushed[i - 1]);
+    pushed.push_back(level);
+  }
+  const Node laughs = Load("[&a [lol], *a]");
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  EXPECT_TRUE(DeepEquals(assigned, assigned));
+  EXPECT_TRUE(DeepEquals(pushed, pushed));
+  EXPECT_EQ(DeepHash(pushed[1]), DeepHash(laughs));
+  EXPECT_NE(DeepHash(pushed), DeepHash(assigned));
+  pushed[0][0] = "lul";
+  EXPECT_FALSE(DeepEquals(pushed[60], Load(Dump(pushed[3]))));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST(NodeTest, DeepHashFollowsChanges) {
+  Node node = Load("{a: [1, 2]}");
+  const std::size_t before = DeepHash(node);
+  node["a"].push_back(3);
+  EXPECT_NE(before, DeepHash(node));
+  EXPECT_TRUE(DeepEquals(node, Load("{a: [1, 2, 3]}")));
+
+  node.Freeze();
+  Node copy = Clone(node);
+  copy.Freeze();
+  EXPECT_EQ(DeepHash(node), DeepHash(copy));
+  EXPECT_TRUE(DeepEquals(node, copy));
+  EXPECT_FALSE(DeepEquals(node, Load("{a: [1, 2, 4]}")));
+}
+
+TEST(NodeTest, NodesAsKeys) {
+  std::unordered_set<Node, NodeHash, NodeEqual> seen;
+  const char* const documents[] = {"{a: 1, b: 2}", "[1, 2]", "{b: 2, a: 1}",
+                                   "[2, 1]", "{a: 1, b: 2}", "x"};
+  for (const char* document : documents) {
+    seen.insert(Load(document));
+  }
+  EXPECT_EQ(4, seen.size());
+  EXPECT_EQ(1, seen.count(Load("{b: 2, a: 1}")));
+  EXPECT_EQ(0, seen.count(Load("{a: 1}")));
+}
+
 class NodeEmitterTest : public ::testing::Test {
  protected:
   void ExpectOutput(const std::string& output, const Node& node) {
@@ -0,0 +1,302 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+const char* const document =
+    "name: example\n"
+    "tags: !!set {a, b}\n"
+    "list: [1, 'two', \"three\", ~]\n"
+    "block:\n"
+    "  - literal: |\n"
+    "      some text\n"
+    "  - !local {x: 1}\n"
+    "? [complex, key]\n"
+    ": value\n"
+    "anchor: &a {shared: true}\n"
+    "alias: *a\n";
+
+std::shared_ptr<const std::string> Packed(const Node& node,
+                                          bool marks = false) {
+  return std::make_shared<const std::string>(Pack(node, marks));
+}
+
+TEST(PackTest, RoundTrip) {
+  const Node node = Load(document);
+  const PackedDocument packed(Packed(node));
+  const Node unpacked = packed.ToNode();
+  EXPECT_EQ(Dump(node), Dump(unpacked));
+  EXPECT_TRUE(DeepEquals(node, unpacked));
+  EXPECT_EQ("tag:yaml.org,2002:set", unpacked["tags"].Tag());
+  EXPECT_EQ("!", unpacked["list"][1].Tag());
+  EXPECT_EQ("!local", unpacked["block"][1].Tag());
+  EXPECT_EQ(EmitterStyle::Flow, unpacked["list"].Style());
+  EXPECT_EQ(EmitterStyle::Block, unpacked["block"].Style());
+  EXPECT_TRUE(unpacked["list"][3].IsNull());
+}
+
+TEST(PackTest, SharedNodes) {
+  const Node unpacked =
+      PackedDocument(Packed(Load(document))).ToNode();
+  EXPECT_TRUE(unpacked["anchor"].is(unpacked["alias"]));
+
+  // including a collection that contains itself
+  const Node cycle = PackedDocument(Packed(Load("&a [1, *a]"))).ToNode();
+  EXPECT_TRUE(cycle[1].is(cycle));
+  EXPECT_EQ(1, cycle[1][1][0].as<int>());
+}
+
+TEST(PackTest, Marks) {
+  const Node node = Load(document);
+  const Node unpacked = PackedDocument(Packed(node, true)).ToNode();
+  EXPECT_EQ(node["list"][2].Mark().pos, unpacked["list"][2].Mark().pos);
+  EXPECT_EQ(node["list"][2].Mark().line, unpacked["list"][2].Mark().line);
+  EXPECT_EQ(node["list"][2].Mark().column,
+            unpacked["list"][2].Mark().column);
+
+  const PackedDocument packed(Packed(node));
+  EXPECT_FALSE(packed.HasMarks());
+  EXPECT_EQ(-1, packed.Root()["list"].Mark().line);
+  EXPECT_LT(packed.size(), PackedDocument(Packed(node, true)).size());
+}
+
+TEST(PackTest, Navigate) {
+  const PackedDocument packed(Packed(Load(document)));
+  const PackedNode root = packed.Root();
+  ASSERT_TRUE(root.IsMap());
+  EXPECT_EQ(7, root.size());
+  EXPECT_EQ("example", root["name"].Scalar());
+  EXPECT_EQ("example", root["name"].as<std::string>());
+  EXPECT_EQ(4, root["list"].size());
+  EXPECT_EQ(1, root["list"][0].as<int>());
+  EXPECT_EQ("three", root["list"][2].ScalarRef().str());
+  EXPECT_TRUE(root["list"][3].IsNull());
+  EXPECT_EQ("some text\n", root["block"][0]["literal"].Scalar());
+  EXPECT_EQ("!local", root["block"][1].Tag());
+  EXPECT_EQ("name", root.Key(0).Scalar());
+  EXPECT_EQ("example", root.Value(0).Scalar());
+  EXPECT_TRUE(root.Key(4).IsSequence());
+  EXPECT_EQ("value", root.Value(4).Scalar());
+  EXPECT_TRUE(root["anchor"].is(root["alias"]));
+  EXPECT_FALSE(root["name"].is(root["list"]));
+  EXPECT_TRUE(root["alias"]["shared"].as<bool>());
+  EXPECT_EQ(1, root["block"][1].ToNode()["x"].as<int>());
+}
+
+TEST(PackTest, Missing) {
+  const PackedDocument packed(Packed(Load(document)));
+  const PackedNode root = packed.Root();
+  EXPECT_FALSE(root["missing"].IsDefined());
+  EXPECT_FALSE(root["list"][4].IsDefined());
+  EXPECT_FALSE(root["name"]["x"].IsDefined());
+  EXPECT_FALSE(root.Key(7).IsDefined());
+  EXPECT_FALSE(root["list"].Key(0).IsDefined());
+  EXPECT_THROW(root["missing"].Type(), InvalidNode);
+  EXPECT_THROW(root["missing"]["x"], InvalidNode);
+  EXPECT_THROW(PackedNode().ToNode(), InvalidNode);
+  EXPECT_THROW(root["list"].as<std::string>(), BadConversion);
+  EXPECT_THROW(root["missing"].as<int>(), InvalidNode);
+}
+
+TEST(PackTest, Convert) {
+  // numbers and bools are read from the packed text, and convert as a
+  // Node's would
+  const Node node =
+      Load("[0x1f, -2.5, x, Yes, off, 300, nope, [1, 2], {a: 1}]");
+  const PackedDocument packed(Packed(node, true));
+  const PackedNode root = packed.Root();
+  EXPECT_EQ(31, root[0].as<int>());
+  EXPECT_EQ(-2.5, root[1].as<double>());
+  EXPECT_EQ('x', root[2].as<char>());
+  EXPECT_TRUE(root[3].as<bool>());
+  EXPECT_FALSE(root[4].as<bool>());
+  EXPECT_EQ(300u, root[5].as<unsigned>());
+  EXPECT_EQ(std::vector<int>({1, 2}), root[7].as<std::vector<int>>());
+  EXPECT_EQ(1, (root[8].as<std::map<std::string, int>>()["a"]));
+
+  EXPECT_THROW(root[2].as<int>(), TypedBadConversion<int>);
+  EXPECT_THROW(root[5].as<unsigned char>(), TypedBadConversion<unsigned char>);
+  EXPECT_THROW(root[6].as<bool>(), TypedBadConversion<bool>);
+  EXPECT_THROW(root[7].as<int>(), TypedBadConversion<int>);
+  EXPECT_THROW(root[8].as<bool>(), TypedBadConversion<bool>);
+  try {
+    root[6].as<double>();
+    ADD_FAILURE() << "expected an exception";
+  } catch (const TypedBadConversion<double>& e) {
+    EXPECT_EQ(node[6].Mark().pos, e.mark.pos);
+  }
+}
+
+TEST(PackTest, LargeMap) {
+  // large enough to be indexed by key, with keys that aren't scalars and a
+  // key that appears twice
+  Node node;
+  for (int i = 0; i < 100; i++) {
+    node[std::to_string(i * 7 % 100)] = i;
+  }
+  node.force_insert("42", "again");
+  Node key;
+  key.push_back("k");
+  node[key] = "complex";
+  node[1000] = "number";
+
+  const PackedDocument packed(Packed(node));
+  const PackedNode root = packed.Root();
+  EXPECT_EQ(103, root.size());
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(i, root[std::to_string(i * 7 % 100)].as<int>());
+  }
+  EXPECT_EQ(6, root["42"].as<int>());
+  EXPECT_EQ("number", root[1000].Scalar());
+  EXPECT_FALSE(root["100"].IsDefined());
+  EXPECT_FALSE(root[""].IsDefined());
+  EXPECT_FALSE(root["zzz"].IsDefined());
+  EXPECT_EQ(Dump(node), Dump(packed.ToNode()));
+}
+
+TEST(PackTest, EmptyAndScalar) {
+  EXPECT_TRUE(PackedDocument(Packed(Node())).ToNode().IsNull());
+  EXPECT_TRUE(PackedDocument(Packed(Node())).Root().IsNull());
+  EXPECT_EQ("text", PackedDocument(Packed(Node("text"))).ToNode().Scalar());
+  EXPECT_EQ("", PackedDocument(Packed(Node(""))).Root().Scalar());
+  EXPECT_EQ(0, PackedDocument(Packed(Load("[]"))).Root().size());
+  EXPECT_EQ(0, PackedDocument(Packed(Load("{}"))).ToNode().size());
+
+  const Node node = Load("{}");
+  EXPECT_THROW(Pack(node["missing"]), InvalidNode);
+}
+
+TEST(PackTest, OutlivesDocument) {
+  Node unpacked;
+  {
+    const PackedDocument packed(Packed(Load(document)));
+    unpacked = packed.ToNode();
+  }
+  EXPECT_EQ("example", unpacked["name"].as<std::string>());
+}
+
+TEST(PackTest, MapFile) {
+  const Node node = Load(document);
+  const char* const filename = "pack_test.yamlpack";
+  {
+    std::ofstream out(filename, std::ios::binary);
+    out << Pack(node, true);
+  }
+
+  Node unpacked;
+  {
+    const PackedDocument packed = PackedDocument::MapFile(filename);
+    EXPECT_TRUE(packed.HasMarks());
+    EXPECT_EQ("three", packed.Root()["list"][2].Scalar());
+    unpacked = packed.ToNode();
+  }
+  std::remove(filename);
+  EXPECT_EQ(Dump(node), Dump(unpacked));
+  EXPECT_THROW(PackedDocument::MapFile("no such file.yamlpack"), BadFile);
+}
+
+TEST(PackTest, BadHeader) {
+  const std::string packed = Pack(Load(document));
+  EXPECT_THROW(PackedDocument(std::make_shared<const std::string>("")),
+               BadPackedData);
+  EXPECT_THROW(PackedDocument(std::make_shared<const std::string>(
+                   packed.substr(0, packed.size() - 1))),
+               BadPackedData);
+  std::string wrongMagic = packed;
+  wrongMagic[0] = 'X';
+  EXPECT_THROW(PackedDocument(std::make_shared<const std::string>(wrongMagic)),
+               BadPackedData);
+  std::string wrongVersion = packed;
+  wrongVersion[8] = 2;
+  EXPECT_THROW(
+      PackedDocument(std::make_shared<const std::string>(wrongVersion)),
+      BadPackedData);
+}
+
+TEST(PackTest, CorruptData) {
+  // whatever's damaged, reading it either works or throws BadPackedData
+  const std::string packed = Pack(Load(document), true);
+  std::mt19937 random(42);
+  for (int i = 0; i < 2000; i++) {
+    std::string corrupt = packed;
+    const std::size_t at = 24 + random() % (packed.size() - 24);
+    corrupt[at] = static_cast<char>(random());
+    try {
+      const PackedDocument doc(std::make_shared<const std::string>(corrupt));
+      Dump(doc.ToNode());
+      const PackedNode block = doc.Root()["block"];
+      if (block.IsDefined() && block[1].IsDefined())
+        block[1]["x"].IsDefined();
+    } catch (const BadPackedData&) {
+    } catch (const std::exception& e) {
+      ADD_FAILURE() << e.what();
+    }
+  }
+}
+
+void PutU32(std::string& out, std::uint32_t value) {
+  for (int i = 0; i < 4; i++)
+    out += static_cast<char>(value >> (8 * i));
+}
+
+// a chain of sequences without marks, each with {@code refs} entries that
+// are all the next one, down to a null
+std::shared_ptr<const std::string> Chain(std::uint32_t levels,
+                                         std::uint32_t refs) {
+  const std::uint32_t header = 24, record = 13 + 4 * refs;
+  std::string out("YAMLPACK", 8);
+  PutU32(out, 1);
+  PutU32(out, 0);
+  PutU32(out, header + levels * record + 5);
+  PutU32(out, header);
+  for (std::uint32_t i = 0; i < levels; i++) {
+    const std::uint32_t offset = header + i * record;
+    out += static_cast<char>(NodeType::Sequence);
+    PutU32(out, 0);
+    PutU32(out, refs);
+    PutU32(out, offset + 13);
+    for (std::uint32_t j = 0; j < refs; j++)
+      PutU32(out, offset + record);
+  }
+  out += static_cast<char>(NodeType::Null);
+  PutU32(out, 0);
+  return std::make_shared<const std::string>(out);
+}
+
+TEST(PackTest, NodeReachedTwice) {
+  // a node that isn't shared can't be in two places, which would otherwise
+  // make the work double at each level
+  EXPECT_NO_THROW(PackedDocument(Chain(3, 1)).ToNode());
+  EXPECT_THROW(PackedDocument(Chain(3, 2)).ToNode(), BadPackedData);
+  EXPECT_THROW(PackedDocument(Chain(64, 2)).ToNode(), BadPackedData);
+
+  // but one that's first written outside a node can be unpacked inside it
+  const PackedDocument packed(Packed(Load(document)));
+  EXPECT_TRUE(DeepEquals(Load("{shared: true}"),
+                         packed.Root()["alias"].ToNode()));
+}
+
+TEST(PackTest, DeepChain) {
+  const std::uint32_t levels = 100000;
+  const PackedDocument packed(Chain(levels, 1));
+  const Node root = packed.ToNode();
+  Node node = root;
+  for (std::uint32_t i = 0; i < levels; i++) {
+    ASSERT_TRUE(node.IsSequence());
+    ASSERT_EQ(1u, node.size());
+    node.reset(node[0]);
+  }
+  EXPECT_TRUE(node.IsNull());
+}
+}  // namespace
+}  // namespace YAML
@@ -0,0 +1,117 @@
+#include "yaml-cpp/node/path.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/parse.h"
+#include "yaml-cpp/node/view.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+const char* const services =
+    "services:\n"
+    "  - name: web\n"
+    "    endpoints: [{timeout: 1}, {timeout: 2}]\n"
+    "  - name: db\n"
+    "    endpoints: [{timeout: 3}]\n"
+    "  - name: cache\n"
+    "limits: {cpu: 2, memory: 512}\n";
+
+std::vector<std::string> Collect(const Path& path, const Node& node) {
+  std::vector<std::string> matches;
+  path.ForEach(node, [&](const NodeView& match) {
+    matches.push_back(match.Scalar());
+  });
+  return matches;
+}
+
+TEST(PathTest, KeysAndIndexes) {
+  Node node = Load(services);
+  EXPECT_EQ("db", Path("services[1].name").Find(node).Scalar());
+  EXPECT_EQ(2, Path("services[0].endpoints[1].timeout").Find(node).as<int>());
+  EXPECT_EQ(512, Path("limits.memory").Find(node).as<int>());
+  EXPECT_TRUE(Path("limits").Find(node).IsMap());
+  EXPECT_TRUE(Path("").Find(node).is(node));
+  EXPECT_EQ("services[1].name", Path("services[1].name").str());
+}
+
+TEST(PathTest, Misses) {
+  Node node = Load(services);
+  EXPECT_FALSE(Path("missing").Find(node));
+  EXPECT_FALSE(Path("services[3]").Find(node));
+  EXPECT_FALSE(Path("services.name").Find(node));
+  EXPECT_FALSE(Path("services[0].name.deeper").Find(node));
+  EXPECT_FALSE(Path("services[2].endpoints[0]").Find(node));
+  EXPECT_FALSE(Path("a").Find(NodeView()));
+  EXPECT_EQ(0, Path("limits.*.deeper").ForEach(node, [](const NodeView&) {}));
+
+  // and nothing was added
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ(3, node["services"].size());
+}
+
+TEST(PathTest, Wildcards) {
+  Node node = Load(services);
+  std::vector<std::string> names = Collect(Path("services[*].name"), node);
+  ASSERT_EQ(3, names.size());
+  EXPECT_EQ("web", names[0]);
+  EXPECT_EQ("cache", names[2]);
+
+  std::vector<std::string> timeouts =
+      Collect(Path("services.*.endpoints[*].timeout"), node);
+  ASSERT_EQ(3, timeouts.size());
+  EXPECT_EQ("1", timeouts[0]);
+  EXPECT_EQ("3", timeouts[2]);
+
+  std::vector<std::string> limits = Collect(Path("limits[*]"), node);
+  ASSERT_EQ(2, limits.size());
+  EXPECT_EQ("2", limits[0]);
+  EXPECT_EQ("512", limits[1]);
+
+  EXPECT_EQ("1", Path("services[*].endpoints[*].timeout").Find(node).Scalar());
+  EXPECT_EQ(0, Path("services[*].name[*]").ForEach(node, [](const NodeView&) {
+  }));
+}
+
+TEST(PathTest, QuotedKeys) {
+  Node node = Load("{'a.b': {\"x[*]\": 1}, \"it's\": 2, '3': 4, q\": 5}");
+  EXPECT_EQ(1, Path("[\"a.b\"][\"x[*]\"]").Find(node).as<int>());
+  EXPECT_EQ(1, Path("['a.b']['x[*]']").Find(node).as<int>());
+  EXPECT_EQ(2, Path("['it''s']").Find(node).as<int>());
+  EXPECT_EQ(5, Path("[\"q\\\"\"]").Find(node).as<int>());
+
+  // an index looks up its text in a map
+  EXPECT_EQ(4, Path("[3]").Find(node).as<int>());
+}
+
+TEST(PathTest, BadPaths) {
+  const char* const bad[] = {"a..b", ".a",     "a.",    "[",   "[x]",
+                             "[1",   "[\"a]",  "['a'",  "a]",  "a[*]b",
+                             "*a",   "a.[0]",  "[]",    "a[-1]"};
+  for (const char* expression : bad) {
+    EXPECT_THROW(Path path(expression), BadPath) << expression;
+  }
+  EXPECT_THROW(Path("[99999999999999999999999]"), BadPath);
+}
+
+TEST(PathTest, LargeMap) {
+  Node node;
+  for (int i = 0; i < 100; i++) {
+    node["key" + std::to_string(i)]["value"] = i;
+  }
+  node["undefined"];
+  EXPECT_EQ(42, Path("key42.value").Find(node).as<int>());
+  EXPECT_FALSE(Path("key100.value").Find(node));
+  EXPECT_FALSE(Path("undefined").Find(node));
+  EXPECT_EQ(100, Path("*.value").ForEach(node, [](const NodeView&) {}));
+
+  node.Freeze();
+  EXPECT_EQ(99, Path("key99.value").Find(node).as<int>());
+}
+}  // namespace
+}  // namespace YAML
@@ -0,0 +1,163 @@
+#include "yaml-cpp/node/view.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/parse.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+namespace YAML {
+namespace {
+TEST(NodeViewTest, ReadsLikeNode) {
+  Node node = Load("name: !tag value\nitems: [1, 2, 3]\nnested: {a: b}\n");
+  NodeView view = node;
+  ASSERT_TRUE(view.IsMap());
+  EXPECT_EQ(3, view.size());
+  EXPECT_TRUE(view["name"].IsScalar());
+  EXPECT_EQ("value", view["name"].Scalar());
+  EXPECT_EQ("value", view["name"].as<std::string>());
+  EXPECT_EQ("!tag", view["name"].Tag());
+  EXPECT_EQ(node["name"].Mark().line, view["name"].Mark().line);
+  EXPECT_TRUE(view["items"].IsSequence());
+  EXPECT_EQ(EmitterStyle::Flow, view["items"].Style());
+  EXPECT_EQ(2, view["items"][1].as<int>());
+  EXPECT_EQ("b", view["nested"]["a"].as<std::string>());
+  EXPECT_TRUE(view["nested"].is(node["nested"]));
+}
+
+TEST(NodeViewTest, MissingKeys) {
+  Node node = Load("a: 1\nseq: [x]\n");
+  NodeView view = node;
+  NodeView missing = view["missing"];
+  EXPECT_FALSE(missing.IsDefined());
+  EXPECT_FALSE(missing);
+  EXPECT_TRUE(!missing);
+  EXPECT_THROW(missing.Type(), InvalidNode);
+  EXPECT_THROW(missing.Scalar(), InvalidNode);
+  EXPECT_THROW(missing.as<int>(), InvalidNode);
+  EXPECT_THROW(missing["deeper"], InvalidNode);
+  EXPECT_EQ(5, missing.as<int>(5));
+  EXPECT_EQ(missing.end(), missing.begin());
+  EXPECT_FALSE(view["seq"][1]);
+  EXPECT_FALSE(NodeView());
+
+  // and nothing was added
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ(1, node["seq"].size());
+}
+
+TEST(NodeViewTest, NodeWithoutData) {
+  Node node;
+  NodeView view = node;
+  EXPECT_TRUE(view.IsNull());
+  EXPECT_EQ(0, view.size());
+}
+
+TEST(NodeViewTest, IterateSequence) {
+  Node node = Load("[a, b, c]");
+  std::vector<std::string> values;
+  NodeView view = node;
+  for (NodeView::const_iterator it = view.begin(); it != view.end(); ++it) {
+    values.push_back(it->Scalar());
+  }
+  ASSERT_EQ(3, values.size());
+  EXPECT_EQ("a", values[0]);
+  EXPECT_EQ("c", values[2]);
+}
+
+TEST(NodeViewTest, IterateMap) {
+  Node node = Load("{a: 1, b: 2, c: 3}");
+  int sum = 0;
+  std::string keys;
+  for (const auto& entry : NodeView(node)) {
+    keys += entry.first.Scalar();
+    sum += entry.second.as<int>();
+  }
+  EXPECT_EQ("abc", keys);
+  EXPECT_EQ(6, sum);
+}
+
+TEST(NodeViewTest, LookUpByValue) {
+  Node node;
+  node[1] = "one";
+  node[2] = "two";
+  node["0x10"] = "sixteen";
+  NodeView view = node;
+  EXPECT_EQ("two", view[2].as<std::string>());
+  EXPECT_EQ("sixteen", view[16].as<std::string>());
+  EXPECT_FALSE(view[3]);
+  EXPECT_EQ(3, node.size());
+}
+
+TEST(NodeViewTest, OutlivesTheNodeItCameFrom) {
+  Node node = Load("outer: {inner: 42}");
+  NodeView view = node["outer"];
+  EXPECT_EQ(42, view["inner"].as<int>());
+
+  Node copy = view["inner"].ToNode();
+  EXPECT_TRUE(copy.is(node["outer"]["inner"]));
+  copy = 43;
+  EXPECT_EQ(43, node["outer"]["inner"].as<int>());
+  EXPECT_FALSE(NodeView().ToNode().IsDefined());
+}
+
+TEST(NodeViewTest, Find) {
+  Node node = Load("a: {b: [x, y]}\nc: scalar\n");
+  NodeView view = node;
+  EXPECT_EQ("y", view.find("a").find("b").find(1).Scalar());
+  EXPECT_FALSE(view.find("missing"));
+  EXPECT_FALSE(view.find("missing").find("deeper").find(0));
+  EXPECT_FALSE(view.find("c").find("d"));
+  EXPECT_FALSE(view.find("a").find("b").find(2));
+  EXPECT_FALSE(NodeView().find("a"));
+
+  EXPECT_EQ("scalar", node.find("c").Scalar());
+  EXPECT_FALSE(node.find("missing"));
+  EXPECT_FALSE(node["c"].find("d"));
+  EXPECT_FALSE(Node().find("a"));
+  EXPECT_FALSE(node["missing"].find("a"));
+
+  // and nothing was added
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ(2, node["a"]["b"].size());
+}
+
+TEST(NodeViewTest, TryAs) {
+  Node node = Load("number: 42\nword: hello\nlist: [1, 2]\n");
+  NodeView view = node;
+
+  int number = 0;
+  EXPECT_TRUE(view.find("number").try_as(number));
+  EXPECT_EQ(42, number);
+
+  number = 7;
+  EXPECT_FALSE(view.find("word").try_as(number));
+  EXPECT_FALSE(view.find("missing").try_as(number));
+  EXPECT_FALSE(view.find("list").try_as(number));
+  EXPECT_EQ(7, number);
+
+  std::string word = "unchanged";
+  EXPECT_TRUE(view.find("word").try_as(word));
+  EXPECT_EQ("hello", word);
+  word = "unchanged";
+  EXPECT_FALSE(view.find("list").try_as(word));
+  EXPECT_FALSE(view.find("missing").try_as(word));
+  EXPECT_EQ("unchanged", word);
+
+  std::vector<int> list;
+  EXPECT_TRUE(view.find("list").try_as(list));
+  EXPECT_EQ(2, list.size());
+}
+
+TEST(NodeViewTest, FrozenDocument) {
+  Node node = Load("a: [1, 2]");
+  node.Freeze();
+  NodeView view = node;
+  EXPECT_EQ(2, view["a"][1].as<int>());
+  EXPECT_TRUE(view["a"].ToNode().IsFrozen());
+}
+}  // namespace
+}  // namespace YAML
@@ -1,5 +1,12 @@
 #include <stddef.h>
+#include <cstdio>
 #include <sstream>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#define fileno _fileno
+#endif
 
 #include "gtest/gtest.h"
 #include "yaml-cpp/ostream_wrapper.h"
@@ -63,4 +70,82 @@ TEST(OstreamWrapperTest, Comment) {
   wrapper.write("\n");
   EXPECT_FALSE(wrapper.comment());
 }
+
+TEST(OstreamWrapperTest, BufferGrows) {
+  YAML::ostream_wrapper wrapper;
+  std::string expected;
+  for (int i = 0; i < 10000; i++) {
+    const std::string line = std::to_string(i) + "\n";
+    wrapper.write(line);
+    expected += line;
+  }
+  EXPECT_EQ(expected, wrapper.str());
+  EXPECT_EQ(expected.size(), wrapper.pos());
+}
+
+TEST(OstreamWrapperTest, PositionAcrossWrites) {
+  YAML::ostream_wrapper wrapper;
+  wrapper.write("a\nbc\n\ndef");
+  EXPECT_EQ(3, wrapper.row());
+  EXPECT_EQ(3, wrapper.col());
+  wrapper.write("gh");
+  EXPECT_EQ(3, wrapper.row());
+  EXPECT_EQ(5, wrapper.col());
+  wrapper.write("\n");
+  EXPECT_EQ(4, wrapper.row());
+  EXPECT_EQ(0, wrapper.col());
+  wrapper.write("");
+  EXPECT_EQ(0, wrapper.col());
+  EXPECT_EQ(12, wrapper.pos());
+}
+
+std::string ReadBack(std::FILE* file) {
+  std::string contents;
+  std::rewind(file);
+  char buffer[256];
+  for (std::size_t n; (n = std::fread(buffer, 1, sizeof buffer, file)) > 0;)
+    contents.append(buffer, n);
+  return contents;
+}
+
+TEST(OstreamWrapperTest, FileDescriptor) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_TRUE(file != NULL);
+  std::string expected;
+  {
+    YAML::ostream_wrapper wrapper(fileno(file), 16);
+    const std::string large(40, 'x');
+    for (int i = 0; i < 100; i++) {
+      const std::string line = (i % 10 ? std::to_string(i) : large) + "\n";
+      wrapper.write(line);
+      expected += line;
+    }
+    EXPECT_STREQ(NULL, wrapper.str());
+    EXPECT_EQ(100, wrapper.row());
+    EXPECT_EQ(expected.size(), wrapper.pos());
+    wrapper.write("tail");
+    expected += "tail";
+    EXPECT_TRUE(wrapper.good());
+  }
+  EXPECT_EQ(expected, ReadBack(file));
+  std::fclose(file);
+}
+
+TEST(OstreamWrapperTest, FileDescriptorFlush) {
+  std::FILE* file = std::tmpfile();
+  ASSERT_TRUE(file != NULL);
+  YAML::ostream_wrapper wrapper(fileno(file));
+  wrapper.write("Hello, world");
+  EXPECT_EQ("", ReadBack(file));
+  wrapper.flush();
+  EXPECT_EQ("Hello, world", ReadBack(file));
+  std::fclose(file);
+}
+
+TEST(OstreamWrapperTest, BadFileDescriptor) {
+  YAML::ostream_wrapper wrapper(-1);
+  EXPECT_FALSE(wrapper.good());
+  wrapper.write("Hello, world\n");
+  EXPECT_EQ(1, wrapper.row());
+}
 }
@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include "tokenqueue.h"
+
+#include <vector>
+
+using YAML::Mark;
+using YAML::Token;
+using YAML::TokenQueue;
+
+namespace {
+Mark MarkAt(int pos) {
+  Mark mark;
+  mark.pos = pos;
+  return mark;
+}
+
+TEST(TokenQueueTest, Empty) {
+  TokenQueue queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(0u, queue.size());
+}
+
+TEST(TokenQueueTest, FirstInFirstOutAcrossBlocks) {
+  TokenQueue queue;
+  for (int i = 0; i < 1000; i++) {
+    queue.push(Token::PLAIN_SCALAR, MarkAt(i));
+  }
+  EXPECT_EQ(1000u, queue.size());
+  EXPECT_EQ(999, queue.back().mark.pos);
+
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_FALSE(queue.empty());
+    EXPECT_EQ(i, queue.front().mark.pos);
+    queue.pop();
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(TokenQueueTest, TokensDontMoveWhileQueued) {
+  TokenQueue queue;
+  Token* pFirst = &queue.push(Token::KEY, MarkAt(0));
+  std::vector<Token*> pushed;
+  for (int i = 1; i < 500; i++) {
+    pushed.push_back(&queue.push(Token::VALUE, MarkAt(i)));
+  }
+  EXPECT_EQ(pFirst, &queue.front());
+  EXPECT_EQ(Token::KEY, pFirst->type);
+
+  queue.pop();
+  for (std::size_t i = 0; i < pushed.size(); i++) {
+    EXPECT_EQ(pushed[i], &queue.front());
+    queue.pop();
+  }
+}
+
+TEST(TokenQueueTest, RecycledTokensAreReset) {
+  TokenQueue queue;
+  for (int i = 0; i < 300; i++) {
+    Token& token = queue.push(Token::TAG, MarkAt(i));
+    token.status = Token::UNVERIFIED;
+    token.value = "value";
+    token.params.push_back("param");
+    token.data = 3;
+    queue.pop();
+  }
+
+  Token& token = queue.push(Token::ANCHOR, MarkAt(7));
+  EXPECT_EQ(Token::VALID, token.status);
+  EXPECT_EQ(Token::ANCHOR, token.type);
+  EXPECT_EQ(7, token.mark.pos);
+  EXPECT_TRUE(token.value.empty());
+  EXPECT_FALSE(token.ref.valid());
+  EXPECT_TRUE(token.params.empty());
+  EXPECT_EQ(0, token.data);
+}
+
+TEST(TokenQueueTest, InterleavedPushAndPop) {
+  TokenQueue queue;
+  int pushed = 0, popped = 0;
+  for (int round = 0; round < 100; round++) {
+    for (int i = 0; i < 7; i++) {
+      queue.push(Token::BLOCK_ENTRY, MarkAt(pushed++));
+    }
+    for (int i = 0; i < 5; i++) {
+      EXPECT_EQ(popped++, queue.front().mark.pos);
+      queue.pop();
+    }
+  }
+  EXPECT_EQ(static_cast<std::size_t>(pushed - popped), queue.size());
+}
+}
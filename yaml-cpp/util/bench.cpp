@@ -0,0 +1,106 @@
+#include "bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+namespace {
+std::atomic<std::size_t> g_allocations(0);
+std::atomic<std::size_t> g_bytes(0);
+
+void* counted_alloc(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_bytes.fetch_add(size, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+}
+
+void* operator new(std::size_t size) {
+  if (void* p = counted_alloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  if (void* p = counted_alloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return counted_alloc(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+  std::free(p);
+}
+
+AllocationCount allocation_count() {
+  AllocationCount count = {g_allocations.load(std::memory_order_relaxed),
+                           g_bytes.load(std::memory_order_relaxed)};
+  return count;
+}
+
+std::string generate_document(std::size_t bytes) {
+  std::stringstream out;
+  for (std::size_t i = 0; static_cast<std::size_t>(out.tellp()) < bytes; i++) {
+    out << "- id: " << i << "\n";
+    out << "  name: record-" << i << "\n";
+    out << "  enabled: " << (i % 2 ? "true" : "false") << "\n";
+    out << "  ratio: " << (i % 97) * 0.125 << "\n";
+    out << "  note: 'quoted value " << i << "'\n";
+    out << "  tags: [alpha, beta, \"gamma\", " << i % 13 << "]\n";
+    out << "  owner:\n";
+    out << "    user: user" << i % 101 << "\n";
+    out << "    email: user" << i % 101 << "@example.com\n";
+  }
+  return out.str();
+}
+
+std::string generate_stream(std::size_t bytes) {
+  std::stringstream out;
+  for (std::size_t i = 0; static_cast<std::size_t>(out.tellp()) < bytes; i++) {
+    out << "---\n";
+    out << "time: 2018-06-01T12:" << (i / 60) % 60 << ":" << i % 60 << "Z\n";
+    out << "level: " << (i % 10 ? "info" : "warning") << "\n";
+    out << "source: {host: node" << i % 32 << ", pid: " << 1000 + i % 7
+        << "}\n";
+    out << "message: 'request " << i << " handled'\n";
+    out << "elapsed: " << (i % 89) * 0.25 << "\n";
+  }
+  return out.str();
+}
+
+double megabytes(std::size_t bytes) {
+  return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+bool parse_bench_args(int argc, char** argv, int& iterations,
+                      std::size_t& bytes) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc)
+      return false;
+    if (arg == "-n") {
+      iterations = std::atoi(argv[++i]);
+      if (iterations <= 0)
+        return false;
+    } else if (arg == "-s") {
+      int mb = std::atoi(argv[++i]);
+      if (mb <= 0)
+        return false;
+      bytes = static_cast<std::size_t>(mb) * 1024 * 1024;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
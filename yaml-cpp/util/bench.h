@@ -0,0 +1,68 @@
+#ifndef UTIL_BENCH_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define UTIL_BENCH_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// Shared helpers for the benchmark tools. Linking bench.cpp replaces the
+// global operator new/delete, so every allocation in the process is counted.
+
+struct AllocationCount {
+  std::size_t allocations;
+  std::size_t bytes;
+};
+
+AllocationCount allocation_count();
+
+// counts the allocations made between construction and stop()
+class AllocationMeter {
+ public:
+  AllocationMeter() : m_start(allocation_count()) {}
+
+  AllocationCount stop() const {
+    AllocationCount now = allocation_count();
+    AllocationCount delta = {now.allocations - m_start.allocations,
+                             now.bytes - m_start.bytes};
+    return delta;
+  }
+
+ private:
+  AllocationCount m_start;
+};
+
+class Timer {
+ public:
+  Timer() : m_start(std::chrono::steady_clock::now()) {}
+
+  double seconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         m_start)
+        .count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point m_start;
+};
+
+// A synthetic document of roughly 'bytes' bytes: a block sequence of records
+// mixing plain, quoted, and numeric scalars, plus nested block collections.
+std::string generate_document(std::size_t bytes);
+
+// A synthetic log-style stream of roughly 'bytes' bytes: many small
+// "---"-separated documents.
+std::string generate_stream(std::size_t bytes);
+
+double megabytes(std::size_t bytes);
+
+// parses "-n N" and "-s MB"-style arguments; returns false on bad usage
+bool parse_bench_args(int argc, char** argv, int& iterations,
+                      std::size_t& bytes);
+
+#endif  // UTIL_BENCH_H_62B23520_7C8E_11DE_8A39_0800200C9A66
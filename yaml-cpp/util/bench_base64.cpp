@@ -0,0 +1,82 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+
+// Encodes and decodes random payloads of several sizes, as base64, and then
+// the largest one as an emitted !!binary scalar, and read back as a Binary.
+
+namespace {
+template <typename F>
+void run(const char* name, std::size_t bytes, F f) {
+  // enough iterations to take a while, whatever the size
+  const std::size_t iterations = std::max<std::size_t>(
+      1, static_cast<std::size_t>(64) * 1024 * 1024 / std::max<std::size_t>(
+                                                          bytes, 1));
+  std::size_t total = 0;
+  Timer timer;
+  for (std::size_t i = 0; i < iterations; i++) {
+    total += f();
+  }
+  const double seconds = timer.seconds();
+  std::printf("  %-18s %8.1f MB/s\n", name,
+              megabytes(bytes) * iterations / seconds);
+  if (total == 0)
+    std::printf("(nothing)\n");
+}
+
+void usage() { std::cerr << "Usage: bench_base64 [-n N]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 1;
+  std::size_t bytes = 0;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::mt19937 random(42);
+  std::vector<unsigned char> data(16 * 1024 * 1024);
+  for (unsigned char& byte : data)
+    byte = static_cast<unsigned char>(random());
+
+  const std::size_t sizes[] = {64, 1024, 64 * 1024, 1024 * 1024,
+                               16 * 1024 * 1024};
+  for (std::size_t size : sizes) {
+    const std::string encoded = YAML::EncodeBase64(data.data(), size);
+    std::string wrapped;
+    for (std::size_t i = 0; i < encoded.size(); i += 76)
+      wrapped += encoded.substr(i, 76) + "\n";
+
+    std::printf("%zu bytes (MB/s of binary data)\n", size);
+    for (int n = 0; n < N; n++) {
+      run("encode", size, [&]() {
+        return YAML::EncodeBase64(data.data(), size).size();
+      });
+      run("decode", size,
+          [&]() { return YAML::DecodeBase64(encoded).size(); });
+      run("decode, wrapped", size,
+          [&]() { return YAML::DecodeBase64(wrapped).size(); });
+    }
+  }
+
+  const YAML::Binary binary(data.data(), data.size());
+  std::printf("!!binary, %zu bytes\n", data.size());
+  run("emit", data.size(), [&]() {
+    YAML::Emitter out;
+    out << binary;
+    return out.size();
+  });
+  YAML::Emitter out;
+  out << binary;
+  const YAML::Node node = YAML::Load(out.c_str());
+  run("as<Binary>", data.size(),
+      [&]() { return node.as<YAML::Binary>().size(); });
+  return 0;
+}
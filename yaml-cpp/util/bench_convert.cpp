@@ -0,0 +1,109 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+
+// Decodes and encodes a million numbers of each type, with convert<T> and
+// with the stringstream code that it replaced.
+
+namespace {
+template <typename T>
+bool stream_decode(const std::string& input, T& rhs) {
+  std::stringstream stream(input);
+  stream.unsetf(std::ios::dec);
+  return (stream >> std::noskipws >> rhs) && (stream >> std::ws).eof();
+}
+
+template <typename T>
+std::string stream_encode(const T& rhs) {
+  std::stringstream stream;
+  stream.precision(std::numeric_limits<T>::digits10 + 1);
+  stream << rhs;
+  return stream.str();
+}
+
+template <typename F>
+double time(F f) {
+  Timer timer;
+  f();
+  return timer.seconds();
+}
+
+template <typename T>
+void run(const char* name, int count, std::mt19937_64& random) {
+  std::vector<T> values;
+  std::vector<YAML::Node> nodes;
+  for (int i = 0; i < count; i++) {
+    const T value = static_cast<T>(
+        std::numeric_limits<T>::is_integer
+            ? static_cast<T>(random())
+            : static_cast<T>(static_cast<double>(random() % 2000000) / 64));
+    values.push_back(value);
+    nodes.push_back(YAML::Node(stream_encode(value)));
+  }
+
+  T sum = 0;
+  const double streamDecode = time([&]() {
+    for (const YAML::Node& node : nodes) {
+      T value;
+      if (stream_decode(node.Scalar(), value))
+        sum += value;
+    }
+  });
+  const double convertDecode = time([&]() {
+    for (const YAML::Node& node : nodes)
+      sum += node.as<T>();
+  });
+
+  std::size_t length = 0;
+  const double streamEncode = time([&]() {
+    for (const T& value : values)
+      length += YAML::Node(stream_encode(value)).Scalar().size();
+  });
+  const double convertEncode = time([&]() {
+    for (const T& value : values)
+      length += YAML::convert<T>::encode(value).Scalar().size();
+  });
+
+  std::printf("%-20s decode %6.1f -> %5.1f ns (%5.2fx)  "
+              "encode %6.1f -> %5.1f ns (%5.2fx)\n",
+              name, streamDecode * 1e9 / count, convertDecode * 1e9 / count,
+              streamDecode / convertDecode, streamEncode * 1e9 / count,
+              convertEncode * 1e9 / count, streamEncode / convertEncode);
+  if (length == 0 && sum == 0)
+    std::printf("(nothing)\n");
+}
+
+void usage() { std::cerr << "Usage: bench_convert [-n N]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 1000000;
+  std::size_t bytes = 0;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::printf("%d values of each type (stream -> convert)\n", N);
+  std::mt19937_64 random(42);
+  run<short>("short", N, random);
+  run<unsigned short>("unsigned short", N, random);
+  run<int>("int", N, random);
+  run<unsigned>("unsigned", N, random);
+  run<long>("long", N, random);
+  run<unsigned long>("unsigned long", N, random);
+  run<long long>("long long", N, random);
+  run<unsigned long long>("unsigned long long", N, random);
+  run<float>("float", N, random);
+  run<double>("double", N, random);
+  run<long double>("long double", N, random);
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "bench.h"
+
+// Emits a large document with Dump, and then with DumpParallel on one to
+// eight threads; and the same document, nested under a key, which is where
+// DumpParallel has to look for something to split.
+
+namespace {
+template <typename F>
+double run(const char* name, int iterations, double baseline,
+           std::size_t bytes, F f) {
+  std::size_t total = 0;
+  Timer timer;
+  for (int i = 0; i < iterations; i++) {
+    total += f().size();
+  }
+  double seconds = timer.seconds();
+  std::printf("%-16s %9.1f ms  %7.1f MB/s  %6.2fx\n", name,
+              seconds * 1000.0 / iterations,
+              megabytes(bytes) * iterations / seconds,
+              baseline > 0 ? baseline / seconds : 1.0);
+  if (total == 0)
+    std::printf("(nothing)\n");
+  return seconds;
+}
+
+void compare(const YAML::Node& node, int iterations) {
+  const std::string expected = YAML::Dump(node);
+  const std::size_t bytes = expected.size();
+  double baseline = run("Dump", iterations, 0.0, bytes,
+                        [&]() { return YAML::Dump(node); });
+  for (unsigned threads = 1; threads <= 8; threads *= 2) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "DumpParallel, %u", threads);
+    run(name, iterations, baseline, bytes,
+        [&]() { return YAML::DumpParallel(node, threads); });
+  }
+  if (YAML::DumpParallel(node, 4) != expected)
+    std::printf("DumpParallel differs from Dump!\n");
+}
+
+void usage() { std::cerr << "Usage: bench_dump [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 3;
+  std::size_t bytes = 16 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  YAML::Node document = YAML::Load(generate_document(bytes));
+  std::printf("%zu records x %d\n", document.size(), N);
+
+  std::printf("\nat the root\n");
+  compare(document, N);
+
+  YAML::Node nested;
+  nested["name"] = "records";
+  nested["records"] = document;
+  std::printf("\nunder a key\n");
+  compare(nested, N);
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "bench.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Writes the pieces of a large document (short tokens, indentation and
+// newlines) straight to an ostream_wrapper's buffer; emits a map of short
+// strings, most of them plain and some of them quoted; emits flow sequences of
+// integers and of doubles (at the default precision, and at 6 digits); then
+// emits the document
+// into the emitter's own buffer, to a std::ofstream, and to a file
+// descriptor (through the emitter's block buffer), with the files going to
+// the null device.
+
+namespace {
+#ifdef _WIN32
+const char* const nullDevice = "NUL";
+#else
+const char* const nullDevice = "/dev/null";
+#endif
+
+template <typename F>
+double run(const char* name, int iterations, std::size_t bytes, F f) {
+  std::size_t total = 0;
+  AllocationMeter meter;
+  Timer timer;
+  for (int i = 0; i < iterations; i++) {
+    total += f();
+  }
+  double seconds = timer.seconds();
+  AllocationCount count = meter.stop();
+  std::printf("%-12s %9.1f ms  %7.1f MB/s  %9zu allocs  (%.1f MB)\n", name,
+              seconds * 1000.0 / iterations,
+              megabytes(bytes) * iterations / seconds,
+              count.allocations / iterations,
+              megabytes(total / iterations));
+  return seconds;
+}
+
+void usage() { std::cerr << "Usage: bench_emit [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 3;
+  std::size_t bytes = 32 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_document(bytes));
+  const YAML::Node document = YAML::Load(input);
+  bytes = YAML::Dump(document).size();
+  std::printf("%.1f MB emitted x %d\n", megabytes(bytes), N);
+
+  const std::string pieces[] = {"- ", "name", ": ", "record", "\n", "    ",
+                                "\"quoted value\"", "12345", "\n", "  "};
+  run("wrapper", N, bytes, [&]() -> std::size_t {
+    YAML::ostream_wrapper out;
+    for (std::size_t i = 0; out.pos() < bytes; i++)
+      out.write(pieces[i % 10]);
+    return out.pos() + out.row() + out.col();
+  });
+
+  const std::string words[] = {"id",   "name",  "a value", "x: y",  "42",
+                               "- no", "#hash", "caf\xC3\xA9", "null", "ok"};
+  run("strings", N, bytes, [&]() -> std::size_t {
+    YAML::Emitter out;
+    out << YAML::BeginMap;
+    for (std::size_t i = 0; out.size() < bytes; i++)
+      out << YAML::Key << words[i % 10] << YAML::Value << words[i % 7];
+    out << YAML::EndMap;
+    return out.size();
+  });
+
+  run("integers", N, bytes, [&]() -> std::size_t {
+    YAML::Emitter out;
+    out << YAML::Flow << YAML::BeginSeq;
+    for (long long i = 0; out.size() < bytes; i++)
+      out << i * 7919 - 5000000;
+    out << YAML::EndSeq;
+    return out.size();
+  });
+  run("doubles", N, bytes, [&]() -> std::size_t {
+    YAML::Emitter out;
+    out << YAML::Flow << YAML::BeginSeq;
+    for (int i = 0; out.size() < bytes; i++)
+      out << (i % 1000) * 0.125 - 60.0 + i / 3.0;
+    out << YAML::EndSeq;
+    return out.size();
+  });
+  run("doubles, 6", N, bytes, [&]() -> std::size_t {
+    YAML::Emitter out;
+    out.SetDoublePrecision(6);
+    out << YAML::Flow << YAML::BeginSeq;
+    for (int i = 0; out.size() < bytes; i++)
+      out << (i % 1000) * 0.125 - 60.0 + i / 3.0;
+    out << YAML::EndSeq;
+    return out.size();
+  });
+
+  run("buffer", N, bytes, [&]() -> std::size_t {
+    YAML::Emitter out;
+    out << document;
+    return out.size();
+  });
+  run("ofstream", N, bytes, [&]() -> std::size_t {
+    std::ofstream file(nullDevice, std::ios::binary);
+    YAML::Emitter out(file);
+    out << document;
+    return out.size();
+  });
+  run("fd", N, bytes, [&]() -> std::size_t {
+#ifdef _WIN32
+    const int fd = ::_open(nullDevice, _O_WRONLY | _O_BINARY);
+#else
+    const int fd = ::open(nullDevice, O_WRONLY);
+#endif
+    std::size_t size = 0;
+    {
+      YAML::Emitter out(fd);
+      out << document;
+      out.Flush();
+      size = out.size();
+    }
+#ifdef _WIN32
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+    return size;
+  });
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+
+// Reads one loaded document from several threads at once: "locked" takes a
+// mutex around each record's lookups (which is what reading a shared document
+// used to need, since reads can write), and "frozen" freezes a copy of it
+// first and reads it with no locking at all.
+
+namespace {
+// looks up a few fields of each of 'count' records, starting at 'first'
+std::size_t read_records(const YAML::Node& document, std::size_t first,
+                         std::size_t count, std::mutex* pLock) {
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    std::unique_lock<std::mutex> lock;
+    if (pLock)
+      lock = std::unique_lock<std::mutex>(*pLock);
+
+    const YAML::Node record = document[(first + i) % document.size()];
+    total += record["name"].Scalar().size();
+    total += record["owner"]["email"].Scalar().size();
+    total += record["tags"][2].Scalar().size();
+    total += record["missing"] ? 1 : 0;
+  }
+  return total;
+}
+
+void run(const char* name, const YAML::Node& document, unsigned threads,
+         std::size_t records, std::mutex* pLock) {
+  std::vector<std::size_t> totals(threads);
+  AllocationMeter meter;
+  Timer timer;
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      totals[t] = read_records(document, t * records, records, pLock);
+    });
+  }
+  for (unsigned t = 0; t < threads; t++)
+    workers[t].join();
+  double seconds = timer.seconds();
+  AllocationCount count = meter.stop();
+
+  double lookups = 7.0 * records * threads;
+  std::printf("%-8s %3u threads  %8.1f ms  %8.2f M lookups/s  %6.2f allocs"
+              "/lookup\n",
+              name, threads, seconds * 1000.0, lookups / seconds / 1e6,
+              static_cast<double>(count.allocations) / lookups);
+}
+
+void usage() { std::cerr << "Usage: bench_frozen [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 200000;
+  std::size_t bytes = 4 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_document(bytes));
+  YAML::Node document = YAML::Load(input);
+  YAML::Node frozen = YAML::Load(input);
+  frozen.Freeze();
+  std::printf("%.1f MB (%zu records), %d records per thread\n",
+              megabytes(input->size()), document.size(), N);
+
+  unsigned cores = std::thread::hardware_concurrency();
+  std::vector<unsigned> counts = {1, 2, 4, 8};
+  if (cores > 8) {
+    counts.push_back(cores);
+  }
+
+  std::mutex lock;
+  std::size_t records = static_cast<std::size_t>(N);
+  for (unsigned threads : counts) {
+    run("locked", document, threads, records, &lock);
+    run("frozen", frozen, threads, records, nullptr);
+  }
+  return 0;
+}
@@ -0,0 +1,96 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "bench.h"
+
+// Compares two copies of a large document, by emitting both and comparing
+// the text, and with DeepEquals; then compares frozen copies that have been
+// hashed (and differ only at the very end). Then finds the distinct records
+// of the document, by their emitted text, and as Nodes in an unordered_set.
+
+namespace {
+void report(const char* name, double seconds, const AllocationCount& count,
+            int iterations, double baseline) {
+  std::printf("%-16s %9.3f ms  %9zu allocs  %8.2fx\n",
+              name, seconds * 1000.0 / iterations,
+              count.allocations / iterations,
+              baseline > 0 ? baseline / seconds : 1.0);
+}
+
+template <typename F>
+double run(const char* name, int iterations, double baseline, F f) {
+  std::size_t result = 0;
+  AllocationMeter meter;
+  Timer timer;
+  for (int i = 0; i < iterations; i++) {
+    result += f();
+  }
+  double seconds = timer.seconds();
+  AllocationCount count = meter.stop();
+  report(name, seconds, count, iterations, baseline);
+  if (result == static_cast<std::size_t>(-1))
+    std::printf("(%zu)\n", result);
+  return seconds;
+}
+
+void usage() { std::cerr << "Usage: bench_hash [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 5;
+  std::size_t bytes = 4 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_document(bytes));
+  YAML::Node lhs = YAML::Load(input);
+  YAML::Node rhs = YAML::Load(input);
+  YAML::Node last = YAML::Load(input);
+  last[last.size() - 1]["owner"]["user"] = "someone else";
+  std::printf("%.1f MB (%zu records) x %d\n", megabytes(input->size()),
+              lhs.size(), N);
+
+  std::printf("\nequal documents\n");
+  double baseline = run("Dump == Dump", N, 0.0, [&]() -> std::size_t {
+    return YAML::Dump(lhs) == YAML::Dump(rhs);
+  });
+  run("DeepEquals", N, baseline,
+      [&]() -> std::size_t { return YAML::DeepEquals(lhs, rhs); });
+
+  std::printf("\ndiffering at the end\n");
+  baseline = run("Dump == Dump", N, 0.0, [&]() -> std::size_t {
+    return YAML::Dump(lhs) == YAML::Dump(last);
+  });
+  run("DeepEquals", N, baseline,
+      [&]() -> std::size_t { return YAML::DeepEquals(lhs, last); });
+  lhs.Freeze();
+  last.Freeze();
+  run("first DeepHash", 1, 0.0, [&]() -> std::size_t {
+    return YAML::DeepHash(lhs) + YAML::DeepHash(last);
+  });
+  run("frozen, hashed", N, baseline,
+      [&]() -> std::size_t { return YAML::DeepEquals(lhs, last); });
+
+  std::printf("\ndistinct records\n");
+  baseline = run("Dump, set", N, 0.0, [&]() -> std::size_t {
+    std::unordered_set<std::string> records;
+    for (YAML::const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+      records.insert(YAML::Dump(*it));
+    return records.size();
+  });
+  run("NodeHash, set", N, baseline, [&]() -> std::size_t {
+    std::unordered_set<YAML::Node, YAML::NodeHash, YAML::NodeEqual> records;
+    for (YAML::const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+      records.insert(*it);
+    return records.size();
+  });
+  return 0;
+}
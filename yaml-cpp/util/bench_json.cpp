@@ -0,0 +1,78 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "bench.h"
+
+// Loads the same JSON document (an array of records, as an API might return
+// them) with the YAML parser, with the JSON one, and through Load with
+// detection on; and then, for comparison, a YAML document of the same size.
+
+namespace {
+std::string generate_json(std::size_t bytes) {
+  std::stringstream out;
+  out << "[\n";
+  for (int i = 0; static_cast<std::size_t>(out.tellp()) < bytes; i++) {
+    out << (i ? ",\n" : "") << "  {\"id\": " << i << ", \"name\": \"item "
+        << i << "\", \"price\": " << (i % 1000) * 0.25 << ", \"active\": "
+        << (i % 3 ? "true" : "false") << ", \"parent\": "
+        << (i % 5 ? std::to_string(i / 5) : "null")
+        << ", \"tags\": [\"red\", \"large\", \"tag " << i % 17 << "\"]"
+        << ", \"owner\": {\"user\": \"user" << i % 101
+        << "\", \"note\": \"line\\none \\\"quoted\\\" \\u00e9\"}}";
+  }
+  out << "\n]\n";
+  return out.str();
+}
+
+template <typename F>
+double run(const char* name, int iterations, double baseline, F f) {
+  std::size_t total = 0;
+  AllocationMeter meter;
+  Timer timer;
+  for (int i = 0; i < iterations; i++) {
+    total += f().size();
+  }
+  double seconds = timer.seconds();
+  AllocationCount count = meter.stop();
+  std::printf("%-16s %8.1f ms  %9zu allocs  %7.1f MB  %6.2fx  (%zu nodes)\n",
+              name, seconds * 1000.0 / iterations,
+              count.allocations / iterations,
+              megabytes(count.bytes / iterations),
+              baseline > 0 ? baseline / seconds : 1.0, total / iterations);
+  return seconds;
+}
+
+void usage() { std::cerr << "Usage: bench_json [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 5;
+  std::size_t bytes = 16 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> json =
+      std::make_shared<const std::string>(generate_json(bytes));
+  std::printf("%.1f MB of JSON x %d\n", megabytes(json->size()), N);
+
+  double baseline =
+      run("Load", N, 0.0, [&]() { return YAML::Load(json); });
+  run("LoadJson", N, baseline, [&]() { return YAML::LoadJson(json); });
+  run("Load, detected", N, baseline,
+      [&]() { return YAML::Load(json, true); });
+
+  std::shared_ptr<const std::string> yaml =
+      std::make_shared<const std::string>(generate_document(bytes));
+  std::printf("\n%.1f MB of YAML x %d\n", megabytes(yaml->size()), N);
+  baseline = run("Load", N, 0.0, [&]() { return YAML::Load(yaml); });
+  run("Load, detected", N, baseline,
+      [&]() { return YAML::Load(yaml, true); });
+  return 0;
+}
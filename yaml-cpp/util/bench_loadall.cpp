@@ -0,0 +1,66 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+
+// Compares LoadAll against LoadAllParallel on a log-style stream of many
+// small documents, for a few thread counts.
+
+namespace {
+void report(const char* name, unsigned threads, double seconds, double mb,
+            double baseline) {
+  std::printf("%-10s %3u threads  %8.1f ms  %8.1f MB/s  %5.2fx\n", name,
+              threads, seconds * 1000.0, mb / seconds, baseline / seconds);
+}
+
+void usage() { std::cerr << "Usage: bench_loadall [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 3;
+  std::size_t bytes = 16 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_stream(bytes));
+  double mb = megabytes(input->size()) * N;
+  std::size_t docs = YAML::LoadAll(input).size();
+  std::printf("%.1f MB (%zu documents) x %d\n", megabytes(input->size()), docs,
+              N);
+
+  double baseline;
+  {
+    Timer timer;
+    for (int i = 0; i < N; i++) {
+      YAML::LoadAll(input);
+    }
+    baseline = timer.seconds();
+    report("LoadAll", 1, baseline, mb, baseline);
+  }
+
+  unsigned cores = std::thread::hardware_concurrency();
+  std::vector<unsigned> counts = {1, 2, 4, 8};
+  if (cores > 8) {
+    counts.push_back(cores);
+  }
+  for (unsigned threads : counts) {
+    Timer timer;
+    for (int i = 0; i < N; i++) {
+      if (YAML::LoadAllParallel(input, threads).size() != docs) {
+        std::cerr << "document count mismatch\n";
+        return 1;
+      }
+    }
+    report("parallel", threads, timer.seconds(), mb, baseline);
+  }
+  return 0;
+}
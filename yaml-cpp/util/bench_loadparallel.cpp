@@ -0,0 +1,66 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+
+// Compares Load against LoadParallel on a single document whose root is a
+// long block sequence, for a few thread counts.
+
+namespace {
+void report(const char* name, unsigned threads, double seconds, double mb,
+            double baseline) {
+  std::printf("%-12s %3u threads  %8.1f ms  %8.1f MB/s  %5.2fx\n", name,
+              threads, seconds * 1000.0, mb / seconds, baseline / seconds);
+}
+
+void usage() { std::cerr << "Usage: bench_loadparallel [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 3;
+  std::size_t bytes = 16 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_document(bytes));
+  double mb = megabytes(input->size()) * N;
+  std::size_t entries = YAML::Load(input).size();
+  std::printf("%.1f MB (%zu entries) x %d\n", megabytes(input->size()),
+              entries, N);
+
+  double baseline;
+  {
+    Timer timer;
+    for (int i = 0; i < N; i++) {
+      YAML::Load(input);
+    }
+    baseline = timer.seconds();
+    report("Load", 1, baseline, mb, baseline);
+  }
+
+  unsigned cores = std::thread::hardware_concurrency();
+  std::vector<unsigned> counts = {1, 2, 4, 8};
+  if (cores > 8) {
+    counts.push_back(cores);
+  }
+  for (unsigned threads : counts) {
+    Timer timer;
+    for (int i = 0; i < N; i++) {
+      if (YAML::LoadParallel(input, threads).size() != entries) {
+        std::cerr << "entry count mismatch\n";
+        return 1;
+      }
+    }
+    report("LoadParallel", threads, timer.seconds(), mb, baseline);
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "bench.h"
+
+// Loads a document whose scalars can't refer to the input (they're long, and
+// have escapes), both from a stream and from memory-resident input. Each such
+// scalar is built once by the scanner; "scalar bytes" is how much of that
+// there is per load, which is what handing the scanner's copy over to the
+// node (rather than copying it) saves.
+
+namespace {
+std::string generate_escaped(std::size_t bytes) {
+  std::stringstream out;
+  for (std::size_t i = 0; static_cast<std::size_t>(out.tellp()) < bytes; i++) {
+    out << "- id: " << i << "\n";
+    out << "  text: \"";
+    for (std::size_t j = 0; j < 4 + i % 8; j++)
+      out << "line " << j << " of record " << i << "\\tends here\\n";
+    out << "\"\n";
+  }
+  return out.str();
+}
+
+std::size_t scalar_bytes(const YAML::Node& document) {
+  std::size_t total = 0;
+  for (YAML::const_iterator it = document.begin(); it != document.end(); ++it)
+    total += (*it)["text"].Scalar().size();
+  return total;
+}
+
+void report(const char* name, double seconds, const AllocationCount& count,
+            double mb, int iterations) {
+  std::printf("%-8s %8.1f ms  %8.0f allocs/MB  %8.0f KB/MB\n", name,
+              seconds * 1000.0 / iterations, count.allocations / mb,
+              count.bytes / 1024.0 / mb);
+}
+
+void usage() { std::cerr << "Usage: bench_moves [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 5;
+  std::size_t bytes = 8 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_escaped(bytes));
+  double mb = megabytes(input->size()) * N;
+  std::printf("%.1f MB x %d, %.1f MB of scalar bytes per load\n",
+              megabytes(input->size()), N,
+              megabytes(scalar_bytes(YAML::Load(input))));
+
+  {
+    AllocationMeter meter;
+    Timer timer;
+    for (int i = 0; i < N; i++) {
+      std::stringstream stream(*input);
+      YAML::Node doc = YAML::Load(stream);
+    }
+    report("stream", timer.seconds(), meter.stop(), mb, N);
+  }
+
+  {
+    AllocationMeter meter;
+    Timer timer;
+    for (int i = 0; i < N; i++) {
+      YAML::Node doc = YAML::Load(input);
+    }
+    report("memory", timer.seconds(), meter.stop(), mb, N);
+  }
+  return 0;
+}
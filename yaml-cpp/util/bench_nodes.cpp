@@ -0,0 +1,81 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "bench.h"
+
+// Times loading a large document into nodes (from memory-resident input, and
+// from a stream), and then destroying it, and counts what loading allocates.
+
+namespace {
+std::size_t count_nodes(const YAML::Node& node) {
+  std::size_t count = 1;
+  if (node.IsSequence()) {
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it)
+      count += count_nodes(*it);
+  } else if (node.IsMap()) {
+    for (YAML::const_iterator it = node.begin(); it != node.end(); ++it)
+      count += count_nodes(it->first) + count_nodes(it->second);
+  }
+  return count;
+}
+
+YAML::Node load(const std::shared_ptr<const std::string>& input,
+                bool retained) {
+  if (retained)
+    return YAML::Load(input);
+  return YAML::Load(*input);
+}
+
+void run(const char* name, const std::shared_ptr<const std::string>& input,
+         std::size_t nodes, int N, bool retained) {
+  double loadTime = 0.0, destroyTime = 0.0;
+  AllocationCount count = {0, 0};
+  for (int i = 0; i < N; i++) {
+    std::unique_ptr<YAML::Node> pNode;
+    {
+      AllocationMeter meter;
+      Timer timer;
+      pNode.reset(new YAML::Node(load(input, retained)));
+      loadTime += timer.seconds();
+      count = meter.stop();
+    }
+    {
+      Timer timer;
+      pNode.reset();
+      destroyTime += timer.seconds();
+    }
+  }
+
+  std::printf("%-9s load %8.1f ms  %6.2f allocs/node  %7.1f bytes/node  "
+              "destroy %7.1f ms\n",
+              name, loadTime * 1000.0 / N,
+              static_cast<double>(count.allocations) / nodes,
+              static_cast<double>(count.bytes) / nodes,
+              destroyTime * 1000.0 / N);
+}
+
+void usage() { std::cerr << "Usage: bench_nodes [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 3;
+  std::size_t bytes = 16 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_document(bytes));
+  std::size_t nodes = count_nodes(YAML::Load(input));
+  std::printf("%.1f MB (%zu nodes) x %d\n", megabytes(input->size()), nodes,
+              N);
+
+  run("retained", input, nodes, N, true);
+  run("stream", input, nodes, N, false);
+  return 0;
+}
@@ -0,0 +1,85 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "bench.h"
+
+// Writes a large document out as YAML and packed, and then reads it back:
+// with LoadFile, and by mapping the packed file and reading it into a Node,
+// or just looking one value up in it.
+
+namespace {
+template <typename F>
+double run(const char* name, int iterations, double baseline, F f) {
+  std::size_t total = 0;
+  AllocationMeter meter;
+  Timer timer;
+  for (int i = 0; i < iterations; i++) {
+    total += f();
+  }
+  double seconds = timer.seconds();
+  AllocationCount count = meter.stop();
+  std::printf("%-20s %9.3f ms  %9zu allocs  %8.1f MB  %8.2fx\n", name,
+              seconds * 1000.0 / iterations, count.allocations / iterations,
+              megabytes(count.bytes / iterations),
+              baseline > 0 ? baseline / seconds : 1.0);
+  if (total == 0)
+    std::printf("(nothing)\n");
+  return seconds;
+}
+
+void write(const char* filename, const std::string& contents) {
+  std::ofstream out(filename, std::ios::binary);
+  out << contents;
+}
+
+void usage() { std::cerr << "Usage: bench_pack [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 5;
+  std::size_t bytes = 16 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  const char* const yamlFile = "bench_pack.yaml";
+  const char* const packedFile = "bench_pack.yamlpack";
+  const std::string input = generate_document(bytes);
+  write(yamlFile, input);
+  const YAML::Node document = YAML::Load(input);
+  const std::size_t last = document.size() - 1;
+
+  Timer timer;
+  const std::string packed = YAML::Pack(document);
+  std::printf("%.1f MB of YAML, %.1f MB packed in %.1f ms (%zu records) x %d\n",
+              megabytes(input.size()), megabytes(packed.size()),
+              timer.seconds() * 1000.0, document.size(), N);
+  write(packedFile, packed);
+
+  std::printf("\nthe whole document\n");
+  double baseline = run("LoadFile", N, 0.0, [&]() {
+    return YAML::LoadFile(yamlFile).size();
+  });
+  run("MapFile, ToNode", N, baseline, [&]() {
+    return YAML::PackedDocument::MapFile(packedFile).ToNode().size();
+  });
+
+  std::printf("\none value\n");
+  baseline = run("LoadFile, lookup", N, 0.0, [&]() {
+    return YAML::LoadFile(yamlFile)[last]["owner"]["user"].Scalar().size();
+  });
+  run("MapFile, lookup", N, baseline, [&]() {
+    const YAML::PackedDocument packed =
+        YAML::PackedDocument::MapFile(packedFile);
+    return packed.Root()[last]["owner"]["user"].ScalarRef().size();
+  });
+
+  std::remove(yamlFile);
+  std::remove(packedFile);
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+
+// Reads the same deep paths out of a large configuration over and over: as
+// operator[] chains on a const Node, as the same chains on a NodeView, and as
+// compiled Paths. Then does the same for a path with a wildcard, against a
+// loop of operator[] chains.
+
+namespace {
+std::string generate_config(int services) {
+  std::stringstream out;
+  out << "settings:\n";
+  for (int i = 0; i < 64; i++) {
+    out << "  setting" << i << ": {retry: {attempts: " << i % 5
+        << "}, enabled: true}\n";
+  }
+  out << "services:\n";
+  for (int i = 0; i < services; i++) {
+    out << "  - name: service" << i << "\n";
+    out << "    owner: team" << i % 17 << "\n";
+    out << "    endpoints:\n";
+    for (int j = 0; j < 5; j++) {
+      out << "      - {url: 'http://host" << i << "/" << j
+          << "', timeout: " << (i + j) % 30 << "}\n";
+    }
+  }
+  return out.str();
+}
+
+void report(const char* name, double seconds, const AllocationCount& count,
+            double queries, double baseline) {
+  std::printf("%-14s %8.1f ms  %7.1f ns/query  %6.2f allocs/query  %5.2fx\n",
+              name, seconds * 1000.0, seconds * 1e9 / queries,
+              static_cast<double>(count.allocations) / queries,
+              baseline > 0 ? baseline / seconds : 1.0);
+}
+
+const int PATHS = 4;
+
+template <typename N>
+std::size_t read_chains(const N& config, int service) {
+  const std::string& timeout =
+      config["services"][service]["endpoints"][3]["timeout"].Scalar();
+  const std::string& attempts =
+      config["settings"]["setting42"]["retry"]["attempts"].Scalar();
+  const std::string& owner = config["services"][service]["owner"].Scalar();
+  const std::string& enabled =
+      config["settings"]["setting7"]["enabled"].Scalar();
+  return timeout.size() + attempts.size() + owner.size() + enabled.size();
+}
+
+void usage() { std::cerr << "Usage: bench_paths [-n N]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 200000;
+  std::size_t bytes = 0;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  const int services = 1000;
+  const YAML::Node config = YAML::Load(generate_config(services));
+  const YAML::NodeView view = config;
+
+  // the paths for every service are compiled up front, as a service
+  // reading its own configuration would
+  std::vector<YAML::Path> paths;
+  for (int i = 0; i < services; i++) {
+    std::stringstream service;
+    service << "services[" << i << "]";
+    paths.push_back(YAML::Path(service.str() + ".endpoints[3].timeout"));
+    paths.push_back(YAML::Path("settings.setting42.retry.attempts"));
+    paths.push_back(YAML::Path(service.str() + ".owner"));
+    paths.push_back(YAML::Path("settings.setting7.enabled"));
+  }
+
+  std::printf("%d services, %d x %d paths\n", services, N, PATHS);
+  double queries = static_cast<double>(N) * PATHS;
+  std::size_t totals[3] = {0, 0, 0};
+  double baseline = 0.0;
+  {
+    AllocationMeter meter;
+    Timer timer;
+    for (int i = 0; i < N; i++)
+      totals[0] += read_chains(config, i % services);
+    baseline = timer.seconds();
+    report("Node chain", baseline, meter.stop(), queries, 0.0);
+  }
+  {
+    AllocationMeter meter;
+    Timer timer;
+    for (int i = 0; i < N; i++)
+      totals[1] += read_chains(view, i % services);
+    report("NodeView chain", timer.seconds(), meter.stop(), queries, baseline);
+  }
+  {
+    AllocationMeter meter;
+    Timer timer;
+    for (int i = 0; i < N; i++) {
+      const YAML::Path* pPaths = &paths[(i % services) * PATHS];
+      for (int p = 0; p < PATHS; p++)
+        totals[2] += pPaths[p].Find(view).Scalar().size();
+    }
+    report("Path", timer.seconds(), meter.stop(), queries, baseline);
+  }
+  if (totals[0] != totals[1] || totals[0] != totals[2])
+    std::printf("results differ!\n");
+
+  const YAML::Path wildcard("services[*].endpoints[3].timeout");
+  int rounds = N / services + 1;
+  queries = static_cast<double>(rounds) * services;
+  std::size_t wildTotals[2] = {0, 0};
+  {
+    AllocationMeter meter;
+    Timer timer;
+    for (int r = 0; r < rounds; r++) {
+      const YAML::Node list = config["services"];
+      for (std::size_t i = 0; i < list.size(); i++)
+        wildTotals[0] += list[i]["endpoints"][3]["timeout"].Scalar().size();
+    }
+    baseline = timer.seconds();
+    report("Node loop", baseline, meter.stop(), queries, 0.0);
+  }
+  {
+    AllocationMeter meter;
+    Timer timer;
+    for (int r = 0; r < rounds; r++) {
+      wildcard.ForEach(view, [&](const YAML::NodeView& match) {
+        wildTotals[1] += match.Scalar().size();
+      });
+    }
+    report("Path [*]", timer.seconds(), meter.stop(), queries, baseline);
+  }
+  if (wildTotals[0] != wildTotals[1])
+    std::printf("results differ!\n");
+  return 0;
+}
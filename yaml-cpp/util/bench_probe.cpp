@@ -0,0 +1,100 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "bench.h"
+
+// Probes each record of a loaded document for optional settings, the way
+// configuration readers do: most of the keys asked for aren't there, and one
+// value is read as a type it isn't. "const" does it with operator[] on a
+// const Node, checking before converting (so looking up twice per hit) and
+// catching the bad conversion, "mutable" does the same on a non-const Node
+// (so that each miss adds an undefined entry), and "find" uses find and
+// try_as.
+
+namespace {
+struct Settings {
+  Settings() : ratio(0.0), retries(3), note(0) {}
+
+  std::string name, description, email;
+  double ratio;
+  int retries, note;
+};
+
+const int PROBES = 6;
+
+template <typename N>
+void probe_with_subscripts(N record, Settings& settings) {
+  if (record["name"])
+    settings.name = record["name"].template as<std::string>();
+  if (record["description"])
+    settings.description = record["description"].template as<std::string>();
+  if (record["ratio"])
+    settings.ratio = record["ratio"].template as<double>();
+  if (record["retries"])
+    settings.retries = record["retries"].template as<int>();
+  if (record["owner"]["email"])
+    settings.email = record["owner"]["email"].template as<std::string>();
+  try {
+    if (record["note"])
+      settings.note = record["note"].template as<int>();
+  } catch (const YAML::BadConversion&) {
+  }
+}
+
+void probe_with_find(const YAML::Node& record, Settings& settings) {
+  record.find("name").try_as(settings.name);
+  record.find("description").try_as(settings.description);
+  record.find("ratio").try_as(settings.ratio);
+  record.find("retries").try_as(settings.retries);
+  record.find("owner").find("email").try_as(settings.email);
+  record.find("note").try_as(settings.note);
+}
+
+template <typename Probe>
+double run(const char* name, YAML::Node& document, Probe probe,
+           double baseline) {
+  AllocationMeter meter;
+  Timer timer;
+  for (YAML::iterator it = document.begin(); it != document.end(); ++it) {
+    Settings settings;
+    probe(*it, settings);
+  }
+  double seconds = timer.seconds();
+  AllocationCount count = meter.stop();
+
+  double probes = static_cast<double>(PROBES) * document.size();
+  std::printf("%-8s %8.1f ms  %7.1f ns/probe  %6.2f allocs/probe  %5.2fx\n",
+              name, seconds * 1000.0, seconds * 1e9 / probes,
+              static_cast<double>(count.allocations) / probes,
+              baseline > 0 ? baseline / seconds : 1.0);
+  return seconds;
+}
+
+void usage() { std::cerr << "Usage: bench_probe [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 1;
+  std::size_t bytes = 8 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_document(bytes));
+  YAML::Node document = YAML::Load(input);
+  std::printf("%.1f MB (%zu records)\n", megabytes(input->size()),
+              document.size());
+
+  // the mutable run goes last, since it changes the document
+  double baseline = run("const", document,
+                        probe_with_subscripts<const YAML::Node&>, 0.0);
+  run("find", document, probe_with_find, baseline);
+  run("mutable", document, probe_with_subscripts<YAML::Node>, baseline);
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "bench.h"
+
+// Compares loading memory-resident input by copying every scalar against
+// loading it with scalars that refer to the retained input.
+
+namespace {
+void report(const char* name, double seconds, const AllocationCount& count,
+            double mb) {
+  std::printf("%-10s %8.1f ms  %10.0f allocs/MB  %10.0f KB/MB\n", name,
+              seconds * 1000.0, count.allocations / mb,
+              count.bytes / 1024.0 / mb);
+}
+
+void usage() { std::cerr << "Usage: bench_scalars [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 5;
+  std::size_t bytes = 4 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_document(bytes));
+  double mb = megabytes(input->size()) * N;
+  std::printf("%.1f MB x %d\n", megabytes(input->size()), N);
+
+  {
+    AllocationMeter meter;
+    Timer timer;
+    for (int i = 0; i < N; i++) {
+      std::stringstream stream(*input);
+      YAML::Node doc = YAML::Load(stream);
+    }
+    report("copied", timer.seconds(), meter.stop(), mb);
+  }
+
+  {
+    AllocationMeter meter;
+    Timer timer;
+    for (int i = 0; i < N; i++) {
+      YAML::Node doc = YAML::Load(input);
+    }
+    report("retained", timer.seconds(), meter.stop(), mb);
+  }
+  return 0;
+}
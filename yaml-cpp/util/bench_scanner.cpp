@@ -0,0 +1,106 @@
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "bench.h"
+
+// Counts the allocations made by the scanner and parser alone (the events go
+// nowhere), for inputs of two sizes. The difference between them is the
+// steady-state cost, which should be (close to) nothing: tokens, indent
+// markers, and the readahead all recycle their storage.
+
+namespace {
+class NullEventHandler : public YAML::EventHandler {
+ public:
+  typedef YAML::Mark Mark;
+  typedef YAML::anchor_t anchor_t;
+
+  NullEventHandler() {}
+
+  virtual void OnDocumentStart(const Mark&) {}
+  virtual void OnDocumentEnd() {}
+  virtual void OnNull(const Mark&, anchor_t) {}
+  virtual void OnAlias(const Mark&, anchor_t) {}
+  virtual void OnScalar(const Mark&, const std::string&, anchor_t,
+                        const std::string&) {}
+  virtual void OnScalarRef(const Mark&, const std::string&, anchor_t,
+                           const YAML::StringRef&) {}
+  virtual void OnSequenceStart(const Mark&, const std::string&, anchor_t,
+                               YAML::EmitterStyle::value) {}
+  virtual void OnSequenceEnd() {}
+  virtual void OnMapStart(const Mark&, const std::string&, anchor_t,
+                          YAML::EmitterStyle::value) {}
+  virtual void OnMapEnd() {}
+};
+
+struct Result {
+  double seconds;
+  AllocationCount count;
+};
+
+Result parse(const std::string& input, bool retained) {
+  std::shared_ptr<const std::string> shared;
+  std::stringstream stream;
+  if (retained)
+    shared = std::make_shared<const std::string>(input);
+  else
+    stream.str(input);
+
+  AllocationMeter meter;
+  Timer timer;
+  NullEventHandler handler;
+  if (retained) {
+    YAML::Parser parser(shared);
+    while (parser.HandleNextDocument(handler)) {
+    }
+  } else {
+    YAML::Parser parser(stream);
+    while (parser.HandleNextDocument(handler)) {
+    }
+  }
+  Result result = {timer.seconds(), meter.stop()};
+  return result;
+}
+
+void run(const char* name, const std::string& small, const std::string& large,
+         bool retained) {
+  Result a = parse(small, retained);
+  Result b = parse(large, retained);
+  double mb = megabytes(large.size() - small.size());
+  double extra = static_cast<double>(b.count.allocations) -
+                 static_cast<double>(a.count.allocations);
+  std::printf("%-10s %8.1f MB/s  %8zu allocs (small)  %8zu allocs (large)"
+              "  %8.1f allocs/MB steady state\n",
+              name, megabytes(large.size()) / b.seconds, a.count.allocations,
+              b.count.allocations, extra / mb);
+}
+
+void usage() { std::cerr << "Usage: bench_scanner [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 1;
+  std::size_t bytes = 4 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::string small = generate_document(bytes / 4);
+  std::string large = generate_document(bytes);
+  std::printf("%.1f MB vs %.1f MB\n", megabytes(small.size()),
+              megabytes(large.size()));
+
+  // warm up (the scanner's regular expressions are built on first use)
+  parse(generate_document(1024), false);
+
+  run("stream", small, large, false);
+  run("retained", small, large, true);
+  return 0;
+}
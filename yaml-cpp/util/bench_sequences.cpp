@@ -0,0 +1,98 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+
+// Reads a flow sequence of a million doubles (like a table of coordinates)
+// into a std::vector<double>: from a loaded document, a Node at a time (as
+// convert<std::vector<T>> used to) and then in bulk; and then straight from
+// the input, by loading it and decoding it, against an EventCursor.
+
+namespace {
+std::string generate_table(int count) {
+  std::stringstream out;
+  out << "name: table\nvalues: [";
+  for (int i = 0; i < count; i++) {
+    out << (i ? ", " : "") << (i % 1000) * 0.125 - 60.0;
+  }
+  out << "]\n";
+  return out.str();
+}
+
+std::vector<double> node_at_a_time(const YAML::Node& node) {
+  std::vector<double> values;
+  for (YAML::const_iterator it = node.begin(); it != node.end(); ++it)
+    values.push_back(it->as<double>());
+  return values;
+}
+
+std::vector<double> load_and_decode(
+    const std::shared_ptr<const std::string>& input) {
+  return YAML::Load(input)["values"].as<std::vector<double>>();
+}
+
+std::vector<double> cursor(const std::shared_ptr<const std::string>& input) {
+  std::vector<double> values;
+  YAML::EventCursor cursor(input);
+  while (cursor.Next()) {
+    if (cursor.Type() == YAML::EventType::Scalar &&
+        cursor.ScalarRef() == YAML::StringRef("values", 6) &&
+        cursor.Next())
+      cursor.ReadNumbers(values);
+  }
+  return values;
+}
+
+template <typename F>
+double run(const char* name, int iterations, double baseline, F f) {
+  std::size_t total = 0;
+  AllocationMeter meter;
+  Timer timer;
+  for (int i = 0; i < iterations; i++) {
+    total += f().size();
+  }
+  double seconds = timer.seconds();
+  AllocationCount count = meter.stop();
+  std::printf("%-16s %8.1f ms  %9zu allocs  %7.1f MB  %6.2fx  (%zu values)\n",
+              name, seconds * 1000.0 / iterations,
+              count.allocations / iterations,
+              megabytes(count.bytes / iterations),
+              baseline > 0 ? baseline / seconds : 1.0, total / iterations);
+  return seconds;
+}
+
+void usage() { std::cerr << "Usage: bench_sequences [-n N]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 5;
+  std::size_t bytes = 0;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_table(1000000));
+  std::printf("%.1f MB, 1000000 doubles x %d\n", megabytes(input->size()), N);
+
+  YAML::Node document = YAML::Load(input);
+  YAML::Node values = document["values"];
+  std::printf("\nfrom a loaded document\n");
+  double baseline = run("Node at a time", N, 0.0,
+                        [&]() { return node_at_a_time(values); });
+  run("bulk", N, baseline,
+      [&]() { return values.as<std::vector<double>>(); });
+
+  std::printf("\nfrom the input\n");
+  baseline =
+      run("Load, bulk", N, 0.0, [&]() { return load_and_decode(input); });
+  run("EventCursor", N, baseline, [&]() { return cursor(input); });
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "bench.h"
+
+// Walks every node of a loaded document, through Node and then through
+// NodeView, summing the sizes of the scalars (so that the walk has something
+// to show for itself).
+
+namespace {
+template <typename N>
+std::size_t walk(const N& node) {
+  std::size_t total = 0;
+  switch (node.Type()) {
+    case YAML::NodeType::Scalar:
+      return node.Scalar().size();
+    case YAML::NodeType::Sequence:
+      for (typename N::const_iterator it = node.begin(); it != node.end();
+           ++it)
+        total += walk<N>(*it);
+      return total;
+    case YAML::NodeType::Map:
+      for (typename N::const_iterator it = node.begin(); it != node.end();
+           ++it)
+        total += walk<N>(it->first) + walk<N>(it->second);
+      return total;
+    default:
+      return 0;
+  }
+}
+
+template <typename N>
+double run(const char* name, const N& document, int iterations,
+           double baseline) {
+  AllocationMeter meter;
+  Timer timer;
+  std::size_t total = 0;
+  for (int i = 0; i < iterations; i++) {
+    total += walk<N>(document);
+  }
+  double seconds = timer.seconds();
+  AllocationCount count = meter.stop();
+  std::printf("%-9s %8.1f ms  %10zu bytes of scalars  %8zu allocs  %5.2fx\n",
+              name, seconds * 1000.0 / iterations, total / iterations,
+              count.allocations, baseline > 0 ? baseline / seconds : 1.0);
+  return seconds;
+}
+
+void usage() { std::cerr << "Usage: bench_views [-n N] [-s MB]\n"; }
+}
+
+int main(int argc, char** argv) {
+  int N = 5;
+  std::size_t bytes = 16 * 1024 * 1024;
+  if (!parse_bench_args(argc, argv, N, bytes)) {
+    usage();
+    return -1;
+  }
+
+  std::shared_ptr<const std::string> input =
+      std::make_shared<const std::string>(generate_document(bytes));
+  YAML::Node document = YAML::Load(input);
+  document.Freeze();
+  std::printf("%.1f MB x %d\n", megabytes(input->size()), N);
+
+  double baseline = run<YAML::Node>("Node", document, N, 0.0);
+  run<YAML::NodeView>("NodeView", YAML::NodeView(document), N, baseline);
+  return 0;
+}